@@ -0,0 +1,239 @@
+// ѹѹȣÿѹʽ / ֱ
+//   1. ߳ѹٶȺѹ (compressChunk)
+//   2. д߳ѹH5FrameWriter::append + HDF5  (ɷ deflate ʱ)
+//   3. ѹthreads ̸߳ѹһ֡д̰߳ H5Dwrite_chunk
+// 2  3 д H5Dread ֡ȽϣȷļԱ׼߽ѹ
+// е rgb_data.h5 (ȡǰ frames ֡)ɺϳɻ (ƽ +  + )
+// ÷: chunk_compress_bench [out_dir] [frames] [threads] [width height channels | rgb_data.h5] [bits]
+//   bits Ϊ 16 ʱ 12 λЧݵĵͨ uint16 ֡۲ shuffle Ч
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ChunkCodec.h"
+#include "H5FrameWriter.h"
+#include "WorkStealingPool.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Input {
+    std::vector<hsize_t> shape;  // ֡״
+    size_t element_size = 1;
+    size_t frame_bytes = 0;
+    std::vector<std::vector<uint8_t>> frames;
+};
+
+static bool loadFrames(const std::string& path, size_t frames, Input& input)
+{
+    try {
+        H5::H5File file(path, H5F_ACC_RDONLY);
+        H5::DataSet ds = file.openDataSet("/rgb/frames");
+        H5::DataSpace space = ds.getSpace();
+        const int rank = space.getSimpleExtentNdims();
+        std::vector<hsize_t> dims(rank);
+        space.getSimpleExtentDims(dims.data());
+        input.shape.assign(dims.begin() + 1, dims.end());
+        input.frame_bytes = 1;
+        for (hsize_t d : input.shape) input.frame_bytes *= (size_t)d;
+        frames = std::min<size_t>(frames, (size_t)dims[0]);
+        for (size_t i = 0; i < frames; ++i) {
+            std::vector<hsize_t> offset(rank, 0), count = dims;
+            offset[0] = i;
+            count[0] = 1;
+            space.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+            H5::DataSpace mem((int)count.size(), count.data());
+            input.frames.emplace_back(input.frame_bytes);
+            ds.read(input.frames.back().data(), H5::PredType::NATIVE_UINT8, mem, space);
+        }
+    }
+    catch (H5::Exception& e) {
+        printf("Failed to read %s: %s\n", path.c_str(), e.getCDetailMsg());
+        return false;
+    }
+    return !input.frames.empty();
+}
+
+static void makeFrames(size_t frames, hsize_t width, hsize_t height, hsize_t channels, int bits, Input& input)
+{
+    input.element_size = bits == 16 ? 2 : 1;
+    if (bits == 16) channels = 1;
+    input.shape = { height, width };
+    if (channels > 1) input.shape.push_back(channels);
+    input.frame_bytes = (size_t)(width * height * channels) * input.element_size;
+
+    std::mt19937 rng(7);
+    std::normal_distribution<double> noise(0.0, 2.0);
+    const double max_value = bits == 16 ? 4095.0 : 255.0;
+    for (size_t f = 0; f < frames; ++f) {
+        input.frames.emplace_back(input.frame_bytes);
+        uint8_t* p8 = input.frames.back().data();
+        uint16_t* p16 = (uint16_t*)p8;
+        const double shift = f * 3.0;  // 滺ƽ
+        for (hsize_t y = 0; y < height; ++y) {
+            for (hsize_t x = 0; x < width; ++x) {
+                const double u = (x + shift) / width, v = (double)y / height;
+                for (hsize_t c = 0; c < channels; ++c) {
+                    double value = 0.35 + 0.25 * std::sin(6.0 * u + c) * std::cos(4.0 * v)
+                        + (((int)((x + shift) / 40) + (int)(y / 40)) % 2) * 0.15 + noise(rng) / 255.0;
+                    value = std::min(std::max(value, 0.0), 1.0) * max_value;
+                    const size_t i = (size_t)((y * width + x) * channels + c);
+                    if (bits == 16) p16[i] = (uint16_t)value;
+                    else p8[i] = (uint8_t)value;
+                }
+            }
+        }
+    }
+}
+
+static bool verify(const std::string& path, const Input& input)
+{
+    H5::H5File file(path, H5F_ACC_RDONLY);
+    H5::DataSet ds = file.openDataSet("/rgb/frames");
+    H5::DataSpace space = ds.getSpace();
+    const int rank = space.getSimpleExtentNdims();
+    std::vector<hsize_t> dims(rank);
+    space.getSimpleExtentDims(dims.data());
+    if (dims[0] != input.frames.size()) {
+        printf("verify: %llu frames in file, expected %zu\n", (unsigned long long)dims[0], input.frames.size());
+        return false;
+    }
+    std::vector<uint8_t> buffer(input.frame_bytes);
+    for (size_t i = 0; i < input.frames.size(); ++i) {
+        std::vector<hsize_t> offset(rank, 0), count = dims;
+        offset[0] = i;
+        count[0] = 1;
+        space.selectHyperslab(H5S_SELECT_SET, count.data(), offset.data());
+        H5::DataSpace mem((int)count.size(), count.data());
+        ds.read(buffer.data(), input.element_size == 2 ? H5::PredType::NATIVE_UINT16 : H5::PredType::NATIVE_UINT8, mem, space);
+        if (memcmp(buffer.data(), input.frames[i].data(), input.frame_bytes) != 0) {
+            printf("verify: frame %zu differs after read-back\n", i);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string out_dir = argc > 1 ? argv[1] : ".";
+    const size_t frames = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 60;
+    const size_t threads = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : logicalCoreCount();
+
+    H5::Exception::dontPrint();
+    registerChunkFilters();
+
+    Input input;
+    if (argc == 5) {
+        if (!loadFrames(argv[4], frames, input)) return 1;
+    }
+    else {
+        const hsize_t width = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1280;
+        const hsize_t height = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 1080;
+        const hsize_t channels = argc > 6 ? std::strtoull(argv[6], nullptr, 10) : 3;
+        const int bits = argc > 7 ? std::atoi(argv[7]) : 8;
+        makeFrames(frames, width, height, channels, bits, input);
+    }
+    const H5::PredType& type = input.element_size == 2 ? H5::PredType::NATIVE_UINT16 : H5::PredType::NATIVE_UINT8;
+    const std::vector<hsize_t>& shape = input.shape;  // Ԫؼƣframe_bytes ֽڼ
+    const double total_mb = (double)input.frame_bytes * input.frames.size() / 1e6;
+    printf("%zu frames, %.1f MB each, element %zu bytes, %zu threads\n",
+        input.frames.size(), input.frame_bytes / 1e6, input.element_size, threads);
+
+    std::vector<ChunkCompression> configs;
+    configs.push_back({ ChunkCodec::None, 0, false });
+    const ChunkCodec codecs[] = { ChunkCodec::Lz4, ChunkCodec::Zstd, ChunkCodec::Deflate };
+    for (ChunkCodec codec : codecs) {
+        if (!chunkCodecAvailable(codec)) {
+            printf("(%s not available in this build)\n", chunkCodecName(codec));
+            continue;
+        }
+        const std::vector<int> levels = codec == ChunkCodec::Lz4 ? std::vector<int>{ 0 } :
+            codec == ChunkCodec::Zstd ? std::vector<int>{ 1, 3 } : std::vector<int>{ 1, 6 };
+        for (int level : levels) {
+            configs.push_back({ codec, level, false });
+            if (input.element_size > 1) configs.push_back({ codec, level, true });
+        }
+    }
+
+    const std::string path = out_dir + "/chunk_compress_bench.h5";
+    printf("%-8s %5s %7s  %6s  %12s  %14s  %14s\n", "codec", "level", "shuffle", "ratio",
+        "1 thread", "writer thread", "parallel");
+    for (const ChunkCompression& config : configs) {
+        // 1. ߳ѹ
+        std::vector<uint8_t> out, scratch;
+        size_t compressed = 0;
+        auto t0 = Clock::now();
+        for (const auto& frame : input.frames) {
+            if (!compressChunk(config, input.element_size, frame.data(), input.frame_bytes, out, scratch)) return 1;
+            compressed += out.size();
+        }
+        const double single_s = std::chrono::duration<double>(Clock::now() - t0).count();
+        const double ratio = (double)input.frame_bytes * input.frames.size() / compressed;
+
+        H5FrameWriter::Options options;
+        options.batch_frames = 1;
+        options.chunk_frames = 1;
+        options.compression = config;
+
+        // 2. д߳ HDF5 ѹ
+        t0 = Clock::now();
+        {
+            H5::H5File file(path, H5F_ACC_TRUNC);
+            H5::Group group = file.createGroup("/rgb");
+            H5FrameWriter writer;
+            if (!writer.create(group, "frames", type, shape, options)) return 1;
+            for (const auto& frame : input.frames) writer.append(frame.data(), frame.size());
+            writer.close();
+        }
+        const double inline_s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (!verify(path, input)) return 1;
+
+        // 3. ̲߳ѹдֻ߳ H5Dwrite_chunk
+        struct Slot {
+            std::vector<uint8_t> chunk;
+            std::vector<uint8_t> scratch;
+            std::atomic<bool> ready{ false };
+        };
+        std::vector<Slot> slots(input.frames.size());
+        t0 = Clock::now();
+        {
+            WorkStealingPool pool(threads);
+            H5::H5File file(path, H5F_ACC_TRUNC);
+            H5::Group group = file.createGroup("/rgb");
+            H5FrameWriter writer;
+            if (!writer.create(group, "frames", type, shape, options)) return 1;
+
+            const Input* in = &input;
+            const ChunkCompression* cfg = &config;
+            for (size_t i = 0; i < slots.size(); ++i) {
+                Slot* slot = &slots[i];
+                pool.enqueue([in, cfg, slot, i]() {
+                    compressChunk(*cfg, in->element_size, in->frames[i].data(), in->frame_bytes, slot->chunk, slot->scratch);
+                    slot->ready.store(true, std::memory_order_release);
+                });
+            }
+            for (Slot& slot : slots) {
+                while (!slot.ready.load(std::memory_order_acquire)) std::this_thread::yield();
+                if (!writer.appendChunk(slot.chunk.data(), slot.chunk.size())) return 1;
+                std::vector<uint8_t>().swap(slot.chunk);
+            }
+            writer.close();
+        }
+        const double parallel_s = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (!verify(path, input)) return 1;
+
+        printf("%-8s %5d %7s  %6.2f  %7.0f MB/s  %9.0f MB/s  %9.0f MB/s\n", chunkCodecName(config.codec),
+            config.level, config.shuffle ? "yes" : "no", ratio,
+            total_mb / single_s, total_mb / inline_s, total_mb / parallel_s);
+    }
+    std::remove(path.c_str());
+    printf("read-back verified for every configuration\n");
+    return 0;
+}
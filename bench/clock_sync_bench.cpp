@@ -0,0 +1,153 @@
+// RGB <-> DVS ʱ߶ľ뿪 (棬Ҫ)
+//
+// һβɼ fps ͬʱ̨
+//   - ¼ʱ (us) Ϊ׼ʼص¼ʱ 1 us Ķ
+//   - RGB 豸ʱ (ns ) й̶ƫƺͻ仯Ƶ (ppmģƯ)֡豸ʱ쳣
+//   - ص 0.5 ~ 8 ms  ()RGB ֡ص 10 ~ 20 msд߳ 20 ms  align
+//   - ص֡ (֡ճ)ѡ;豸ʱ (ϵ)³ʼ
+// ÿ֡ⲻ豸ʱһΣͳϵ
+// ʱ˳ִ addTriggers / addRgbFrame / alignÿ֡ (ֵ - ʵع) ķλ
+// 豸ԴԼÿεõĿ
+// ÷: clock_sync_bench [frames] [fps] [drift_ppm] [reset_device_clock 0/1]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+#include "ClockSync.h"
+
+struct Action {
+    double host_us;      // ʱ (us)
+    int kind;            // 0 ص1 RGB ֡ص2 д߳ align
+    uint64_t frame;
+};
+
+static double percentile(std::vector<double>& v, double q)
+{
+    if (v.empty()) return 0;
+    const size_t i = std::min(v.size() - 1, (size_t)(q * (v.size() - 1) + 0.5));
+    std::nth_element(v.begin(), v.begin() + i, v.end());
+    return v[i];
+}
+
+int main(int argc, char* argv[])
+{
+    const uint64_t frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    const double fps = argc > 2 ? std::atof(argv[2]) : 60;
+    const double drift_ppm = argc > 3 ? std::atof(argv[3]) : 40;
+    const bool reset_device = argc > 4 && std::atoi(argv[4]) != 0;
+
+    std::mt19937_64 rng(11);
+    std::normal_distribution<double> edge_jitter(0, 0.7);     // us
+    std::normal_distribution<double> device_jitter(0, 1500);  // ns
+    std::uniform_real_distribution<double> unit(0, 1);
+    std::exponential_distribution<double> trigger_delay(1.0 / 2000);  // ƽ 2 ms
+
+    const double period_us = 1e6 / fps;
+    const double t0_us = 123456;                 // һ¼ʱʱ
+    const double device0_ns = 9.87e11;           // 豸ʱ¼ʱ 0 Ķ
+    const uint64_t first_frame_number = 1000;
+    const uint64_t reset_at = reset_device ? frames / 2 : UINT64_MAX;
+
+    // ʵֵ
+    std::vector<double> edge_us(frames), device_ns(frames);
+    std::vector<char> observed(frames);
+    double device_offset = device0_ns;
+    for (uint64_t k = 0; k < frames; ++k) {
+        const double t = t0_us + k * period_us;
+        edge_us[k] = t;
+        // Ƶ drift_ppm  10 Ϊڱ仯 +-20%豸ʱƵʵĻ
+        const double omega = 2 * 3.14159265358979 / 600e6;
+        const double elapsed_ppm_us = drift_ppm * (t + 0.2 * (1 - std::cos(omega * t)) / omega);
+        const double ticks = (t + elapsed_ppm_us * 1e-6) * 1000;
+        if (k == reset_at) device_offset = -ticks + 5e6;
+        device_ns[k] = device_offset + ticks;
+        observed[k] = unit(rng) > 0.01;          // 1% ֡ڻص˱
+    }
+
+    std::vector<Action> actions;
+    double batch_host = 0;
+    for (uint64_t k = 0; k < frames; ++k) {
+        // صһ 1 ms ʱϲ
+        const double arrive = edge_us[k] + 500 + trigger_delay(rng);
+        batch_host = std::max(arrive, batch_host);
+        actions.push_back({ batch_host, 0, k });
+        if (observed[k]) {
+            const double frame_host = edge_us[k] + 10000 + unit(rng) * 10000;
+            actions.push_back({ frame_host, 1, k });
+            actions.push_back({ frame_host + 20000, 2, k });
+        }
+    }
+    std::stable_sort(actions.begin(), actions.end(), [](const Action& a, const Action& b) { return a.host_us < b.host_us; });
+
+    ClockSync sync;
+    sync.reset();
+    const double host0_ns = 5e12;                //  steady_clock ¼ʱ 0 Ķ
+    std::vector<double> device_err, host_err;
+    uint64_t none = 0, glitches = 0;
+    double add_s = 0, align_s = 0;
+    uint64_t adds = 0, aligns = 0;
+    using Clock = std::chrono::steady_clock;
+    for (const Action& a : actions) {
+        const uint64_t host_ns = (uint64_t)(host0_ns + a.host_us * 1000);
+        const uint64_t k = a.frame;
+        if (a.kind == 0) {
+            const Metavision::EventExtTrigger edges[2] = {
+                Metavision::EventExtTrigger(1, (Metavision::timestamp)std::llround(edge_us[k] + edge_jitter(rng)), 0),
+                Metavision::EventExtTrigger(0, (Metavision::timestamp)std::llround(edge_us[k] + period_us / 2), 0),
+            };
+            const Clock::time_point c = Clock::now();
+            sync.addTriggers(edges, edges + 2);
+            add_s += std::chrono::duration<double>(Clock::now() - c).count();
+            adds++;
+            continue;
+        }
+        uint64_t device = (uint64_t)std::llround(device_ns[k] + device_jitter(rng));
+        if (a.kind == 1 && unit(rng) < 0.002) {
+            device ^= (uint64_t)1 << 40;         // 0.2% ֡豸ʱ쳣
+            glitches++;
+        }
+        if (a.kind == 1) {
+            const Clock::time_point c = Clock::now();
+            sync.addRgbFrame(first_frame_number + k, host_ns, device);
+            add_s += std::chrono::duration<double>(Clock::now() - c).count();
+            adds++;
+            continue;
+        }
+        const uint64_t frame_host_ns = (uint64_t)(host0_ns + (a.host_us - 20000) * 1000);
+        const Clock::time_point c = Clock::now();
+        const ClockSync::Estimate e = sync.align(first_frame_number + k, frame_host_ns, device);
+        align_s += std::chrono::duration<double>(Clock::now() - c).count();
+        aligns++;
+        // ǰ 2 豸ʱ 2 Ϊڣ
+        const bool settling = edge_us[k] - t0_us < 2e6 ||
+            (k >= reset_at && edge_us[k] - edge_us[reset_at] < 2e6);
+        if (settling) continue;
+        if (e.source == ClockSync::Source::None) none++;
+        else if (e.source == ClockSync::Source::Device) device_err.push_back(std::fabs(e.t_us - edge_us[k]));
+        else host_err.push_back(std::fabs(e.t_us - edge_us[k]));
+        // ͬһ֡豸ʱٶһΣ (豸ʱʱ·)
+        const ClockSync::Estimate h = sync.align(first_frame_number + k, frame_host_ns, 0);
+        if (h.source == ClockSync::Source::Host) host_err.push_back(std::fabs(h.t_us - edge_us[k]));
+    }
+
+    const ClockSync::Stats s = sync.stats();
+    printf("%llu frames at %.0f fps, drift %.0f ppm%s: %llu pulses, %llu RGB frames, %llu pairs, %llu glitches\n",
+        (unsigned long long)frames, fps, drift_ppm, reset_device ? ", device clock reset midway" : "",
+        (unsigned long long)s.pulses, (unsigned long long)s.rgb_frames, (unsigned long long)s.pairs,
+        (unsigned long long)glitches);
+    printf("device fit: slope %.9f us/tick (%.1f ppm), residual %.2f us, rejected %llu; host fit: residual %.0f us, rejected %llu; relocks %llu\n",
+        s.device_slope, s.device_slope > 0 ? (1 / (1e3 * s.device_slope) - 1) * 1e6 : 0.0, s.device_residual_us, (unsigned long long)s.device_rejected,
+        s.host_residual_us, (unsigned long long)s.host_rejected, (unsigned long long)s.relocks);
+    const size_t n_device = device_err.size(), n_host = host_err.size();
+    const double d50 = percentile(device_err, 0.5), d99 = percentile(device_err, 0.99), dmax = percentile(device_err, 1.0);
+    const double h50 = percentile(host_err, 0.5), h99 = percentile(host_err, 0.99);
+    printf("aligned frames: device %zu (|err| p50 %.2f us, p99 %.2f us, max %.2f us), host %zu (p50 %.0f us, p99 %.0f us), none %llu\n",
+        n_device, d50, d99, dmax, n_host, h50, h99, (unsigned long long)none);
+    printf("cost: %.0f ns per add, %.0f ns per align\n", add_s * 1e9 / std::max<uint64_t>(adds, 1),
+        align_s * 1e9 / std::max<uint64_t>(aligns, 1));
+    // 豸ϵӦ붶ͬһ֡صӳٵĶ (Ϊ +-5 ms ȷֲ)
+    return (n_device > 0 && d99 < 10 && n_host > 0 && h99 < 10000) ? 0 : 2;
+}
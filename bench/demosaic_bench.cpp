@@ -0,0 +1,198 @@
+// Demosaic ʵֵȷУ
+//
+// 1. 뱾ļذزοʵֽڱȽ (4  x 2 ַ x пָ
+//    ߴ縲Ǳ߽β)κβһ¶ӡ׸λòԷֵ˳
+// 2. ֡ÿַ / ָȡ iterations һ
+// 3. дз֣1, 2, 4, ... ̸߳һдУƴӽ֡һ
+// ÷: demosaic_bench [width] [height] [iterations] [max_threads]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "Demosaic.h"
+#include "WorkStealingPool.h"
+
+using Clock = std::chrono::steady_clock;
+
+static const BayerPattern kPatterns[] = { BayerPattern::GB, BayerPattern::RG, BayerPattern::GR, BayerPattern::BG };
+static const char* kPatternNames[] = { "GB", "RG", "GR", "BG" };
+static const DemosaicMethod kMethods[] = { DemosaicMethod::Bilinear, DemosaicMethod::EdgeAware };
+static const char* kMethodNames[] = { "bilinear", "edge-aware" };
+
+// 0 = B, 1 = G, 2 = R
+static int colorAt(BayerPattern pattern, int x, int y)
+{
+    static const int layout[4][2][2] = {
+        { { 1, 0 }, { 2, 1 } },  // GB
+        { { 2, 1 }, { 1, 0 } },  // RG
+        { { 1, 2 }, { 0, 1 } },  // GR
+        { { 0, 1 }, { 1, 2 } },  // BG
+    };
+    return layout[(int)pattern][y & 1][x & 1];
+}
+
+static int reflect(int i, int n)
+{
+    return i < 0 ? -i : (i >= n ? 2 * n - 2 - i : i);
+}
+
+// زοȱʧɫȡ 3x3 иɫصƽ ( Demosaic.h еĹʽ)
+static void referenceDemosaic(const std::vector<uint8_t>& src, std::vector<uint8_t>& dst,
+    int width, int height, BayerPattern pattern, DemosaicMethod method)
+{
+    auto at = [&](int x, int y) { return (int)src[(size_t)reflect(y, height) * width + reflect(x, width)]; };
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const int own = colorAt(pattern, x, y);
+            for (int ch = 0; ch < 3; ++ch) {
+                int value;
+                if (ch == own) {
+                    value = at(x, y);
+                }
+                else {
+                    int sum = 0, n = 0;
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            if ((dx || dy) && colorAt(pattern, x + dx, y + dy) == ch) {
+                                sum += at(x + dx, y + dy);
+                                n++;
+                            }
+                        }
+                    }
+                    value = (sum + n / 2) / n;
+                    if (ch == 1 && method == DemosaicMethod::EdgeAware) {
+                        const int dh = std::abs(at(x - 1, y) - at(x + 1, y));
+                        const int dv = std::abs(at(x, y - 1) - at(x, y + 1));
+                        if (dh < dv) value = (at(x - 1, y) + at(x + 1, y) + 1) / 2;
+                        else if (dv < dh) value = (at(x, y - 1) + at(x, y + 1) + 1) / 2;
+                    }
+                }
+                dst[((size_t)y * width + x) * 3 + ch] = (uint8_t)value;
+            }
+        }
+    }
+}
+
+// Ĳͼƽ + ֱ / ˮƽԵ +  edge-aware ĸ֧ߵ
+static std::vector<uint8_t> makeMosaic(int width, int height, unsigned seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> noise(-24, 24);
+    std::vector<uint8_t> img((size_t)width * height);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            int v = (x * 255) / std::max(width - 1, 1) / 2 + ((y / 7) % 2) * 64 + ((x / 13) % 2) * 48 + noise(rng);
+            img[(size_t)y * width + x] = (uint8_t)std::min(std::max(v, 0), 255);
+        }
+    }
+    return img;
+}
+
+static bool compare(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int width, const char* what)
+{
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] != b[i]) {
+            size_t px = i / 3;
+            printf("MISMATCH %s at (%zu, %zu) channel %zu: %d vs %d\n",
+                what, px % width, px / width, i % 3, a[i], b[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool verify(int width, int height, SimdLevel max_level)
+{
+    std::vector<uint8_t> src = makeMosaic(width, height, (unsigned)(width * 131 + height));
+    std::vector<uint8_t> expected((size_t)width * height * 3), actual(expected.size());
+    char what[96];
+    for (int p = 0; p < 4; ++p) {
+        for (int m = 0; m < 2; ++m) {
+            referenceDemosaic(src, expected, width, height, kPatterns[p], kMethods[m]);
+            for (int l = 0; l <= (int)max_level; ++l) {
+                std::fill(actual.begin(), actual.end(), 0);
+                demosaic(src.data(), width, actual.data(), (size_t)width * 3, width, height,
+                    kPatterns[p], kMethods[m], (SimdLevel)l);
+                snprintf(what, sizeof(what), "%dx%d %s %s %s", width, height,
+                    kPatternNames[p], kMethodNames[m], simdLevelName((SimdLevel)l));
+                if (!compare(expected, actual, width, what)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 2448;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 2048;
+    const int iterations = argc > 3 ? std::atoi(argv[3]) : 20;
+    const size_t max_threads = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : logicalCoreCount();
+    const SimdLevel best = detectSimdLevel();
+
+    printf("frame %dx%d, iterations %d, detected %s\n", width, height, iterations, simdLevelName(best));
+
+    // 1. ȷ
+    const int sizes[][2] = { { 2, 2 }, { 3, 5 }, { 17, 4 }, { 67, 33 }, { 130, 9 }, { 257, 66 }, { 640, 48 } };
+    for (const auto& size : sizes) {
+        if (!verify(size[0], size[1], best)) return 1;
+    }
+    if (!verify(width, std::min(height, 64), best)) return 1;
+    printf("bit-exact: all patterns / methods / levels match the reference\n");
+
+    // 2. ֡
+    std::vector<uint8_t> src = makeMosaic(width, height, 1);
+    std::vector<uint8_t> dst((size_t)width * height * 3), full(dst.size());
+    const double mpix = (double)width * height / 1e6;
+    for (int m = 0; m < 2; ++m) {
+        for (int l = 0; l <= (int)best; ++l) {
+            double best_ms = 1e30;
+            for (int i = 0; i < iterations; ++i) {
+                auto t0 = Clock::now();
+                demosaic(src.data(), width, dst.data(), (size_t)width * 3, width, height,
+                    BayerPattern::GB, kMethods[m], (SimdLevel)l);
+                best_ms = std::min(best_ms, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+            }
+            printf("%-10s %-7s %8.3f ms/frame  %8.1f Mpix/s\n", kMethodNames[m], simdLevelName((SimdLevel)l),
+                best_ms, mpix / best_ms * 1e3);
+        }
+    }
+
+    // 3. дз
+    struct BandJob {
+        const uint8_t* src;
+        uint8_t* dst;
+        int width, height;
+        std::atomic<int> done{ 0 };
+    } job{ src.data(), dst.data(), width, height };
+    demosaic(src.data(), width, full.data(), (size_t)width * 3, width, height, BayerPattern::GB, DemosaicMethod::Bilinear);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        WorkStealingPool pool(threads);
+        const int band = (height + (int)threads - 1) / (int)threads;
+        double best_ms = 1e30;
+        for (int i = 0; i < iterations; ++i) {
+            std::fill(dst.begin(), dst.end(), 0);
+            job.done = 0;
+            auto t0 = Clock::now();
+            for (size_t t = 0; t < threads; ++t) {
+                BandJob* p = &job;
+                const int row_begin = (int)t * band;
+                pool.enqueue([p, row_begin, band]() {
+                    demosaicRows(p->src, p->width, p->dst, (size_t)p->width * 3, p->width, p->height,
+                        BayerPattern::GB, DemosaicMethod::Bilinear, row_begin, row_begin + band);
+                    p->done.fetch_add(1, std::memory_order_release);
+                });
+            }
+            while (job.done.load(std::memory_order_acquire) < (int)threads) std::this_thread::yield();
+            best_ms = std::min(best_ms, std::chrono::duration<double, std::milli>(Clock::now() - t0).count());
+        }
+        if (!compare(full, dst, width, "row bands")) return 1;
+        printf("bands  threads %2zu  %8.3f ms/frame  %8.1f Mpix/s\n", threads, best_ms, mpix / best_ms * 1e3);
+    }
+    return 0;
+}
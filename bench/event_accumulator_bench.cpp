@@ -0,0 +1,119 @@
+// DVS ʾ֡ɣԭ (PeriodicFrameGenerationAlgorithm + CDFrameGenerator) Աȵ EventAccumulator
+//
+// ¼ SyntheticEventSource Ԥɵڴ (ʱ)ٰ 4096 һٶ͸ʵ֣
+// ÿ봦¼ (Mev/sǽ) Ͱ¼ʱ֡
+// ע CDFrameGenerator Լ߳Ⱦֻ add_events ʱ䣬Ⱦһϡ
+// ÷: event_accumulator_bench [events_millions] [rate_mev_s] [uniform|gaussian|edge]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <metavision/sdk/core/algorithms/periodic_frame_generation_algorithm.h>
+#include <metavision/sdk/core/utils/cd_frame_generator.h>
+#include "EventAccumulator.h"
+#include "SyntheticEventSource.h"
+
+using Clock = std::chrono::steady_clock;
+
+static const size_t kBatch = 4096;
+
+template <typename Feed>
+static double timeFeed(const std::vector<Metavision::EventCD>& events, Feed feed)
+{
+    const Clock::time_point t0 = Clock::now();
+    for (size_t i = 0; i < events.size(); i += kBatch) {
+        const size_t n = std::min(kBatch, events.size() - i);
+        feed(events.data() + i, events.data() + i + n);
+    }
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+static void report(const char* name, size_t events, double seconds, uint64_t frames)
+{
+    printf("%-34s %7.1f Mev/s  %6.3f s  %llu frames\n", name, events / seconds / 1e6, seconds, (unsigned long long)frames);
+}
+
+int main(int argc, char* argv[])
+{
+    const double millions = argc > 1 ? std::atof(argv[1]) : 50.0;
+    const double rate = argc > 2 ? std::atof(argv[2]) : 20.0;
+    const char* shape = argc > 3 ? argv[3] : "edge";
+
+    SyntheticEventSource::Options options;
+    options.rate_mev_s = rate;
+    options.real_time = false;
+    options.buffer_events = kBatch;
+    options.max_events = (uint64_t)(millions * 1e6);
+    options.distribution = strcmp(shape, "uniform") == 0 ? SyntheticEventSource::Distribution::Uniform
+        : strcmp(shape, "gaussian") == 0 ? SyntheticEventSource::Distribution::Gaussian
+        : SyntheticEventSource::Distribution::MovingEdge;
+    const int width = options.width;
+    const int height = options.height;
+
+    // Ԥȫ¼
+    std::vector<Metavision::EventCD> events;
+    events.reserve((size_t)options.max_events);
+    {
+        SyntheticEventSource source(options);
+        if (!source.open()) return 1;
+        std::mutex mutex;
+        source.start([&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.insert(events.end(), begin, end);
+        });
+        while (!source.finished()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        source.stop();
+    }
+    if (events.empty()) return 1;
+    printf("%zu events, %.2f s of event time\n", events.size(), (events.back().t - events.front().t) * 1e-6);
+
+    // ԭһ (PeriodicFrameGenerationAlgorithm  DVS δʹ)
+    {
+        uint64_t frames = 0;
+        Metavision::PeriodicFrameGenerationAlgorithm frame_gen(width, height, 20000, 50);
+        frame_gen.set_output_callback([&frames](Metavision::timestamp, cv::Mat&) { frames++; });
+        Metavision::CDFrameGenerator cd_frame_generator(width, height);
+        cd_frame_generator.set_display_accumulation_time_us(30000);
+        cd_frame_generator.start(30, [](const Metavision::timestamp&, const cv::Mat&) {});
+        const double seconds = timeFeed(events, [&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+            frame_gen.process_events(begin, end);
+            cd_frame_generator.add_events(begin, end);
+        });
+        cd_frame_generator.stop();
+        report("periodic + CDFrameGenerator", events.size(), seconds, frames);
+    }
+
+    // ʾ֡ cv::Mat DVS ｻĿͬ
+    cv::Mat display(height, width, CV_8UC3);
+    auto copy_display = [&display](const EventImage& image) {
+        cv::Mat(image.height, image.width, CV_8UC3, const_cast<uint8_t*>(image.data), image.stride).copyTo(display);
+    };
+    EventAccumulator::DisplayOptions display_options;
+
+    {
+        EventAccumulator accumulator(width, height);
+        accumulator.setDisplayOutput(display_options, copy_display);
+        const double seconds = timeFeed(events, [&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+            accumulator.processEvents(begin, end);
+        });
+        report("accumulator: display", events.size(), seconds, accumulator.stats().display_frames);
+    }
+    {
+        EventAccumulator accumulator(width, height);
+        accumulator.setDisplayOutput(display_options, copy_display);
+        accumulator.setHistogramOutput(100, [](const EventImage&) {});
+        accumulator.setTimeSurfaceOutput(60, 50000, [](const EventImage&) {});
+        const double seconds = timeFeed(events, [&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+            accumulator.processEvents(begin, end);
+        });
+        const EventAccumulator::Stats stats = accumulator.stats();
+        report("accumulator: display+hist+surface", events.size(), seconds,
+            stats.display_frames + stats.histogram_frames + stats.time_surface_frames);
+    }
+    return 0;
+}
@@ -0,0 +1,218 @@
+// ¼룺ѹʡȷ
+//
+// 1. λÿֿ (0..32) ı AVX2 ֽڱȽϣһ
+// 2. ¼ϣϳ¼Դֲַ (ٶɲռ) .raw طŵõʵ¼
+// 3. ÿϱ ֽ / ¼ ( EventCD  16 ֽڱȽ)̱߳ /  Mev/s (ָ)
+//    Լ 1, 2, 4, ... ֹ̰߳б /  Mev/sԭ¼ͬ
+// ÷: event_codec_bench synthetic [events_millions] [rate_mev_s] [block_events] [max_threads]
+//       event_codec_bench replay <file.raw> [block_events] [max_threads]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <thread>
+#include <vector>
+#include "BitPack.h"
+#include "EventCodec.h"
+#include "MetavisionEventSource.h"
+#include "SyntheticEventSource.h"
+
+using Clock = std::chrono::steady_clock;
+
+static double secondsSince(Clock::time_point t0)
+{
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+static bool checkBitPack()
+{
+    std::mt19937 rng(7);
+    std::vector<SimdLevel> levels = { SimdLevel::Scalar };
+    if (detectSimdLevel() >= SimdLevel::AVX2) levels.push_back(SimdLevel::AVX2);
+    uint32_t in[kBitPackGroup], back[kBitPackGroup];
+    std::vector<uint8_t> reference(bitPackedBytes(32)), packed(bitPackedBytes(32));
+    for (int width = 0; width <= 32; ++width) {
+        for (uint32_t& v : in) v = rng();  // λʱ뱻
+        const uint32_t mask = width >= 32 ? 0xFFFFFFFFu : ((1u << width) - 1);
+        packBits256(in, width, reference.data(), SimdLevel::Scalar);
+        for (SimdLevel level : levels) {
+            packBits256(in, width, packed.data(), level);
+            unpackBits256(packed.data(), width, back, level);
+            if (memcmp(packed.data(), reference.data(), bitPackedBytes(width)) != 0) {
+                printf("bitpack: width %d %s output differs from scalar\n", width, simdLevelName(level));
+                return false;
+            }
+            for (size_t i = 0; i < kBitPackGroup; ++i) {
+                if (back[i] != (in[i] & mask)) {
+                    printf("bitpack: width %d %s value %zu: %u != %u\n", width, simdLevelName(level), i, back[i], in[i] & mask);
+                    return false;
+                }
+            }
+        }
+    }
+    printf("bitpack: widths 0-32 identical across %zu implementations\n", levels.size());
+    return true;
+}
+
+static bool collect(EventSource& source, std::vector<Metavision::EventCD>& events)
+{
+    events.clear();
+    if (!source.open()) return false;
+    source.start([&events](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+        events.insert(events.end(), begin, end);
+    });
+    while (!source.finished()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    source.stop();
+    return !events.empty();
+}
+
+static bool sameEvents(const std::vector<Metavision::EventCD>& a, const std::vector<Metavision::EventCD>& b)
+{
+    if (a.size() != b.size()) {
+        printf("  decoded %zu events, expected %zu\n", b.size(), a.size());
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].x != b[i].x || a[i].y != b[i].y || a[i].p != b[i].p || a[i].t != b[i].t) {
+            printf("  event %zu differs: (%u,%u,%d,%lld) != (%u,%u,%d,%lld)\n", i, b[i].x, b[i].y, b[i].p,
+                (long long)b[i].t, a[i].x, a[i].y, a[i].p, (long long)a[i].t);
+            return false;
+        }
+    }
+    return true;
+}
+
+// ߳ k  k, k + threads, ... 飻ȷԼĻ壬ɺ˳ƴ
+static double encodeParallel(const std::vector<Metavision::EventCD>& events, size_t block_events, int threads,
+    std::vector<uint8_t>& stream)
+{
+    const size_t blocks = (events.size() + block_events - 1) / block_events;
+    std::vector<std::vector<uint8_t>> parts(blocks);
+    const Clock::time_point t0 = Clock::now();
+    std::vector<std::thread> workers;
+    for (int k = 0; k < threads; ++k) {
+        workers.emplace_back([&, k]() {
+            for (size_t b = k; b < blocks; b += threads) {
+                const size_t first = b * block_events;
+                encodeEventBlock(events.data() + first, std::min(block_events, events.size() - first), parts[b]);
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    stream.clear();
+    for (const auto& part : parts) stream.insert(stream.end(), part.begin(), part.end());
+    return secondsSince(t0);
+}
+
+static double decodeParallel(const std::vector<uint8_t>& stream, const std::vector<EventBlockInfo>& blocks, int threads,
+    std::vector<Metavision::EventCD>& out, bool& ok)
+{
+    const Clock::time_point t0 = Clock::now();
+    std::vector<std::thread> workers;
+    std::vector<char> good(threads, 1);
+    for (int k = 0; k < threads; ++k) {
+        workers.emplace_back([&, k]() {
+            for (size_t b = k; b < blocks.size(); b += threads) {
+                const EventBlockInfo& info = blocks[b];
+                if (!decodeEventBlock(stream.data() + info.offset, stream.size() - info.offset, out.data() + info.first_event))
+                    good[k] = 0;
+            }
+        });
+    }
+    for (std::thread& w : workers) w.join();
+    ok = std::all_of(good.begin(), good.end(), [](char g) { return g != 0; });
+    return secondsSince(t0);
+}
+
+static int run(const char* name, const std::vector<Metavision::EventCD>& events, size_t block_events, int max_threads)
+{
+    const double mev = events.size() / 1e6;
+    std::vector<uint8_t> stream;
+    std::vector<EventBlockInfo> blocks;
+    std::vector<Metavision::EventCD> decoded;
+    int status = 0;
+
+    printf("%s: %zu events, %zu per block\n", name, events.size(), block_events);
+    std::vector<SimdLevel> levels = { SimdLevel::Scalar };
+    if (detectSimdLevel() >= SimdLevel::AVX2) levels.push_back(SimdLevel::AVX2);
+    for (SimdLevel level : levels) {
+        stream.clear();
+        Clock::time_point t0 = Clock::now();
+        encodeEvents(events.data(), events.size(), stream, block_events, level);
+        const double encode_s = secondsSince(t0);
+
+        if (!scanEventBlocks(stream.data(), stream.size(), blocks)) {
+            printf("  block scan failed\n");
+            return 2;
+        }
+        decoded.assign(events.size(), Metavision::EventCD());
+        bool ok = true;
+        t0 = Clock::now();
+        for (const EventBlockInfo& info : blocks) {
+            ok &= decodeEventBlock(stream.data() + info.offset, stream.size() - info.offset,
+                decoded.data() + info.first_event, level);
+        }
+        const double decode_s = secondsSince(t0);
+        ok = ok && sameEvents(events, decoded);
+        if (!ok) status = 2;
+        printf("  %-6s %.3f B/event (%.1fx vs EventCD), encode %.0f Mev/s, decode %.0f Mev/s%s\n", simdLevelName(level),
+            (double)stream.size() / events.size(), 16.0 * events.size() / stream.size(),
+            mev / encode_s, mev / decode_s, ok ? "" : "  MISMATCH");
+    }
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        const double encode_s = encodeParallel(events, block_events, threads, stream);
+        bool ok = scanEventBlocks(stream.data(), stream.size(), blocks);
+        decoded.assign(events.size(), Metavision::EventCD());
+        const double decode_s = ok ? decodeParallel(stream, blocks, threads, decoded, ok) : 0;
+        ok = ok && sameEvents(events, decoded);
+        if (!ok) status = 2;
+        printf("  %2d threads: encode %.0f Mev/s, decode %.0f Mev/s%s\n", threads, mev / encode_s,
+            decode_s > 0 ? mev / decode_s : 0.0, ok ? "" : "  MISMATCH");
+    }
+    return status;
+}
+
+int main(int argc, char* argv[])
+{
+    if (!checkBitPack()) return 2;
+    const char* mode = argc > 1 ? argv[1] : "synthetic";
+    const int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+    std::vector<Metavision::EventCD> events;
+
+    if (strcmp(mode, "replay") == 0) {
+        if (argc < 3) {
+            printf("usage: event_codec_bench replay <file.raw> [block_events] [max_threads]\n");
+            return 1;
+        }
+        MetavisionEventSource::Options options;
+        options.file = argv[2];
+        options.real_time = false;
+        MetavisionEventSource source(options);
+        if (!collect(source, events)) return 1;
+        const size_t block_events = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : kEventBlockDefaultEvents;
+        return run(argv[2], events, std::max<size_t>(1, block_events), argc > 4 ? std::atoi(argv[4]) : hw);
+    }
+
+    const double millions = argc > 2 ? std::atof(argv[2]) : 20.0;
+    const double rate = argc > 3 ? std::atof(argv[3]) : 20.0;
+    const size_t block_events = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : kEventBlockDefaultEvents;
+    const int max_threads = argc > 5 ? std::atoi(argv[5]) : hw;
+
+    int status = 0;
+    for (auto distribution : { SyntheticEventSource::Distribution::Uniform, SyntheticEventSource::Distribution::Gaussian,
+             SyntheticEventSource::Distribution::MovingEdge }) {
+        SyntheticEventSource::Options options;
+        options.rate_mev_s = rate;
+        options.distribution = distribution;
+        options.real_time = false;
+        options.max_events = (uint64_t)(millions * 1e6);
+        SyntheticEventSource source(options);
+        if (!collect(source, events)) return 1;
+        status |= run(SyntheticEventSource::distributionName(distribution), events,
+            std::max<size_t>(1, block_events), max_threads);
+    }
+    return status;
+}
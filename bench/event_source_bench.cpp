@@ -0,0 +1,99 @@
+// DVS ¼Դ£ϳ¼Դ (ֿռֲ)  .raw طţٶ / ʵʱ͸һ
+//
+// ߼ڴΧڡʱͳ¼ ON ¼
+// ͳ¼ (Mev/sǽ) Ͱ¼ʱ¼ʡ
+// ÷: event_source_bench synthetic [rate_mev_s] [seconds] [realtime 0/1] [buffer_events]
+//       event_source_bench replay <file.raw> [realtime 0/1]
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include "MetavisionEventSource.h"
+#include "SyntheticEventSource.h"
+
+struct Consumer {
+    int width = 0;
+    int height = 0;
+    uint64_t events = 0;
+    uint64_t on = 0;
+    uint64_t out_of_range = 0;
+    uint64_t backwards = 0;
+    Metavision::timestamp first_t = -1;
+    Metavision::timestamp last_t = 0;
+
+    void operator()(const Metavision::EventCD* begin, const Metavision::EventCD* end)
+    {
+        if (begin == end) return;
+        if (first_t < 0) first_t = begin->t;
+        for (const Metavision::EventCD* e = begin; e != end; ++e) {
+            out_of_range += (e->x >= width) | (e->y >= height);
+            backwards += e->t < last_t;
+            last_t = e->t;
+            on += e->p;
+        }
+        events += (uint64_t)(end - begin);
+    }
+};
+
+static int run(EventSource& source, double max_seconds)
+{
+    if (!source.open()) return 1;
+    Consumer consumer;
+    consumer.width = source.width();
+    consumer.height = source.height();
+
+    const auto t0 = std::chrono::steady_clock::now();
+    source.start([&consumer](const Metavision::EventCD* begin, const Metavision::EventCD* end) { consumer(begin, end); });
+    while (!source.finished() &&
+        std::chrono::steady_clock::now() - t0 < std::chrono::duration<double>(max_seconds)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    source.stop();
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    const double span_s = consumer.events > 0 ? (consumer.last_t - consumer.first_t) * 1e-6 : 0;
+    printf("%-9s %llu events in %.2f s: %.1f Mev/s wall, %.1f Mev/s event time, ON %.1f%%, out of range %llu, backwards %llu\n",
+        source.name(), (unsigned long long)consumer.events, seconds, consumer.events / seconds / 1e6,
+        span_s > 0 ? consumer.events / span_s / 1e6 : 0.0, consumer.events ? 100.0 * consumer.on / consumer.events : 0.0,
+        (unsigned long long)consumer.out_of_range, (unsigned long long)consumer.backwards);
+    return (consumer.out_of_range == 0 && consumer.backwards == 0) ? 0 : 2;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* mode = argc > 1 ? argv[1] : "synthetic";
+    if (strcmp(mode, "replay") == 0) {
+        if (argc < 3) {
+            printf("usage: event_source_bench replay <file.raw> [realtime 0/1]\n");
+            return 1;
+        }
+        MetavisionEventSource::Options options;
+        options.file = argv[2];
+        options.real_time = argc > 3 && std::atoi(argv[3]) != 0;
+        MetavisionEventSource source(options);
+        return run(source, 1e9);
+    }
+
+    const double rate = argc > 2 ? std::atof(argv[2]) : 20.0;
+    const double seconds = argc > 3 ? std::atof(argv[3]) : 2.0;
+    const bool real_time = argc > 4 && std::atoi(argv[4]) != 0;
+    const size_t buffer_events = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 4096;
+
+    int status = 0;
+    for (auto distribution : { SyntheticEventSource::Distribution::Uniform, SyntheticEventSource::Distribution::Gaussian,
+             SyntheticEventSource::Distribution::MovingEdge }) {
+        SyntheticEventSource::Options options;
+        options.rate_mev_s = rate;
+        options.distribution = distribution;
+        options.real_time = real_time;
+        options.buffer_events = buffer_events;
+        // ʱ¼ʱʱ
+        options.max_events = real_time ? 0 : (uint64_t)(rate * 1e6 * seconds);
+        SyntheticEventSource source(options);
+        status |= run(source, real_time ? seconds : 1e9);
+    }
+    return status;
+}
@@ -0,0 +1,121 @@
+// ¼д HDF5 ĳ£ԼʱҵȷԺͺʱ
+//
+// ¼ SyntheticEventSource Ԥɵڴ (ʱ)ٰ 4096 һٶȽ H5EventWriter
+// ʱһֱȴ (¼)Բľд߳ܳܵ¼ʡʱ close (дꡢüر)
+// ֮ H5EventReader أ¼ȶ¼ݣʱڴе std::lower_bound ȶԡ
+// ÷: h5_event_bench [events_millions] [rate_mev_s] [none|deflate|zstd|lz4] [file]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+#include "H5EventReader.h"
+#include "H5EventWriter.h"
+#include "SyntheticEventSource.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char* argv[])
+{
+    const double millions = argc > 1 ? std::atof(argv[1]) : 50.0;
+    const double rate = argc > 2 ? std::atof(argv[2]) : 20.0;
+    const char* codec = argc > 3 ? argv[3] : "none";
+    const std::string path = argc > 4 ? argv[4] : "h5_event_bench.h5";
+
+    SyntheticEventSource::Options source_options;
+    source_options.rate_mev_s = rate;
+    source_options.real_time = false;
+    source_options.max_events = (uint64_t)(millions * 1e6);
+    source_options.distribution = SyntheticEventSource::Distribution::MovingEdge;
+
+    std::vector<Metavision::EventCD> events;
+    events.reserve((size_t)source_options.max_events);
+    {
+        SyntheticEventSource source(source_options);
+        if (!source.open()) return 1;
+        std::mutex mutex;
+        source.start([&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+            std::lock_guard<std::mutex> lock(mutex);
+            events.insert(events.end(), begin, end);
+        });
+        while (!source.finished()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        source.stop();
+    }
+    if (events.empty()) return 1;
+
+    H5EventWriter::Options options;
+    options.block_timeout_ms = 60000;
+    if (strcmp(codec, "deflate") == 0) options.compression.codec = ChunkCodec::Deflate;
+    else if (strcmp(codec, "zstd") == 0) options.compression.codec = ChunkCodec::Zstd;
+    else if (strcmp(codec, "lz4") == 0) options.compression.codec = ChunkCodec::Lz4;
+    options.compression.shuffle = options.compression.codec != ChunkCodec::None;
+    if (options.compression.codec != ChunkCodec::None) {
+        if (!chunkCodecAvailable(options.compression.codec)) {
+            printf("%s is not available in this build\n", codec);
+            return 1;
+        }
+        registerChunkFilters();
+    }
+
+    H5EventWriter writer(options);
+    if (!writer.open(path, source_options.width, source_options.height)) return 1;
+    const Clock::time_point t0 = Clock::now();
+    const size_t batch = 4096;
+    for (size_t i = 0; i < events.size(); i += batch) {
+        const size_t n = std::min(batch, events.size() - i);
+        writer.write(events.data() + i, events.data() + i + n);
+    }
+    const double fed = std::chrono::duration<double>(Clock::now() - t0).count();
+    const bool closed = writer.close();
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    const H5EventWriter::Stats stats = writer.stats();
+    printf("write (%s): %llu events in %.2f s (fed in %.2f s): %.1f Mev/s, %.0f MB/s, dropped %llu, "
+        "%llu H5Dwrite, queue high water %zu/%zu%s\n",
+        codec, (unsigned long long)stats.written, seconds, fed, stats.written / seconds / 1e6,
+        stats.bytes / seconds / 1e6, (unsigned long long)stats.dropped_events, (unsigned long long)stats.writes,
+        stats.queue.high_water, stats.queue.capacity, closed ? "" : ", errors");
+
+    // У
+    H5EventReader reader;
+    if (!reader.open(path)) return 1;
+    int status = reader.eventCount() == events.size() ? 0 : 2;
+    printf("read back %llu events (%zu expected)\n", (unsigned long long)reader.eventCount(), events.size());
+
+    std::mt19937_64 rng(7);
+    std::vector<Metavision::EventCD> chunk;
+    uint64_t mismatches = 0;
+    for (int i = 0; i < 100; ++i) {
+        const uint64_t begin = rng() % events.size();
+        const uint64_t end = std::min<uint64_t>(begin + 1000, events.size());
+        if (!reader.read(begin, end, chunk)) return 1;
+        for (size_t j = 0; j < chunk.size(); ++j) {
+            const Metavision::EventCD& a = chunk[j];
+            const Metavision::EventCD& b = events[(size_t)begin + j];
+            mismatches += a.x != b.x || a.y != b.y || a.p != b.p || a.t != b.t;
+        }
+    }
+
+    const Metavision::timestamp first_t = events.front().t;
+    const Metavision::timestamp span = events.back().t - first_t + 2000;
+    uint64_t bad_seeks = 0;
+    const int seeks = 2000;
+    const Clock::time_point s0 = Clock::now();
+    for (int i = 0; i < seeks; ++i) {
+        const Metavision::timestamp t = first_t - 1000 + (Metavision::timestamp)(rng() % (uint64_t)span);
+        const uint64_t found = reader.lowerBound(t);
+        const uint64_t expected = (uint64_t)(std::lower_bound(events.begin(), events.end(), t,
+            [](const Metavision::EventCD& e, Metavision::timestamp value) { return e.t < value; }) - events.begin());
+        bad_seeks += found != expected;
+    }
+    const double seek_us = std::chrono::duration<double, std::micro>(Clock::now() - s0).count() / seeks;
+    printf("content mismatches %llu, seeks %d: %.1f us each, wrong %llu\n", (unsigned long long)mismatches, seeks,
+        seek_us, (unsigned long long)bad_seeks);
+    if (mismatches || bad_seeks) status = 2;
+    reader.close();
+    std::remove(path.c_str());
+    return status;
+}
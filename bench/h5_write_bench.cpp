@@ -0,0 +1,80 @@
+// HDF5 ֡д֡չ ( extendAndWriteHDF5 )  vs  H5FrameWriter д / չ / ֿ֡
+//
+// ÿд frames ֡ width x height x channels  uint8 ݵļʱرļ
+// дٶ (MB/s)H5Dwrite  extent ôļд꼴ɾ
+// עϵͳҳãҪٶ frames Զڴ档
+// ÷: h5_write_bench [out_dir] [frames] [width] [height] [channels]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "H5FrameWriter.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Config {
+    const char* name;
+    size_t batch_frames;
+    size_t chunk_frames;
+    double growth;
+};
+
+int main(int argc, char* argv[])
+{
+    const std::string out_dir = argc > 1 ? argv[1] : ".";
+    const size_t frames = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 200;
+    const hsize_t width = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1280;
+    const hsize_t height = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1024;
+    const hsize_t channels = argc > 5 ? std::strtoull(argv[5], nullptr, 10) : 3;
+
+    const Config configs[] = {
+        { "per-frame extend", 1, 1, 1.0 },
+        { "geometric", 1, 1, 2.0 },
+        { "batch 4", 4, 1, 2.0 },
+        { "batch 16", 16, 1, 2.0 },
+        { "batch 4, chunk 4", 4, 4, 2.0 },
+        { "batch 16, chunk 4", 16, 4, 2.0 },
+        { "batch 16, chunk 16", 16, 16, 2.0 },
+    };
+
+    const size_t frame_bytes = (size_t)(width * height * channels);
+    std::vector<uint8_t> frame(frame_bytes);
+    for (size_t i = 0; i < frame_bytes; ++i) frame[i] = (uint8_t)(i * 31 + (i >> 12));
+    printf("%zu frames of %llux%llux%llu (%.1f MB each) -> %s\n", frames, (unsigned long long)width,
+        (unsigned long long)height, (unsigned long long)channels, frame_bytes / 1e6, out_dir.c_str());
+
+    H5::Exception::dontPrint();
+    std::vector<hsize_t> shape = { height, width };
+    if (channels > 1) shape.push_back(channels);
+
+    for (const Config& config : configs) {
+        const std::string path = out_dir + "/h5_write_bench.h5";
+        H5FrameWriter::Options options;
+        options.batch_frames = config.batch_frames;
+        options.chunk_frames = config.chunk_frames;
+        options.growth = config.growth;
+
+        H5FrameWriter::Stats stats;
+        auto t0 = Clock::now();
+        {
+            H5::H5File file(path, H5F_ACC_TRUNC);
+            H5::Group group = file.createGroup("/rgb");
+            H5FrameWriter writer;
+            if (!writer.create(group, "frames", H5::PredType::NATIVE_UINT8, shape, options)) return 1;
+            for (size_t i = 0; i < frames; ++i) {
+                frame[0] = (uint8_t)i;  // ÿ֡ݲͬ
+                if (!writer.append(frame.data(), frame.size())) return 1;
+            }
+            writer.close();
+            stats = writer.stats();
+            file.close();
+        }
+        const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+        printf("%-20s %9.1f MB/s  %7.1f fps  writes %5llu  extends %5llu\n", config.name,
+            stats.bytes / 1e6 / seconds, frames / seconds,
+            (unsigned long long)stats.writes, (unsigned long long)stats.extends);
+        std::remove(path.c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,141 @@
+// ʵʱ潻ӣmutex +  clone  vs  TripleBuffer (±)
+//
+// ģ֡صԹ̶֡ʷ width x height x 3 ֡ (ÿֽ֡ڶŵĵ 8 λ)
+// ģ GUI ʱˢȡֽ֡ڼǷ˺ѡ
+// ÿηÿȡ֡ĺʱԼȡ֡ / ֡ (ػ) Ĵ
+// ÷: latest_frame_bench [seconds] [producer_fps] [consumer_hz] [width] [height]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "TripleBuffer.h"
+
+using Clock = std::chrono::steady_clock;
+using Frame = std::vector<uint8_t>;
+
+struct Result {
+    std::vector<double> publish_us;
+    std::vector<double> fetch_us;
+    uint64_t fresh = 0;
+    uint64_t stale = 0;
+    uint64_t torn = 0;
+};
+
+static double elapsedUs(Clock::time_point t0)
+{
+    return std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+}
+
+static bool intact(const Frame& f)
+{
+    if (f.empty()) return true;
+    const uint8_t v = f[0];
+    for (uint8_t b : f) if (b != v) return false;
+    return true;
+}
+
+static void report(const char* name, Result& r)
+{
+    auto pct = [](std::vector<double>& v, size_t p) { return v.empty() ? 0.0 : v[std::min(v.size() - 1, v.size() * p / 100)]; };
+    std::sort(r.publish_us.begin(), r.publish_us.end());
+    std::sort(r.fetch_us.begin(), r.fetch_us.end());
+    printf("%-14s publish p50 %8.1f us  p99 %8.1f | fetch p50 %8.1f us  p99 %8.1f | fresh %6llu  stale %6llu  torn %llu\n",
+        name, pct(r.publish_us, 50), pct(r.publish_us, 99), pct(r.fetch_us, 50), pct(r.fetch_us, 99),
+        (unsigned long long)r.fresh, (unsigned long long)r.stale, (unsigned long long)r.torn);
+}
+
+//  / ߰Уpublish / fetch ɵ÷ṩ
+template <class Publish, class Fetch>
+static void run(double seconds, int producer_fps, int consumer_hz, size_t bytes, Publish&& publish, Fetch&& fetch, Result& r)
+{
+    std::atomic<bool> stop{ false };
+    std::thread producer([&]() {
+        Frame source(bytes);
+        uint64_t seq = 0;
+        auto next = Clock::now();
+        while (!stop.load()) {
+            std::memset(source.data(), (int)(++seq & 0xFF), bytes);
+            auto t0 = Clock::now();
+            publish(source);
+            r.publish_us.push_back(elapsedUs(t0));
+            next += std::chrono::microseconds(1000000 / producer_fps);
+            std::this_thread::sleep_until(next);
+        }
+    });
+
+    const auto end = Clock::now() + std::chrono::duration<double>(seconds);
+    auto next = Clock::now();
+    while (Clock::now() < end) {
+        auto t0 = Clock::now();
+        const Frame* f = fetch();
+        r.fetch_us.push_back(elapsedUs(t0));
+        if (!f) {
+            r.stale++;
+        }
+        else {
+            r.fresh++;
+            if (!intact(*f)) r.torn++;
+        }
+        next += std::chrono::microseconds(1000000 / consumer_hz);
+        std::this_thread::sleep_until(next);
+    }
+    stop = true;
+    producer.join();
+}
+
+int main(int argc, char* argv[])
+{
+    const double seconds = argc > 1 ? std::atof(argv[1]) : 5.0;
+    const int producer_fps = argc > 2 ? std::atoi(argv[2]) : 30;
+    const int consumer_hz = argc > 3 ? std::atoi(argv[3]) : 100;
+    const int width = argc > 4 ? std::atoi(argv[4]) : 1280;
+    const int height = argc > 5 ? std::atoi(argv[5]) : 720;
+    const size_t bytes = (size_t)width * height * 3;
+    printf("%dx%dx3 frames, producer %d fps, consumer %d Hz, %.1f s\n", width, height, producer_fps, consumer_hz, seconds);
+
+    // ص clone ֡ȡ֡ʱ clone һΣ÷޷֪Ƿ֡
+    {
+        Result r;
+        std::mutex m;
+        Frame latest;
+        Frame out;
+        run(seconds, producer_fps, consumer_hz, bytes,
+            [&](const Frame& src) {
+                Frame copy(src);
+                std::lock_guard<std::mutex> lk(m);
+                latest = std::move(copy);
+            },
+            [&]() -> const Frame* {
+                std::lock_guard<std::mutex> lk(m);
+                if (latest.empty()) return nullptr;
+                out = latest;
+                return &out;
+            }, r);
+        report("mutex+clone", r);
+    }
+
+    // 壺дԭؿһΣ˫ֻ±ꣻ֡ʱʲôҲ
+    {
+        Result r;
+        TripleBuffer<Frame> slot;
+        run(seconds, producer_fps, consumer_hz, bytes,
+            [&](const Frame& src) {
+                Frame& w = slot.writeBuffer();
+                w.resize(src.size());
+                std::memcpy(w.data(), src.data(), src.size());
+                slot.publish();
+            },
+            [&]() -> const Frame* {
+                if (!slot.update()) return nullptr;
+                return &slot.readBuffer();
+            }, r);
+        report("TripleBuffer", r);
+        printf("TripleBuffer overwritten before being read: %llu\n", (unsigned long long)slot.overwritten());
+    }
+    return 0;
+}
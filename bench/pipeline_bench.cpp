@@ -0,0 +1,80 @@
+//  RGB ߵѹ⣺SyntheticFrameSource -> RGB (ص / ַ / ת /  / д) -> sink
+//
+// ϳ֡Դ趨֡ (Զ) ͳ frames ֹ֡ͣʵ֡ʡ֡
+// дзֵдʡ֡Դͳ֡ = д֡ + ֡ ʱ 0
+// ÷: pipeline_bench [out_dir] [frames] [fps] [width] [height] [workers] [bgr|raw] [h5|log]
+//                      [jitter_us] [burst_frames] [burst_every] [drop_every]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include "RGB.h"
+#include "SyntheticFrameSource.h"
+
+int main(int argc, char* argv[])
+{
+    const std::string out_dir = argc > 1 ? argv[1] : ".";
+    SyntheticFrameSource::Options options;
+    options.max_frames = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+    options.fps = argc > 3 ? std::atof(argv[3]) : 500;
+    options.width = argc > 4 ? (uint32_t)std::atoi(argv[4]) : 1280;
+    options.height = argc > 5 ? (uint32_t)std::atoi(argv[5]) : 1024;
+    const size_t workers = argc > 6 ? std::strtoull(argv[6], nullptr, 10) : 6;
+    const bool raw = argc > 7 && strcmp(argv[7], "raw") == 0;
+    const bool frame_log = argc > 8 && strcmp(argv[8], "log") == 0;
+    options.jitter_us = argc > 9 ? std::atoi(argv[9]) : 0;
+    options.burst_frames = argc > 10 ? std::atoi(argv[10]) : 0;
+    options.burst_every = argc > 11 ? std::atoi(argv[11]) : 0;
+    options.drop_every = argc > 12 ? std::atoi(argv[12]) : 0;
+
+    auto source = std::make_unique<SyntheticFrameSource>(options);
+    SyntheticFrameSource* synthetic = source.get();
+    RGB rgb(std::move(source));
+    if (!synthetic->isOpen()) return 1;
+    rgb.setWorkerCount(workers);
+    rgb.setRecordFormat(raw ? RGB::RecordFormat::RawBayer : RGB::RecordFormat::BGR);
+    rgb.setColorConversion(RGB::ColorConversion::Bilinear);
+    rgb.setSink(frame_log ? RGB::SinkType::FrameLog : RGB::SinkType::Hdf5);
+
+    const auto t0 = std::chrono::steady_clock::now();
+    rgb.startCapture(out_dir);
+    while (!synthetic->finished()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        // startCapture ʧʱ֡Դ
+        if (synthetic->stats().generated == 0 && std::chrono::steady_clock::now() - t0 > std::chrono::seconds(5)) {
+            printf("Frame source did not start.\n");
+            return 1;
+        }
+    }
+    const double capture_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    rgb.stopCapture();
+    const double total_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    const SyntheticFrameSource::Stats src = synthetic->stats();
+    const FrameSinkStats sink = rgb.getSinkStats();
+    const QueueStats queue = rgb.getWriteQueueStats();
+    const ReorderStats reorder = rgb.getReorderStats();
+    const uint64_t ring_dropped = rgb.getDroppedFrameCount();
+    const uint64_t queue_dropped = queue.dropped_oldest + queue.dropped_newest + queue.rejected;
+    const uint64_t spill_dropped = rgb.getSpillStats().dropped;
+
+    printf("\n%ux%u %s -> %s, %zu workers\n", options.width, options.height, raw ? "raw" : "BGR",
+        frame_log ? "frame log" : "HDF5", workers);
+    printf("source: delivered %llu in %.2f s (%.0f fps, target %.0f), injected drops %llu, late %llu (max %.2f ms)\n",
+        (unsigned long long)src.delivered, capture_s, src.delivered / capture_s, options.fps,
+        (unsigned long long)src.dropped, (unsigned long long)src.late, src.max_late_ns / 1e6);
+    printf("written %llu frames, %.0f MB in %.2f s (%.0f MB/s incl. drain)\n",
+        (unsigned long long)sink.frames, sink.bytes / 1e6, total_s, sink.bytes / total_s / 1e6);
+    printf("dropped: image ring %llu, write queue %llu, spill %llu; reorder gaps %llu, late %llu\n",
+        (unsigned long long)ring_dropped, (unsigned long long)queue_dropped, (unsigned long long)spill_dropped,
+        (unsigned long long)reorder.gaps, (unsigned long long)reorder.late);
+    printf("write queue peak %zu/%zu, blocked %.1f ms (buffer pool peaks are printed by stopCapture)\n",
+        queue.high_water, queue.capacity, queue.blocked_ns / 1e6);
+
+    const bool balanced = sink.frames + ring_dropped + queue_dropped + spill_dropped + reorder.late == src.delivered;
+    if (!balanced) printf("frame accounting does not balance!\n");
+    return balanced ? 0 : 2;
+}
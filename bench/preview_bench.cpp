@@ -0,0 +1,121 @@
+// GUI ߳ÿˢ RGB Ԥĺʱ· vs ߳ԤԤ
+//
+// · (GUI ߳)getLatestFrame ¡֡ (ԭʼģʽ֡ȥ) -> cv::resize INTER_AREA -> cvtColor BGR2RGB
+//                    -> QPixmap::fromImage һʾߴ RGB888
+// ·߳ previewFromBgr / previewFromBayer һʾߴ RGB888
+//         GUI ֻ߳ʣȡ + fromImage һο ( memcpy ģ)
+// ⱨ previewFromBgr  OpenCV INTER_AREA ز
+// ÷: preview_bench [width] [height] [iterations] [display_width] [display_height]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+#include <opencv2/opencv.hpp>
+#include "Preview.h"
+#include "PixelFormat.h"
+
+using Clock = std::chrono::steady_clock;
+
+static void report(const char* name, std::vector<double>& us)
+{
+    std::sort(us.begin(), us.end());
+    const size_t n = us.size();
+    double sum = 0;
+    for (double v : us) sum += v;
+    printf("%-34s mean %9.1f us  p50 %9.1f  p99 %9.1f  max %9.1f\n",
+        name, sum / n, us[n / 2], us[n * 99 / 100], us[n - 1]);
+}
+
+template <class Fn>
+static std::vector<double> measure(int iterations, Fn&& fn)
+{
+    std::vector<double> us;
+    us.reserve(iterations);
+    for (int i = 0; i < iterations; ++i) {
+        auto t0 = Clock::now();
+        fn();
+        us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+    }
+    return us;
+}
+
+// ģ QPixmap::fromImage Ŀ (·)
+static void wrapForQt(const cv::Mat& rgb, std::vector<uint8_t>& pixmap)
+{
+    pixmap.resize(rgb.total() * rgb.elemSize());
+    memcpy(pixmap.data(), rgb.data, pixmap.size());
+}
+
+int main(int argc, char* argv[])
+{
+    const int width = argc > 1 ? std::atoi(argv[1]) : 1280;
+    const int height = argc > 2 ? std::atoi(argv[2]) : 1080;
+    const int iterations = argc > 3 ? std::atoi(argv[3]) : 300;
+    const int display_w = argc > 4 ? std::atoi(argv[4]) : 640;
+    const int display_h = argc > 5 ? std::atoi(argv[5]) : 540;
+    printf("frame %dx%d -> preview %dx%d, %d refreshes\n", width, height, display_w, display_h, iterations);
+
+    std::mt19937 rng(7);
+    cv::Mat mosaic(height, width, CV_8UC1);
+    for (size_t i = 0; i < mosaic.total(); ++i) mosaic.data[i] = (uint8_t)(rng() & 0xFF);
+    cv::Mat bgr;
+    demosaicToBgr(mosaic, bgr, "BayerGB8");
+    std::vector<uint8_t> pixmap;
+
+    // ---------- BGR ¼ģʽ ----------
+    std::vector<double> old_bgr = measure(iterations, [&]() {
+        cv::Mat latest = bgr.clone();
+        cv::Mat resized, display;
+        cv::resize(latest, resized, cv::Size(display_w, display_h), 0, 0, cv::INTER_AREA);
+        cv::cvtColor(resized, display, cv::COLOR_BGR2RGB);
+        wrapForQt(display, pixmap);
+    });
+    report("BGR  old: GUI thread", old_bgr);
+
+    cv::Mat preview(display_h, display_w, CV_8UC3);
+    std::vector<double> worker_bgr = measure(iterations, [&]() {
+        previewFromBgr(bgr.data, bgr.step, bgr.cols, bgr.rows, preview.data, preview.step, display_w, display_h);
+    });
+    report("BGR  new: worker (previewFromBgr)", worker_bgr);
+
+    // ---------- ԭʼģʽ ----------
+    std::vector<double> old_raw = measure(iterations, [&]() {
+        cv::Mat latest;
+        demosaicToBgr(mosaic, latest, "BayerGB8");
+        cv::Mat resized, display;
+        cv::resize(latest, resized, cv::Size(display_w, display_h), 0, 0, cv::INTER_AREA);
+        cv::cvtColor(resized, display, cv::COLOR_BGR2RGB);
+        wrapForQt(display, pixmap);
+    });
+    report("Raw  old: GUI thread", old_raw);
+
+    std::vector<double> worker_raw = measure(iterations, [&]() {
+        previewFromBayer(mosaic.data, mosaic.step, mosaic.cols, mosaic.rows, BayerPattern::GB,
+            preview.data, preview.step, display_w, display_h);
+    });
+    report("Raw  new: worker (previewFromBayer)", worker_raw);
+
+    // ---------- · GUI ߳ʣµĹ ----------
+    std::vector<double> gui_new = measure(iterations, [&]() {
+        cv::Mat shared = preview; // ȡã
+        wrapForQt(shared, pixmap);
+    });
+    report("new: GUI thread", gui_new);
+
+    // ----------  OpenCV INTER_AREA Ĳ ----------
+    cv::Mat reference_bgr, reference;
+    cv::resize(bgr, reference_bgr, cv::Size(display_w, display_h), 0, 0, cv::INTER_AREA);
+    cv::cvtColor(reference_bgr, reference, cv::COLOR_BGR2RGB);
+    previewFromBgr(bgr.data, bgr.step, bgr.cols, bgr.rows, preview.data, preview.step, display_w, display_h);
+    int max_diff = 0;
+    for (int y = 0; y < display_h; ++y) {
+        const uint8_t* a = preview.data + (size_t)y * preview.step;
+        const uint8_t* b = reference.data + (size_t)y * reference.step;
+        for (int i = 0; i < display_w * 3; ++i) max_diff = std::max(max_diff, std::abs((int)a[i] - (int)b[i]));
+    }
+    printf("previewFromBgr vs INTER_AREA + BGR2RGB: max abs diff %d\n", max_diff);
+    return 0;
+}
@@ -0,0 +1,84 @@
+// DataQueue ʱԶԱȣ̶߰֡ͣ߱ (ģд̸)
+//
+// ÿֲԱ棺 /  / ˻صԪзֵۼʱ䡢push ʱλ
+//  disposer ǷͷÿһԪ (live ӦΪ 0)
+// ÷: queue_policy_bench [items] [producer_us] [consumer_us] [capacity] [timeout_ms]
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "DataQueue.h"
+
+using Clock = std::chrono::steady_clock;
+
+static std::atomic<long> live{ 0 };
+
+struct Item {
+    Item() { live++; }
+    ~Item() { live--; }
+};
+
+static void run(const char* name, QueuePolicy policy, size_t items, int producer_us, int consumer_us,
+    size_t capacity, int timeout_ms)
+{
+    DataQueue<Item*> queue(capacity, policy, [](Item*& item) { delete item; item = nullptr; },
+        std::chrono::milliseconds(timeout_ms));
+    std::atomic<bool> done{ false };
+    uint64_t consumed = 0;
+
+    std::thread consumer([&]() {
+        std::vector<Item*> batch;
+        while (!done || !queue.empty()) {
+            batch.clear();
+            if (queue.pop_n(batch, 8, std::chrono::milliseconds(5)) == 0) continue;
+            for (Item* item : batch) {
+                std::this_thread::sleep_for(std::chrono::microseconds(consumer_us));
+                delete item;
+                consumed++;
+            }
+        }
+    });
+
+    std::vector<double> push_us;
+    push_us.reserve(items);
+    auto next = Clock::now();
+    for (size_t i = 0; i < items; ++i) {
+        next += std::chrono::microseconds(producer_us);
+        std::this_thread::sleep_until(next);
+        Item* item = new Item();
+        auto t0 = Clock::now();
+        if (!queue.push(item)) delete item; // Reject ˻ص÷ѱ disposer ͷŲÿ
+        push_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - t0).count());
+    }
+    done = true;
+    consumer.join();
+
+    std::sort(push_us.begin(), push_us.end());
+    const QueueStats s = queue.stats();
+    printf("%-11s pushed %7llu consumed %7llu dropped old %6llu new %6llu rejected %6llu timeouts %5llu "
+        "peak %4zu blocked %8.1f ms push p50 %7.1f us p99 %9.1f us live %ld\n",
+        name, (unsigned long long)s.pushed, (unsigned long long)consumed,
+        (unsigned long long)s.dropped_oldest, (unsigned long long)s.dropped_newest,
+        (unsigned long long)s.rejected, (unsigned long long)s.timeouts, s.high_water, s.blocked_ns / 1e6,
+        push_us[push_us.size() / 2], push_us[push_us.size() * 99 / 100], live.load());
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t items = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000;
+    const int producer_us = argc > 2 ? std::atoi(argv[2]) : 200;
+    const int consumer_us = argc > 3 ? std::atoi(argv[3]) : 300;
+    const size_t capacity = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 128;
+    const int timeout_ms = argc > 5 ? std::atoi(argv[5]) : 2;
+    printf("items %zu, producer every %d us, consumer %d us/item, capacity %zu, block timeout %d ms\n",
+        items, producer_us, consumer_us, capacity, timeout_ms);
+
+    run("Block", QueuePolicy::Block, items, producer_us, consumer_us, capacity, timeout_ms);
+    run("DropOldest", QueuePolicy::DropOldest, items, producer_us, consumer_us, capacity, timeout_ms);
+    run("DropNewest", QueuePolicy::DropNewest, items, producer_us, consumer_us, capacity, timeout_ms);
+    run("Reject", QueuePolicy::Reject, items, producer_us, consumer_us, capacity, timeout_ms);
+    return 0;
+}
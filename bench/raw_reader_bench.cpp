@@ -0,0 +1,261 @@
+// ¼Ƶ .raw ļĲнʱ
+//
+// synthetic: úϳ¼Դ (ƶ) ¼ EVT 3.0 / EVT 2.0 д .raw (ͬһʱͬһе¼ϲΪ)
+//            ʱӽӽƴʼǻƴԭ¼ͬ
+// file:      ȡһʵ¼Ƶļ߳Ľ뵥߳Ƚ
+// 棺 (˳ɨ)  sidecar صĺʱ1, 2, 4, ... ߳ readAll  Mev/s
+//        eventsBetween ѯĺʱȫ¼ʱ˵ĽȽ
+// ÷: raw_reader_bench synthetic [events_millions] [max_threads] [block_kib]
+//       raw_reader_bench file <file.raw> [max_threads] [block_kib]
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <thread>
+#include <vector>
+#include "RawEventReader.h"
+#include "SyntheticEventSource.h"
+
+using Clock = std::chrono::steady_clock;
+using Events = std::vector<Metavision::EventCD>;
+
+static double secondsSince(Clock::time_point t0)
+{
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+static bool sameEvents(const Events& a, const Events& b)
+{
+    if (a.size() != b.size()) {
+        printf("  %zu events, expected %zu\n", a.size(), b.size());
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].x != b[i].x || a[i].y != b[i].y || a[i].p != b[i].p || a[i].t != b[i].t) {
+            printf("  event %zu: (%u,%u,%d,%lld), expected (%u,%u,%d,%lld)\n", i, a[i].x, a[i].y, a[i].p,
+                (long long)a[i].t, b[i].x, b[i].y, b[i].p, (long long)b[i].t);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void writeHeader(std::FILE* file, const char* evt, int width, int height)
+{
+    fprintf(file, "%% evt %s\n%% format EVT%c;height=%d;width=%d\n%% geometry %dx%d\n%% end\n",
+        evt, evt[0], height, width, width, height);
+}
+
+static void put16(std::vector<uint8_t>& out, uint32_t w)
+{
+    out.push_back((uint8_t)w);
+    out.push_back((uint8_t)(w >> 8));
+}
+
+static void put32(std::vector<uint8_t>& out, uint32_t w)
+{
+    put16(out, w & 0xFFFF);
+    put16(out, w >> 16);
+}
+
+static bool writeEvt3(const char* path, const Events& events, int width, int height)
+{
+    std::vector<uint8_t> data;
+    int64_t high = -1, low = -1;
+    int y = -1;
+    for (size_t i = 0; i < events.size();) {
+        const Metavision::EventCD& e = events[i];
+        if ((e.t >> 12) != high) {
+            high = e.t >> 12;
+            put16(data, 0x8000 | (uint32_t)(high & 0xFFF));
+            low = -1;
+        }
+        if ((e.t & 0xFFF) != low) {
+            low = e.t & 0xFFF;
+            put16(data, 0x6000 | (uint32_t)low);
+        }
+        if (e.y != y) {
+            y = e.y;
+            put16(data, 0x0000 | (uint32_t)y);
+        }
+        // ͬһʱ̡ͬһСͬһԡ [x, x + 12) ڵ¼ϲΪ VECT_12
+        uint32_t mask = 1;
+        size_t j = i + 1;
+        while (j < events.size() && events[j].t == e.t && events[j].y == e.y && events[j].p == e.p &&
+            events[j].x > events[j - 1].x && events[j].x < e.x + 12) {
+            mask |= 1u << (events[j].x - e.x);
+            j++;
+        }
+        if (j - i > 1) {
+            put16(data, 0x3000 | ((uint32_t)(e.p & 1) << 11) | e.x);
+            put16(data, 0x4000 | mask);
+        }
+        else {
+            put16(data, 0x2000 | ((uint32_t)(e.p & 1) << 11) | e.x);
+        }
+        i = j;
+    }
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    writeHeader(file, "3.0", width, height);
+    const bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    return (std::fclose(file) == 0) && ok;
+}
+
+static bool writeEvt2(const char* path, const Events& events, int width, int height)
+{
+    std::vector<uint8_t> data;
+    int64_t high = -1;
+    for (const Metavision::EventCD& e : events) {
+        if ((e.t >> 6) != high) {
+            high = e.t >> 6;
+            put32(data, 0x80000000u | (uint32_t)(high & 0x0FFFFFFF));
+        }
+        put32(data, ((uint32_t)(e.p & 1) << 28) | ((uint32_t)(e.t & 0x3F) << 22) | ((uint32_t)e.x << 11) | e.y);
+    }
+    std::FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    writeHeader(file, "2.0", width, height);
+    const bool ok = std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    return (std::fclose(file) == 0) && ok;
+}
+
+// reference ΪʱԵ߳ readAll ĽΪ׼
+static int run(const std::string& path, Events reference, int max_threads, size_t block_bytes)
+{
+    int status = 0;
+    RawEventReader::Options options;
+    options.block_bytes = block_bytes;
+    std::error_code ec;
+    std::filesystem::remove(path + ".idx", ec);
+
+    Clock::time_point t0 = Clock::now();
+    RawEventReader reader(options);
+    if (!reader.open(path)) return 1;
+    const double scan_s = secondsSince(t0);
+    t0 = Clock::now();
+    RawEventReader cached(options);
+    if (!cached.open(path) || !cached.indexLoaded() || cached.eventCount() != reader.eventCount()) {
+        printf("  sidecar index was not reused\n");
+        status = 2;
+    }
+    const double load_s = secondsSince(t0);
+    const double mev = reader.eventCount() / 1e6;
+    printf("  index: scan %.3f s (%.0f Mev/s), sidecar load %.4f s, %zu blocks of %zu KiB\n",
+        scan_s, mev / scan_s, load_s, reader.index().size(), block_bytes >> 10);
+
+    Events events;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        options.threads = threads;
+        RawEventReader r(options);
+        if (!r.open(path)) return 1;
+        t0 = Clock::now();
+        const bool ok = r.readAll(events);
+        const double s = secondsSince(t0);
+        if (reference.empty()) reference = events;
+        const bool same = ok && sameEvents(events, reference);
+        if (!same) status = 2;
+        printf("  %2d threads: readAll %.0f Mev/s%s\n", threads, mev / s, same ? "" : "  MISMATCH");
+    }
+
+    // ʱ䷶Χѯȫ¼Ĺ˽Ƚ
+    std::mt19937_64 rng(5);
+    const int64_t first = reader.firstTimestamp(), last = reader.lastTimestamp();
+    double query_s = 0;
+    uint64_t returned = 0;
+    const int queries = 200;
+    for (int q = 0; q < queries; ++q) {
+        const int64_t a = first + (int64_t)(rng() % (uint64_t)(last - first + 1));
+        const int64_t span = (int64_t)(rng() % 20000);  //  20 ms
+        Events expected;
+        for (const Metavision::EventCD& e : reference) {
+            if (e.t >= a && e.t < a + span) expected.push_back(e);
+        }
+        t0 = Clock::now();
+        const bool ok = reader.eventsBetween(a, a + span, events);
+        query_s += secondsSince(t0);
+        returned += events.size();
+        if (!ok || !sameEvents(events, expected)) {
+            printf("  eventsBetween(%lld, %lld) MISMATCH\n", (long long)a, (long long)(a + span));
+            status = 2;
+            break;
+        }
+    }
+    printf("  eventsBetween: %d queries, %.0f events each, %.3f ms per query\n", queries,
+        (double)returned / queries, query_s * 1e3 / queries);
+    std::filesystem::remove(path + ".idx", ec);
+    return status;
+}
+
+int main(int argc, char* argv[])
+{
+    const char* mode = argc > 1 ? argv[1] : "synthetic";
+    const int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+    if (strcmp(mode, "file") == 0) {
+        if (argc < 3) {
+            printf("usage: raw_reader_bench file <file.raw> [max_threads] [block_kib]\n");
+            return 1;
+        }
+        const int max_threads = argc > 3 ? std::atoi(argv[3]) : hw;
+        const size_t block_bytes = (argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1024) << 10;
+        printf("%s\n", argv[2]);
+        return run(argv[2], Events(), max_threads, block_bytes);
+    }
+
+    const double millions = argc > 2 ? std::atof(argv[2]) : 10.0;
+    const int max_threads = argc > 3 ? std::atoi(argv[3]) : hw;
+    const size_t block_bytes = (argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1024) << 10;
+
+    SyntheticEventSource::Options options;
+    options.rate_mev_s = 10;
+    options.distribution = SyntheticEventSource::Distribution::MovingEdge;
+    options.real_time = false;
+    options.max_events = (uint64_t)(millions * 1e6);
+    SyntheticEventSource source(options);
+    if (!source.open()) return 1;
+    Events events;
+    events.reserve((size_t)options.max_events);
+    source.start([&events](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+        events.insert(events.end(), begin, end);
+    });
+    while (!source.finished()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    source.stop();
+
+    //  EVT2 ǰ 0.5 s ʼ (2^34 us ͬʱҲ EVT3  2^24 us )
+    // ͬһʱ̵¼˳ (Сԡ) 
+    const int64_t start = ((int64_t)1 << 34) - 500000;
+    for (Metavision::EventCD& e : events) e.t += start;
+    for (size_t i = 0; i < events.size();) {
+        size_t j = i;
+        while (j < events.size() && events[j].t == events[i].t) j++;
+        std::sort(events.begin() + i, events.begin() + j, [](const Metavision::EventCD& a, const Metavision::EventCD& b) {
+            return a.y != b.y ? a.y < b.y : a.p != b.p ? a.p < b.p : a.x < b.x;
+        });
+        i = j;
+    }
+
+    const std::string dir = std::filesystem::temp_directory_path().string();
+    int status = 0;
+    for (int evt : { 3, 2 }) {
+        const std::string path = dir + (evt == 3 ? "/raw_reader_bench_evt3.raw" : "/raw_reader_bench_evt2.raw");
+        const bool written = evt == 3 ? writeEvt3(path.c_str(), events, options.width, options.height)
+            : writeEvt2(path.c_str(), events, options.width, options.height);
+        if (!written) {
+            printf("Failed to write %s\n", path.c_str());
+            return 1;
+        }
+        // ֻ֪ļڵļֵʱȥһ¼ڻڵ
+        const int64_t period = (int64_t)1 << (evt == 3 ? 24 : 34);
+        const int64_t base = events.front().t / period * period;
+        Events reference = events;
+        for (Metavision::EventCD& e : reference) e.t -= base;
+        printf("EVT%d, %.1f bytes/event\n", evt, (double)std::filesystem::file_size(path) / events.size());
+        status |= run(path, std::move(reference), max_threads, block_bytes);
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+    return status;
+}
@@ -0,0 +1,157 @@
+// 洢˳дʣH5FrameSink (rgb_data.h5) vs FrameLogSink (O_DIRECT ֡־)
+//
+// ̰߳д̵߳ķʽ sink->writeͳƴ open  close ʱ䣻
+// HDF5 ҳ棬close ֮ fsync һΣʱҲȥ O_DIRECT Ľɱȡ
+// ¼ write õĺʱֲд߳̿סʱ hdf5_write_queue Ҫ
+// ÷: sink_bench <dir[,dir2,...]> [frames] [width] [height] [channels] [segment_frames]
+//   Ŀ¼ (ŷָڲͬ) ʱԷֶ¼ƣÿ segment_frames ֡ (Ĭ 64) һΣ
+//   дЩĿ¼ÿĿ¼һд߳
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+#include "FrameLog.h"
+#include "H5FrameSink.h"
+#include "SegmentedSink.h"
+
+#if defined(_WIN32)
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using Clock = std::chrono::steady_clock;
+
+static void syncFile(const std::string& path)
+{
+#if defined(_WIN32)
+    int fd = _open(path.c_str(), _O_RDWR);
+    if (fd >= 0) { _commit(fd); _close(fd); }
+#else
+    int fd = ::open(path.c_str(), O_RDWR);
+    if (fd >= 0) { fsync(fd); ::close(fd); }
+#endif
+}
+
+static void run(const char* label, FrameSink& sink, const std::string& dir, const std::string& file,
+    const FrameFormat& format, const std::vector<std::vector<uint8_t>>& frames, size_t count)
+{
+    std::vector<double> latencies;
+    latencies.reserve(count);
+    auto t0 = Clock::now();
+    if (!sink.open(dir, format)) {
+        printf("%-28s open failed\n", label);
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        FrameRecord record;
+        record.data = frames[i % frames.size()].data();
+        record.data_bytes = frames[i % frames.size()].size();
+        record.frame_number = i;
+        record.host_timestamp_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now().time_since_epoch()).count();
+        record.device_timestamp = i * 10000;
+        auto w0 = Clock::now();
+        sink.write(record);
+        latencies.push_back(std::chrono::duration<double, std::micro>(Clock::now() - w0).count());
+    }
+    sink.close();
+    if (!file.empty()) syncFile(dir + "/" + file);
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    std::sort(latencies.begin(), latencies.end());
+    const FrameSinkStats s = sink.stats();
+    printf("%-28s %8.0f MB/s  %7.1f fps  write p50 %7.0f us  p99 %7.0f  max %8.0f  writes %6llu  errors %llu\n",
+        label, s.bytes / 1e6 / seconds, count / seconds, latencies[count / 2], latencies[count * 99 / 100],
+        latencies.back(), (unsigned long long)s.writes, (unsigned long long)s.errors);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        printf("usage: %s <dir[,dir2,...]> [frames] [width] [height] [channels] [segment_frames]\n", argv[0]);
+        return 1;
+    }
+    std::vector<std::string> dirs;
+    {
+        std::string list = argv[1];
+        size_t start = 0;
+        while (start <= list.size()) {
+            size_t comma = list.find(',', start);
+            if (comma == std::string::npos) comma = list.size();
+            if (comma > start) dirs.push_back(list.substr(start, comma - start));
+            start = comma + 1;
+        }
+    }
+    const std::string dir = dirs.front();
+    const size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500;
+    FrameFormat format;
+    format.width = argc > 3 ? (uint32_t)std::atoi(argv[3]) : 1280;
+    format.height = argc > 4 ? (uint32_t)std::atoi(argv[4]) : 1080;
+    format.channels = argc > 5 ? (uint32_t)std::atoi(argv[5]) : 3;
+    format.pixel_format = format.channels == 1 ? "BayerRG8" : "BGR8";
+    const uint64_t segment_frames = argc > 6 ? std::strtoull(argv[6], nullptr, 10) : 64;
+
+    // ֡ͬдȫҳļϵͳ⴦
+    std::vector<std::vector<uint8_t>> frames(4, std::vector<uint8_t>(format.frameBytes()));
+    uint32_t seed = 12345;
+    for (auto& frame : frames) {
+        for (uint8_t& b : frame) {
+            seed = seed * 1664525u + 1013904223u;
+            b = (uint8_t)(seed >> 24);
+        }
+    }
+    printf("%zu frames of %ux%ux%u (%.1f MB each) in %s\n", count, format.width, format.height,
+        format.channels, format.frameBytes() / 1e6, dir.c_str());
+
+    {
+        H5FrameSink sink;
+        run("hdf5 batch 4", sink, dir, H5FrameSink::kFileName, format, frames, count);
+    }
+
+    struct LogConfig {
+        const char* label;
+        size_t records_per_write;
+        size_t queue_depth;
+        DirectFileWriter::Backend backend;
+    };
+    const LogConfig configs[] = {
+        { "framelog sync qd1 x1", 1, 1, DirectFileWriter::Backend::Sync },
+        { "framelog sync qd1 x4", 4, 1, DirectFileWriter::Backend::Sync },
+        { "framelog async qd4 x1", 1, 4, DirectFileWriter::Backend::Auto },
+        { "framelog async qd4 x4", 4, 4, DirectFileWriter::Backend::Auto },
+        { "framelog async qd8 x4", 4, 8, DirectFileWriter::Backend::Auto },
+    };
+    for (const LogConfig& config : configs) {
+        FrameLogSink::Options options;
+        options.records_per_write = config.records_per_write;
+        options.queue_depth = config.queue_depth;
+        options.backend = config.backend;
+        FrameLogSink sink(options);
+        run(config.label, sink, dir, FrameLogSink::kFileName, format, frames, count);
+    }
+
+    if (dirs.size() > 1) {
+        // ֶļڹرʱ sink дꣻHDF5 ֶβٵ fsync (ҳĻд̯ͬ)
+        SegmentPolicy policy;
+        policy.max_frames = segment_frames;
+        policy.directories = dirs;
+        char label[64];
+        {
+            SegmentedSink sink("bench", []() { return std::make_unique<H5FrameSink>(); }, policy);
+            snprintf(label, sizeof(label), "segmented hdf5 x%zu dirs", dirs.size());
+            run(label, sink, dir, "", format, frames, count);
+        }
+        {
+            SegmentedSink sink("bench", []() { return std::make_unique<FrameLogSink>(); }, policy);
+            snprintf(label, sizeof(label), "segmented framelog x%zu dirs", dirs.size());
+            run(label, sink, dir, "", format, frames, count);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+// д̸߳ʱ㣺DataQueue (ڴ) + SpillRing (ڴӳ价ļ)
+//
+// ̶߰֡ʲ֡ ( RGB::releaseToWriter ͬжϣ֡гˮλͽ)
+// д߳ȡڴСٰ˳ ThrottledSink װУ sink
+// ֡ϸ֡һ¡ڴзֵ (ڴ) / ֡дʡ
+// ÷: spill_bench [spill_dir] [frames] [fps] [frame_kb] [sink_mb_per_s] [stall_every] [stall_ms] [ring_mb]
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DataQueue.h"
+#include "SpillRing.h"
+#include "ThrottledSink.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Frame {
+    uint64_t number = 0;
+    std::vector<uint8_t> pixels;
+};
+
+static void fillFrame(Frame& f, uint64_t number, size_t bytes)
+{
+    f.number = number;
+    f.pixels.resize(bytes);
+    for (size_t i = 0; i < bytes; i += 4096) f.pixels[i] = (uint8_t)(number * 31 + i / 4096);
+    memcpy(f.pixels.data(), &number, sizeof(number));
+}
+
+// У˳ݣ
+class CheckingSink : public FrameSink {
+public:
+    explicit CheckingSink(size_t frame_bytes) : frame_bytes(frame_bytes) {}
+
+    bool openFile(const std::string&, const FrameFormat&) override { return true; }
+    bool write(const FrameRecord& record) override
+    {
+        uint64_t stored = 0;
+        memcpy(&stored, record.data, sizeof(stored));
+        bool ok = stored == record.frame_number;
+        for (size_t i = 4096; ok && i < frame_bytes; i += 4096) {
+            ok = record.data[i] == (uint8_t)(record.frame_number * 31 + i / 4096);
+        }
+        if (!ok) corrupt++;
+        if (record.frame_number != next) out_of_order++;
+        next = record.frame_number + 1;
+        s.frames++;
+        s.bytes += frame_bytes;
+        return ok;
+    }
+    bool close() override { return true; }
+    const char* name() const override { return "check"; }
+    const char* fileName() const override { return "check"; }
+    FrameSinkStats stats() const override { return s; }
+
+    uint64_t corrupt = 0;
+    uint64_t out_of_order = 0;
+
+private:
+    size_t frame_bytes;
+    uint64_t next = 0;
+    FrameSinkStats s;
+};
+
+int main(int argc, char* argv[])
+{
+    SpillRing::Options spill_options;
+    spill_options.directory = argc > 1 ? argv[1] : ".";
+    const uint64_t frames = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2000;
+    const int fps = argc > 3 ? std::atoi(argv[3]) : 200;
+    const size_t frame_bytes = (argc > 4 ? std::strtoull(argv[4], nullptr, 10) : 1024) * 1024;
+    ThrottledSink::Options throttle;
+    throttle.mb_per_s = argc > 5 ? std::atof(argv[5]) : 150;
+    throttle.stall_every_frames = argc > 6 ? std::atoi(argv[6]) : 500;
+    throttle.stall_ms = argc > 7 ? std::atoi(argv[7]) : 1000;
+    spill_options.capacity_bytes = (argc > 8 ? std::strtoull(argv[8], nullptr, 10) : 1024) << 20;
+    spill_options.high_water_frames = 32;
+    spill_options.wait_ms = 5000;
+
+    printf("%llu frames x %zu KB at %d fps (%.0f MB/s), sink %.0f MB/s, stall %d ms every %d frames, ring %llu MB in %s\n",
+        (unsigned long long)frames, frame_bytes >> 10, fps, frame_bytes * (double)fps / 1e6, throttle.mb_per_s,
+        throttle.stall_ms, throttle.stall_every_frames, (unsigned long long)(spill_options.capacity_bytes >> 20),
+        spill_options.directory.c_str());
+
+    SpillRing ring;
+    if (!ring.open(spill_options)) return 1;
+    DataQueue<Frame*> queue(128, QueuePolicy::Block, [](Frame*& f) { delete f; f = nullptr; }, std::chrono::milliseconds(100));
+    auto checker = std::make_unique<CheckingSink>(frame_bytes);
+    CheckingSink* check = checker.get();
+    ThrottledSink sink(std::move(checker), throttle);
+    FrameFormat format;
+    sink.openFile("", format);
+
+    std::atomic<bool> producer_done{ false };
+    auto t0 = Clock::now();
+    std::thread writer([&]() {
+        std::vector<Frame*> batch;
+        while (!producer_done || !queue.empty() || ring.records() > 0) {
+            batch.clear();
+            const bool spilled = ring.records() > 0;
+            if (queue.pop_n(batch, 64, std::chrono::milliseconds(spilled ? 0 : 5)) > 0) {
+                for (Frame* f : batch) {
+                    FrameRecord r;
+                    r.data = f->pixels.data();
+                    r.data_bytes = f->pixels.size();
+                    r.frame_number = f->number;
+                    sink.write(r);
+                    delete f;
+                }
+            }
+            else if (spilled) {
+                FrameRecord r;
+                for (int i = 0; i < 64 && ring.front(r); ++i) {
+                    sink.write(r);
+                    ring.pop();
+                }
+            }
+        }
+    });
+
+    std::mutex spill_mutex;
+    auto next = Clock::now();
+    for (uint64_t i = 0; i < frames; ++i) {
+        next += std::chrono::microseconds(1000000 / fps);
+        std::this_thread::sleep_until(next);
+        Frame* f = new Frame();
+        fillFrame(*f, i, frame_bytes);
+
+        std::lock_guard<std::mutex> lk(spill_mutex);
+        if (ring.shouldSpill((size_t)queue.size())) {
+            FrameRecord r;
+            r.data = f->pixels.data();
+            r.data_bytes = f->pixels.size();
+            r.frame_number = f->number;
+            ring.append(r);
+            delete f;
+            continue;
+        }
+        if (!queue.push(f)) delete f;
+    }
+    producer_done = true;
+    writer.join();
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    const QueueStats q = queue.stats();
+    const SpillRing::Stats s = ring.stats();
+    const FrameSinkStats written = sink.stats();
+    printf("written %llu/%llu frames in %.1f s (%.0f MB/s), out of order %llu, corrupt %llu\n",
+        (unsigned long long)written.frames, (unsigned long long)frames, seconds, written.bytes / seconds / 1e6,
+        (unsigned long long)check->out_of_order, (unsigned long long)check->corrupt);
+    printf("memory queue: peak %zu frames (%.0f MB), dropped %llu\n",
+        q.high_water, q.high_water * (double)frame_bytes / 1e6, (unsigned long long)(q.dropped_newest + q.dropped_oldest));
+    printf("spill ring: spilled %llu, restored %llu, dropped %llu, peak %.0f MB, producer waited %.1f ms\n",
+        (unsigned long long)s.spilled, (unsigned long long)s.restored, (unsigned long long)s.dropped,
+        s.peak_bytes / 1e6, s.wait_ns / 1e6);
+    ring.close();
+    return (written.frames == frames && check->out_of_order == 0 && check->corrupt == 0) ? 0 : 2;
+}
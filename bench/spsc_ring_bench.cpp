@@ -0,0 +1,150 @@
+// ɼص˿ԱȣSpscRing::try_push  vs  DataQueue::push + Semaphore::notify
+//
+// ߳ģ imageCallback֡¼ push ʱ߳ģ distributeTasksThread
+// ÷: spsc_ring_bench [frames] [interval_us]
+//   interval_us = 0 ʱΪͻģʽ (ȫ)򰴹̶֡
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "DataQueue.h"
+#include "Semaphore.h"
+#include "SpscRing.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct FakeNode {
+    unsigned int frame_number;
+};
+
+struct Result {
+    std::vector<double> push_ns;
+    uint64_t consumed = 0;
+    uint64_t dropped = 0;
+};
+
+static void spinUntil(Clock::time_point t)
+{
+    while (Clock::now() < t) {}
+}
+
+static void report(const char* name, Result& r)
+{
+    std::sort(r.push_ns.begin(), r.push_ns.end());
+    double sum = 0;
+    for (double v : r.push_ns) sum += v;
+    const size_t n = r.push_ns.size();
+    printf("%-28s mean %8.1f ns  p50 %8.1f  p99 %8.1f  p99.9 %9.1f  max %10.1f  consumed %llu  dropped %llu\n",
+        name, sum / n, r.push_ns[n / 2], r.push_ns[n * 99 / 100], r.push_ns[n * 999 / 1000], r.push_ns[n - 1],
+        (unsigned long long)r.consumed, (unsigned long long)r.dropped);
+}
+
+static Result runDataQueue(size_t frames, int interval_us)
+{
+    Result r;
+    r.push_ns.reserve(frames);
+    DataQueue<FakeNode*> queue(1000, QueuePolicy::DropOldest, [](FakeNode*& node) { delete node; });
+    Semaphore sem;
+    std::atomic<bool> running{ true };
+    std::atomic<uint64_t> consumed{ 0 };
+
+    std::thread consumer([&]() {
+        FakeNode* node = nullptr;
+        while (running) {
+            sem.wait();
+            if (queue.try_pop(node)) {
+                delete node;
+                consumed++;
+            }
+        }
+        // notifyAll ѼΪ 1ʣԪֱȡ
+        while (queue.try_pop(node)) {
+            delete node;
+            consumed++;
+        }
+    });
+
+    Clock::time_point next = Clock::now();
+    for (size_t i = 0; i < frames; ++i) {
+        if (interval_us > 0) {
+            next += std::chrono::microseconds(interval_us);
+            spinUntil(next);
+        }
+        FakeNode* node = new FakeNode{ (unsigned int)i };
+        auto t0 = Clock::now();
+        queue.push(node);
+        sem.notify();
+        auto t1 = Clock::now();
+        r.push_ns.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+    running = false;
+    sem.notifyAll();
+    consumer.join();
+
+    r.consumed = consumed;
+    r.dropped = queue.stats().dropped_oldest;
+    return r;
+}
+
+static Result runSpscRing(size_t frames, int interval_us)
+{
+    Result r;
+    r.push_ns.reserve(frames);
+    SpscRing<FakeNode*> ring(256);
+    std::atomic<bool> running{ true };
+    std::atomic<uint64_t> consumed{ 0 };
+
+    std::thread consumer([&]() {
+        int idle_rounds = 0;
+        while (true) {
+            FakeNode* node = nullptr;
+            if (!ring.try_pop(node)) {
+                if (!running) break;
+                if (++idle_rounds < 64) std::this_thread::yield();
+                else std::this_thread::sleep_for(std::chrono::microseconds(200));
+                continue;
+            }
+            idle_rounds = 0;
+            delete node;
+            consumed++;
+        }
+    });
+
+    Clock::time_point next = Clock::now();
+    for (size_t i = 0; i < frames; ++i) {
+        if (interval_us > 0) {
+            next += std::chrono::microseconds(interval_us);
+            spinUntil(next);
+        }
+        FakeNode* node = new FakeNode{ (unsigned int)i };
+        auto t0 = Clock::now();
+        bool pushed = ring.try_push(node);
+        auto t1 = Clock::now();
+        if (!pushed) delete node;
+        r.push_ns.push_back(std::chrono::duration<double, std::nano>(t1 - t0).count());
+    }
+    running = false;
+    consumer.join();
+
+    r.consumed = consumed;
+    r.dropped = ring.dropped();
+    return r;
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t frames = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const int interval_us = argc > 2 ? std::atoi(argv[2]) : 0;
+
+    printf("frames = %zu, interval = %d us (%s)\n", frames, interval_us, interval_us > 0 ? "paced" : "burst");
+
+    Result q = runDataQueue(frames, interval_us);
+    report("DataQueue + Semaphore", q);
+
+    Result s = runSpscRing(frames, interval_us);
+    report("SpscRing::try_push", s);
+    return 0;
+}
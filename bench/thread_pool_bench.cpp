@@ -0,0 +1,118 @@
+// ThreadPool (е + std::function)  vs  WorkStealingPool (ÿ߳˫˶ + SmallTask)
+//
+// ύ߳ģ distributeTasksThreadύС񣻼¼ÿύʼִеŶӳ٣
+// Լȫ߳ȡ 1, 2, 4, 8, 16, 32
+// ÷: thread_pool_bench [tasks] [work_us] [batch]
+//   work_us: ÿæʱģһظʽת (Ĭ 20us)
+//   batch:   WorkStealingPool һ enqueueBatchÿ (Ĭ 8)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "ThreadPool.h"
+#include "WorkStealingPool.h"
+
+using Clock = std::chrono::steady_clock;
+
+struct Sample {
+    Clock::time_point submitted;
+    double wait_ns = 0;
+};
+
+static void busyWait(int us)
+{
+    auto end = Clock::now() + std::chrono::microseconds(us);
+    while (Clock::now() < end) {}
+}
+
+static void runTask(Sample* s, int work_us, std::atomic<size_t>* done)
+{
+    s->wait_ns = std::chrono::duration<double, std::nano>(Clock::now() - s->submitted).count();
+    busyWait(work_us);
+    done->fetch_add(1, std::memory_order_release);
+}
+
+static void waitDone(std::atomic<size_t>& done, size_t n)
+{
+    while (done.load(std::memory_order_acquire) < n) std::this_thread::yield();
+}
+
+static void report(const char* name, size_t workers, std::vector<Sample>& samples, double seconds)
+{
+    std::vector<double> w;
+    w.reserve(samples.size());
+    for (const Sample& s : samples) w.push_back(s.wait_ns);
+    std::sort(w.begin(), w.end());
+    const size_t n = w.size();
+    printf("%-22s workers %2zu  %9.0f tasks/s  wait p50 %9.0f ns  p99 %10.0f  p99.9 %10.0f  max %11.0f\n",
+        name, workers, n / seconds, w[n / 2], w[n * 99 / 100], w[n * 999 / 1000], w[n - 1]);
+}
+
+int main(int argc, char* argv[])
+{
+    const size_t tasks = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200000;
+    const int work_us = argc > 2 ? std::atoi(argv[2]) : 20;
+    const size_t batch = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 8;
+    const size_t worker_counts[] = { 1, 2, 4, 8, 16, 32 };
+
+    printf("tasks = %zu, work = %d us, batch = %zu, logical cores = %zu\n", tasks, work_us, batch, logicalCoreCount());
+
+    for (size_t workers : worker_counts) {
+        std::vector<Sample> samples(tasks);
+
+        {
+            std::atomic<size_t> done{ 0 };
+            auto t0 = Clock::now();
+            {
+                ThreadPool pool(workers);
+                for (size_t i = 0; i < tasks; ++i) {
+                    Sample* s = &samples[i];
+                    s->submitted = Clock::now();
+                    pool.enqueue([s, work_us, &done]() { runTask(s, work_us, &done); });
+                }
+                waitDone(done, tasks);
+            }
+            report("ThreadPool", workers, samples, std::chrono::duration<double>(Clock::now() - t0).count());
+        }
+
+        {
+            std::atomic<size_t> done{ 0 };
+            auto t0 = Clock::now();
+            {
+                WorkStealingPool pool(workers);
+                for (size_t i = 0; i < tasks; ++i) {
+                    Sample* s = &samples[i];
+                    s->submitted = Clock::now();
+                    pool.enqueue([s, work_us, &done]() { runTask(s, work_us, &done); });
+                }
+                waitDone(done, tasks);
+            }
+            report("WorkStealingPool", workers, samples, std::chrono::duration<double>(Clock::now() - t0).count());
+        }
+
+        {
+            std::atomic<size_t> done{ 0 };
+            auto t0 = Clock::now();
+            {
+                WorkStealingPool pool(workers);
+                std::vector<SmallTask> pending;
+                pending.reserve(batch);
+                for (size_t i = 0; i < tasks; ++i) {
+                    Sample* s = &samples[i];
+                    s->submitted = Clock::now();
+                    pending.emplace_back([s, work_us, &done]() { runTask(s, work_us, &done); });
+                    if (pending.size() == batch || i + 1 == tasks) {
+                        pool.enqueueBatch(pending.begin(), pending.end());
+                        pending.clear();
+                    }
+                }
+                waitDone(done, tasks);
+            }
+            report("WorkStealingPool/batch", workers, samples, std::chrono::duration<double>(Clock::now() - t0).count());
+        }
+    }
+    return 0;
+}
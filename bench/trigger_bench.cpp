@@ -0,0 +1,124 @@
+// ֵӳƾ (αնϵ FakeUnoҪӲ POSIX)
+//
+// ÿֲ cycles  ʼ ->  hold_ms -> ֹͣ
+//   - ˳򣺵һڷʼ (GUI ̨ uno.startһ)
+//   - Ӧȫ (A / P / Q)ֹͣʱٹ̼һ
+//   - UNO Ƶ  -> һ ӳʵֵ֮
+// òӦľɹ̼ģʽȷ start / stop Ȼɹacked Ϊ false
+//  GUI ÷boot_ms Ϊ 0 ʱ startAsync / stopAsync أ߳ϰ˳ɡ
+// ÷: trigger_bench [cycles] [hold_ms] [first_pulse_delay_us]
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "FakeUno.h"
+#include "Uno.h"
+
+static double percentile(std::vector<double>& v, double q)
+{
+    if (v.empty()) return 0;
+    const size_t i = std::min(v.size() - 1, (size_t)(q * (v.size() - 1) + 0.5));
+    std::nth_element(v.begin(), v.begin() + i, v.end());
+    return v[i];
+}
+
+int main(int argc, char* argv[])
+{
+    const int cycles = argc > 1 ? std::atoi(argv[1]) : 20;
+    const int hold_ms = argc > 2 ? std::atoi(argv[2]) : 100;
+    const int64_t first_pulse_delay_us = argc > 3 ? std::atoll(argv[3]) : 150;
+    bool ok = true;
+
+    for (const int baud : { 9600, 115200 }) {
+        FakeUno::Options fake_options;
+        fake_options.baud = baud;
+        fake_options.trigger_hz = 60;
+        fake_options.first_pulse_delay_us = first_pulse_delay_us;
+        FakeUno fake(fake_options);
+        if (!fake.open()) return 1;
+
+        UNO::Options options;
+        options.port = fake.portName();
+        options.baud = baud;
+        options.boot_ms = 0;
+        UNO uno(options);
+        if (!uno.isOpen()) return 1;
+
+        std::vector<double> latency, error, rtt;
+        int misordered = 0, missing = 0, miscounted = 0;
+        for (int i = 0; i < cycles; ++i) {
+            const auto cameras_ready = std::chrono::steady_clock::now();
+            uno.start();
+            std::this_thread::sleep_for(std::chrono::milliseconds(hold_ms));
+            uno.stop();
+            const UNO::Stats s = uno.stats();
+            const FakeUno::Truth truth = fake.truth();
+            if (!s.acked || !s.pulse_seen || !s.stopped) {
+                missing++;
+                continue;
+            }
+            const uint64_t ready_ns = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                cameras_ready.time_since_epoch()).count();
+            if (truth.first_pulse_ns <= s.command_host_ns || s.command_host_ns < ready_ns) misordered++;
+            if (s.pulses != truth.pulses || s.pulses == 0) miscounted++;
+            const double true_us = (truth.first_pulse_ns - s.command_host_ns) / 1e3;
+            latency.push_back(true_us);
+            error.push_back(std::fabs(s.latency_us - true_us));
+            rtt.push_back(s.ack_rtt_us);
+        }
+        const double l50 = percentile(latency, 0.5), l99 = percentile(latency, 0.99);
+        const double e50 = percentile(error, 0.5), e99 = percentile(error, 0.99);
+        const double r50 = percentile(rtt, 0.5);
+        printf("%6d baud: command -> first pulse p50 %.0f us, p99 %.0f us; estimate |err| p50 %.0f us, p99 %.0f us; "
+            "ack rtt p50 %.0f us; missing %d, misordered %d, miscounted %d\n",
+            baud, l50, l99, e50, e99, r50, missing, misordered, miscounted);
+        // ӦԶСһֽڵĴʱӵȶ
+        const double tolerance_us = 10e6 / baud + 500;
+        if (missing || misordered || miscounted || latency.empty() || e99 > tolerance_us) ok = false;
+    }
+
+    // ɹ̼Ӧ
+    FakeUno::Options legacy_options;
+    legacy_options.legacy = true;
+    FakeUno legacy(legacy_options);
+    if (!legacy.open()) return 1;
+    UNO::Options options;
+    options.port = legacy.portName();
+    options.boot_ms = 0;
+    options.ack_timeout_ms = 50;
+    UNO uno(options);
+    const auto t0 = std::chrono::steady_clock::now();
+    const bool started = uno.start();
+    const bool stopped = uno.stop();
+    const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    const UNO::Stats s = uno.stats();
+    printf("legacy firmware: start %s, stop %s, acked %s, %.0f ms spent waiting, %llu starts seen by the board\n",
+        started ? "ok" : "failed", stopped ? "ok" : "failed", s.acked ? "yes" : "no", ms,
+        (unsigned long long)legacy.truth().starts);
+    if (!started || !stopped || s.acked || legacy.truth().starts != 1) ok = false;
+
+    // 첽մ򿪴ڣstartAsync Ҫ߳ϵ boot_ms
+    FakeUno async_fake;
+    if (!async_fake.open()) return 1;
+    UNO::Options async_options;
+    async_options.port = async_fake.portName();
+    async_options.boot_ms = 300;
+    UNO async_uno(async_options);
+    bool async_started = false, async_stopped = false;
+    const auto a0 = std::chrono::steady_clock::now();
+    async_uno.startAsync([&](bool result) { async_started = result; });
+    async_uno.stopAsync([&](bool result) { async_stopped = result; });
+    const double submit_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - a0).count();
+    async_uno.waitIdle();
+    const double done_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - a0).count();
+    const UNO::Stats a = async_uno.stats();
+    printf("async: submit %.2f ms, handshake done after %.0f ms (boot %d ms), start %s, stop %s, acked %s, %u pulses\n",
+        submit_ms, done_ms, async_options.boot_ms, async_started ? "ok" : "failed", async_stopped ? "ok" : "failed",
+        a.acked ? "yes" : "no", a.pulses);
+    if (submit_ms > 50 || !async_started || !async_stopped || !a.acked || !a.stopped ||
+        async_fake.truth().starts != 1) ok = false;
+    return ok ? 0 : 2;
+}
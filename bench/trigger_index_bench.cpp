@@ -0,0 +1,137 @@
+// ϳ¼Դͬʱ CD ¼ʹ (صͬһ CD ص)
+//  DVS Ľӷд dvs_events.h5 + /dvs/frames H5EventReader ֡У飺
+// ֡ k ¼Χ¼ [t_begin, t_end)Χǰһ¼ t_beginΧһ¼ t_end
+// RGB ֡Ŵ 1000 ʼ© 1% (ģص˶֡)ӦϵӰ졣
+// stall_ms > 0 ʱдֻ 4 飬¼֮һһ߳ռס h5Mutex stall_ms 룬
+// д߳ͣס˵ȴʱ飺֡УͬҪͨ (¼ΧӦʵд)ļ = յ¼ - 
+// ÷: trigger_index_bench [events_millions] [rate_mev_s] [trigger_hz] [exposure_us (0 = ½)] [file] [stall_ms]
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+#include "H5EventReader.h"
+#include "H5EventWriter.h"
+#include "H5Lock.h"
+#include "SyntheticEventSource.h"
+#include "TriggerIndex.h"
+
+using Clock = std::chrono::steady_clock;
+
+int main(int argc, char* argv[])
+{
+    const double millions = argc > 1 ? std::atof(argv[1]) : 20.0;
+    const double rate = argc > 2 ? std::atof(argv[2]) : 10.0;
+    const double trigger_hz = argc > 3 ? std::atof(argv[3]) : 200.0;
+    const long exposure_us = argc > 4 ? std::atol(argv[4]) : 0;
+    const std::string path = argc > 5 ? argv[5] : "trigger_index_bench.h5";
+    const int stall_ms = argc > 6 ? std::atoi(argv[6]) : 0;
+
+    SyntheticEventSource::Options options;
+    options.rate_mev_s = rate;
+    options.real_time = false;
+    options.max_events = (uint64_t)(millions * 1e6);
+    options.distribution = SyntheticEventSource::Distribution::MovingEdge;
+    options.trigger_hz = trigger_hz;
+    SyntheticEventSource source(options);
+    if (!source.open()) return 1;
+
+    H5EventWriter writer;
+    if (stall_ms > 0) {
+        H5EventWriter::Options writer_options;
+        writer_options.queue_buffers = 4;
+        writer_options.block_timeout_ms = 10;
+        writer.setOptions(writer_options);
+    }
+    if (!writer.open(path, options.width, options.height)) return 1;
+    TriggerIndex::Options index_options;
+    index_options.exposure_us = exposure_us;
+    TriggerIndex index(index_options);
+    index.reset();
+
+    std::mt19937 rng(3);
+    uint64_t rgb_reported = 0;
+    uint64_t pulses = 0;
+    source.setTriggerCallback([&](const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end) {
+        index.addTriggers(begin, end);
+        for (const Metavision::EventExtTrigger* e = begin; e != end; ++e) {
+            if (e->p != 1) continue;
+            if (rng() % 100 != 0) {
+                index.addRgbFrame(1000 + pulses);
+                rgb_reported++;
+            }
+            pulses++;
+        }
+    });
+    std::atomic<uint64_t> produced{ 0 };
+    const Clock::time_point t0 = Clock::now();
+    source.start([&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+        writer.write(begin, end);
+        index.addEvents(begin, end);
+        produced.fetch_add((uint64_t)(end - begin), std::memory_order_relaxed);
+    });
+    std::thread stall;
+    if (stall_ms > 0) {
+        stall = std::thread([&]() {
+            while (produced.load(std::memory_order_relaxed) < options.max_events / 3 && !source.finished()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+            std::this_thread::sleep_for(std::chrono::milliseconds(stall_ms));
+        });
+    }
+    while (!source.finished()) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    source.stop();
+    if (stall.joinable()) stall.join();
+    index.finish();
+    writer.close([&](H5::Group& group) {
+        index.mapEventRows([&](uint64_t event) { return writer.rowOf(event); });
+        return index.write(group, writer.stats().dropped_events);
+    });
+    const H5EventWriter::Stats writer_stats = writer.stats();
+    const double seconds = std::chrono::duration<double>(Clock::now() - t0).count();
+    const TriggerIndex::Stats stats = index.stats();
+    printf("%llu events, %llu pulses (%llu rising edges), %llu RGB frames reported, %llu late, %llu approximate, %.2f s\n",
+        (unsigned long long)stats.events, (unsigned long long)stats.pulses, (unsigned long long)pulses,
+        (unsigned long long)rgb_reported, (unsigned long long)stats.late, (unsigned long long)stats.approximate, seconds);
+
+    H5EventReader reader;
+    if (!reader.open(path)) return 1;
+    uint64_t bad = 0;
+    uint64_t checked_events = 0;
+    std::vector<Metavision::EventCD> frame_events, neighbour;
+    const TriggerIndex::Row* rows = index.rows().data();
+    const Clock::time_point r0 = Clock::now();
+    double lookup_s = 0;
+    for (size_t k = 0; k < reader.indexedFrames(); ++k) {
+        const uint64_t frame_number = reader.firstFrameNumber() + k;
+        const Clock::time_point l0 = Clock::now();
+        uint64_t begin = 0, end = 0;
+        if (!reader.frameRange(frame_number, begin, end)) {
+            bad++;
+            continue;
+        }
+        lookup_s += std::chrono::duration<double>(Clock::now() - l0).count();
+        const Metavision::timestamp t_begin = rows[k].t_begin;
+        const Metavision::timestamp t_end = rows[k].t_end;
+        if (!reader.read(begin, end, frame_events)) return 1;
+        for (const Metavision::EventCD& e : frame_events) bad += e.t < t_begin || e.t >= t_end;
+        checked_events += frame_events.size();
+        if (begin > 0 && reader.read(begin - 1, begin, neighbour)) bad += neighbour[0].t >= t_begin;
+        if (end < reader.eventCount() && reader.read(end, end + 1, neighbour)) bad += neighbour[0].t < t_end;
+    }
+    const double verify_s = std::chrono::duration<double>(Clock::now() - r0).count();
+    printf("frames %zu (first %llu), %llu events checked, errors %llu, frameRange %.3f us, verify %.2f s\n",
+        reader.indexedFrames(), (unsigned long long)reader.firstFrameNumber(), (unsigned long long)checked_events,
+        (unsigned long long)bad, reader.indexedFrames() ? lookup_s * 1e6 / reader.indexedFrames() : 0.0, verify_s);
+    const bool rows_match = reader.eventCount() == stats.events - writer_stats.dropped_events;
+    printf("%llu events dropped in %zu ranges, %llu rows in file (%s)\n", (unsigned long long)writer_stats.dropped_events,
+        writer.droppedRanges().size(), (unsigned long long)reader.eventCount(), rows_match ? "ok" : "MISMATCH");
+    const bool ok = bad == 0 && rows_match && reader.indexedFrames() == stats.pulses && stats.pulses > 0 &&
+        (stall_ms == 0 || writer_stats.dropped_events > 0);
+    reader.close();
+    std::remove(path.c_str());
+    return ok ? 0 : 2;
+}
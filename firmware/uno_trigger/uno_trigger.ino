@@ -0,0 +1,76 @@
+// 触发控制器固件 (Arduino UNO)：串口命令启动 / 停止方波，方波同时接 RGB 相机的触发输入和 DVS 的 Trigger In
+//
+// 协议见 include/Uno.h：
+//   'a' -> "A <us>" (收到命令的 micros())，随后 "P <us>" (第一个上升沿)
+//   'q' -> "Q <us> <pulses>"
+//   'v' -> "V 1"
+// 应答经发送缓冲异步发出，不影响方波的时序。波特率必须与 UNO::Options::baud 一致。
+
+const uint8_t kTriggerPin = 9;
+const unsigned long kBaud = 9600;
+const unsigned long kPeriodUs = 33333;     // 30 Hz
+const unsigned long kHighUs = kPeriodUs / 2;
+
+bool running = false;
+bool high = false;
+bool first_reported = true;
+unsigned long pulse_start = 0;             // 当前脉冲上升沿的 micros()
+unsigned long first_pulse = 0;
+unsigned long pulses = 0;
+
+void setup() {
+  pinMode(kTriggerPin, OUTPUT);
+  digitalWrite(kTriggerPin, LOW);
+  Serial.begin(kBaud);
+}
+
+void risingEdge(unsigned long now) {
+  digitalWrite(kTriggerPin, HIGH);
+  high = true;
+  pulse_start = now;
+  pulses++;
+}
+
+void loop() {
+  const unsigned long now = micros();
+  if (running) {
+    if (high && now - pulse_start >= kHighUs) {
+      digitalWrite(kTriggerPin, LOW);
+      high = false;
+    }
+    else if (!high && now - pulse_start >= kPeriodUs) {
+      risingEdge(pulse_start + kPeriodUs);  // 按计划时刻递推，不累积循环抖动
+    }
+  }
+  if (!first_reported) {
+    first_reported = true;
+    Serial.print("P ");
+    Serial.println(first_pulse);
+  }
+
+  if (Serial.available() > 0) {
+    const char command = Serial.read();
+    const unsigned long received = micros();
+    if (command == 'a') {  // 运行中再收到也从头开始，保证总有应答
+      pulses = 0;
+      running = true;
+      risingEdge(micros());
+      first_pulse = pulse_start;
+      Serial.print("A ");
+      Serial.println(received);
+      first_reported = false;
+    }
+    else if (command == 'q') {
+      running = false;
+      high = false;
+      digitalWrite(kTriggerPin, LOW);
+      Serial.print("Q ");
+      Serial.print(received);
+      Serial.print(" ");
+      Serial.println(pulses);
+    }
+    else if (command == 'v') {
+      Serial.println("V 1");
+    }
+  }
+}
@@ -0,0 +1,24 @@
+#ifndef BITPACK_H
+#define BITPACK_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Demosaic.h"  // SimdLevel / detectSimdLevel
+
+// 256  32 λ޷һĶλÿֵֻ width λ (0 <= width <= 32)
+//
+// ""  ( SIMD-BP128 ͬ˼·8  32 λͨ) i ֵڵ i % 8 ͨǸͨĵ i / 8 ֵ
+// ÿͨ 32 ֵΰ width λƴ 32 λ (λǰ)8 ͨĵ k ڴš
+// һ width * 32 ֽڣwidth Ϊ 0 ʱռռ (ȫ 0)
+//  k  8 ֵģ / ʱ 8 ͨλͬһ AVX2 ָһ
+// ʵ AVX2 ʵֵֽһ£ʱ CPU ѡ ( AVX2 ʱñ)
+constexpr size_t kBitPackGroup = 256;
+
+inline size_t bitPackedBytes(int width) { return (size_t)width * 32; }
+
+// out  bitPackedBytes(width) ֽڣin г width λĲֱ
+void packBits256(const uint32_t* in, int width, uint8_t* out, SimdLevel level = detectSimdLevel());
+// in  bitPackedBytes(width) ֽڣ 256 ֵ out
+void unpackBits256(const uint8_t* in, int width, uint32_t* out, SimdLevel level = detectSimdLevel());
+
+#endif // BITPACK_H
@@ -0,0 +1,48 @@
+#ifndef CHUNKCODEC_H
+#define CHUNKCODEC_H
+
+#include <H5Cpp.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// HDF5 ѹ (ڹ߳Ԥѹд߳ H5Dwrite_chunk ֱд)
+//
+// compressChunk Ӧ HDF5 ֽڼݣļԱ׼ HDF5 ȡ
+//   Deflate:  deflate  (1)zlib ʽ
+//   Zstd:    ע 32015 (hdf5plugin / HDF5 ٷ zstd ) zstd ֡
+//   Lz4:     ע 32004 (HDF5 ٷ lz4 )ԭʼ / Сͷķֿʽ
+// shuffle ΪֽŹ (2)ԪشСţѹ֮ǰԪΪ 1 ֽʱͬڲš
+// Zstd / Lz4 ҪڱʱҵӦĿ (DUALCAMERA_HAVE_ZSTD / DUALCAMERA_HAVE_LZ4)
+// Deflate Ҫ zlib (DUALCAMERA_HAVE_ZLIB)
+
+enum class ChunkCodec {
+    None,
+    Deflate,
+    Zstd,
+    Lz4,
+};
+
+struct ChunkCompression {
+    ChunkCodec codec = ChunkCodec::None;
+    int level = 0;          // Deflate: 1-9Zstd: 1-22 (0 ΪĬ 3)Lz4: 
+    bool shuffle = false;
+};
+
+const char* chunkCodecName(ChunkCodec codec);
+// αǷָ֧ѹʽ
+bool chunkCodecAvailable(ChunkCodec codec);
+
+//  HDF5 ע᱾ڵ zstd / lz4  (вʱظע)
+// ֮ͬһڿ H5Dread ѹݡظá
+bool registerChunkFilters();
+
+// ݼ compressChunk һµĹ
+bool setChunkFilters(H5::DSetCreatPropList& props, const ChunkCompression& compression);
+
+// ѹһĿ (size ֽڣԪشС element_size)д out
+// scratch Ϊ shuffle м仺壬÷鸴Աظ
+bool compressChunk(const ChunkCompression& compression, size_t element_size,
+    const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::vector<uint8_t>& scratch);
+
+#endif // CHUNKCODEC_H
@@ -0,0 +1,146 @@
+#ifndef CLOCKSYNC_H
+#define CLOCKSYNC_H
+
+#include <metavision/sdk/base/events/event_ext_trigger.h>
+#include <H5Cpp.h>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// ʽ³ֱ y = a + b * xʱ֮ƫƺƯ
+//
+// ռ warmup 㣬 Theil-Sen (бʵλ) ʼֱߺͲв߶ȣ֮ÿ O(1)
+//   - |в| > reject_k * scale ĵ㶪 (֡ / 塢쳣ʱ) relock_after ³ʼ
+//   - |в| > huber_k * scale ĵ㰴 Huber ȨؽȨȨΪ 1
+//   - ȨС˵ۼ forgetting ָܸƯƵĻ仯
+// ۼµĵΪԭ㣬x / y Ϊ int64 (ns豸ȴֵ) ʱҲʧȡ
+class RobustLineFit {
+public:
+    struct Options {
+        size_t warmup = 16;
+        double forgetting = 0.995;   // Լ 200 ļ (30 fps Լ 7 )ļƯ
+        double huber_k = 2.0;
+        double reject_k = 8.0;
+        double min_scale = 1.0;      // в߶ (y ĵλ)ʱڰȺ
+        size_t relock_after = 32;
+    };
+
+    RobustLineFit() = default;
+    explicit RobustLineFit(const Options& options) : options(options) {}
+
+    void setOptions(const Options& new_options) { options = new_options; }
+    void reset();
+    //  false ʾõ㱻Ⱥ㶪 (ʼ֮ǰĵ㶼ᱻ)
+    bool add(int64_t x, int64_t y);
+
+    bool ready() const { return ready_; }
+    double predict(int64_t x) const { return (double)oy + a + b * (double)(x - ox); }
+    double slope() const { return b; }
+    double scale() const { return scale_; }   // в߶ (Լڵвı׼)
+    int64_t originX() const { return ox; }    // һõĵ㣻predict(originX()) Ǵ˴ֵ
+    uint64_t samples() const { return samples_; }
+    uint64_t rejected() const { return rejected_; }
+    uint64_t relocks() const { return relocks_; }
+
+private:
+    void restart();  // ״̬
+    void initialize();
+    void accumulate(int64_t x, int64_t y, double weight);
+
+    Options options;
+    bool ready_ = false;
+    std::vector<std::pair<int64_t, int64_t>> warm;
+    int64_t ox = 0, oy = 0;                     // ԭ
+    double sw = 0, sx = 0, sy = 0, sxx = 0, sxy = 0;
+    double a = 0, b = 0;                         // ԭֱ
+    double scale_ = 0;
+    size_t consecutive_rejects = 0;
+    uint64_t samples_ = 0;
+    uint64_t rejected_ = 0;
+    uint64_t relocks_ = 0;
+};
+
+// RGB ʱ -> DVS ¼ʱ (us) ߶
+//
+//  TriggerIndex Լͬ k ʼ (¼ʱ) Ӧβɼ RGB ĵ k ֡ (֡ = һ֡֡ + k)
+// ÿһ (֡, ʼص¼ʱ) ͷֱ 豸ʱ -> ¼  ֡صʱ -> ¼ ϣ
+// 豸ʱ (Ϊ 0) 豸δʱ˶ʱ (ƽӳѱգΪ뼶)
+// align ĳһ֡¼ʱϵعʼʱ̣RGB д߳дÿ֡ʱãд֡Ա (/rgb/event_timestamps)
+// addTriggers ¼Դ̡߳addRgbFrame  RGB ֡Դ̡߳align  RGB д߳ϵãڲ (ÿֻмʮٴ)
+class ClockSync {
+public:
+    enum class Source : uint8_t {
+        None = 0,     // ûй
+        Device = 1,   // 豸ʱ -> ¼ʱ
+        Host = 2,     // ʱ -> ¼ʱ (˻)
+    };
+
+    struct Options {
+        bool rising_starts = true;   //  TriggerIndex::Options һ
+        int channel = -1;
+        RobustLineFit::Options device_fit;
+        RobustLineFit::Options host_fit;
+        size_t max_pending = 4096;   // ȴԵ / ֡ౣٸ
+    };
+
+    struct Estimate {
+        int64_t t_us = INT64_MIN;
+        Source source = Source::None;
+    };
+
+    struct Stats {
+        uint64_t pulses = 0;
+        uint64_t rgb_frames = 0;
+        uint64_t pairs = 0;
+        uint64_t device_rejected = 0;
+        uint64_t host_rejected = 0;
+        uint64_t relocks = 0;
+        bool device_ready = false;
+        bool host_ready = false;
+        double device_slope = 0;         // ¼ us / 豸
+        double device_residual_us = 0;
+        double host_slope = 0;           // ¼ us /  ns
+        double host_residual_us = 0;
+    };
+
+    ClockSync();
+    explicit ClockSync(const Options& options);
+    // ĬϹʹõãϵĲв߶޷ſ 200 us
+    static Options defaultOptions();
+
+    void setOptions(const Options& new_options);  // reset ֮ǰ
+    void reset();
+
+    void addTriggers(const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end);
+    void addRgbFrame(uint64_t frame_number, uint64_t host_timestamp_ns, uint64_t device_timestamp);
+    Estimate align(uint64_t frame_number, uint64_t host_timestamp_ns, uint64_t device_timestamp) const;
+
+    //  parent д clock 飺ϵղ ()¶
+    bool write(H5::Group& parent) const;
+    Stats stats() const;
+
+private:
+    struct Frame {
+        uint64_t host_ns;
+        uint64_t device_timestamp;
+    };
+
+    void pair(int64_t t, const Frame& frame);
+
+    Options options;
+    mutable std::mutex mutex;
+    RobustLineFit device_fit;    // x: 豸ʱy: ¼ us
+    RobustLineFit host_fit;      // x: ֡ص nsy: ¼ us
+    uint64_t pulses = 0;
+    bool have_rgb = false;
+    uint64_t first_frame_number = 0;
+    uint64_t rgb_frames = 0;
+    uint64_t pairs = 0;
+    std::map<uint64_t, int64_t> pending_pulses; // ţֵΪʼص¼ʱ
+    std::map<uint64_t, Frame> pending_frames;   //  ֡ - һ֡֡
+};
+
+#endif // CLOCKSYNC_H
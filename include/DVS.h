@@ -1,36 +1,106 @@
 #ifndef DVS_H
 #define DVS_H
-#include <metavision/sdk/driver/camera.h>
-#include <metavision/sdk/driver/ext_trigger.h>
-#include <metavision/hal/facilities/i_trigger_in.h>
-#include <metavision/sdk/core/algorithms/periodic_frame_generation_algorithm.h>
+#include "ClockSync.h"
 #include "DataQueue.h"
+#include "EventAccumulator.h"
+#include "EventSource.h"
+#include "FrameSink.h"
+#include "H5EventWriter.h"
+#include "SegmentManifest.h"
+#include "TriggerIndex.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <opencv2/opencv.hpp>
-#include <metavision/sdk/core/utils/cd_frame_generator.h>
 
 class DVS {
+public:
+	// ¼ƸʽSDK дĳ .rawд HDF5 ʽļ dvs_events.h5ͬʱ
+	enum class RecordFormat {
+		Raw,
+		Hdf5,
+		RawAndHdf5,
+	};
+
 private:
-	Metavision::Camera cam;
-	std::uint32_t acc;
-	double fps;
-	Metavision::PeriodicFrameGenerationAlgorithm  * frame_gen;
-	Metavision::CDFrameGenerator* cd_frame_generator;
+	std::unique_ptr<EventSource> source;  // ļطŻϳ¼Դ
+	// ¼ۼʾ֡ (Լõֱͼ / ʱ) Ⱦ
+	std::unique_ptr<EventAccumulator> accumulator;
 	//Metavision::ExtTrigger& ext_trigger;
 	int camera_width;
 	int camera_height;
 	std::string save_folder;
-	DataQueue<std::pair<const Metavision::EventCD* , const Metavision::EventCD*> > raw_queue;
-	// +++ Ա滻 cv::Mat  +++
-	std::mutex m_frame_mutex;   // ڱ m_latest_frame Ļ
-	cv::Mat m_latest_frame;     // ڴ洢GUIҪȡ֡
+	RecordFormat record_format = RecordFormat::Raw;
+	// dvs_events.h5¼Դֻ߳רд߳д HDF5
+	H5EventWriter event_writer;
+	std::atomic<bool> writing_events{ false };
+	bool events_file_opened = false;  // ¼ƴ򿪹 dvs_events.h5
+	// ⲿ -> ÿ RGB ֡¼Χ dvs_events.h5 һд
+	TriggerIndex trigger_index;
+	// RGB ʱ -> ¼ʱӵϣ HDF5 ¼ƣÿ start ¿ʼ
+	ClockSync clock_sync;
+	// ֡ص -> GUI ̵߳֡彻±꣬
+	TripleBuffer<cv::Mat> m_live_frame;
+
+	// ֶ¼ƣʱ / ļС .raw гɶΣдĿ¼
+	SegmentPolicy segment_policy;
+	SegmentManifest segment_manifest;
+	std::string dataset_folder;  // ./<name>嵥 dvs_manifest.json 
+	std::string current_segment_path;
+	std::thread segment_thread;
+	std::mutex segment_mutex;
+	std::condition_variable segment_cv;
+	bool segment_stop = false;
+	// ¼Ƶ .rawûСļ (save_folder)Ƿֶ (segment_manifest ĸ)
+	enum class RawOutput { None, Single, Segmented };
+	RawOutput raw_output = RawOutput::None;
+	void segmentLoop();
+	void stopSegments();
+	std::string segmentPath(uint32_t index, std::string& manifest_path) const;
+	void closeSegment(SegmentInfo& info);
+	void onEvents(const Metavision::EventCD* begin, const Metavision::EventCD* end); // ¼Դ̣߳ۼ
+	void onTriggers(const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end);
+	bool startStream();
+	void closeEventFile();
 public:
-	DVS();
+	DVS();  // Ĭʹõһ̨õ Prophesee 
+	// ָ¼Դ SyntheticEventSource ط .raw  MetavisionEventSource¼Դڹʱ
+	explicit DVS(std::unique_ptr<EventSource> event_source);
 	~DVS();
 	void stopRecord();
-	void start(const std::string& name);
+	// ¼Ƶ <root>/<name>/ (.rawdvs_events.h5dvs_manifest.json)
+	void start(const std::string& name, const std::string& root = ".");
+	const std::string& datasetFolder() const { return dataset_folder; }
+	// ¼д .raw ()  dvs_events.h5 ļС֮ͣstopRecord ֮
+	uint64_t recordedBytes() const;
+	//  start ֮ǰãmax_frames ¼Чֶֻ .raw
+	void setSegmentation(const SegmentPolicy& policy);
+	//  start ֮ǰãĬֻд .raw¼ .raw ¼Դ (ط / ϳ) Կд HDF5
+	void setRecordFormat(RecordFormat format);
+	// dvs_events.h5 ĿСȺѹ start ֮ǰ
+	void setEventWriterOptions(const H5EventWriter::Options& options);
+	const H5EventWriter::Options& getEventWriterOptions() const { return event_writer.getOptions(); }
+	H5EventWriter::Stats getEventWriterStats() const { return event_writer.stats(); }
+	// ʾ֡֡ʺۻ (Ĭ 30 fps30 ms)fps <= 0 ʾ֡ (޽¼)
+	void setDisplay(double fps, Metavision::timestamp accumulation_us);
+	// عⴰã start ֮ǰ (ֻд HDF5 ʱЧ)
+	// (ʱӶʹͬʼغͨ)
+	void setTriggerIndex(const TriggerIndex::Options& options);
+	// RGB ֡Դ߳ϵãյ֡źʱѴӦ RGB ֡šʱ ( RGB::setFrameObserver)
+	void onRgbFrame(uint64_t frame_number, uint64_t host_timestamp_ns, uint64_t device_timestamp);
+	// RGB д߳ϵãһ֡عʼʱ̶뵽¼ʱӣд event_timestamp_us / source ( RGB::setTimestampAligner)
+	void alignRgbFrame(FrameRecord& record) const;
+	ClockSync::Stats getClockSyncStats() const { return clock_sync.stats(); }
 	void stop();
 	//void decode();
-	cv::Mat getFrame();
+	// ֻһ߳ (GUI) á֡ʱ trueframe ֱĶˣһε֮ǰֲ
+	bool getFrame(cv::Mat& frame);
+	EventSource* eventSource() const { return source.get(); }
+	//  start ֮ǰͨüֱͼ / ʱ (ص¼Դ߳ϵ)¼ԴʧʱΪ
+	EventAccumulator* eventAccumulator() const { return accumulator.get(); }
 
 };
 
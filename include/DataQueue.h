@@ -3,41 +3,121 @@
 #ifndef DATAQUEUE_H
 #define DATAQUEUE_H
 
+#include <algorithm>
 #include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <atomic> // +++ 1. 引入 atomic
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
 
+// 队列满时 push 的处理方式
+enum class QueuePolicy {
+    Block,       // 等待消费者腾出空间，超过 block_timeout 仍满则丢弃新元素
+    DropOldest,  // 丢弃队首 (最旧) 元素，新元素照常入队
+    DropNewest,  // 丢弃新元素
+    Reject,      // 不入队，新元素仍归调用方
+};
+
+struct QueueStats {
+    size_t capacity = 0;
+    size_t size = 0;
+    size_t high_water = 0;         // size 的峰值
+    uint64_t pushed = 0;           // 成功入队的元素数
+    uint64_t popped = 0;
+    uint64_t dropped_oldest = 0;   // DropOldest 挤掉的旧元素
+    uint64_t dropped_newest = 0;   // DropNewest 丢弃的新元素，以及 Block 等待超时后丢弃的新元素
+    uint64_t rejected = 0;         // Reject 退回调用方的元素
+    uint64_t timeouts = 0;         // Block 等待超时次数
+    uint64_t blocked_ns = 0;       // push 等待空间的累计时间
+};
+
+// 有界阻塞队列 (多生产者 / 多消费者，单锁)
+// 容量、满时策略和 disposer 由构造函数指定。被丢弃的元素 (DropOldest 挤掉的旧元素、
+// DropNewest / Block 超时丢弃的新元素、clear 清掉的元素) 都交给 disposer 处理，
+// 元素是裸指针时由它负责 delete；没有 disposer 时只是从队列中移除。
 template <typename T>
 class DataQueue
 {
 public:
-    DataQueue() : is_stopped(false) {}; // +++ 2. 初始化标志
-    ~DataQueue() {};
+    using Disposer = std::function<void(T&)>;
 
-    void push(T& value)
+    explicit DataQueue(size_t capacity = 1000, QueuePolicy policy = QueuePolicy::DropOldest,
+        Disposer disposer = nullptr, std::chrono::milliseconds block_timeout = std::chrono::milliseconds(100))
+        : is_stopped(false), capacity(capacity == 0 ? 1 : capacity), policy(policy),
+          disposer(std::move(disposer)), block_timeout(block_timeout) {}; // +++ 2. 初始化标志
+    ~DataQueue() { clear(); };
+
+    // 在队列投入使用前调用
+    void configure(size_t new_capacity, QueuePolicy new_policy, Disposer new_disposer = nullptr,
+        std::chrono::milliseconds new_block_timeout = std::chrono::milliseconds(100))
     {
-        std::lock_guard<std::mutex> lk(m); 
-        if (queue.size() >= MAX_LEN)
-            queue.pop_front();
-        queue.emplace_back(std::move(value));
-        cond.notify_one();
+        std::lock_guard<std::mutex> lk(m);
+        capacity = new_capacity == 0 ? 1 : new_capacity;
+        policy = new_policy;
+        disposer = std::move(new_disposer);
+        block_timeout = new_block_timeout;
     }
-    void wait_push(T& value)
+
+    // 按策略入队，返回 value 是否进入了队列。
+    // 返回 false 时：Reject 下 value 仍归调用方；DropNewest / Block 超时下 value 已交给 disposer
+    // (没有 disposer 时同样仍归调用方)。队列已 stopWait 时不等待，按 Reject 处理。
+    bool push(T& value)
     {
         std::unique_lock<std::mutex> lk(m);
-        cond.wait(lk,[this](){return queue.size()<MAX_LEN;});
-        queue.emplace_back(std::move(value));
-        cond.notify_one();
+        if (queue.size() >= capacity) {
+            switch (policy) {
+            case QueuePolicy::DropOldest:
+                dispose(queue.front());
+                queue.pop_front();
+                stats_.dropped_oldest++;
+                break;
+            case QueuePolicy::DropNewest:
+                dispose(value);
+                stats_.dropped_newest++;
+                return false;
+            case QueuePolicy::Reject:
+                stats_.rejected++;
+                return false;
+            case QueuePolicy::Block:
+                if (!waitForSpace(lk, block_timeout)) {
+                    if (is_stopped) {
+                        stats_.rejected++;
+                        return false;
+                    }
+                    stats_.timeouts++;
+                    stats_.dropped_newest++;
+                    dispose(value);
+                    return false;
+                }
+                break;
+            }
+        }
+        enqueue(value);
+        return true;
     }
+
+    // 无论策略如何，一直等到有空间 (或队列被 stopWait) 为止
+    bool wait_push(T& value)
+    {
+        std::unique_lock<std::mutex> lk(m);
+        if (queue.size() >= capacity && !waitForSpace(lk, std::chrono::milliseconds::max())) {
+            stats_.rejected++;
+            return false;
+        }
+        enqueue(value);
+        return true;
+    }
+
     bool try_pop(T& value)
     {
-        std::lock_guard<std::mutex> lk(m); 
+        std::lock_guard<std::mutex> lk(m);
         if(queue.empty())
             return false;
-        value = queue.front();
-        queue.pop_front();
-        return true;                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                                     
+        popFront(value);
+        return true;
     }
     // <<< 3. 修改 wait_pop，使其返回 bool
     bool wait_pop(T& value)
@@ -45,7 +125,7 @@ public:
         std::unique_lock<std::mutex> lk(m);
 
         // 等待，直到 (队列不为空) 或者 (队列被停止)
-        cond.wait(lk, [this]() { return !queue.empty() || is_stopped; });
+        not_empty.wait(lk, [this]() { return !queue.empty() || is_stopped; });
 
         // 如果我们醒来是因为队列被停止了，并且队列是空的，
         // 那么这是一个“停止”信号，返回 false
@@ -54,16 +134,53 @@ public:
             return false;
         }
 
-        value = queue.front();
-        queue.pop_front();
+        popFront(value);
         return true;
     }
 
+    // 最多等待 timeout，超时或被停止且队列为空时返回 false
+    bool wait_pop(T& value, std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lk(m);
+        not_empty.wait_for(lk, timeout, [this]() { return !queue.empty() || is_stopped; });
+        if (queue.empty()) return false;
+        popFront(value);
+        return true;
+    }
+
+    // 批量取出：一次加锁移出最多 max_count 个元素，追加到 out 末尾 (移动，不拷贝)，返回取出的个数。
+    // 队列为空时最多等待 timeout (默认不等待)
+    size_t pop_n(std::vector<T>& out, size_t max_count,
+        std::chrono::milliseconds timeout = std::chrono::milliseconds(0))
+    {
+        std::unique_lock<std::mutex> lk(m);
+        if (queue.empty() && timeout.count() > 0) {
+            not_empty.wait_for(lk, timeout, [this]() { return !queue.empty() || is_stopped; });
+        }
+        const size_t n = std::min(max_count, queue.size());
+        out.reserve(out.size() + n);
+        for (size_t i = 0; i < n; ++i) {
+            out.emplace_back(std::move(queue.front()));
+            queue.pop_front();
+        }
+        stats_.popped += n;
+        if (n > 0) not_full.notify_all();
+        return n;
+    }
+
+    // 取出全部元素 (不等待)
+    size_t drain(std::vector<T>& out)
+    {
+        return pop_n(out, (size_t)-1);
+    }
 
+    // 清空队列，元素交给 disposer
     void clear()
     {
         std::lock_guard<std::mutex> lk(m);
+        for (T& value : queue) dispose(value);
         queue.clear();
+        not_full.notify_all();
     };
     bool empty() const
     {
@@ -73,7 +190,24 @@ public:
     int size() const
     {
         std::lock_guard<std::mutex> lk(m);
-        return queue.size();
+        return (int)queue.size();
+    }
+
+    QueueStats stats() const
+    {
+        std::lock_guard<std::mutex> lk(m);
+        QueueStats s = stats_;
+        s.capacity = capacity;
+        s.size = queue.size();
+        return s;
+    }
+
+    // 计数清零 (新的采集会话开始时调用)
+    void resetStats()
+    {
+        std::lock_guard<std::mutex> lk(m);
+        stats_ = QueueStats();
+        stats_.high_water = queue.size();
     }
 
     // +++ 4. 添加 stopWait (或叫 shutdown) 函数
@@ -81,7 +215,8 @@ public:
     {
         std::lock_guard<std::mutex> lk(m);
         is_stopped = true;
-        cond.notify_all(); // 唤醒所有等待此队列的线程
+        not_empty.notify_all(); // 唤醒所有等待此队列的线程
+        not_full.notify_all();
     }
 
     // +++ 5. (可选) 添加一个“重置”函数
@@ -92,11 +227,53 @@ public:
     }
 
 private:
+    void dispose(T& value)
+    {
+        if (disposer) disposer(value);
+    }
+
+    void enqueue(T& value)
+    {
+        queue.emplace_back(std::move(value));
+        stats_.pushed++;
+        if (queue.size() > stats_.high_water) stats_.high_water = queue.size();
+        not_empty.notify_one();
+    }
+
+    void popFront(T& value)
+    {
+        value = std::move(queue.front());
+        queue.pop_front();
+        stats_.popped++;
+        not_full.notify_one();
+    }
+
+    // 在锁内等待空间，返回 false 表示超时或队列被停止
+    bool waitForSpace(std::unique_lock<std::mutex>& lk, std::chrono::milliseconds timeout)
+    {
+        const auto t0 = std::chrono::steady_clock::now();
+        auto ready = [this]() { return queue.size() < capacity || is_stopped; };
+        if (timeout == std::chrono::milliseconds::max()) {
+            not_full.wait(lk, ready);
+        }
+        else {
+            not_full.wait_for(lk, timeout, ready);
+        }
+        stats_.blocked_ns += (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count();
+        return queue.size() < capacity && !is_stopped;
+    }
+
     mutable std::mutex m;
-    std::condition_variable cond;
+    std::condition_variable not_empty;
+    std::condition_variable not_full;  // 消费者取走元素时通知，wait_push / Block 策略在上面等待
     std::deque<T> queue;
-    const int MAX_LEN = 1000;
     std::atomic<bool> is_stopped; // +++ 6. 添加停止标志
+    size_t capacity;
+    QueuePolicy policy;
+    Disposer disposer;
+    std::chrono::milliseconds block_timeout;
+    QueueStats stats_;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,60 @@
+#ifndef DEMOSAIC_H
+#define DEMOSAIC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// 8 λ Bayer  -> BGR8 ȥˣ MVS SDK  OpenCV
+//
+// ʵ (ο / SSE4 / AVX2 / AVX-512) ֽһ£ʱ CPU Զѡ
+// ߽簴 reflect-101 (񣬲߽籾)  Bayer λ䡣
+//
+// ֵʽ (c ΪǰأL/R/U/D ΪңԽΪ UL/UR/DL/DRavg2 = (a + b + 1) >> 1)
+//   R/B λãɫ = cɫ = (UL + UR + DL + DR + 2) >> 2
+//             G = Bilinear:  (L + R + U + D + 2) >> 2
+//                 EdgeAware: |L - R| < |U - D| ȡ avg2(L, R)֮ȡ avg2(U, D)ʱͬ Bilinear
+//   G λã  G = cͬɫ = avg2(L, R)ͬɫ = avg2(U, D)
+
+enum class BayerPattern {
+    GB,  // һ G B / ڶ R G  (PFNC BayerGB8)
+    RG,  // R G / G B
+    GR,  // G R / B G
+    BG,  // B G / G R
+};
+
+enum class DemosaicMethod {
+    Bilinear,
+    EdgeAware,  // ɫݶȽСķֵٱԵЧӦ
+};
+
+enum class SimdLevel {
+    Scalar,
+    SSE4,
+    AVX2,
+    AVX512,  // AVX-512F + AVX-512BW
+};
+
+// ǰ CPU (ϵͳ) ֵ֧߼
+SimdLevel detectSimdLevel();
+const char* simdLevelName(SimdLevel level);
+
+// PFNC  (BayerGB8 ) -> BayerPattern 8 λ Bayer ʽʱ false
+bool bayerPatternFromName(const std::string& name, BayerPattern& pattern);
+
+// ֻ [row_begin, row_end) У֡ (±߽Ҫ)
+// ̸߳һдƴ֡Ľȫͬ
+// src: width x height ͨп src_stride ֽڣdst: BGR ֯п dst_stride ֽڡ
+// width / height Ϊ 2level  CPU ּ֧ʱԶ
+void demosaicRows(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+    int width, int height, BayerPattern pattern, DemosaicMethod method,
+    int row_begin, int row_end, SimdLevel level = detectSimdLevel());
+
+inline void demosaic(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+    int width, int height, BayerPattern pattern, DemosaicMethod method,
+    SimdLevel level = detectSimdLevel())
+{
+    demosaicRows(src, src_stride, dst, dst_stride, width, height, pattern, method, 0, height, level);
+}
+
+#endif // DEMOSAIC_H
@@ -0,0 +1,90 @@
+#ifndef DIRECTFILEWRITER_H
+#define DIRECTFILEWRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ƹҳ˳׷дļͬʱֶд;
+//   - LinuxO_DIRECT + io_uring (ֱϵͳã liburingҪ 5.6 ں)
+//     io_uring ʱ˻ O_DIRECT + pwriteļϵͳ֧ O_DIRECT ʱ˻ͨд
+//   - WindowsFILE_FLAG_NO_BUFFERING + ص I/O
+// ÷ͨ acquire() õһ鰴 4096 ֽڶĻ壬ú submit() ׷ӵļĩβ
+// л嶼;ʱ acquire() ȴɡÿдĳȱ kAlignment ı
+// ֻڵ߳ʹá
+class DirectFileWriter {
+public:
+    static const size_t kAlignment = 4096;
+
+    enum class Backend {
+        Auto,      // γ io_uring / ص I/O˻ͬд
+        IoUring,
+        Overlapped,
+        Sync,      // ͬ pwrite / WriteFile (Ȼ O_DIRECT)
+    };
+
+    struct Stats {
+        uint64_t writes = 0;
+        uint64_t bytes = 0;
+        uint64_t waits = 0;      // acquire ʱл嶼;ҪȴĴ
+        uint64_t errors = 0;
+    };
+
+    DirectFileWriter() = default;
+    ~DirectFileWriter();
+
+    DirectFileWriter(const DirectFileWriter&) = delete;
+    DirectFileWriter& operator=(const DirectFileWriter&) = delete;
+
+    // queue_depth ;壬ÿ buffer_bytes ֽ (ȡ kAlignment)
+    bool open(const std::string& path, size_t queue_depth, size_t buffer_bytes, Backend backend = Backend::Auto);
+    // ȴ;ɺرգɹдֽڶ (ҳ)
+    bool close();
+
+    uint8_t* acquire();
+    bool submit(uint8_t* buffer, size_t bytes);
+
+    bool isOpen() const { return is_open; }
+    bool failed() const { return broken || stats_.errors > 0; }
+    const char* backendName() const;
+    uint64_t offset() const { return next_offset; }
+    Stats stats() const { return stats_; }
+
+private:
+    struct Slot {
+        uint8_t* buffer = nullptr;
+        bool in_flight = false;
+        size_t bytes = 0;
+        void* overlapped = nullptr;  // Windows: OVERLAPPED*
+    };
+
+    bool waitOne();           // ȴһ;
+    bool submitSync(Slot& slot, size_t bytes, uint64_t offset);
+    void complete(size_t index, int64_t result);
+#if defined(__linux__)
+    void abandonRing();       // io_uring_enter ʧܺ ringʵִ˵
+#endif
+    void releaseBuffers();
+
+    std::vector<Slot> slots;
+    size_t buffer_bytes = 0;
+    size_t in_flight = 0;
+    size_t next_slot = 0;
+    uint64_t next_offset = 0;
+    uint64_t allocated = 0;  // Ԥļ (Linux fallocate)
+    Backend active = Backend::Sync;
+    bool is_open = false;
+    bool broken = false;     // д·ֲɻָĴacquire / submit һʧ
+    Stats stats_;
+
+#if defined(_WIN32)
+    void* handle = nullptr;
+#else
+    int fd = -1;
+    struct Ring;
+    Ring* ring = nullptr;
+#endif
+};
+
+#endif // DIRECTFILEWRITER_H
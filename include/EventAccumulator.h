@@ -0,0 +1,108 @@
+#ifndef EVENTACCUMULATOR_H
+#define EVENTACCUMULATOR_H
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// ¼ۼÿ EventCD ֻһΣͬʱȡ PeriodicFrameGenerationAlgorithm + CDFrameGenerator
+//  OpenCVΪԭʼ (EventImage)÷ cv::Mat / QImage
+//
+// ÿرһ uint32(t - base) << 1 | pһ¼ʱͼ (0 ʾδ¼)
+// ʾ֡ʱ涼ֻͼȾ¼ֻдһΣֱͼʱٶۼһ uint16 
+// ʱӽ 2^31 us (Լ 35 ) ʱƽ baseڵؼΪ 0
+//
+// ¼ʱȣԶڣ¼ĳʱʱڸôп
+// ۼʱ֮ǰ¼Ⱦټ ( PeriodicFrameGenerationAlgorithm ͬ)
+// һο (¼ж) ʱֻȾһ֡
+//   - ʾ֡BGR8accumulation_us ¼ذһμɫΪɫ ( CDFrameGenerator ɫһ)
+//   - ֱͼ2 x uint16 (OFF, ON)һÿص¼ (ͼ)
+//   - ʱ棺uint8255 * (1 - (t - t_last) / decay_us)decay_us ֮ǰΪ 0
+// Ⱦѭ޷֧ 32 λ㣬ֱ
+//
+// ֻһ߳ (¼Դ߳)  processEventsset*Output ڵһ processEvents ֮ǰá
+// ص processEvents ߳ϵãEventImage::data ֻڻصڼЧ
+struct EventImage {
+    const uint8_t* data = nullptr;
+    size_t stride = 0;               // п (ֽ)
+    int width = 0;
+    int height = 0;
+    int channels = 0;                // ʾ֡ 3 (BGR)ֱͼ 2 (OFF, ON)ʱ 1
+    int bytes_per_channel = 1;       // ֱͼΪ 2 (uint16)Ϊ 1
+    Metavision::timestamp t = 0;     // Ⱦʱ (¼ʱus)
+};
+
+class EventAccumulator {
+public:
+    using OutputCallback = std::function<void(const EventImage& image)>;
+
+    struct DisplayOptions {
+        double fps = 30;
+        Metavision::timestamp accumulation_us = 30000;
+        uint8_t background[3] = { 52, 37, 30 };   // BGR
+        uint8_t on_color[3] = { 236, 223, 216 };
+        uint8_t off_color[3] = { 201, 126, 64 };
+    };
+
+    struct Stats {
+        uint64_t events = 0;
+        uint64_t batches = 0;            // processEvents ô
+        uint64_t display_frames = 0;
+        uint64_t histogram_frames = 0;
+        uint64_t time_surface_frames = 0;
+        uint64_t rebases = 0;
+    };
+
+    EventAccumulator(int width, int height);
+
+    // fps <= 0  callback Ϊձʾرո
+    void setDisplayOutput(const DisplayOptions& options, OutputCallback callback);
+    void setHistogramOutput(double fps, OutputCallback callback);
+    void setTimeSurfaceOutput(double fps, Metavision::timestamp decay_us, OutputCallback callback);
+
+    void processEvents(const Metavision::EventCD* begin, const Metavision::EventCD* end);
+
+    // ۼ״̬һ¼¿ʼ (ļ / ¿ʼɼʱ)
+    void reset();
+
+    int width() const { return width_; }
+    int height() const { return height_; }
+    Stats stats() const { return stats_; }
+
+private:
+    enum { kDisplay, kHistogram, kTimeSurface, kOutputs };
+
+    struct Output {
+        bool enabled = false;
+        Metavision::timestamp period_us = 0;
+        Metavision::timestamp next_t = 0;   // һȾ¼ʱ
+        OutputCallback callback;
+    };
+
+    void accumulate(const Metavision::EventCD* begin, const Metavision::EventCD* end);
+    void rebase(Metavision::timestamp t);
+    void emitDue(Metavision::timestamp t);   // Ⱦ next_t <= t 
+    void renderDisplay(Metavision::timestamp t);
+    void renderHistogram(Metavision::timestamp t);
+    void renderTimeSurface(Metavision::timestamp t);
+    uint32_t relative(Metavision::timestamp t) const;  // Ⱦʱ -> ʱ (ضϵ [0, 2^31))
+
+    int width_;
+    int height_;
+    std::vector<uint32_t> last_event;   // (t - base) << 1 | p
+    std::vector<uint16_t> histogram;    // [2 * pixel + p]
+    std::vector<uint8_t> display;       // BGR8
+    std::vector<uint8_t> time_surface;
+
+    DisplayOptions display_options;
+    Metavision::timestamp decay_us = 50000;
+    Output outputs[kOutputs];
+
+    bool started = false;
+    Metavision::timestamp base = 0;
+    Stats stats_;
+};
+
+#endif // EVENTACCUMULATOR_H
@@ -0,0 +1,57 @@
+#ifndef EVENTCODEC_H
+#define EVENTCODEC_H
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Demosaic.h"  // SimdLevel / detectSimdLevel
+
+// EventCD Ľտ ()ͳԼ 2 ~ 3 ֽ / ¼ EventCD  16 ֽ
+//
+// ໥Ŀ˳ƴӶɣÿ kEventBlockMaxEvents ¼ö̷ֱ߳ / 롣
+// ͷ (32 ֽڣС)
+//   u32 magic "DCEB" | u32 ֽ (ͷ) | u32 ¼ | u8 汾 | u8 ģʽ | u8 ׸ | u8 
+//   i64 һ¼ t (ʱ) | i64 һ¼ t
+// ͷԴʱ䷶ΧʱʱתʱҪ롣
+// 壺
+//   - ģʽ 1 (γ)varint γȻÿγ̳ - 1  varint (Դ "׸" ʼ)
+//   - 256 ¼һ飬ͷΪ 4 ֽ (dt, x, y, p)  3  varint ׼ֵ (zigzag(min dt), min x, min y)
+//      (ֵ - ׼) Ķλ (BitPack.h Ų֣ÿ  * 32 ֽ)
+//     dt = t[i] - t[i - 1] (ڵһ¼һһ¼ڵһ¼Ϊ 0)Ϊ֤
+//     dt ȳ 32 λʱȼΪ 255Ϊ zigzag varint
+//     ģʽ 0 ʱ p ֽڵĵ 7 λΪ 0  1λΪ׼ ( 0 ʾͬһ)ģʽ 1 ʱ p
+//     һ鲻 256 ʱû׼ֵ (Ϊ 0)
+// ȽּԱʾĴСȡСߡλ /  CPU ѡ AVX2 ʵֽ֣һ¡
+constexpr size_t kEventBlockHeaderBytes = 32;
+constexpr size_t kEventBlockMaxEvents = (size_t)1 << 20;
+constexpr size_t kEventBlockDefaultEvents = (size_t)1 << 16;  // ѹԸߣС鲢ȸϸ
+
+struct EventBlockInfo {
+    uint64_t offset = 0;         // еʼֽ (scanEventBlocks д)
+    uint64_t first_event = 0;    // ĵһ¼е (scanEventBlocks д)
+    uint32_t events = 0;
+    uint32_t bytes = 0;          // ͷ
+    int64_t t_first = 0;
+    int64_t t_last = 0;
+};
+
+// һ (1 <= count <= kEventBlockMaxEvents)׷ӵ outؿֽϷʱ 0
+size_t encodeEventBlock(const Metavision::EventCD* events, size_t count, std::vector<uint8_t>& out,
+    SimdLevel level = detectSimdLevel());
+
+// ȡͷ (size Ϊ data ֮õֽ)
+bool readEventBlockInfo(const uint8_t* data, size_t size, EventBlockInfo& info);
+
+// һ飬out  info.events λãʱ false
+bool decodeEventBlock(const uint8_t* data, size_t size, Metavision::EventCD* out,
+    SimdLevel level = detectSimdLevel());
+
+//  block_events ¼ֿ¼׷ӵ outؿ
+size_t encodeEvents(const Metavision::EventCD* events, size_t count, std::vector<uint8_t>& out,
+    size_t block_events = kEventBlockDefaultEvents, SimdLevel level = detectSimdLevel());
+
+// ֻͷõÿλú¼Χ (н / ʱ)ʱ false
+bool scanEventBlocks(const uint8_t* data, size_t size, std::vector<EventBlockInfo>& blocks);
+
+#endif // EVENTCODEC_H
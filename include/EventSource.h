@@ -0,0 +1,49 @@
+#ifndef EVENTSOURCE_H
+#define EVENTSOURCE_H
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/events/event_ext_trigger.h>
+#include <functional>
+#include <string>
+
+// DVS ¼ԴDVS ¼ߵǰˣ EventCD 彻 DVS  (֡)
+// Ŀǰʵ֣
+//   - MetavisionEventSourceProphesee ط¼Ƶ .raw ļ (ʵʱ / ٶ)
+//   - SyntheticEventSource趨¼ʺͿռֲ¼Ҫ
+//
+// ˳open -> width / height -> start(callback) -> ... -> stop -> close
+// ص¼Դ߳ϵã[begin, end) ֻڻصڼЧͬһ¼ԴĻصᲢ
+class EventSource {
+public:
+    using Callback = std::function<void(const Metavision::EventCD* begin, const Metavision::EventCD* end)>;
+    using TriggerCallback = std::function<void(const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end)>;
+
+    virtual ~EventSource() = default;
+
+    // 򿪲豸 / ļʧʱӡԭ򲢷 false
+    virtual bool open() = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // ֱ (open ֮Ч)
+    virtual int width() const = 0;
+    virtual int height() const = 0;
+
+    // ʼ / ֹͣ¼stop ֮󲻻лص
+    virtual bool start(Callback callback) = 0;
+    virtual void stop() = 0;
+    // ⲿصĻص start ֮ǰ (nullptr ʾҪ) CD صͬһ߳ϵã
+    // ֤ͬһʱ̵ CD ¼ʹִ֧¼Դ
+    virtual void setTriggerCallback(TriggerCallback callback) { (void)callback; }
+    // ޳ȵ¼Դ (ļطš趨¼ĺϳԴ) ȫͳ󷵻 true
+    virtual bool finished() const { return false; }
+
+    // ԭʼ¼Ϊ .raw (ֻ֧)path Ϊʱֹͣ¼
+    virtual bool startRecording(const std::string& path) { (void)path; return false; }
+    virtual bool stopRecording(const std::string& path = std::string()) { (void)path; return false; }
+    virtual bool canRecord() const { return false; }
+
+    virtual const char* name() const = 0;
+};
+
+#endif // EVENTSOURCE_H
@@ -0,0 +1,62 @@
+#ifndef FAKEUNO_H
+#define FAKEUNO_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// αնϵļٴԼ߳ϰ firmware/uno_trigger ЭӦ UNO ҪӲ
+// ֡ӳٺ˳UNO  portName()  (Options::boot_ms Ϊ 0)
+//
+// ڵĴʱ䰴 baud ģ (ÿֽ 10 bit)ֽ "" ֮ŴÿӦ𷢳ǰĴʱ䡣
+// յ 'a' 󷽲 first_pulse_delay_us ʼ (ģ̼뵽һ) trigger_hz 壬'q' ֹͣ
+// legacy Ϊ true ʱκӦ (ɹ̼)ֻ֧ POSIX (posix_openpt)Windows  open  false
+class FakeUno {
+public:
+    struct Options {
+        int baud = 9600;
+        double trigger_hz = 30;
+        int64_t first_pulse_delay_us = 100;
+        bool legacy = false;
+    };
+
+    // ʵʱ ( steady_clock ns)Ժ UNO ĹֵȽ
+    struct Truth {
+        uint64_t command_ns = 0;       // һοʼ "" 
+        uint64_t first_pulse_ns = 0;   // Ӧĵһ
+        uint64_t stop_ns = 0;
+        uint32_t pulses = 0;
+        uint64_t starts = 0;
+    };
+
+    FakeUno() = default;
+    explicit FakeUno(const Options& options) : options(options) {}
+    ~FakeUno();
+
+    bool open();
+    void close();
+    const std::string& portName() const { return port_name; }
+    Truth truth() const;
+
+private:
+    void run();
+    void reply(const std::string& line);
+    uint32_t micros(uint64_t t_ns) const;   // ϵ micros() open ΢32 λ
+    uint32_t pulsesUntil(uint64_t t_ns) const;
+
+    Options options;
+    int master = -1;
+    int slave = -1;                  // ִ򿪣UNO رպ˶õ EIO
+    std::string port_name;
+    uint64_t boot_ns = 0;
+    std::thread thread;
+    std::atomic<bool> running{ false };
+    bool output_on = false;
+    uint64_t tx_free_ns = 0;         // ģķͶ֮
+    mutable std::mutex truth_mutex;
+    Truth truth_;
+};
+
+#endif // FAKEUNO_H
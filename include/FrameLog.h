@@ -0,0 +1,121 @@
+#ifndef FRAMELOG_H
+#define FRAMELOG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "DirectFileWriter.h"
+#include "FrameSink.h"
+
+// ֻ׷ӵԭʼ֡־ (rgb_frames.dcfl)нṹ 4096 ֽڶ룬 O_DIRECT ֱд
+//
+//   [ļͷ 4096 ֽ] [¼ 0] [¼ 1] ...
+//   ÿ¼С̶Ϊ record_bytes = ȡ 4096 (64 ֽڼ¼ͷ + frame_bytes )
+//
+// ΪС֡ļƳдһ뱻ϵһ¼ (Ȳ magic ) ֱӺԣ
+// Բɼ;Ҳܶǰд֡ framelog_to_h5 תΪ rgb_data.h5
+namespace framelog {
+    const char kMagic[8] = { 'D', 'C', 'F', 'R', 'L', 'O', 'G', '1' };
+    const uint32_t kVersion = 1;
+    const uint32_t kHeaderBytes = 4096;
+    const uint32_t kRecordMagic = 0x52464344;  // "DCFR"
+    const uint32_t kRecordHeaderBytes = 64;
+
+#pragma pack(push, 1)
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t header_bytes;
+        uint32_t width;
+        uint32_t height;
+        uint32_t channels;
+        uint32_t mvs_pixel_type;
+        uint64_t frame_bytes;
+        uint64_t record_bytes;
+        char pixel_format[32];       //  0 β
+    };
+
+    struct RecordHeader {
+        uint32_t magic;
+        uint32_t payload_bytes;
+        uint64_t sequence;           // ־ڵţ 0 ʼڼ¼±
+        uint64_t frame_number;
+        uint64_t host_timestamp_ns;
+        uint64_t device_timestamp;
+        int64_t event_timestamp_us;  // 뵽¼ʱӵʱ̣flags ĵ 8 λΪԴ (0 ʾûй)
+        uint32_t flags;              // ɰ汾д־ֶΪ 0
+        uint8_t reserved[kRecordHeaderBytes - 52];
+    };
+#pragma pack(pop)
+    static_assert(sizeof(RecordHeader) == kRecordHeaderBytes, "record header must be 64 bytes");
+
+    uint64_t recordBytes(uint64_t frame_bytes);
+}
+
+// д֡־ sinkÿ֡뻺壬ܹ records_per_write ύ
+//  DirectFileWriter  queue_depth дͬʱ;
+class FrameLogSink : public FrameSink {
+public:
+    static const char* const kFileName;   // "rgb_frames.dcfl"
+
+    struct Options {
+        size_t records_per_write = 4;   // ÿύļ¼
+        size_t queue_depth = 4;         // ͬʱ;д
+        DirectFileWriter::Backend backend = DirectFileWriter::Backend::Auto;
+    };
+
+    FrameLogSink() = default;
+    explicit FrameLogSink(const Options& options) : options(options) {}
+    ~FrameLogSink() override;
+
+    bool openFile(const std::string& file_path, const FrameFormat& format) override;
+    bool write(const FrameRecord& record) override;
+    bool flush() override;
+    bool close() override;
+
+    const char* name() const override { return "framelog"; }
+    const char* fileName() const override { return kFileName; }
+    FrameSinkStats stats() const override;
+    const char* backendName() const { return writer.backendName(); }
+
+private:
+    Options options;
+    DirectFileWriter writer;
+    FrameFormat format;
+    uint64_t frame_bytes = 0;
+    uint64_t record_bytes = 0;
+    uint8_t* current = nullptr;     // Ļ
+    size_t filled = 0;              // current еļ¼
+    uint64_t sequence = 0;
+    uint64_t size_mismatches = 0;
+    FrameSinkStats stats_;
+};
+
+// ˳ȡ֡־
+class FrameLogReader {
+public:
+    FrameLogReader() = default;
+    ~FrameLogReader();
+
+    FrameLogReader(const FrameLogReader&) = delete;
+    FrameLogReader& operator=(const FrameLogReader&) = delete;
+
+    bool open(const std::string& file_path);
+    void close();
+
+    const FrameFormat& format() const { return format_; }
+    uint64_t frameCount() const { return frame_count; }
+    uint64_t frameBytes() const { return header.frame_bytes; }
+
+    // ȡ index ¼pixels Ҫ frameBytes() ֽڣ¼ʱ false
+    bool read(uint64_t index, framelog::RecordHeader& record, uint8_t* pixels);
+
+private:
+    FILE* file = nullptr;
+    framelog::FileHeader header{};
+    FrameFormat format_;
+    uint64_t frame_count = 0;
+};
+
+#endif // FRAMELOG_H
@@ -0,0 +1,49 @@
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <opencv2/core.hpp>
+#include <cstddef>
+#include <cstdint>
+
+// ̶С֡
+// startCapture ʱ Width/Height һԷ䲢Ԥȴҳ棬ɼв malloc / ȱҳ
+//   - acquire/release  (汾ŵ Treiber ջ) SDK ص߳
+//   - allocator() һ cv::MatAllocatorcv::Mat::create ֱӴӳȡ壻
+//     ü cv::Mat Լάһ Mat ͷʱԶ黹
+//   - غľߴ糬Сʱ˻ͨѷ䣬ͳƣ֡
+class FramePool {
+public:
+    struct Stats {
+        size_t buffer_size = 0;   // ֽ
+        size_t capacity = 0;      // ܿ
+        size_t in_use = 0;        // ǰĿ
+        size_t high_water = 0;    // ķֵ
+        uint64_t acquired = 0;    // ɹӳȡĴ
+        uint64_t exhausted = 0;   // ؿա˻ضѷĴ
+        uint64_t oversize = 0;    // ڵС˻ضѷĴ
+    };
+
+    FramePool(size_t buffer_size, size_t buffer_count);
+    ~FramePool();
+
+    unsigned char* acquire();            // ؿʱ nullptr  exhausted
+    void release(unsigned char* buffer);
+    bool owns(const void* ptr) const;
+
+    cv::MatAllocator* allocator();
+    Stats stats() const;
+    size_t bufferSize() const;
+
+private:
+    class PoolMatAllocator;
+    struct Shared;
+
+    // ջͷFramePool ͷȥÿ UMatData һã
+    // һͷŵĸ٣ FramePool Դ cv::Mat ճͷţͷŵڴ
+    Shared* shared;
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+};
+
+#endif // FRAMEPOOL_H
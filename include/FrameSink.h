@@ -0,0 +1,82 @@
+#ifndef FRAMESINK_H
+#define FRAMESINK_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+// һβɼ֡ͬĸʽ
+struct FrameFormat {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t channels = 3;          // BGR Ϊ 3ԭʼΪ 1
+    std::string pixel_format;       // PFNC ƣ /rgb/frames  pixel_format һ
+    uint32_t mvs_pixel_type = 0;    // ԭʼͣԭʼʱ
+
+    size_t frameBytes() const { return (size_t)width * height * channels; }
+};
+
+// д߳̽ sink һ֡
+struct FrameRecord {
+    const uint8_t* data = nullptr;      // 
+    size_t data_bytes = 0;              // data ֽӦڴ sink ʱ FrameFormat::frameBytes()
+    const uint8_t* chunk = nullptr;     // ߳ԤѹõĿ ( acceptsCompressedChunks()  sink ʹ)
+    size_t chunk_bytes = 0;
+    uint64_t frame_number = 0;          // ֡
+    uint64_t host_timestamp_ns = 0;     // صյ֡ʱʱ (steady_clock, ns)
+    uint64_t device_timestamp = 0;      // ʱ (nDevTimeStampHigh:Lowλ)
+    int64_t event_timestamp_us = INT64_MIN;  // 뵽 DVS ¼ʱӵعʼʱ (us) ClockSync
+    uint8_t event_timestamp_source = 0;      // ClockSync::Source0 ûйƣ1 豸ʱ2 ʱ
+    // data / chunk ߡǿʱ sink  write غڴ ( owner )
+    // Ϊʱ sink  write ǰ򿽱
+    std::shared_ptr<const void> owner;
+};
+
+// ֡С sink ʱĸʽ (ɼ;˷ֱʻظʽ) ʱܰʽԽ硣
+// sink д֮ǰãʱ false sink Ϊͬһ sink ֻӡһ
+inline bool checkFrameBytes(const FrameRecord& record, size_t expected, uint64_t& mismatches)
+{
+    if (record.data_bytes == expected) return true;
+    if (mismatches++ == 0) {
+        printf("Frame %llu has %zu bytes but the recording expects %zu, frames of a different size are not written.\n",
+            (unsigned long long)record.frame_number, record.data_bytes, expected);
+    }
+    return false;
+}
+
+struct FrameSinkStats {
+    uint64_t frames = 0;        // ѽյ֡
+    uint64_t bytes = 0;         // ԭʼ (δѹ) ֽ
+    uint64_t stored_bytes = 0;  // ʵдļֽ (¼ͷ䣬ѹĴС)
+    uint64_t writes = 0;        // ײдô
+    uint64_t errors = 0;
+};
+
+// hdf5_write_queue ֮Ĵ洢
+// д߳Ψһĵ÷open -> write... (пʱ flush) -> close
+class FrameSink {
+public:
+    virtual ~FrameSink() = default;
+
+    //  base_path Ŀ¼´ sink Ĭļ (fileName())
+    virtual bool open(const std::string& base_path, const FrameFormat& format)
+    {
+        return openFile(base_path + "/" + fileName(), format);
+    }
+    // ֱָļ· (ֶ¼ơתʹ)
+    virtual bool openFile(const std::string& file_path, const FrameFormat& format) = 0;
+    virtual bool write(const FrameRecord& record) = 0;
+    // дݴ (дʱΪʱ)
+    virtual bool flush() { return true; }
+    virtual bool close() = 0;
+
+    virtual const char* name() const = 0;
+    virtual const char* fileName() const = 0;
+    virtual FrameSinkStats stats() const = 0;
+    // Ϊ true ʱ߳Ԥѹÿһ֡write յ record.chunk ǿ
+    virtual bool acceptsCompressedChunks() const { return false; }
+};
+
+#endif // FRAMESINK_H
@@ -0,0 +1,69 @@
+#ifndef FRAMESOURCE_H
+#define FRAMESOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// RGB ֡ԴRGB ɼߵǰˣؾ SDK
+// Ŀǰʵ֣
+//   - MvsFrameSource MVS SDK (CoaXPress Ӳ)
+//   - SyntheticFrameSourceԼ̰߳趨֡ Bayer ֡ҪͷԺѹ
+//
+// ˳open -> format -> start(callback) -> ... -> stop -> close
+// ص֡Դ߳ (SDK ȡ̻߳ϳ߳) ã뾡췵أ
+// SourceFrame::data ֻڻصڼЧҪʱɻص
+
+// ظʽpixel_format Ϊ PFNC  (BayerGB8 )д /rgb/frames  pixel_format ԣ
+// pixel_type Ϊ PFNC ֵ ( 16~23 λλ)MVS  MvGvspPixelType ֮ͬ
+struct SourceFormat {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    std::string pixel_format = "Unknown";
+    uint32_t pixel_type = 0;
+
+    size_t bitsPerPixel() const
+    {
+        size_t bits = (pixel_type >> 16) & 0xFF;
+        return bits > 0 ? bits : 8;
+    }
+    size_t frameBytes() const { return ((size_t)width * height * bitsPerPixel() + 7) / 8; }
+};
+
+struct SourceFrame {
+    const uint8_t* data = nullptr;
+    size_t bytes = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t pixel_type = 0;
+    uint64_t frame_number = 0;       // ֡ԴԼ֡ţ֡ʱ
+    uint64_t device_timestamp = 0;   // ʱ (λ)
+};
+
+class FrameSource {
+public:
+    using Callback = std::function<void(const SourceFrame& frame)>;
+
+    virtual ~FrameSource() = default;
+
+    // 򿪲豸ʧʱӡԭ򲢷 false
+    virtual bool open() = 0;
+    virtual void close() = 0;
+    virtual bool isOpen() const = 0;
+
+    // ǰֱʺظʽ (open ֮Ч)
+    virtual bool format(SourceFormat& format) = 0;
+
+    // ʼ / ֹͣ֡stop ֮󲻻лص
+    virtual bool start(Callback callback) = 0;
+    virtual void stop() = 0;
+
+    // һ֡תΪ BGR8 (dst  width * height * 3 ֽ)
+    // 8 λ Bayer ʽ RGB Լȥˣʽ (Լѡ SDK תʱ) ֡Դ
+    virtual bool convertToBgr(const SourceFrame& frame, uint8_t* dst, size_t dst_bytes) = 0;
+
+    virtual const char* name() const = 0;
+};
+
+#endif // FRAMESOURCE_H
@@ -14,12 +14,14 @@
 #include <QCloseEvent>
 #include <QApplication>
 #include <opencv2/opencv.hpp>
+#include "PipelineConfig.h"
 #include "RGB.h"
 #include "DVS.h"
 #include "Uno.h"
 #include <QLineEdit>
 #include <QMessageBox>
 #include <QTimer> // +++  QTimer
+#include <QStatusBar>
 
 class GUI : public QMainWindow {
     // +++  Q_OBJECT ꣡
@@ -49,6 +51,11 @@ private:
     // void updateDVS();
     // void updateRGB();
 
+    //  UNO ߳ɣص GUI ̴߳
+    void showTriggerStatus(bool ok);  // ֮״̬ʾӦ͵һӳ
+    void stopCameras();               // ֹ̨֮ͣͣ
+    bool cameras_running = false;     // stoprecord ֮stopCameras ֮ǰΪ true
+
     QLabel* view_DVS;
     QLabel* view_RGB;
     QHBoxLayout* buttonLayout;
@@ -56,6 +63,7 @@ private:
     QHBoxLayout* viewLayout;
     QLineEdit* datasetInput;
     QHBoxLayout* datasetLayout;
+    PipelineConfig config;  // ߳ȡʾˢµȣʱ PipelineConfig::defaultPath() ȡ
     DVS dvs;
     RGB rgb;
     UNO uno;
@@ -0,0 +1,64 @@
+#ifndef H5EVENTREADER_H
+#define H5EVENTREADER_H
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <H5Cpp.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ȡ H5EventWriter д dvs_events.h5
+// open ʱʱڴ (ÿСʱԼ 3600000 29MB)ʱʱֱӶλڵĸӣ
+// ֻһ t ֣Ҫͷɨ衣
+// д (/dvs/frames TriggerIndex) ʱframeRange  RGB ֡ O(1) ֡عڼ¼Χ
+//  HDF5 ö h5MutexԺ¼ед߳ͬһڹ档
+class H5EventReader {
+public:
+    H5EventReader() = default;
+    ~H5EventReader();
+
+    bool open(const std::string& file_path);
+    void close();
+    bool isOpen() const { return file != nullptr; }
+
+    uint64_t eventCount() const { return event_count; }
+    int width() const { return width_; }
+    int height() const { return height_; }
+    Metavision::timestamp indexResolution() const { return index_us; }
+
+    // һ t >= t ¼ (ûΪ eventCount())
+    uint64_t lowerBound(Metavision::timestamp t);
+    // ʱ [t0, t1) ¼ŷΧ [begin, end)
+    bool findRange(Metavision::timestamp t0, Metavision::timestamp t1, uint64_t& begin, uint64_t& end);
+    //  [begin, end) ¼ out
+    bool read(uint64_t begin, uint64_t end, std::vector<Metavision::EventCD>& out);
+    // findRange + read
+    bool readBetween(Metavision::timestamp t0, Metavision::timestamp t1, std::vector<Metavision::EventCD>& out);
+
+    // RGB ֡ frame_number عⴰڵ¼ŷΧûд֡ųΧʱ false
+    bool frameRange(uint64_t frame_number, uint64_t& begin, uint64_t& end) const;
+    bool readFrame(uint64_t frame_number, std::vector<Metavision::EventCD>& out);
+    size_t indexedFrames() const { return frame_event_begin.size(); }
+    uint64_t firstFrameNumber() const { return first_frame_number; }
+
+private:
+    bool readColumn(H5::DataSet& dataset, const H5::PredType& type, uint64_t begin, uint64_t count, void* out);
+
+    std::unique_ptr<H5::H5File> file;
+    H5::DataSet x_column;
+    H5::DataSet y_column;
+    H5::DataSet p_column;
+    H5::DataSet t_column;
+    std::vector<uint64_t> time_index;
+    std::vector<uint64_t> frame_event_begin;   //  k Ϊ֡ first_frame_number + k
+    std::vector<uint64_t> frame_event_end;
+    uint64_t first_frame_number = 0;
+    std::vector<int64_t> t_scratch;
+    uint64_t event_count = 0;
+    Metavision::timestamp index_us = 1000;
+    Metavision::timestamp index_t0 = 0;
+    int width_ = 0;
+    int height_ = 0;
+};
+
+#endif // H5EVENTREADER_H
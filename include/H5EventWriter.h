@@ -0,0 +1,136 @@
+#ifndef H5EVENTWRITER_H
+#define H5EVENTWRITER_H
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <H5Cpp.h>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DataQueue.h"
+#include "H5FrameWriter.h"
+
+//  CD ¼ֱд HDF5 ʽݼ (dvs_events.h5) rgb_data.h5 һֱ h5py ȡ
+//   /dvs/x            Nuint16
+//   /dvs/y            Nuint16
+//   /dvs/p            Nuint8
+//   /dvs/t            Nint64¼ʱ (us)
+//   /dvs/time_index   Muint64 k Ϊһ t >= index_t0 + k * index_us ¼
+//   /dvs ԣwidthheightindex_usindex_t0
+// ʱ index_us (Ĭ 1ms) һʱʱֱӶλڵĸӣڸڶ ( H5EventReader)
+//
+// write ¼Դ߳ϵãֻ¼˻壻 buffer_events нУ
+// רд̲߳Сʱ׷ӵе H5FrameWriter
+// ʱ¼Դ߳ȴ block_timeout_msһ ( dropped_events)ڿסص
+// Ŀ鰴 write յ¼żǳ䣬rowOf ݴ˰¼Żļк ( /dvs/frames)
+class H5EventWriter {
+public:
+    static const char* const kFileName;   // "dvs_events.h5"
+
+    struct Options {
+        size_t chunk_events = 1 << 18;    // ÿÿ¼ (t һ 2MB)
+        size_t buffer_events = 1 << 16;   // ô¼
+        size_t queue_buffers = 256;       //  ()ĬԼ 1600 ¼
+        int block_timeout_ms = 100;
+        Metavision::timestamp index_us = 1000;  // ʱķֱ
+        // еĿѹ (t  shuffle ѹʺܸ)Ĭϲѹѹд߳ɣ
+        // deflate ֻԼ 2 Mev/s¼Ӧѡ lz4 / zstd
+        ChunkCompression compression;
+    };
+
+    struct Stats {
+        uint64_t events = 0;          // write յ¼
+        uint64_t written = 0;         // дļ¼
+        uint64_t dropped_events = 0;  // ¼
+        uint64_t bytes = 0;           // дԭʼֽ (ÿ¼ 13 ֽ)
+        uint64_t writes = 0;          //  H5Dwrite ֮
+        uint64_t index_entries = 0;
+        uint64_t errors = 0;
+        QueueStats queue;
+    };
+
+    // write յĵ first ¼ ( 0 ʼ)  count ¼
+    struct DroppedRange {
+        uint64_t first = 0;
+        uint64_t count = 0;
+    };
+
+    H5EventWriter() = default;
+    explicit H5EventWriter(const Options& options) : options(options) {}
+    ~H5EventWriter();
+
+    // ļд߳
+    bool open(const std::string& file_path, int width, int height);
+    // ֻһ߳ (¼Դ߳) ã¼밴ʱ
+    void write(const Metavision::EventCD* begin, const Metavision::EventCD* end);
+    //  /dvs ׷ ()¼д֮ļر֮ǰã h5Mutex
+    using CloseHook = std::function<bool(H5::Group& group)>;
+
+    // ͳ˻ʣ¼ȴд߳д겢رļǰ˱ֹͣ write
+    bool close(const CloseHook& before_close = nullptr);
+
+    bool isOpen() const { return is_open; }
+    void setOptions(const Options& new_options) { options = new_options; }  // open ֮ǰ
+    const Options& getOptions() const { return options; }
+    Stats stats() const;
+
+    // ֻ߳ϵã close ֮ ( close Ļص) 
+    const std::vector<DroppedRange>& droppedRanges() const { return dropped_ranges; }
+    // write յĵ event ¼ /dvs екţ¼ʱΪһд¼к
+    uint64_t rowOf(uint64_t event) const;
+
+private:
+    using EventBuffer = std::vector<Metavision::EventCD>;
+
+    void writeLoop();
+    void pushPending();                   // ˣǰ
+    bool writeBuffer(const EventBuffer& buffer);
+    void recycle(EventBuffer* buffer);
+    EventBuffer* takeBuffer();
+    bool closeFile(const CloseHook& before_close = nullptr);
+
+    Options options;
+    std::unique_ptr<H5::H5File> file;
+    H5FrameWriter x_column;
+    H5FrameWriter y_column;
+    H5FrameWriter p_column;
+    H5FrameWriter t_column;
+    H5FrameWriter time_index;
+    int width_ = 0;
+    int height_ = 0;
+    bool is_open = false;
+
+    // 
+    EventBuffer* pending = nullptr;
+    DataQueue<EventBuffer*> queue{ 256, QueuePolicy::Block };
+    DataQueue<EventBuffer*> free_buffers{ 256, QueuePolicy::Reject };  // дĻص︴
+    uint64_t pushed_events = 0;           // Ѿӵ¼ = һһ¼
+    std::vector<DroppedRange> dropped_ranges;
+
+    // д߳
+    std::thread writer_thread;
+    std::vector<uint16_t> x_scratch;
+    std::vector<uint16_t> y_scratch;
+    std::vector<uint8_t> p_scratch;
+    std::vector<int64_t> t_scratch;
+    std::vector<uint64_t> index_scratch;
+    bool index_started = false;
+    Metavision::timestamp index_t0 = 0;
+    Metavision::timestamp next_index_t = 0;
+
+    std::atomic<uint64_t> events{ 0 };
+    std::atomic<uint64_t> written{ 0 };
+    std::atomic<uint64_t> dropped_events{ 0 };
+    std::atomic<uint64_t> errors{ 0 };
+    std::atomic<uint64_t> writes{ 0 };
+    std::atomic<uint64_t> index_entries{ 0 };
+    std::atomic<bool> stopping{ false };
+    Stats final_stats;                    // close ֮ stats() һ
+
+    H5EventWriter(const H5EventWriter&) = delete;
+    H5EventWriter& operator=(const H5EventWriter&) = delete;
+};
+
+#endif // H5EVENTWRITER_H
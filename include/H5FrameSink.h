@@ -0,0 +1,49 @@
+#ifndef H5FRAMESINK_H
+#define H5FRAMESINK_H
+
+#include <H5Cpp.h>
+#include <memory>
+#include "FrameSink.h"
+#include "H5FrameWriter.h"
+
+// д rgb_data.h5  sink
+//   /rgb/frames             N x H x W x 3 (BGR)  N x H x W (ԭʼ) pixel_format / mvs_pixel_type
+//   /rgb/frame_numbers      Nuint64֡
+//   /rgb/host_timestamps    Nuint64ʱ (ns)
+//   /rgb/device_timestamps  Nuint64ʱ
+//   /rgb/event_timestamps   Nint64뵽 DVS ¼ʱӵعʼʱ (us)ûйʱΪ INT64_MIN
+//   /rgb/event_timestamp_sources  Nuint8ClockSync::Source (0 ޣ1 豸ʱ2 ʱ)
+class H5FrameSink : public FrameSink {
+public:
+    static const char* const kFileName;   // "rgb_data.h5"
+
+    explicit H5FrameSink(const H5FrameWriter::Options& options = H5FrameWriter::Options());
+    ~H5FrameSink() override;
+
+    bool openFile(const std::string& file_path, const FrameFormat& format) override;
+    bool write(const FrameRecord& record) override;
+    bool flush() override;
+    bool close() override;
+
+    const char* name() const override { return "hdf5"; }
+    const char* fileName() const override { return kFileName; }
+    FrameSinkStats stats() const override;
+    bool acceptsCompressedChunks() const override { return options.compression.codec != ChunkCodec::None; }
+
+    H5FrameWriter::Stats writerStats() const { return frames.isOpen() ? frames.stats() : last_stats; }
+
+private:
+    H5FrameWriter::Options options;
+    std::unique_ptr<H5::H5File> file;
+    H5FrameWriter frames;
+    H5FrameWriter frame_numbers;
+    H5FrameWriter host_timestamps;
+    H5FrameWriter device_timestamps;
+    H5FrameWriter event_timestamps;
+    H5FrameWriter event_timestamp_sources;
+    H5FrameWriter::Stats last_stats;
+    uint64_t errors = 0;
+    uint64_t size_mismatches = 0;
+};
+
+#endif // H5FRAMESINK_H
@@ -0,0 +1,86 @@
+#ifndef H5FRAMEWRITER_H
+#define H5FRAMEWRITER_H
+
+#include <H5Cpp.h>
+#include "ChunkCodec.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// չ HDF5 ݼ (N x frame_shape) ׷֡д
+//   - append ֻ֡ݴ batch_frames ֡ ( flush) ʱһ H5Dwrite д
+//   - ݼ N ά growth Ԥչÿ֡ extend һΣclose ʱüʵ֡
+//   - ֿ״Ϊ chunk_frames x frame_shapebatch_frames ȡΪ chunk_frames ı
+//     ʹÿд뾡Ŀ
+// ѹʱд
+//   - append HDF5 ڵ߳ѹ (򵥣ѹٶȾдٶȵ)
+//   - appendChunk÷߳ compressChunk ѹһֻ֡ H5Dwrite_chunk (Ҫ chunk_frames Ϊ 1)
+// ֻڵ߳ʹãҵ÷Ҫ h5Mutex (HDF5 ̰߳ȫ)
+class H5FrameWriter {
+public:
+    struct Options {
+        size_t batch_frames = 4;     // ÿд֡
+        size_t chunk_frames = 1;     // ÿ֡
+        size_t initial_frames = 64;  // ʱԤ֡
+        double growth = 2.0;         // ʱ˱չ<= 1 ʾÿֻչպù (Ϊ)
+        ChunkCompression compression; // ѹĬϲѹ
+    };
+
+    struct Stats {
+        uint64_t frames = 0;    // д֡
+        uint64_t bytes = 0;     // дԭʼ (δѹ) ֽ
+        uint64_t stored_bytes = 0; // appendChunk ʵдֽ (ѹ)
+        uint64_t writes = 0;    // H5Dwrite ô
+        uint64_t extends = 0;   // ݼչ
+    };
+
+    H5FrameWriter() = default;
+    ~H5FrameWriter();
+
+    H5FrameWriter(const H5FrameWriter&) = delete;
+    H5FrameWriter& operator=(const H5FrameWriter&) = delete;
+
+    //  parent ´ݼ nameÿ֡״Ϊ frame_shapeԪΪ type
+    bool create(H5::Group& parent, const std::string& name, const H5::PredType& type,
+        const std::vector<hsize_t>& frame_shape, const Options& options);
+
+    // ׷һ֡ ()bytes  frameBytes() ʱ false
+    bool append(const void* data, size_t bytes);
+    // ׷ count ֡ (ţ bytes ֽڣӦΪ count * frameBytes())ݴΪʱֱдݴ
+    bool appendFrames(const void* data, size_t count, size_t bytes);
+    // ׷һѹõĵ֡ (compressChunk )
+    bool appendChunk(const void* chunk, size_t chunk_bytes);
+    // дݴе֡
+    bool flush();
+    // flush ݼüʵ֡ر
+    bool close();
+
+    bool isOpen() const { return is_open; }
+    H5::DataSet& dataset() { return ds; }
+    size_t frameBytes() const { return frame_bytes; }
+    size_t pendingFrames() const { return staged; }
+    uint64_t frameCount() const { return written + staged; }
+    Stats stats() const { return stats_; }
+
+private:
+    bool setExtent(uint64_t frames);
+    bool ensureCapacity(uint64_t frames);
+    bool writeFrames(const void* data, size_t count);
+    bool checkBytes(size_t bytes, size_t count);
+
+    H5::DataSet ds;
+    // Ԥ͵ id ڿЧ H5::PredType Ĺ HDF5
+    // дڲ h5Mutex ߳ (ֶ¼ƵĿ߳ͷ sink)
+    hid_t type_id = H5I_INVALID_HID;
+    std::vector<hsize_t> dims;   // ݼǰάȣdims[0] Ϊչ֡ ()
+    Options opts;
+    size_t frame_bytes = 0;
+    std::vector<uint8_t> staging;
+    size_t staged = 0;
+    uint64_t written = 0;
+    bool is_open = false;
+    Stats stats_;
+};
+
+#endif // H5FRAMEWRITER_H
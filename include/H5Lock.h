@@ -0,0 +1,16 @@
+#ifndef H5LOCK_H
+#define H5LOCK_H
+
+#include <mutex>
+
+//  HDF5 ùõ
+// а HDF5 һ㲻̰߳ȫ (û H5_HAVE_THREADSAFE)ʹ߳дͬļҲͬʱ⣺
+// RGB д߳ (ֶʱÿĿ¼һ)¼д̺߳Ͷȡ˶Ҫڵ HDF5 ֮ǰ
+// 룬ĺԵͬĺ
+inline std::recursive_mutex& h5Mutex()
+{
+    static std::recursive_mutex mutex;
+    return mutex;
+}
+
+#endif // H5LOCK_H
@@ -0,0 +1,36 @@
+#ifndef JSONESCAPE_H
+#define JSONESCAPE_H
+
+#include <cstdio>
+#include <string>
+
+// ת JSON ַ ()šбܺͿַ (< 0x20)  JSON 涨ת壬
+// ֽԭ嵥¼ժҪ
+inline std::string escapeJson(const std::string& text)
+{
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        switch (c) {
+        case '"': out += "\\\""; break;
+        case '\\': out += "\\\\"; break;
+        case '\b': out += "\\b"; break;
+        case '\f': out += "\\f"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\t': out += "\\t"; break;
+        default:
+            if ((unsigned char)c < 0x20) {
+                char code[8];
+                snprintf(code, sizeof(code), "\\u%04x", (unsigned)(unsigned char)c);
+                out += code;
+            }
+            else {
+                out += c;
+            }
+        }
+    }
+    return out;
+}
+
+#endif // JSONESCAPE_H
@@ -0,0 +1,56 @@
+#ifndef METAVISIONEVENTSOURCE_H
+#define METAVISIONEVENTSOURCE_H
+
+#include <metavision/sdk/driver/camera.h>
+#include <atomic>
+#include "EventSource.h"
+
+// Metavision SDK ¼Դ
+//   - file Ϊգһ̨õ Prophesee ⲿ (Main ͨ)֧¼ .raw
+//   - file ǿգط¼Ƶ .raw / .hdf5 ļreal_time Ϊ true ʱ¼ʱĽͳ
+//     Խٶͳ (ѹ¼)ļ finished()  true
+class MetavisionEventSource : public EventSource {
+public:
+    struct Options {
+        std::string file;
+        bool real_time = true;
+    };
+
+    MetavisionEventSource() = default;
+    explicit MetavisionEventSource(const Options& options) : options(options) {}
+    ~MetavisionEventSource() override;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return opened; }
+    int width() const override { return sensor_width; }
+    int height() const override { return sensor_height; }
+    bool start(Callback callback) override;
+    void stop() override;
+    void setTriggerCallback(TriggerCallback callback) override { trigger_callback = std::move(callback); }
+    bool finished() const override { return end_of_file.load(std::memory_order_acquire); }
+    bool startRecording(const std::string& path) override;
+    bool stopRecording(const std::string& path = std::string()) override;
+    bool canRecord() const override { return opened && options.file.empty(); }
+    const char* name() const override { return options.file.empty() ? "camera" : "replay"; }
+
+    Metavision::Camera& camera() { return cam; }
+
+private:
+    Options options;
+    Metavision::Camera cam;
+    bool opened = false;
+    std::atomic<bool> running{ false };
+    int sensor_width = 0;
+    int sensor_height = 0;
+    std::atomic<bool> end_of_file{ false };
+    Metavision::CallbackId cd_callback_id = 0;  // start ʱעᡢstop ʱƳ
+    TriggerCallback trigger_callback;
+    Metavision::CallbackId trigger_callback_id = 0;
+    bool trigger_registered = false;
+
+    MetavisionEventSource(const MetavisionEventSource&) = delete;
+    MetavisionEventSource& operator=(const MetavisionEventSource&) = delete;
+};
+
+#endif // METAVISIONEVENTSOURCE_H
@@ -0,0 +1,43 @@
+#ifndef MVSFRAMESOURCE_H
+#define MVSFRAMESOURCE_H
+
+#include "FrameSource.h"
+
+//  MVS SDK ֡Դöٵһ̨ CoaXPress ΪӲ (Line0 ءصع)
+// ͷļ MvCameraControl.hֻ MvsFrameSource.cpp  SDK
+// ûж DUALCAMERA_HAVE_MVS ʱ open ֱʧ ( CMakeLists.txt)
+class MvsFrameSource : public FrameSource {
+public:
+    struct Options {
+        unsigned int image_node_count = 200;  // SDK ڲȡ֡
+    };
+
+    MvsFrameSource() = default;
+    explicit MvsFrameSource(const Options& options) : options(options) {}
+    ~MvsFrameSource() override;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return camera_handle != nullptr; }
+    bool format(SourceFormat& format) override;
+    bool start(Callback callback) override;
+    void stop() override;
+    bool convertToBgr(const SourceFrame& frame, uint8_t* dst, size_t dst_bytes) override;
+    const char* name() const override { return "MVS"; }
+
+    // MVS  -> PFNC  (ֻгԭĸʽ)
+    static std::string pixelFormatName(unsigned int pixel_type);
+
+private:
+    void deliver(const SourceFrame& frame) { if (callback) callback(frame); }
+
+    Options options;
+    void* camera_handle = nullptr;
+    bool grabbing = false;
+    Callback callback;
+
+    MvsFrameSource(const MvsFrameSource&) = delete;
+    MvsFrameSource& operator=(const MvsFrameSource&) = delete;
+};
+
+#endif // MVSFRAMESOURCE_H
@@ -0,0 +1,79 @@
+#ifndef PIPELINECONFIG_H
+#define PIPELINECONFIG_H
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include "DataQueue.h"
+
+class RGB;
+class DVS;
+
+// ߹ģ߳ / ȡСʾ֡Ԥ
+//
+// ĬֵǰдڴĳԴļȡ set  (ϵ --rgb.workers 8)
+// ļΪ key = value ı# ͷΪעͣkey  write ͬ (rgb.workersdvs.display_fps...)
+// ûгֵĬֵʶ key 
+// apply  rgb.* / dvs.*  RGB / DVS ( startCapture / start ֮ǰ)gui.* ֻнʹá
+// PipelineTuner ڱúϳɸزһ save д
+struct PipelineConfig {
+    struct Rgb {
+        size_t workers = 6;                 // ʽת߳
+        bool pin_workers = false;           // ̰߳󶨵̶߼
+        size_t ring_frames = 256;           // ص -> ̵ַ߳У˶֡
+        size_t dispatch_batch = 16;         // ַ߳ÿһύ֡
+        size_t raw_pool_buffers = 64;       // ԭʼݻؿ (ľʱ˻ضѷ)
+        size_t bgr_pool_buffers = 32;       // BGR ֡ؿ
+        size_t write_queue_frames = 128;    // д
+        QueuePolicy write_queue_policy = QueuePolicy::Block;
+        int write_block_timeout_ms = 100;
+        size_t reorder_window = 64;         // Żȴ֡
+        int reorder_gap_timeout_ms = 500;
+        size_t hdf5_batch_frames = 4;       // ÿ H5Dwrite ϲ֡ (д̵߳ݴ滺尴)
+        size_t hdf5_chunk_frames = 1;
+        int preview_width = 640;
+        int preview_height = 540;
+        double preview_fps = 30;            // <= 0 رԤ
+    } rgb;
+
+    struct Dvs {
+        double display_fps = 30;            // <= 0 ʾ֡
+        int64_t display_accumulation_us = 30000;
+        size_t h5_buffer_events = 1 << 16;  // dvs_events.h5¼һ
+        size_t h5_queue_buffers = 256;      // dvs_events.h5д ()
+        size_t h5_chunk_events = 1 << 18;
+    } dvs;
+
+    struct Gui {
+        int dvs_refresh_ms = 10;
+        int rgb_refresh_ms = 33;
+        int view_width = 640;               // ʾڵСߴ磬DVS ʾ֡ŵߴ
+        int view_height = 540;
+    } gui;
+
+    // ȡļ (ֻļгֵ)򲻿дʱ falseԭѴӡ
+    bool load(const std::string& path);
+    bool save(const std::string& path) const;
+    bool write(FILE* out) const;
+    //  key һ set("rgb.workers", "8")key ʶֵϷʱ false
+    bool set(const std::string& key, const std::string& value);
+    static bool hasKey(const std::string& key);
+
+    // key = value ıĽload  dualcamera-record  --config ã# ͷΪעͣkey / value Ŀհȥ
+    // ÿһ applyʽԻ apply  false дӡ򲻿ļʱ false
+    using KeyValueHandler = std::function<bool(const std::string& key, const std::string& value)>;
+    static bool readKeyValues(const std::string& path, const KeyValueHandler& apply);
+    static std::string trim(const std::string& text);
+
+    void apply(RGB& rgb) const;
+    void apply(DVS& dvs) const;
+
+    // RGB ֡غ HDF5 ݴ滺ռõڴ (ֽ)frame_bytes Ϊдһ֡ (BGR ԭʼ)
+    uint64_t rgbBufferBytes(uint64_t raw_frame_bytes, uint64_t bgr_frame_bytes, uint64_t frame_bytes) const;
+
+    //  DUALCAMERA_CONFIGδʱΪǰĿ¼µ dualcamera.conf
+    static std::string defaultPath();
+};
+
+#endif // PIPELINECONFIG_H
@@ -0,0 +1,68 @@
+#ifndef PIPELINETUNER_H
+#define PIPELINETUNER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "PipelineConfig.h"
+#include "Recorder.h"
+
+// 궨ڱúϳɸ (Recorder ĺϳԴʵд) ¼ҳȶĿ֡ʡڴٵĹ߲
+//
+// "" ָһ¼֡Դ֡ȫдûж֡ûȱڡûд֡û˻ضѷ䣬
+// ֡ԴȷʵĿ֡ʳ֡
+// ˳ȷ
+//   1. ߳ 1 ʼӣȡһϵ (ʼã㹻)
+//   2. СHDF5 ÿдϲ֡ (д̵߳ݴ滺尴) ͷַСԴСȡһϵ
+//   3. ȣ¼и (֡ءдСŴڡdvs_events.h5 ) ķֵ headroom
+//      ȷ¼֤ʱȼӱԣԲ˻ʼõ
+//   4. ȷϣҪд¼һΣϲҵ (ok)
+// ÿ¼д directory £ɾ
+class PipelineTuner {
+public:
+    struct Options {
+        double target_fps = 30;
+        uint32_t width = 1280;
+        uint32_t height = 1024;
+        double event_rate = 1.0;                 // Mev/s
+        RGB::RecordFormat rgb_format = RGB::RecordFormat::BGR;
+        RGB::SinkType rgb_sink = RGB::SinkType::Hdf5;
+        DVS::RecordFormat dvs_format = DVS::RecordFormat::Hdf5;   // ϳ¼Դ¼ .raw
+        std::string directory = ".";
+        double trial_seconds = 3;
+        size_t max_workers = 0;                  // 0 ʾ߼
+        double headroom = 1.5;
+    };
+
+    struct Trial {
+        std::string stage;                       // "workers" / "hdf5_batch" / "dispatch_batch" / "depths" / "final"
+        PipelineConfig config;
+        Recorder::Summary summary;
+        bool sustained = false;
+        uint64_t buffer_bytes = 0;               // PipelineConfig::rgbBufferBytes
+    };
+
+    struct Result {
+        bool ok = false;                         // ҵ˸Ŀ֡ʵ (config ͨȷ¼)
+        bool depths_confirmed = false;           // Ļͨȷϣfalse ʱ config ʼ
+        PipelineConfig config;                   // ok Ϊ false ʱԹõһ
+        uint64_t buffer_bytes = 0;
+        std::vector<Trial> trials;
+    };
+
+    explicit PipelineTuner(const Options& options);
+
+    // base Ϊʼ (ͨĬֵǰļ)Ԥʾ֡ gui.* ԭڽ
+    Result run(const PipelineConfig& base);
+
+private:
+    Trial runTrial(const std::string& stage, const PipelineConfig& config);
+    bool sustained(const Recorder::Summary& summary) const;
+    uint64_t bufferBytes(const PipelineConfig& config) const;
+    size_t withHeadroom(size_t peak, size_t minimum) const;
+
+    Options options;
+    int trial_index = 0;
+};
+
+#endif // PIPELINETUNER_H
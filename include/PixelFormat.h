@@ -0,0 +1,48 @@
+#ifndef PIXELFORMAT_H
+#define PIXELFORMAT_H
+
+#include <opencv2/imgproc.hpp>
+#include <string>
+#include "Demosaic.h"
+
+// ԭʼ֡ظʽƣ /rgb/frames  pixel_format һ (GenICam PFNC )
+//  MVS SDK߶ȡҲʹá
+
+// ͨ 8 λ (Ҷ) ʽ N x H x W ʽԭ
+inline bool isRawMosaic8(const std::string& format)
+{
+    return format == "BayerGB8" || format == "BayerRG8" || format == "BayerGR8" ||
+           format == "BayerBG8" || format == "Mono8";
+}
+
+//  -> BGR  OpenCV ת룻ֵ֧ĸʽ -1
+// ע OpenCV  Bayer ȡǵڶеڶУ PFNC  (һǰ) ô
+//   PFNC BayerGB (G B / R G) -> COLOR_BayerGR2BGR
+inline int mosaicToBgrCode(const std::string& format)
+{
+    if (format == "BayerGB8") return cv::COLOR_BayerGR2BGR;
+    if (format == "BayerRG8") return cv::COLOR_BayerBG2BGR;
+    if (format == "BayerGR8") return cv::COLOR_BayerGB2BGR;
+    if (format == "BayerBG8") return cv::COLOR_BayerRG2BGR;
+    if (format == "Mono8") return cv::COLOR_GRAY2BGR;
+    return -1;
+}
+
+//  -> BGRʽ֧ʱ false
+// Bayer ʽʹĿڵ Demosaic (ɼʱתһ)Mono8  OpenCV
+inline bool demosaicToBgr(const cv::Mat& mosaic, cv::Mat& bgr, const std::string& format,
+    DemosaicMethod method = DemosaicMethod::Bilinear)
+{
+    int code = mosaicToBgrCode(format);
+    if (code < 0 || mosaic.empty() || mosaic.type() != CV_8UC1) return false;
+    BayerPattern pattern;
+    if (bayerPatternFromName(format, pattern) && mosaic.cols >= 2 && mosaic.rows >= 2) {
+        bgr.create(mosaic.rows, mosaic.cols, CV_8UC3);
+        demosaic(mosaic.data, mosaic.step, bgr.data, bgr.step, mosaic.cols, mosaic.rows, pattern, method);
+        return true;
+    }
+    cv::cvtColor(mosaic, bgr, code);
+    return true;
+}
+
+#endif // PIXELFORMAT_H
@@ -0,0 +1,27 @@
+#ifndef PREVIEW_H
+#define PREVIEW_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Demosaic.h"
+
+// ԤͼɣһαԴͼͬʱС (ƽȼ INTER_AREA ) ͨţ
+// ֱ RGB888 (R G B ֯)GUI ֻ߳ѽ QImage OpenCV
+//
+// Ŀ (x, y) ȡԴͼ [x*W/w, (x+1)*W/w) x [y*H/h, (y+1)*H/h) ƽֵ ( 1 Դ)
+// dst п dst_stride ֽڣdst_w / dst_h ɴԴͼ (ʱ˻ΪڷŴ)
+
+// BGR8 -> RGB888
+void previewFromBgr(const uint8_t* src, size_t src_stride, int src_w, int src_h,
+    uint8_t* dst, size_t dst_stride, int dst_w, int dst_h);
+
+// 8 λ Bayer  -> RGB888ÿ 2x2 Ԫֱȡ R / (G1+G2)/2 / B ("" ȥ)
+// ڰֱƽԴ߰żضϣΪ 2
+void previewFromBayer(const uint8_t* src, size_t src_stride, int src_w, int src_h, BayerPattern pattern,
+    uint8_t* dst, size_t dst_stride, int dst_w, int dst_h);
+
+// Mono8 -> RGB888 (ͨͬ)
+void previewFromMono(const uint8_t* src, size_t src_stride, int src_w, int src_h,
+    uint8_t* dst, size_t dst_stride, int dst_w, int dst_h);
+
+#endif // PREVIEW_H
@@ -1,33 +1,119 @@
 #ifndef RGB_H
 #define RGB_H
 
-#include <MvCameraControl.h>
 #include <opencv2/opencv.hpp>
+#include "FrameSource.h"
 #include "DataQueue.h"
-#include "DataStack.h"
-#include "ThreadPool.h"
-#include <QDateTime>
-#include <QDir>
+#include "SpscRing.h"
+#include "TripleBuffer.h"
+#include "FramePool.h"
+#include "ReorderBuffer.h"
+#include "PixelFormat.h"
+#include "Preview.h"
+#include "H5FrameSink.h"
+#include "FrameLog.h"
+#include "SegmentedSink.h"
+#include "SpillRing.h"
+#include "ThrottledSink.h"
+#include "WorkStealingPool.h"
 #include <fstream>
 #include <chrono>
+#include <deque>
 #include <mutex>
 #include <condition_variable>
 #include <thread>
+#include <atomic>
 #include <H5Cpp.h> // +++ ADDED:  HDF5 C++ API
 #include <memory>  // +++ ADDED:  smart pointers
 
 class RGB {
 public:
     // ==================== Public Interface ====================
-    RGB();
+    RGB();  // Ĭʹ MVS  (MvsFrameSource)
+    // ָ֡Դ SyntheticFrameSource ()֡Դڹʱ
+    explicit RGB(std::unique_ptr<FrameSource> source);
     ~RGB();
 
     // Camera control
-    void startCapture(const std::string& save_path);
+    //  false ʾûпʼ (δʼ洢˴򲻿)ԭѴӡ
+    bool startCapture(const std::string& save_path);
     void stopCapture();
 
+    // Recording format
+    enum class RecordFormat {
+        BGR,       // ÿ֡ȥˣ/rgb/frames Ϊ N x H x W x 3  BGR
+        RawBayer,  // ֱӱĵͨˣ/rgb/frames Ϊ N x H x Wȡʱȥ
+    };
+
+    // BGR תʽ֡ԴԴת (MVS Ϊ MV_CC_ConvertPixelType)Ŀڵ SIMD ȥ ( 8 λ Bayer ʽʽ֡Դ)
+    enum class ColorConversion {
+        MvsSdk,
+        Bilinear,
+        EdgeAware,
+    };
+
+    // 洢ˣHDF5 (rgb_data.h5) O_DIRECT дԭʼ֡־ (rgb_frames.dcfl framelog_to_h5 ת)
+    enum class SinkType {
+        Hdf5,
+        FrameLog,
+    };
+
+    // Pipeline configuration ( startCapture ֮ǰ)
+    void setRecordFormat(RecordFormat format);
+    void setColorConversion(ColorConversion conversion);
+    void setWorkerCount(size_t count, bool pin_to_cores = false);
+    // ص -> ̵ַ߳ (ȡΪ 2 ) ֡صĿ (Ĭ 256 / 64 / 32)
+    // غľʱ˻ضѷ䣬֡ʱ֡
+    void setFrameBuffers(size_t ring_frames, size_t raw_pool_buffers, size_t bgr_pool_buffers);
+    // ַ߳ÿһύ̳߳ص֡ (Ĭ 16)
+    void setDispatchBatch(size_t frames);
+    // Ŵڣ໺֡ȴٵĶ֡ʱȱ
+    void setReorderWindow(size_t window, int gap_timeout_ms);
+    // HDF5 д룺ÿϲ batch_frames ֡дÿ chunk_frames ֡
+    void setHdf5Batching(size_t batch_frames, size_t chunk_frames);
+    // HDF5 ѹ (zstd / LZ4 / deflate)ڹ߳вѹ
+    void setCompression(const ChunkCompression& compression);
+    // ֡־ѹHDF5  / ѹöЧ
+    void setSink(SinkType type, const FrameLogSink::Options& log_options = FrameLogSink::Options());
+    // ֶ¼ƣ֡ / ֽ / ʱжΣдĿ¼ݼĿ¼ rgb_manifest.json
+    void setSegmentation(const SegmentPolicy& policy);
+    // дʱ (Ĭ 128 ֡ 100 ms ֡)֡ getWriteQueueStats
+    void setWriteQueue(size_t capacity, QueuePolicy policy, int block_timeout_ms = 100);
+    // 㣺дг high_water_frames ֡֡д directory µڴӳ价ļ
+    // д߳׷Ϻ˳ءdirectory Ϊձʾ (Ĭ)
+    void setSpill(const SpillRing::Options& options);
+    // ãΪдٶ / ͣ
+    void setSinkThrottle(const ThrottledSink::Options& options);
+    // ÿβɼֻ֡Դǰ frames ֡ (ص˶)֮֡֡ԴصֱӺԣ۲Ҳ0 ʾ
+    void setFrameLimit(uint64_t frames);
+    // ֡Դ߳ÿյһ֡һ ( / ֡ж֮ǰ)֡Ž DVS Ĵصﲻ
+    using FrameObserver = std::function<void(uint64_t frame_number, uint64_t host_timestamp_ns, uint64_t device_timestamp)>;
+    void setFrameObserver(FrameObserver observer);
+    // д߳ÿдһ֮֡ǰ (ص֡)֡źʱд record  event_timestamp_us / source
+    // 罻 DVS 뵽¼ʱ (DVS::alignRgbFrame)ʱֶα "ûй"
+    using TimestampAligner = std::function<void(FrameRecord& record)>;
+    void setTimestampAligner(TimestampAligner aligner);
+
+    // Ԥ̰߳ fps ֱ֡ width x height  RGB888GUI ֻ߳ QImage
+    // fps <= 0 رԤ (޽¼)width / height <= 0 ʱԤߴ
+    void setPreview(int width, int height, double fps);
+
     // Image access
-    void getLatestFrame(cv::Mat* output_frame);
+    // µԤͼ (RGB888Ԥߴ)ֻһ߳ (GUI) á
+    // Ԥʱ truergb_preview ֱĶˣһε֮ǰֲ
+    bool getLatestPreview(cv::Mat& rgb_preview);
+
+    // Statistics
+    uint64_t getDroppedFrameCount() const { return image_ring.dropped(); } // βɼص֡
+    uint64_t getReceivedFrameCount() const { return received_frames.load(std::memory_order_relaxed); } // βɼ֡Դ֡ ()
+    FramePool::Stats getRawPoolStats() const;  // صԭʼõĻ (ɼΪһβɼͳ)
+    FramePool::Stats getBgrPoolStats() const;  // ת BGR ֡õĻ (ͬ)
+    ReorderStats getReorderStats() const;      // ȡȱٵ֡
+    FrameSinkStats getSinkStats() const { return sink_stats; } // һβɼдͳ
+    QueueStats getWriteQueueStats() const { return hdf5_write_queue.stats(); } // дзֵ֡ʱ
+    SpillRing::Stats getSpillStats() const { return spill_ring.stats(); }    //  / صֽ֡
+
+    FrameSource* frameSource() const { return frame_source.get(); }
 
     // Status flag
     bool is_recording;
@@ -35,145 +121,144 @@ public:
 private:
     // ==================== Internal Types ====================
     struct ImageNode {
-        unsigned char* image_data = nullptr;
+        cv::Mat raw;                 // 1 x data_length ԭʼݣ raw_pool 䣬 ImageNode 黹
         uint64_t data_length = 0;
         unsigned int width = 0;
         unsigned int height = 0;
         unsigned int frame_number = 0;
-        MvGvspPixelType pixel_type = PixelType_Gvsp_BayerGB8;
-
-        ~ImageNode() {
-            if (image_data) {
-                free(image_data);
-                image_data = nullptr;
-            }
-        }
+        uint64_t host_timestamp_ns = 0;  // صյ֡ʱ (steady_clock)
+        uint64_t device_timestamp = 0;   // ʱ
+        uint32_t pixel_type = 0;         // PFNC  (SourceFrame::pixel_type)
     };
 
     // +++ ADDED: ½ṹ壬ڴѴáдHDF5֡
     struct ProcessedFrame {
-        cv::Mat frame;       // BGR ʽ cv::Mat
+        cv::Mat frame;       // BGR ʽ cv::Mat (bgr_pool )
         unsigned int frame_number;
+        uint64_t host_timestamp_ns = 0;
+        uint64_t device_timestamp = 0;
+        std::vector<uint8_t> chunk; // ѹʱ߳Ԥѹõ HDF5 
     };
 
-    // (Semaphore class is unchanged)
-    class Semaphore {
-    public:
-        explicit Semaphore(long initial_count = 0) : count(initial_count) {}
-        ~Semaphore() { notifyAll(); }
-
-        void wait() {
-            std::unique_lock<std::mutex> lock(mutex);
-            condition.wait(lock, [&]() { return count > 0; });
-            --count;
-        }
-
-        bool wait(int timeout_seconds) {
-            std::unique_lock<std::mutex> lock(mutex);
-            bool success = condition.wait_for(
-                lock,
-                std::chrono::seconds(timeout_seconds),
-                [&]() { return count > 0; }
-            );
-            if (success) --count;
-            return success;
-        }
-
-        void notify() {
-            std::unique_lock<std::mutex> lock(mutex);
-            ++count;
-            condition.notify_one();
-        }
-
-        void notifyAll() {
-            std::unique_lock<std::mutex> lock(mutex);
-            count = 1;
-            condition.notify_all();
-        }
-
-    private:
-        std::mutex mutex;
-        std::condition_variable condition;
-        long count = 0;
-    };
-
-    ThreadPool* thread_pool;
+    WorkStealingPool* thread_pool;
+    size_t worker_count = 6;   // ʽת߳
+    RecordFormat record_format = RecordFormat::BGR;
+    ColorConversion color_conversion = ColorConversion::MvsSdk;
+    bool write_raw = false;    // βɼʵǷ񱣴ԭʼ (ظʽ֧ʱ˻ BGR)
+    std::string raw_pixel_format; // ǰظʽ (PFNC)д pixel_format 
+    bool pin_workers = false;  // Ƿѹ̰߳󶨵̶߼
     std::thread task_distribution_thread;
 
     void distributeTasksThread();
     // ==================== Camera State ====================
     bool task_stop = false;
     bool is_initialized = false;
-    bool is_saving = false;
-    bool should_exit = false;
-    int nRet;
+    std::atomic<bool> is_saving{ false };
+    std::atomic<uint64_t> received_frames{ 0 };
+    uint64_t frame_limit = 0;
+    std::atomic<bool> should_exit{ false }; // ɼص̶߳ȡԭ
+    std::atomic<bool> writer_should_exit{ false }; // ȫ֪ͨд߳˳
     int frame_counter = 0;
-    unsigned int nImageNodeNum;
     std::string save_folder;
 
     // ==================== Camera Hardware ====================
-    void* camera_handle = nullptr;
-    unsigned char* rgb_buffer = nullptr;
-    unsigned int image_node_count = 200; // Default buffer count
-
-    // ==================== Camera SDK Structures ====================
-    MV_CC_DEVICE_INFO_LIST device_list;
-    MVCC_INTVALUE int_value_params;
-    MV_FRAME_OUT output_frame;
-    MV_CC_PIXEL_CONVERT_PARAM pixel_convert_params;
-    MV_CC_IMAGE image_params;
-    MV_CC_SAVE_IMAGE_PARAM image_save_params;
+    std::unique_ptr<FrameSource> frame_source;
+    SourceFormat source_format;          // startCapture ʱ֡Դȡķֱʺظʽ
 
     // ==================== Threading ====================
     // std::thread save_thread; // <<< CHANGED: ǽ hdf5_writer_thread 滻
     std::thread hdf5_writer_thread; // +++ ADDED: רõHDF5д߳
     std::mutex task_mutex;
-    std::mutex display_mutex;
-    Semaphore image_semaphore;
-    std::vector<std::thread> worker_threads;
-    std::queue<std::function<void()>> task_queue;
-    std::condition_variable task_cv;
+
+    // ==================== Frame Buffer Pools ====================
+    //  startCapture а Width/Height  cv::Mat  ()
+    std::unique_ptr<FramePool> raw_pool;
+    std::unique_ptr<FramePool> bgr_pool;
+    size_t raw_pool_buffers = 64;
+    size_t bgr_pool_buffers = 32;
+    size_t image_ring_frames = 256;
+    FramePool::Stats last_raw_pool_stats;      // ͷǰͳ
+    FramePool::Stats last_bgr_pool_stats;
+    size_t dispatch_batch = 16;
 
     // ==================== Data Structures ====================
-    DataQueue<ImageNode*> image_queue; // L1 (Callback) -> L2 (Distributor) Ķ
-    DataQueue<ProcessedFrame*> hdf5_write_queue; // +++ ADDED: L3 (Pool) -> L4 (HDF5 Writer) Ķ
-    LimitedStack<cv::Mat> display_stack{ 3 };
+    SpscRing<ImageNode*> image_ring{ 256 }; // L1 (Callback) -> L2 (Distributor) Уص̲߳startCapture ʱ image_ring_frames ؽ
+    // L3 (Pool) -> L4 (Writer) ĶУд߳̽ frame_sink
+    // дʱ (Ż / ַ߳)ʱŶ֡֡ disposer ͷŲÿ
+    DataQueue<ProcessedFrame*> hdf5_write_queue{ 128, QueuePolicy::Block,
+        [](ProcessedFrame*& frame) { delete frame; frame = nullptr; }, std::chrono::milliseconds(100) };
+    ReorderBuffer<ProcessedFrame*> reorder_buffer{ 64, std::chrono::milliseconds(500) }; // ߳ -> ɼ˳
+
+    // ==================== Preview ====================
+    int preview_width = 640;
+    int preview_height = 540;
+    int64_t preview_interval_ns = 33333333;        // Լ 30 FPS GUI ˢһ£0 ʾر
+    std::atomic<int64_t> last_preview_ns{ 0 };     // һԤʱ (steady_clock)
+    std::atomic<bool> preview_busy{ false };       // ֤ͬһʱֻһ߳д preview_buffer
+    TripleBuffer<cv::Mat> preview_buffer;          // ߳ -> GUI ̣߳ԭظ
+
+    // ==================== Storage Sink ====================
+    std::unique_ptr<FrameSink> frame_sink; // ǰɼĴ洢ˣstartCapture ʱ sink_type 
+    SinkType sink_type = SinkType::Hdf5;
+    H5FrameWriter::Options h5_write_options;
+    FrameLogSink::Options frame_log_options;
+    SegmentPolicy segment_policy;
+    ThrottledSink::Options sink_throttle;
+    FrameObserver frame_observer;
+    TimestampAligner timestamp_aligner;
+    FrameSinkStats sink_stats;
+    bool compress_frames = false;       // βɼǷڹ߳Ԥѹ (sink ѹʱ)
+    std::mutex sink_mutex;              //  sink Ĵ򿪺͹ر
+
+    // ==================== Spill ====================
+    SpillRing::Options spill_options;
+    SpillRing spill_ring;               //  sink һ򿪺͹ر
+    std::mutex spill_mutex;             // л "лǽ" жϺд룬֤˳
 
-    // ==================== HDF5 Members ====================
-    std::unique_ptr<H5::H5File> h5_file; // +++ ADDED: HDF5 ļ
-    H5::DataSet h5_rgb_dataset;         // +++ ADDED: HDF5 ͼݼ
-    hsize_t h5_rgb_dims[4];             // +++ ADDED: ͼݼά
-    std::mutex h5_mutex;                // +++ ADDED: HDF5ļҪڿʱ
+    // ==================== Release ====================
+    // Żֻѷе֡ǽ outbox֮ / ٵд̲Ῠס߳
+    std::deque<ProcessedFrame*> release_outbox;
+    std::mutex outbox_mutex;            //  release_outbox
+    std::mutex release_mutex;           // ͬһʱֻһ̰߳ outbox֤˳
 
     // ==================== Private Methods ====================
     // Initialization
     void initializeInternalParameters();
-    bool initializeCameraSDK();
-    bool enumerateAndSelectCamera();
-    bool allocateImageBuffers();
-    bool configureCameraSettings();
 
     // Resource management
-    void cleanupResources();
     void clearImageQueue();
     void clearHDF5Queue();
 
     // Thread functions
-    static void imageCallback(unsigned char* image_data, MV_FRAME_OUT_INFO_EX* frame_info, void* user_data);
+    void onSourceFrame(const SourceFrame& frame);     // ֡Դ߳ϵãԭʼݣ image_ring
 
     // <<< CHANGED: ̳߳ص
     void processAndQueueFrame(ImageNode* image_node); // +++ ADDED
+    bool convertToBgr(ImageNode* image_node, cv::Mat& bgr_frame);
+    void queueRawFrame(ImageNode* image_node);        // ԭʼģʽתֱӽд
+    bool claimPreview();                              // һԤһûԤʱ true
+    void publishPreview(const cv::Mat& frame);        // BGR ԭʼ -> Ԥ RGB888 preview_buffer ( claimPreview)
 
     // <<< REPLACED: ɵı溯 ( .cpp б processAndQueueFrame 滻)
     // void processAndSaveImage(ImageNode* image_node); 
 
-    // +++ ADDED: HDF5 д̵߳ѭ
+    // д̵߳ѭ (hdf5_write_queue -> frame_sink)
     void hdf5WriteLoop();
+    void releaseToWriter(ProcessedFrame*& frame);
+    void stageRelease(ProcessedFrame*& frame);    // reorder_buffer  emitǽ release_outbox
+    bool popRelease(ProcessedFrame*& frame);
+    void clearReleases();
+    void drainReleases();                         // ֮ãoutbox -> д / 
+    void writeExpired();                          // д̣߳泬ʱȱڣеֱ֡д
+    void writeFrame(ProcessedFrame* frame);
+    bool spillFrame(ProcessedFrame* frame);
+    size_t restoreSpilled(size_t max_frames);     // д̣߳˳де֡д֡
 
     // +++ ADDED: HDF5 
-    bool initializeHDF5(const std::string& base_path);
-    void extendAndWriteHDF5(ProcessedFrame* frame);
-    void closeHDF5();
+    bool createFramePools();
+    void releaseFramePools();
+    bool openSink(const std::string& base_path);
+    void closeSink();
 
     // Disallow copying
     RGB(const RGB&) = delete;
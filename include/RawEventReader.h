@@ -0,0 +1,104 @@
+#ifndef RAWEVENTREADER_H
+#define RAWEVENTREADER_H
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// ߶ȡ DVS::start ¼Ƶ .raw ļ (Prophesee EVT 2.0 / EVT 3.0) Metavision SDK Ľ
+//
+// open ʱ˳ɨһļÿ block_bytes ֽڼ¼һ飺Ľ״̬ (ʱλEVT3  /  / )
+// ֮ǰ¼¼С / ʱ״̬ÿ鶼Զ룬
+//   - readAll ö̷ֿ߳룬ֱдĶӦλ
+//   - eventsBetween(t0, t1) ֲҵһ / һڷΧڵĿ (O(log n))ֻЩٰʱ
+//  <file>.idx (sidecar)ļС / С / ʽһʱֱӼأɨ裻Ŀ¼дʱֻڴС
+// ʱ SDK ķʽ (EVT2 Լ 4.7 СʱEVT3 Լ 16.7 )һʱλ֮ǰ¼
+// ֻ CD ¼ⲿ¼ (¼ʱ TriggerIndex д HDF5)
+class RawEventReader {
+public:
+    enum class Format {
+        Unknown,
+        Evt2,
+        Evt3,
+    };
+
+    struct Options {
+        size_t block_bytes = (size_t)1 << 20;  // ȣҲǲнĵλ
+        int threads = 0;                       // 0 ʾ hardware_concurrency
+        bool use_sidecar = true;               // ȡ / д <file>.idx
+    };
+
+    // Ľ״̬ (ָʽãEVT2 ֻõ time_high)
+    struct DecoderState {
+        int64_t time_high = 0;   // ʱλ (us)
+        uint16_t time_low = 0;   // EVT3 ʱ 12 λ
+        uint16_t y = 0;          // EVT3 ǰ
+        uint16_t base_x = 0;     // EVT3 ¼ʼ
+        uint8_t polarity = 0;    // EVT3 ¼ļ
+        uint8_t started = 0;     // Ѿʱλ
+    };
+
+    struct Block {
+        uint64_t offset = 0;         // ֽƫ
+        uint64_t bytes = 0;
+        uint64_t first_event = 0;    // ֮ǰп¼
+        uint64_t events = 0;
+        int64_t t_min = INT64_MAX;   // ¼ʱ䷶Χ (û¼ʱֳֵ)
+        int64_t t_max = INT64_MIN;
+        DecoderState state;
+    };
+
+    RawEventReader() = default;
+    explicit RawEventReader(const Options& options) : options(options) {}
+
+    // ļͷػʧʱӡԭ򲢷 false
+    bool open(const std::string& path);
+    void close();
+    bool isOpen() const { return format_ != Format::Unknown; }
+
+    Format format() const { return format_; }
+    static const char* formatName(Format format);
+    int width() const { return width_; }
+    int height() const { return height_; }
+    uint64_t eventCount() const { return event_count; }
+    int64_t firstTimestamp() const { return event_count > 0 ? suffix_min.front() : 0; }
+    int64_t lastTimestamp() const { return event_count > 0 ? prefix_max.back() : 0; }
+    const std::vector<Block>& index() const { return blocks; }
+    bool indexLoaded() const { return index_loaded; }   //  sidecar (ûɨ)
+
+    // ȫ CD ¼ļ˳
+    bool readAll(std::vector<Metavision::EventCD>& out) const;
+    // t0 <= t < t1  CD ¼ļ˳
+    bool eventsBetween(int64_t t0, int64_t t1, std::vector<Metavision::EventCD>& out) const;
+    // 뵥飬׷ӵ out
+    bool readBlock(size_t block, std::vector<Metavision::EventCD>& out) const;
+
+private:
+    bool parseHeader(std::FILE* file);
+    bool buildIndex(std::FILE* file);
+    bool loadSidecar(const std::string& path);
+    void saveSidecar(const std::string& path) const;
+    void finishIndex();
+    // н [first, last] 鵽 out (out Ѱ¼ã blocks[first].first_event ʼ)
+    bool decodeBlocks(size_t first, size_t last, Metavision::EventCD* out) const;
+    bool decodeBlock(std::FILE* file, const Block& block, std::vector<uint8_t>& buffer, Metavision::EventCD* out) const;
+    int threadCount(size_t blocks) const;
+
+    Options options;
+    std::string path_;
+    Format format_ = Format::Unknown;
+    int width_ = 0;
+    int height_ = 0;
+    uint64_t data_offset = 0;     // ļͷ֮һֽ
+    uint64_t file_size = 0;
+    uint64_t event_count = 0;
+    bool index_loaded = false;
+    std::vector<Block> blocks;
+    std::vector<int64_t> prefix_max;   // max(t_max[0..i])һ t >= t0 Ŀ
+    std::vector<int64_t> suffix_min;   // min(t_min[i..])һ t < t1 Ŀ
+};
+
+#endif // RAWEVENTREADER_H
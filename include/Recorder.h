@@ -0,0 +1,104 @@
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "DVS.h"
+#include "PipelineConfig.h"
+#include "RGB.h"
+#include "Uno.h"
+
+// ޽¼ƣ GUI ͬ DVS + RGB +  ߣ QtԤ / ʾ֡
+//
+// start ˳ GUI::start ͬ (DVS -> RGB -> )stop  GUI::stoprecord ͬ ( -> DVS -> RGB)
+//  RGB ֡ŵĶӦϵʱӶ붼ճ
+// <dvs_root>/<dataset>/ (.rawdvs_events.h5)  <rgb_root>/<dataset>/ (rgb_data.h5  rgb_frames.dcfl)
+// ֶ¼ʱд segment_directories
+class Recorder {
+public:
+    struct Options {
+        std::string dataset;
+        std::string rgb_root = ".";
+        std::string dvs_root = ".";
+
+        // RGB
+        RGB::RecordFormat rgb_format = RGB::RecordFormat::BGR;
+        RGB::SinkType rgb_sink = RGB::SinkType::Hdf5;
+        SegmentPolicy segments;                         // DVS ʹ max_frames
+        uint64_t max_frames = 0;                        // ֻ¼֡Դǰ N ֡ (ص˶)0 ʾ
+
+        // DVS
+        DVS::RecordFormat dvs_format = DVS::RecordFormat::RawAndHdf5;
+
+        // trigger Ϊ false ʱ򿪴 (ⲿźԴ)
+        bool trigger = true;
+        UNO::Options trigger_options;
+
+        // ϳԴ (ûʱ֤ߺʹ)RGB Ϊ SyntheticFrameSourceDVS Ϊ SyntheticEventSource
+        bool synthetic = false;
+        double synthetic_fps = 30;
+        uint32_t synthetic_width = 1280;
+        uint32_t synthetic_height = 1024;
+        double synthetic_event_rate = 1.0;              // Mev/s
+
+        // ߳ / ȡСԤʾ֡òʹ (޽¼ǹر)
+        PipelineConfig pipeline;
+    };
+
+    // һ¼ƵĽwriteJson ΪɶժҪ
+    struct Summary {
+        std::string dataset;
+        double seconds = 0;
+        uint64_t rgb_received = 0;       // ֡Դ֡
+        uint64_t rgb_frames = 0;         // д֡
+        uint64_t rgb_dropped = 0;        // ص + д + ֡
+        uint64_t rgb_bytes = 0;          // ԭʼֽ
+        uint64_t rgb_stored_bytes = 0;   // ʵдֽ
+        uint64_t rgb_errors = 0;
+        uint64_t dvs_events = 0;         // ¼Դ¼
+        uint64_t dvs_dropped = 0;        // dvs_events.h5 дж¼
+        uint64_t dvs_bytes = 0;          // .raw + dvs_events.h5 ļС
+        bool trigger_acked = false;
+        double trigger_latency_ms = -1;  //  -> һ壬δ֪Ϊ -1
+        uint32_t trigger_pulses = 0;
+        uint64_t clock_pairs = 0;
+        double clock_residual_us = -1;   // 豸ʱϵĲвδΪ -1
+
+        // ķֵռãPipelineTuner ݴȷ
+        size_t raw_pool_peak = 0;
+        size_t bgr_pool_peak = 0;
+        uint64_t pool_fallbacks = 0;     // غľ˻ضѷĴ
+        size_t write_queue_peak = 0;
+        size_t reorder_peak = 0;
+        uint64_t reorder_gaps = 0;
+        size_t dvs_queue_peak = 0;       // dvs_events.h5 д ()
+
+        double rgbMegabytesPerSecond() const { return seconds > 0 ? rgb_stored_bytes / 1e6 / seconds : 0; }
+        bool ok() const { return rgb_errors == 0 && rgb_frames > 0; }
+        bool writeJson(FILE* out) const;
+    };
+
+    explicit Recorder(const Options& options);
+    ~Recorder();
+
+    bool start();
+    void stop();
+    bool isRunning() const { return running; }
+    double elapsedSeconds() const;
+    uint64_t rgbFramesReceived() const { return rgb->getReceivedFrameCount(); }
+    //  max_frames ֡ԴѾô֮֡֡ٽ
+    bool frameLimitReached() const { return options.max_frames > 0 && rgbFramesReceived() >= options.max_frames; }
+    Summary summary() const { return summary_; }   // stop ֮Ч
+
+private:
+    Options options;
+    std::unique_ptr<DVS> dvs;
+    std::unique_ptr<RGB> rgb;
+    std::unique_ptr<UNO> uno;
+    bool running = false;
+    uint64_t start_ns = 0;
+    Summary summary_;
+};
+
+#endif // RECORDER_H
@@ -0,0 +1,200 @@
+#ifndef REORDERBUFFER_H
+#define REORDERBUFFER_H
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <utility>
+
+struct ReorderStats {
+    size_t depth = 0;          // ǰѾȴ׵֡
+    size_t max_depth = 0;      // depth ķֵ
+    size_t outstanding = 0;    // ѵǼǡδɵ֡
+    uint64_t released = 0;     // Ѱе֡
+    uint64_t gaps = 0;         // 涪ʧ֡ (תʧ /  / ʱ)
+    uint64_t late = 0;         // 涪ʧŵ֡
+};
+
+// ŵн绺
+// ߳˳ɣౣ֤ϸ񰴲ɼ˳
+//   1. ַ̰߳ɼ˳ expect(seq) Ǽÿһ֡ (Ѷ֡Ǽǣ˲ᱻȴ)
+//   2. ߳ɺ insert(seq, value, emit)תʧ skip(seq, emit)
+//   3. ׵֡һͬ֡һͨ emit 
+// ׳ٳٲʱգΪȱ (gap) к֡
+//   - Ѿ֡ window ֡
+//   - 类֡ѵȴ gap_timeout ( flushExpired ڼ)
+// Ϊȱ֮ŵ֡ǳٵ֡insert  falseɵ÷ͷš
+// emit ڲڵã֤̲߳ insert ʱ˳ҡ
+template <typename T>
+class ReorderBuffer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    using Stats = ReorderStats;
+
+    explicit ReorderBuffer(size_t window = 64, std::chrono::milliseconds gap_timeout = std::chrono::milliseconds(500))
+        : window(window == 0 ? 1 : window), gap_timeout(gap_timeout) {}
+
+    void configure(size_t new_window, std::chrono::milliseconds new_gap_timeout)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        window = new_window == 0 ? 1 : new_window;
+        gap_timeout = new_gap_timeout;
+    }
+
+    // ̵ַ߳ãseq ϸ򷵻 false (֡)
+    bool expect(uint64_t seq)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        if (has_last && seq <= last_expected) return false;
+        slots.push_back(Slot{ seq });
+        last_expected = seq;
+        has_last = true;
+        return true;
+    }
+
+    template <class Emit>
+    bool insert(uint64_t seq, T value, Emit&& emit)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        Slot* slot = find(seq);
+        if (!slot || slot->state != SlotState::Waiting) {
+            stats_.late++;
+            return false;
+        }
+        slot->state = SlotState::Ready;
+        slot->value = std::move(value);
+        slot->ready_time = Clock::now();
+        depth++;
+        stats_.max_depth = std::max(stats_.max_depth, depth);
+
+        drain(emit);
+        if (depth > window) {
+            declareHeadGaps();
+            drain(emit);
+        }
+        return true;
+    }
+
+    template <class Emit>
+    void skip(uint64_t seq, Emit&& emit)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        Slot* slot = find(seq);
+        if (!slot || slot->state != SlotState::Waiting) return;
+        slot->state = SlotState::Skipped;
+        drain(emit);
+    }
+
+    // д߳ڿʱãõ֡ȴ gap_timeout ʱȱ
+    template <class Emit>
+    void flushExpired(Emit&& emit)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        if (depth == 0) return;
+        for (const Slot& slot : slots) {
+            if (slot.state != SlotState::Ready) continue;
+            if (Clock::now() - slot.ready_time > gap_timeout) {
+                declareHeadGaps();
+                drain(emit);
+            }
+            return;
+        }
+    }
+
+    // ֹͣʱãй̶߳ѽδ֡ȫΪȱڣѾİ
+    template <class Emit>
+    void flushAll(Emit&& emit)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        while (!slots.empty()) {
+            declareHeadGaps();
+            drain(emit);
+        }
+    }
+
+    // ȫ (Ѿ֡ dispose ͷ)
+    template <class Dispose>
+    void clear(Dispose&& dispose)
+    {
+        std::lock_guard<std::mutex> lk(m);
+        for (Slot& slot : slots) {
+            if (slot.state == SlotState::Ready) dispose(slot.value);
+        }
+        slots.clear();
+        depth = 0;
+        has_last = false;
+        stats_ = Stats();
+    }
+
+    Stats stats() const
+    {
+        std::lock_guard<std::mutex> lk(m);
+        Stats s = stats_;
+        s.depth = depth;
+        s.outstanding = 0;
+        for (const Slot& slot : slots) {
+            if (slot.state == SlotState::Waiting) s.outstanding++;
+        }
+        return s;
+    }
+
+private:
+    enum class SlotState { Waiting, Ready, Skipped };
+
+    struct Slot {
+        uint64_t seq = 0;
+        SlotState state = SlotState::Waiting;
+        T value{};
+        Clock::time_point ready_time{};
+    };
+
+    Slot* find(uint64_t seq)
+    {
+        auto it = std::lower_bound(slots.begin(), slots.end(), seq,
+            [](const Slot& slot, uint64_t s) { return slot.seq < s; });
+        if (it == slots.end() || it->seq != seq) return nullptr;
+        return &*it;
+    }
+
+    // Ѷδ֡Ϊȱ
+    void declareHeadGaps()
+    {
+        for (Slot& slot : slots) {
+            if (slot.state == SlotState::Ready) break;
+            if (slot.state == SlotState::Waiting) slot.state = SlotState::Skipped;
+        }
+    }
+
+    template <class Emit>
+    void drain(Emit& emit)
+    {
+        while (!slots.empty()) {
+            Slot& head = slots.front();
+            if (head.state == SlotState::Waiting) break;
+            if (head.state == SlotState::Ready) {
+                depth--;
+                stats_.released++;
+                emit(head.value);
+            }
+            else {
+                stats_.gaps++;
+            }
+            slots.pop_front();
+        }
+    }
+
+    mutable std::mutex m;
+    std::deque<Slot> slots;     //  seq 
+    size_t depth = 0;
+    size_t window;
+    std::chrono::milliseconds gap_timeout;
+    uint64_t last_expected = 0;
+    bool has_last = false;
+    Stats stats_;
+};
+
+#endif // REORDERBUFFER_H
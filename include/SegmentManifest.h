@@ -0,0 +1,53 @@
+#ifndef SEGMENTMANIFEST_H
+#define SEGMENTMANIFEST_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "FrameSink.h"
+
+// ֶ¼
+// ʱɼ֡ / ֽ / ʱгɶļдͬĿ¼ (ͬĴ)
+// ݼĿ¼µ嵥ļ (rgb_manifest.json / dvs_manifest.json) ˳гзֶΣ
+// ȡ˾ݴ˰ƴһ¼ơ
+
+// жһﵽеһΣΪ 0 ֻһĿ¼ʱֶ
+struct SegmentPolicy {
+    uint64_t max_frames = 0;        // ÿ֡ (DVS )
+    uint64_t max_bytes = 0;         // ÿֽ (RGB ԭʼֽڣDVS  .raw ļС)
+    double max_seconds = 0;         // ÿʱ
+    // дĸĿ¼ÿĿ¼һд̣߳ļ <Ŀ¼>/<ݼ>/ ¡
+    // ΪʱȫдݼĿ¼
+    std::vector<std::string> directories;
+
+    bool enabled() const { return max_frames > 0 || max_bytes > 0 || max_seconds > 0 || directories.size() > 1; }
+};
+
+struct SegmentInfo {
+    uint32_t index = 0;
+    std::string path;                   // ݼĿ¼ʱΪ·Ϊ·
+    uint64_t first_frame = 0;           // εһ֡¼е (DVS Ϊ 0)
+    uint64_t frames = 0;
+    uint64_t bytes = 0;
+    uint64_t first_host_timestamp_ns = 0;
+    uint64_t last_host_timestamp_ns = 0;
+    bool closed = false;                // رգһΪ false ˵ɼж
+};
+
+struct SegmentManifest {
+    std::string stream;                 // "rgb" / "dvs"
+    std::string file_name;              // ֶʱļ (rgb_data.h5 / rgb_frames.dcfl / <name>.raw)
+    FrameFormat format;
+    std::vector<SegmentInfo> segments;
+    bool complete = false;              // ɼзֶζر
+};
+
+// base_name Ϊ rgb_data.h5 ʱ 3 Ϊ rgb_data_00003.h5
+std::string segmentFileName(const std::string& base_name, uint32_t index);
+
+// дʱļˢٸ;ʱ嵥һε汾
+bool writeSegmentManifest(const std::string& path, const SegmentManifest& manifest);
+// ·ᰴ嵥Ŀ¼չ
+bool readSegmentManifest(const std::string& path, SegmentManifest& manifest);
+
+#endif // SEGMENTMANIFEST_H
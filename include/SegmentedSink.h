@@ -0,0 +1,101 @@
+#ifndef SEGMENTEDSINK_H
+#define SEGMENTEDSINK_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "FrameSink.h"
+#include "SegmentManifest.h"
+
+// ֶ¼Ƶ sink֡ SegmentPolicy гɶΣ factory  sink д
+//   -  i д policy.directories[i % n]ÿĿ¼Լд̺߳нУ
+//     һλд / رʱһѾһϿʼдĿ¼
+//   - write ֻ֡ (ͬ owner) ŽĿ̵߳ĶУأrecord.owner Ϊʱſһ
+//   - ÿοʼ / رһζд嵥 (<stream>_manifest.json)close ʱ complete
+// ʱ write ѹ hdf5_write_queue
+//  sink ڸԵĿ߳ϴдͬĿ¼ sink ͬʱУ sink ʵʹá
+// H5FrameSink ÿڶ h5Mutex (H5Lock.h) HDF5 HDF5 Ŀ¼ڿǴеģ
+// еֻиĿ¼ԼŶӺ͹رա
+class SegmentedSink : public FrameSink {
+public:
+    using Factory = std::function<std::unique_ptr<FrameSink>()>;
+
+    // stream Ϊ嵥ǰ׺ ("rgb")queue_frames ΪÿĿ߳Ŷӵ֡
+    SegmentedSink(const std::string& stream, Factory factory, const SegmentPolicy& policy, size_t queue_frames = 16);
+    ~SegmentedSink() override;
+
+    // file_path Ϊ嵥·ݼĿ¼ȡĿ¼
+    bool openFile(const std::string& file_path, const FrameFormat& format) override;
+    bool write(const FrameRecord& record) override;
+    bool close() override;
+
+    const char* name() const override { return label.c_str(); }
+    const char* fileName() const override { return manifest_name.c_str(); }
+    FrameSinkStats stats() const override;
+    bool acceptsCompressedChunks() const override { return accepts_chunks; }
+
+    SegmentManifest manifest() const;
+
+private:
+    struct Item {
+        enum class Kind { Open, Frame, Close };
+        Kind kind = Kind::Frame;
+        uint32_t segment = 0;
+        std::string path;
+        FrameRecord record;
+    };
+
+    struct Target {
+        std::string directory;
+        std::thread thread;
+        std::mutex m;
+        std::condition_variable cv;
+        std::deque<Item> items;
+        size_t queued_frames = 0;
+        bool stop = false;
+    };
+
+    void targetLoop(Target& target);
+    void push(Target& target, Item&& item);
+    void startSegment(uint64_t timestamp_ns);
+    void finishSegment();
+    void segmentClosed(uint32_t segment, bool ok, const FrameSinkStats& segment_stats);
+    bool saveManifest();
+    void stopTargets();
+
+    Factory factory;
+    SegmentPolicy policy;
+    size_t queue_frames;
+    std::string stream;
+    std::string label;
+    std::string manifest_name;
+    std::string child_file_name;
+    bool accepts_chunks = false;
+
+    std::string base_path;
+    std::string manifest_path;
+    FrameFormat format;
+    std::vector<std::unique_ptr<Target>> targets;
+    bool is_open = false;
+
+    // ֻɵ write ߳޸
+    bool segment_open = false;
+    uint32_t segment_index = 0;
+    uint64_t segment_frames = 0;
+    uint64_t segment_bytes = 0;
+    uint64_t segment_start_ns = 0;
+    uint64_t total_frames = 0;
+    uint64_t total_bytes = 0;
+    uint64_t size_mismatches = 0;       // СʽûнĿ̵߳֡ ( errors)
+
+    mutable std::mutex manifest_mutex;  //  manifest_  closed_statsĿ߳ڹرշֶʱ
+    SegmentManifest manifest_;
+    FrameSinkStats closed_stats;
+};
+
+#endif // SEGMENTEDSINK_H
@@ -0,0 +1,50 @@
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+//  mutex + condition_variable ļź
+// (ԭ RGB ڲ࣬ɼص SpscRing Ƴbenchmark Ϊʹ)
+class Semaphore {
+public:
+    explicit Semaphore(long initial_count = 0) : count(initial_count) {}
+    ~Semaphore() { notifyAll(); }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(mutex);
+        condition.wait(lock, [&]() { return count > 0; });
+        --count;
+    }
+
+    bool wait(int timeout_seconds) {
+        std::unique_lock<std::mutex> lock(mutex);
+        bool success = condition.wait_for(
+            lock,
+            std::chrono::seconds(timeout_seconds),
+            [&]() { return count > 0; }
+        );
+        if (success) --count;
+        return success;
+    }
+
+    void notify() {
+        std::unique_lock<std::mutex> lock(mutex);
+        ++count;
+        condition.notify_one();
+    }
+
+    void notifyAll() {
+        std::unique_lock<std::mutex> lock(mutex);
+        count = 1;
+        condition.notify_all();
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable condition;
+    long count = 0;
+};
+
+#endif // SEMAPHORE_H
@@ -0,0 +1,86 @@
+#ifndef SMALLTASK_H
+#define SMALLTASK_H
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// ֻƶ void() ɵö󣬲״ֱ̬Ӵڶڲ (kInlineSize ֽ)
+//  std::function ͬʱӲڶϷ䣻񳬹 kInlineSize  lambda ڱڱ
+// ʱӦΪһָ롣
+class SmallTask {
+public:
+    static constexpr size_t kInlineSize = 48;
+
+    SmallTask() noexcept = default;
+
+    template <class F, class Fn = std::decay_t<F>,
+              class = std::enable_if_t<!std::is_same<Fn, SmallTask>::value>>
+    SmallTask(F&& f)
+    {
+        static_assert(sizeof(Fn) <= kInlineSize, "SmallTask: captured state is too large, capture a pointer instead");
+        static_assert(alignof(Fn) <= alignof(std::max_align_t), "SmallTask: over-aligned callable");
+        static_assert(std::is_nothrow_move_constructible<Fn>::value, "SmallTask: callable must be nothrow movable");
+        new (storage) Fn(std::forward<F>(f));
+        ops = &opsFor<Fn>;
+    }
+
+    SmallTask(SmallTask&& other) noexcept { moveFrom(other); }
+
+    SmallTask& operator=(SmallTask&& other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    SmallTask(const SmallTask&) = delete;
+    SmallTask& operator=(const SmallTask&) = delete;
+
+    ~SmallTask() { reset(); }
+
+    void operator()() { ops->invoke(storage); }
+    explicit operator bool() const noexcept { return ops != nullptr; }
+
+    void reset() noexcept
+    {
+        if (ops) {
+            ops->destroy(storage);
+            ops = nullptr;
+        }
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void*);
+        void (*move)(void* dst, void* src) noexcept;
+        void (*destroy)(void*) noexcept;
+    };
+
+    template <class Fn>
+    static void invokeImpl(void* p) { (*static_cast<Fn*>(p))(); }
+    template <class Fn>
+    static void moveImpl(void* dst, void* src) noexcept { new (dst) Fn(std::move(*static_cast<Fn*>(src))); }
+    template <class Fn>
+    static void destroyImpl(void* p) noexcept { static_cast<Fn*>(p)->~Fn(); }
+
+    template <class Fn>
+    static constexpr Ops opsFor = { &invokeImpl<Fn>, &moveImpl<Fn>, &destroyImpl<Fn> };
+
+    void moveFrom(SmallTask& other) noexcept
+    {
+        if (other.ops) {
+            other.ops->move(storage, other.storage);
+            ops = other.ops;
+            other.reset();
+        }
+    }
+
+    alignas(std::max_align_t) unsigned char storage[kInlineSize];
+    const Ops* ops = nullptr;
+};
+
+#endif // SMALLTASK_H
@@ -0,0 +1,97 @@
+#ifndef SPILLRING_H
+#define SPILLRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "FrameSink.h"
+
+// д֮㣺д̸ʱ֡ԭ׷ӵʱϵڴӳ价ļ
+// д߳׷Ϻٰ˳أ֤֡ڴռޡ
+//
+// ʹԼ ( hdf5_write_queue )
+//   -  (ͬһʱֻһ)  shouldSpill(г) Ϊ true ʱ appendճӡ
+//     ֻҪл֡֡ͼ֤е֡һڴ
+//   -  (д߳) ȡڴУٰ˳ front / pop е֡
+// front ص FrameRecord ֱָӳڴ (owner Ϊ) pop ֮ǰЧ
+//
+// ļʽcapacity ֽڵĻÿ¼ = 64 ֽͷ +  + ѹ (԰ 64 ֽڶ)
+// ¼ԽļĩβŲʱдһƱǴͷʼļֻڱβɼʹãclose ʱɾ
+class SpillRing {
+public:
+    struct Options {
+        std::string directory;                 // ʱĿ¼Ϊձʾ
+        uint64_t capacity_bytes = 4ull << 30;  // ļС
+        size_t high_water_frames = 32;         // ڴдﵽô֡ʼ
+        int wait_ms = -1;                      // ʱȴã֮֡< 0 һֱȵпռ (ѹ)
+    };
+
+    struct Stats {
+        uint64_t spilled = 0;      // д뻷֡
+        uint64_t restored = 0;     // ӻص֡
+        uint64_t dropped = 0;      // ȴʱ֡
+        uint64_t bytes = 0;        // д뻷ֽ (¼ͷͶ)
+        uint64_t peak_bytes = 0;   // ͬʱڵֽ
+        uint64_t wait_ns = 0;      // ߵȴռۼʱ
+    };
+
+    SpillRing() = default;
+    ~SpillRing();
+
+    SpillRing(const SpillRing&) = delete;
+    SpillRing& operator=(const SpillRing&) = delete;
+
+    bool open(const Options& options);
+    void close();  // ӳ䲢ɾļʣ֡һ
+    bool isOpen() const { return base != nullptr; }
+    const std::string& path() const { return file_path; }
+
+    bool shouldSpill(size_t queued_frames) const
+    {
+        return isOpen() && (records() > 0 || queued_frames >= options.high_water_frames);
+    }
+
+    // ---------- ߶ ----------
+    //  record.data  record.data_bytes ֽں record.chunkʱȴ wait_ms (< 0 ʱ)
+    // ʱ¼ʱ false ( dropped)
+    bool append(const FrameRecord& record);
+
+    // ---------- ߶ ----------
+    uint64_t records() const { return record_count.load(std::memory_order_acquire); }
+    bool front(FrameRecord& record);
+    void pop();
+
+    Stats stats() const;
+
+private:
+    uint64_t freeBytes() const;
+    void release(uint64_t from, uint64_t to);  // Ѷҳ (дش)
+    void flushRange(uint64_t offset, uint64_t bytes);
+
+    Options options;
+    std::string file_path;
+    uint8_t* base = nullptr;
+    uint64_t capacity = 0;
+#if defined(_WIN32)
+    void* file_handle = nullptr;
+    void* mapping_handle = nullptr;
+#else
+    int fd = -1;
+#endif
+
+    // ߼ƫƣλ = offset % capacity
+    alignas(64) std::atomic<uint64_t> tail{ 0 };  // д
+    alignas(64) std::atomic<uint64_t> head{ 0 };  // д
+    std::atomic<uint64_t> record_count{ 0 };
+    uint64_t front_bytes = 0;                     // ߣǰ front ¼ĳ
+
+    std::atomic<uint64_t> spilled{ 0 };
+    std::atomic<uint64_t> restored{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<uint64_t> spilled_bytes{ 0 };
+    std::atomic<uint64_t> peak_bytes{ 0 };
+    std::atomic<uint64_t> wait_ns{ 0 };
+};
+
+#endif // SPILLRING_H
@@ -0,0 +1,127 @@
+#ifndef SPSCRING_H
+#define SPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// /н绷ζ
+//  MVS ɼص () -> ַ߳ () ֮Ľӣ
+//   - try_push ޵ȴʱ false 붪֡
+//   - ߺ߸ԵڶĻУα
+//   - ±ͨ & mask õȡΪ 2 
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(size_t capacity)
+        : capacity_(roundUpPow2(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          slots_(new T[capacity_]) {}
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // ---------- ߶ ----------
+    bool try_push(const T& value)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ >= capacity_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail - cached_head_ >= capacity_) {
+                mark_dropped();
+                return false;
+            }
+        }
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ڷ/֮֡ǰȼ飬˾Ͳ˷һ malloc + memcpy
+    bool full()
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ < capacity_) return false;
+        cached_head_ = head_.load(std::memory_order_acquire);
+        return tail - cached_head_ >= capacity_;
+    }
+
+    // ֻߵã load + store  fetch_add
+    void mark_dropped()
+    {
+        dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    // ---------- ߶ ----------
+    bool try_pop(T& value)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) return false;
+        }
+        value = std::move(slots_[head & mask_]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // ---------- ͳ (ֵ̣߳) ----------
+    bool empty() const { return size() == 0; }
+    size_t size() const
+    {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+    size_t capacity() const { return capacity_; }
+    uint64_t pushed() const { return tail_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+    // ֻߺ߶ֹͣʱ
+    void reset()
+    {
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_relaxed);
+        cached_head_ = 0;
+        cached_tail_ = 0;
+        dropped_.store(0, std::memory_order_relaxed);
+    }
+
+    // ͬϣΪ capacity (ȡΪ 2 ݣ뵱ǰͬʱ·)
+    void reset(size_t capacity)
+    {
+        const size_t rounded = roundUpPow2(capacity < 2 ? 2 : capacity);
+        if (rounded != capacity_) {
+            slots_.reset(new T[rounded]);
+            capacity_ = rounded;
+            mask_ = rounded - 1;
+        }
+        reset();
+    }
+
+private:
+    static constexpr size_t kCacheLine = 64;
+
+    static size_t roundUpPow2(size_t v)
+    {
+        size_t p = 1;
+        while (p < v) p <<= 1;
+        return p;
+    }
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<T[]> slots_;
+
+    // ߶ռĻ
+    alignas(kCacheLine) std::atomic<size_t> head_{ 0 };
+    size_t cached_tail_ = 0;
+
+    // ߶ռĻ
+    alignas(kCacheLine) std::atomic<size_t> tail_{ 0 };
+    size_t cached_head_ = 0;
+    std::atomic<uint64_t> dropped_{ 0 };
+};
+
+#endif // SPSCRING_H
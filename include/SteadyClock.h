@@ -0,0 +1,15 @@
+#ifndef STEADYCLOCK_H
+#define STEADYCLOCK_H
+
+#include <chrono>
+#include <cstdint>
+
+// ʱ (steady_clock) ĵǰʱ̣λ ns
+// ֡¼ host_timestamp_nsʱֶֹ̡ʱ䶼ͬһڿֱȽ
+inline uint64_t steadyNowNs()
+{
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+#endif // STEADYCLOCK_H
@@ -0,0 +1,96 @@
+#ifndef SYNTHETICEVENTSOURCE_H
+#define SYNTHETICEVENTSOURCE_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "EventSource.h"
+
+// ϳ¼ԴԼ߳ϰ趨¼ EventCDҪκλѹ¼ߡ
+//
+// ¼ buffer_events һͳʱ¼ʾȵ (΢룬)
+// real_time Ϊ true ʱǽӽ (ÿһ¼ʱ̲ͳ)ٶɡ
+// ԤȰռֲһűѭʹã·ֻвƽƺдʱ߳̿ɴʮ Mev/s
+//   - Uniformȷֲ
+//   - Gaussian (center_x, center_y) Ϊġ׼ sigma ĸ˹ߣ speed_px_s ˮƽƶ
+//   - MovingEdge sigma ֱ speed_px_s ɨ (ǰ ON OFF)ӽʵ¼ֲ
+// trigger_hz > 0 ʱͬʱⲿ ( p = 1ռձ trigger_duty)ÿ CD ص֮ͳһʱ䷶Χڵıأ
+// ģⴥص CD ص
+class SyntheticEventSource : public EventSource {
+public:
+    enum class Distribution {
+        Uniform,
+        Gaussian,
+        MovingEdge,
+    };
+
+    struct Options {
+        int width = 1280;
+        int height = 720;
+        double rate_mev_s = 1.0;           // ¼ (¼ / 룬¼ʱ)
+        Distribution distribution = Distribution::Uniform;
+        double sigma = 40;                 // Gaussian ı׼ / MovingEdge ı߿ ()
+        double speed_px_s = 200;           //  / ߵƶٶ ( / )
+        size_t buffer_events = 4096;       // ÿλص¼
+        bool real_time = true;
+        uint64_t max_events = 0;           // ͳô¼ֹͣ0 ʾ
+        uint32_t seed = 1;
+        double trigger_hz = 0;             // Ƶʣ0 ʾ
+        double trigger_duty = 0.5;
+    };
+
+    struct Stats {
+        uint64_t events = 0;       // ͳ¼
+        uint64_t buffers = 0;      // ص
+        uint64_t late = 0;         // صʱһļƻʱ (¼Դ)
+        int64_t last_timestamp = 0;
+    };
+
+    SyntheticEventSource() = default;
+    explicit SyntheticEventSource(const Options& options) : options(options) {}
+    ~SyntheticEventSource() override;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return opened; }
+    int width() const override { return options.width; }
+    int height() const override { return options.height; }
+    bool start(Callback callback) override;
+    void stop() override;
+    bool finished() const override { return done.load(std::memory_order_acquire); }
+    void setTriggerCallback(TriggerCallback callback) override { trigger_callback = std::move(callback); }
+    const char* name() const override { return "synthetic"; }
+
+    Stats stats() const;
+    static const char* distributionName(Distribution distribution);
+
+private:
+    struct Offset {
+        int16_t dx;
+        int16_t dy;
+        int16_t p;
+    };
+
+    void run();
+
+    Options options;
+    std::vector<Offset> table;  // ڷֲĵƫ (Uniform Ϊ)
+    bool opened = false;
+
+    Callback callback;
+    TriggerCallback trigger_callback;
+    std::thread thread;
+    std::atomic<bool> running{ false };
+    std::atomic<bool> done{ false };
+
+    std::atomic<uint64_t> events{ 0 };
+    std::atomic<uint64_t> buffers{ 0 };
+    std::atomic<uint64_t> late{ 0 };
+    std::atomic<int64_t> last_timestamp{ 0 };
+
+    SyntheticEventSource(const SyntheticEventSource&) = delete;
+    SyntheticEventSource& operator=(const SyntheticEventSource&) = delete;
+};
+
+#endif // SYNTHETICEVENTSOURCE_H
@@ -0,0 +1,85 @@
+#ifndef SYNTHETICFRAMESOURCE_H
+#define SYNTHETICFRAMESOURCE_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+#include "FrameSource.h"
+
+// ϳ֡ԴԼ߳ϰ趨֡ 8 λ Bayer ( Mono8) ֡Ҫ
+// ûĻ ( Linux) ͨѹ ɼ -> ת -> д ߣ֡ʿԶʵ
+//
+// ÿ֡һ֡ƽƵĽ + ̸ǰ 8 ֽд֡ţοԾݴУ˳ݡ
+// ֡Ԥ pattern_frames ѭʹãɱռó֡ʱ䡣
+//
+// ʱ򣺵 n ֡ļƻʱ = ʼʱ + n / fpsټ [-jitter_us, +jitter_us] ľȶ (ۻ)
+// burst_every > 0 ʱÿ burst_every ֡еǰ burst_frames ֡ȴͳ (ģⴥ崮)
+// fps <= 0 ʾ٣صؾͳһ֡
+// ֡ע룺drop_every > 0 ʱÿ drop_every ֡һ֡drop_probability Ϊ֡ʣ
+// ֡ص֡ճ (֡ʱıһ)
+class SyntheticFrameSource : public FrameSource {
+public:
+    struct Options {
+        uint32_t width = 1280;
+        uint32_t height = 1024;
+        std::string pixel_format = "BayerRG8";  // BayerGB8 / BayerRG8 / BayerGR8 / BayerBG8 / Mono8
+        double fps = 200;
+        int jitter_us = 0;
+        int burst_frames = 0;
+        int burst_every = 0;
+        int drop_every = 0;
+        double drop_probability = 0;
+        uint64_t max_frames = 0;                // ͳôֹ֡ͣ֡0 ʾ
+        int pattern_frames = 8;
+        uint32_t seed = 1;
+    };
+
+    struct Stats {
+        uint64_t generated = 0;   // ѷ֡ŵ֡ ()
+        uint64_t delivered = 0;   // ص
+        uint64_t dropped = 0;     // ע붪֡
+        uint64_t late = 0;        // صʱѾһ֡ƻʱ̵Ĵ (֡Դ)
+        int64_t max_late_ns = 0;  // 
+    };
+
+    SyntheticFrameSource() = default;
+    explicit SyntheticFrameSource(const Options& options) : options(options) {}
+    ~SyntheticFrameSource() override;
+
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return opened; }
+    bool format(SourceFormat& format) override;
+    bool start(Callback callback) override;
+    void stop() override;
+    bool convertToBgr(const SourceFrame& frame, uint8_t* dst, size_t dst_bytes) override;
+    const char* name() const override { return "synthetic"; }
+
+    Stats stats() const;
+    bool finished() const { return done.load(std::memory_order_acquire); } // max_frames ȫͳ
+
+private:
+    void run();
+
+    Options options;
+    SourceFormat source_format;
+    std::vector<std::vector<uint8_t>> patterns;
+    bool opened = false;
+
+    Callback callback;
+    std::thread thread;
+    std::atomic<bool> running{ false };
+    std::atomic<bool> done{ false };
+
+    std::atomic<uint64_t> generated{ 0 };
+    std::atomic<uint64_t> delivered{ 0 };
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<uint64_t> late{ 0 };
+    std::atomic<int64_t> max_late_ns{ 0 };
+
+    SyntheticFrameSource(const SyntheticFrameSource&) = delete;
+    SyntheticFrameSource& operator=(const SyntheticFrameSource&) = delete;
+};
+
+#endif // SYNTHETICFRAMESOURCE_H
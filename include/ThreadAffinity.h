@@ -0,0 +1,13 @@
+#ifndef THREADAFFINITY_H
+#define THREADAFFINITY_H
+
+#include <cstddef>
+
+// ѵǰ̰߳󶨵ָ߼ (Windows: SetThreadAffinityMask, Linux: pthread_setaffinity_np)
+// ˺ųΧƽ̨֧ʱ false̱߳ԭ
+bool pinCurrentThreadToCore(size_t core);
+
+// ߼ (hardware_concurrency  0 ʱ 1 )
+size_t logicalCoreCount();
+
+#endif // THREADAFFINITY_H
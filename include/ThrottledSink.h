@@ -0,0 +1,78 @@
+#ifndef THROTTLEDSINK_H
+#define THROTTLEDSINK_H
+
+#include <chrono>
+#include <memory>
+#include <thread>
+#include "FrameSink.h"
+
+// Ϊٵ sink װд̸ϵ (֤деıѹ)
+//   - mb_per_s > 0ԭʼֽƽд
+//   - stall_every_frames > 0ÿдô֡ͣ stall_ms (ģļϵͳˢ̡ռ)
+class ThrottledSink : public FrameSink {
+public:
+    struct Options {
+        double mb_per_s = 0;
+        int stall_every_frames = 0;
+        int stall_ms = 0;
+
+        bool enabled() const { return mb_per_s > 0 || (stall_every_frames > 0 && stall_ms > 0); }
+    };
+
+    ThrottledSink(std::unique_ptr<FrameSink> inner, const Options& options)
+        : inner(std::move(inner)), options(options) {}
+
+    bool open(const std::string& base_path, const FrameFormat& format) override
+    {
+        start();
+        return inner->open(base_path, format);
+    }
+
+    bool openFile(const std::string& file_path, const FrameFormat& format) override
+    {
+        start();
+        return inner->openFile(file_path, format);
+    }
+
+    bool write(const FrameRecord& record) override
+    {
+        const bool ok = inner->write(record);
+        frames++;
+        if (options.stall_every_frames > 0 && options.stall_ms > 0 && frames % options.stall_every_frames == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(options.stall_ms));
+            stalled += std::chrono::milliseconds(options.stall_ms);
+        }
+        if (options.mb_per_s > 0) {
+            // дֽӦʱ֮ǰ (ͣʱ㣬)
+            const double seconds = (double)inner->stats().bytes / (options.mb_per_s * 1e6);
+            std::this_thread::sleep_until(started + stalled +
+                std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds)));
+        }
+        return ok;
+    }
+
+    bool flush() override { return inner->flush(); }
+    bool close() override { return inner->close(); }
+    const char* name() const override { return inner->name(); }
+    const char* fileName() const override { return inner->fileName(); }
+    FrameSinkStats stats() const override { return inner->stats(); }
+    bool acceptsCompressedChunks() const override { return inner->acceptsCompressedChunks(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    void start()
+    {
+        started = Clock::now();
+        stalled = Clock::duration::zero();
+        frames = 0;
+    }
+
+    std::unique_ptr<FrameSink> inner;
+    Options options;
+    Clock::time_point started;
+    Clock::duration stalled{};
+    uint64_t frames = 0;
+};
+
+#endif // THROTTLEDSINK_H
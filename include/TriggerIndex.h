@@ -0,0 +1,122 @@
+#ifndef TRIGGERINDEX_H
+#define TRIGGERINDEX_H
+
+#include <metavision/sdk/base/events/event_cd.h>
+#include <metavision/sdk/base/events/event_ext_trigger.h>
+#include <H5Cpp.h>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+// ⲿؽ "RGB ֡ -> ¼Χ" 
+//
+// UNO ķͬʱ̨ÿʼضӦ RGB һع⣬DVS  Trigger In ͬһص¼ʱ
+// GUI  DVS  RGB Ե k  RGB ڱβɼеĵ k ֡
+// (֡ = һ֡֡ + kص˶֡ӰӦϵΪ֡)
+//
+// ÿعⴰΪ [ʼ, ) exposure_us ʱΪ [ʼ, ʼ + exposure_us)
+// ڱ߽¼жλΪ "һ t >= ߽¼" dvs_events.h5 кһ£
+//   - ߽յ¼Ⱥ¼ʱһ
+//   - ߽յ¼ (ص CD ص) history_events ¼ʱ
+//   -  (ʷ)ȡʷ¼ţ approximate
+// д dvs_events.h5  /dvs  (write)
+//   /dvs/triggers/{t, p, id, host_ns}                 ԭʼأhost_ns Ϊصʱʱ (ûʱΪ 0)
+//   /dvs/frames/{frame_number, t_begin, t_end, event_begin, event_end, rgb_received}   ÿһ
+// ֡ f Ӧ f - frame_number[0] Уȡ O(1) ҵ֡عڼ¼ ( H5EventReader::frameRange)
+// ¼Ű addEvents յ¼дʱwrite ֮ǰ mapEventRows ļкš
+//
+// addEvents / addTriggers ¼Դ߳ϵ (ͬһ̣߳)addRgbFrame  RGB ֡Դ߳ϵã
+// finish / write ¼Դֹ֮ͣá
+class TriggerIndex {
+public:
+    struct Options {
+        bool rising_starts = true;               //  (p = 1) ʼع⣻ʱΪ false
+        Metavision::timestamp exposure_us = 0;   // > 0 ʱù̶عʱ
+        int channel = -1;                        // ֻʹ id Ĵ-1 ʾȫ
+        size_t history_events = 1 << 20;         // ٸ¼ʱ
+    };
+
+    struct Row {
+        uint64_t pulse = 0;
+        Metavision::timestamp t_begin = 0;
+        Metavision::timestamp t_end = -1;        // -1ûյ
+        uint64_t event_begin = 0;
+        uint64_t event_end = 0;
+    };
+
+    struct Stats {
+        uint64_t edges = 0;          // յĴ (֮ͨ)
+        uint64_t pulses = 0;
+        uint64_t late = 0;           // ߽յ¼ʷﶨλ
+        uint64_t approximate = 0;    // ʷλòȷ
+        uint64_t rgb_frames = 0;     // addRgbFrame 
+        uint64_t events = 0;
+    };
+
+    TriggerIndex() = default;
+    explicit TriggerIndex(const Options& options) : options(options) {}
+
+    void setOptions(const Options& new_options) { options = new_options; }  // reset ֮ǰ
+    // µĲɼʼǰ
+    void reset();
+
+    void addEvents(const Metavision::EventCD* begin, const Metavision::EventCD* end);
+    // host_timestamp_nsһصʱʱ (steady_clock, ns) /rgb/host_timestamps ͬһʱ
+    void addTriggers(const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end,
+        uint64_t host_timestamp_ns = 0);
+    void addRgbFrame(uint64_t frame_number);
+
+    // ¼δλı߽綼һ¼֮ûнصһ嶪
+    void finish();
+    // finish ֮write ֮ǰãrow_of(¼) ظ¼ļек ( H5EventWriter::rowOf)
+    // ڱ¼ϵı߽Ƶһд¼
+    template <class RowOf>
+    void mapEventRows(RowOf&& row_of)
+    {
+        for (Row& row : rows_) {
+            row.event_begin = row_of(row.event_begin);
+            row.event_end = row_of(row.event_end);
+        }
+    }
+    // д triggers / frames 飻dropped_events (д¼) ΪԼ
+    bool write(H5::Group& parent, uint64_t dropped_events) const;
+
+    const std::vector<Row>& rows() const { return rows_; }
+    Stats stats() const;
+
+private:
+    struct Boundary {
+        Metavision::timestamp t;
+        size_t row;
+        bool is_end;
+    };
+
+    void addBoundary(Metavision::timestamp t, size_t row, bool is_end);
+    void resolve(const Boundary& boundary, uint64_t position);
+    uint64_t positionInHistory(Metavision::timestamp t);
+
+    Options options;
+    std::vector<Row> rows_;
+    std::vector<Metavision::EventExtTrigger> edges;
+    std::vector<uint64_t> edge_host_ns;  //  edges һһӦ
+    std::deque<Boundary> pending;    //  t 
+    bool open_pulse = false;         // һڵȽ
+
+    // ¼ʱ ()history[(head + i) % size] Ϊ events_seen - count + i ¼
+    std::vector<Metavision::timestamp> history;
+    size_t history_head = 0;
+    size_t history_count = 0;
+    uint64_t events_seen = 0;
+    Metavision::timestamp last_t = INT64_MIN;
+
+    uint64_t late = 0;
+    uint64_t approximate = 0;
+
+    mutable std::mutex rgb_mutex;
+    bool have_rgb = false;
+    uint64_t first_frame_number = 0;
+    std::vector<uint8_t> rgb_received;   //  frame_number - first_frame_number
+    uint64_t rgb_frames = 0;
+};
+
+#endif // TRIGGERINDEX_H
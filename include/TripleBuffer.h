@@ -0,0 +1,74 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <atomic>
+#include <cstdint>
+
+// /ߵ "ֵ" 
+// ڲɼ/߳ () -> GUI ߳ () ʵʱ潻ӣ
+//   -  writeBuffer() ԭд룬publish() м۽
+//   -  update() ֵʱмۻˣ򷵻 false (ػ)
+//   - õһ߲ڶĻ壬˫ȴȡľֱֵӱ
+//   - ÿ publish ֵһ𽻻readSequence() Կм˼֡
+// ± (д / м / ) ʼջͬм± "ֵ" ־һԭֽ
+// cv::Mat ȿɸ÷ͣcreate / copyTo ڳߴ粻ʱֱӸû壬̬²ٷڴ档
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer() = default;
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // ---------- ߶ ----------
+    T& writeBuffer() { return slots_[write_].value; }
+
+    //  writeBuffer() еݣ ( 1 ʼ)
+    uint64_t publish()
+    {
+        slots_[write_].sequence = ++published_;
+        const uint8_t prev = middle_.exchange((uint8_t)(write_ | kFresh), std::memory_order_acq_rel);
+        if (prev & kFresh) overwritten_.store(overwritten_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        write_ = prev & kIndexMask;
+        return published_;
+    }
+
+    // ---------- ߶ ----------
+    // ֵʱ˲ true֮ readBuffer() һ update() ֮ǰֲ
+    bool update()
+    {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+        const uint8_t prev = middle_.exchange(read_, std::memory_order_acq_rel);
+        read_ = prev & kIndexMask;
+        return true;
+    }
+
+    const T& readBuffer() const { return slots_[read_].value; }
+    T& readBuffer() { return slots_[read_].value; }
+
+    // ǰֵţδȡκֵʱΪ 0
+    uint64_t readSequence() const { return slots_[read_].sequence; }
+
+    // ȡֵǵĴ
+    uint64_t overwritten() const { return overwritten_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    struct alignas(64) Slot {
+        T value{};
+        uint64_t sequence = 0;
+    };
+
+    Slot slots_[3];
+    alignas(64) std::atomic<uint8_t> middle_{ 1 };
+    // ˽
+    alignas(64) uint8_t write_ = 0;
+    uint64_t published_ = 0;
+    std::atomic<uint64_t> overwritten_{ 0 };
+    // ˽
+    alignas(64) uint8_t read_ = 2;
+};
+
+#endif // TRIPLEBUFFER_H
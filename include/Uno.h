@@ -1,21 +1,101 @@
 #ifndef UNO_H
 #define UNO_H
 #include <stdio.h>
-#include <windows.h>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
 
+//  (Arduino UNO)ڷ / ֹͣͬʱ RGB  DVS
+//
+// ǵֽ 'a' (ʼ) / 'q' (ֹͣ)ɹ̼ճֻǲӦ
+// ¹̼ (firmware/uno_trigger) лӦʱΪ micros()
+//   'a' -> "A <us>"            յʼʱ
+//          "P <us>"            һ
+//   'q' -> "Q <us> <pulses>"   ֹͣ˶ٸ
+//   'v' -> "V <version>"
+// start / stop Ӧ ( ack_timeout_ms / pulse_timeout_ms)ݴ˲һӳ٣
+//    rtt = յ "A" ʱ - ʱ = ӳ + ֽڴ + "A" д + ӳ
+//     (rtt - δʱ) / 2 + ֽڴ ( baud ÿֽ 10 bitӳΪԳ)
+//   ӳ =  + (P - A)һǰϴյһ
+// ûӦ (ɹ̼) ʱ acked Ϊ falseӳδ֪
+//
+// 򿪴ڻ UNO λ (DTR)bootloader Լ 1.5 s յᶪʧstart ȵ򿪺 boot_ms ŷ
+//  start 룺GUI ߳ startAsync / stopAsyncڲִ߳С
+// Windows  Win32  APIƽ̨ termios ( /dev/ttyACM0FakeUno αն)
 class UNO {
-	private:
-		char data;
-		DWORD bytesWritten;
-		HANDLE hSerial;
-		DCB dcbSerialParams;
-		const char* portName;
 	public:
-		UNO();
+		struct Options {
+#if defined(_WIN32)
+			std::string port = "COM3";
+#else
+			std::string port = "/dev/ttyACM0";
+#endif
+			int baud = 9600;                 // ̼ Serial.begin һ
+			int boot_ms = 2000;              // 򿪴ںòܷ (αնΪ 0)
+			int ack_timeout_ms = 200;
+			int pulse_timeout_ms = 500;      // ȵһޣҪڷ
+		};
+
+		struct Stats {
+			bool acked = false;              // յ "A"
+			bool pulse_seen = false;         // յ "P"
+			uint64_t command_host_ns = 0;    // ʼʱ (steady_clock)
+			double ack_rtt_us = 0;           // 
+			double command_us = 0;           // Ƶ  -> յ
+			double device_delay_us = 0;      // ϣյ -> һ
+			double latency_us = 0;           // Ƶ  -> һ
+			bool stopped = false;            // յ "Q"
+			uint32_t pulses = 0;             // ֹͣʱ̼
+		};
+
+		UNO();  // Ĭϴڣʱ
+		explicit UNO(const Options& options);
 		~UNO();
-		void start();
-		void stop();
+		bool open(const Options& options);
+		void close();
+		bool isOpen() const { return handle != -1; }
+		bool start();
+		bool stop();
+		// start / stop 첽汾˳ִ߳Уdone ڸ߳ϵãΪ start / stop ķֵ
+		// Ҫͬ start / stop ͬʱʹáclose () ִύ
+		using Done = std::function<void(bool ok)>;
+		void startAsync(Done done = nullptr);
+		void stopAsync(Done done = nullptr);
+		void waitIdle();  // ύ첽ȫִ
+		// һ start / stop ֽ
+		Stats stats() const;
+
+	private:
+		bool writeCommand(char command);
+		// һ ()timeout_ms ûһз false
+		bool readLine(std::string& line, int timeout_ms);
+		int readSome(char* buffer, int size, int timeout_ms);
+		void discardInput();
+		void submit(bool start_command, Done done);
+		void commandLoop();
+		void stopCommandThread();
+
+		Options options;
+		intptr_t handle = -1;                // Win32 HANDLE  POSIX fd-1 ʾδ
+		uint64_t opened_ns = 0;
+		std::string rx;                      // δеĽ
+		Stats stats_;
+		mutable std::mutex stats_mutex;     // ߳д stats_̶߳
 
+		struct Command {
+			bool start = true;
+			Done done;
+		};
+		std::thread command_thread;
+		std::mutex command_mutex;
+		std::condition_variable command_cv;
+		std::deque<Command> commands;
+		size_t commands_pending = 0;         // ύδִ (ִ) 
+		bool command_exit = false;
 };
 
-#endif
\ No newline at end of file
+#endif
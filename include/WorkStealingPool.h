@@ -0,0 +1,188 @@
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "SmallTask.h"
+#include "ThreadAffinity.h"
+
+// ȡ̳߳
+//   - ÿ߳Լ˫˶к߳ͬһ
+//   - ̴߳Լеβȡ (LIFOѺ)ʱ̶߳еͷȡ (FIFO)
+//   - ⲿ߳ύ䵽У߳ڲύŽԼĶ
+//   -  SmallTask״̬ţ std::function ڶϷ
+//   - pin_threads Ϊ true ʱ i ̰߳󶨵߼ (first_core + i) % 
+class WorkStealingPool {
+public:
+    explicit WorkStealingPool(size_t num_threads, bool pin_threads = false, size_t first_core = 0)
+        : queues(num_threads == 0 ? 1 : num_threads)
+    {
+        for (size_t i = 0; i < queues.size(); ++i) {
+            queues[i] = std::make_unique<WorkerQueue>();
+        }
+        for (size_t i = 0; i < queues.size(); ++i) {
+            workers.emplace_back([this, i, pin_threads, first_core] {
+                if (pin_threads) {
+                    pinCurrentThreadToCore((first_core + i) % logicalCoreCount());
+                }
+                workerLoop(i);
+            });
+        }
+    }
+
+    ~WorkStealingPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stop = true;
+        }
+        sleep_cv.notify_all();
+        for (std::thread& worker : workers) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    template <class F>
+    void enqueue(F&& f)
+    {
+        if (stop) {
+            throw std::runtime_error("Cannot enqueue on stopped WorkStealingPool");
+        }
+        // ȼӣ߳̿ pending > 0 Ͳ˯
+        pending.fetch_add(1);
+        WorkerQueue& q = *queues[targetQueue()];
+        {
+            std::lock_guard<std::mutex> lock(q.mutex);
+            q.tasks.emplace_back(std::forward<F>(f));
+        }
+        wake(1);
+    }
+
+    // ύÿֻһͳһ
+    template <class It>
+    void enqueueBatch(It first, It last)
+    {
+        if (stop) {
+            throw std::runtime_error("Cannot enqueue on stopped WorkStealingPool");
+        }
+        const size_t count = (size_t)std::distance(first, last);
+        if (count == 0) return;
+        pending.fetch_add(count);
+        const size_t n = queues.size();
+        const size_t start = next_queue.fetch_add(1, std::memory_order_relaxed);
+        for (size_t k = 0; first != last && k < n; ++k) {
+            // ʣƽָ start ʼĸ
+            size_t remaining = (size_t)std::distance(first, last);
+            size_t share = (remaining + (n - k) - 1) / (n - k);
+            WorkerQueue& q = *queues[(start + k) % n];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            for (size_t j = 0; j < share; ++j, ++first) {
+                q.tasks.emplace_back(std::move(*first));
+            }
+        }
+        wake(count);
+    }
+
+    size_t size() const { return workers.size(); }
+    size_t pendingTasks() const { return pending.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) WorkerQueue {
+        std::mutex mutex;
+        std::deque<SmallTask> tasks;
+    };
+
+    // ǰ߳ǱصḶ́߳tls_pool ָ򱾳أtls_index Ϊ±
+    static inline thread_local const WorkStealingPool* tls_pool = nullptr;
+    static inline thread_local size_t tls_index = 0;
+
+    size_t targetQueue()
+    {
+        if (tls_pool == this) return tls_index;
+        return next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    }
+
+    void wake(size_t count)
+    {
+        if (sleepers.load() == 0) return;
+        std::lock_guard<std::mutex> lock(sleep_mutex);
+        if (count > 1) sleep_cv.notify_all();
+        else sleep_cv.notify_one();
+    }
+
+    bool popLocal(size_t index, SmallTask& task)
+    {
+        WorkerQueue& q = *queues[index];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) return false;
+        task = std::move(q.tasks.back());
+        q.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t thief, SmallTask& task)
+    {
+        const size_t n = queues.size();
+        for (size_t k = 1; k < n; ++k) {
+            WorkerQueue& q = *queues[(thief + k) % n];
+            std::unique_lock<std::mutex> lock(q.mutex, std::try_to_lock);
+            if (!lock.owns_lock() || q.tasks.empty()) continue;
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void workerLoop(size_t index)
+    {
+        tls_pool = this;
+        tls_index = index;
+        int idle_rounds = 0;
+        while (true) {
+            SmallTask task;
+            if (popLocal(index, task) || steal(index, task)) {
+                pending.fetch_sub(1);
+                idle_rounds = 0;
+                task();
+                continue;
+            }
+            // пֻǱ try_lock ˣó˯
+            if (pending.load() > 0 && ++idle_rounds < 16) {
+                std::this_thread::yield();
+                continue;
+            }
+            idle_rounds = 0;
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleepers.fetch_add(1);
+            sleep_cv.wait(lock, [this] { return stop || pending.load() > 0; });
+            sleepers.fetch_sub(1);
+            if (stop && pending.load() == 0) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> next_queue{ 0 };
+    std::atomic<size_t> pending{ 0 };   // ӡδȡߵ
+    std::atomic<size_t> sleepers{ 0 };
+
+    std::mutex sleep_mutex;
+    std::condition_variable sleep_cv;
+    std::atomic<bool> stop{ false };
+};
+
+#endif // WORKSTEALINGPOOL_H
@@ -0,0 +1,255 @@
+// ޽¼ (dualcamera-record) QtԤʱ֡¼ɶժҪ
+//
+// ÷: dualcamera-record --dataset NAME [--duration SEC | --frames N] [ѡ...]
+//   --frames N              ֻ¼֡Դǰ N ֡ (ص˶Ҳ N)ֱ֮֡Ӻԣʵд֡ժҪ rgb.frames
+//   --config FILE           key = value ļkey ѡͬ ( --)# ͷΪעͣѡļ
+//   --output DIR            RGB  DVS Ŀ¼ (Ĭ .)--rgb-output / --dvs-output ֱָ
+//   --segment-dirs A,B      ֶ¼ʱдĿ¼--segment-seconds / --segment-mb Ϊÿ
+//   --sink hdf5|framelog    --format bgr|raw    --dvs raw|hdf5|both    --workers N    --pin-workers
+//   --trigger-port PORT     --trigger-baud BAUD    --no-trigger (ⲿźԴ)
+//   --synthetic             ϳԴҪ ( --no-trigger)--synthetic-fps / -width / -height / -event-rate
+//   --summary FILE          ժҪдļ (Ĭϴӡ stderr stdout ϵ־һ)
+//   --rgb.workers 8 ...     ߲ ( PipelineConfig)ļͬд rgb.workers = 8
+//                           ȶ PipelineConfig::defaultPath() (ʱ)ٶ --config
+// Ctrl+C ǰ¼ƣճժҪժҪ ok Ϊ false (ûд֡д) ʱ˳Ϊ 1
+//
+// 궨: dualcamera-record --calibrate [--target-fps FPS] [--synthetic-width W --synthetic-height H] [--format / --sink / --dvs]
+//                         [--output DIR] [--trial-seconds S] [--max-workers N] [--headroom X] [--save-config FILE]
+//   úϳɸҳܸĿ֡ʡڴٵĹ߲ ( PipelineTuner)д --save-config
+//   (Ĭ PipelineConfig::defaultPath()GUI ͱʱȡ)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "PipelineTuner.h"
+#include "Recorder.h"
+
+namespace {
+    std::atomic<bool> interrupted{ false };
+
+    struct RunSettings {
+        double duration_s = 0;
+        std::string summary_path;
+        bool calibrate = false;
+        PipelineTuner::Options tune;
+        std::string save_config = PipelineConfig::defaultPath();
+    };
+
+    void onSignal(int)
+    {
+        interrupted = true;
+    }
+
+    // ѡļд key = true / false
+    bool isSwitch(const std::string& key)
+    {
+        return key == "no-trigger" || key == "synthetic" || key == "pin-workers" || key == "calibrate";
+    }
+
+    // ļͬһָʽдʱ¼ (Ѵӡ)
+    bool readConfig(const std::string& path, std::map<std::string, std::string>& settings)
+    {
+        return PipelineConfig::readKeyValues(path, [&settings](const std::string& key, const std::string& value) {
+            settings[key] = value;
+            return true;
+        });
+    }
+
+    bool parseArguments(int argc, char* argv[], std::map<std::string, std::string>& settings)
+    {
+        // ȶļϵѡٸ
+        for (int i = 1; i + 1 < argc; ++i) {
+            if (std::string(argv[i]) == "--config" && !readConfig(argv[i + 1], settings)) return false;
+        }
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg.compare(0, 2, "--") != 0) {
+                printf("Unexpected argument %s\n", arg.c_str());
+                return false;
+            }
+            const std::string key = arg.substr(2);
+            if (isSwitch(key)) {
+                settings[key] = "true";
+                continue;
+            }
+            if (i + 1 >= argc) {
+                printf("Missing value for %s\n", arg.c_str());
+                return false;
+            }
+            if (key != "config") settings[key] = argv[i + 1];
+            i++;
+        }
+        return true;
+    }
+
+    bool isTrue(const std::string& value)
+    {
+        return value == "true" || value == "1" || value == "yes" || value == "on";
+    }
+
+    std::vector<std::string> splitList(const std::string& text)
+    {
+        std::vector<std::string> items;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ',')) {
+            item = PipelineConfig::trim(item);
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    bool buildOptions(std::map<std::string, std::string> settings, Recorder::Options& options, RunSettings& run)
+    {
+        auto take = [&settings](const char* key, std::string& value) {
+            auto it = settings.find(key);
+            if (it == settings.end()) return false;
+            value = it->second;
+            settings.erase(it);
+            return true;
+        };
+        std::string value;
+        if (take("dataset", value)) options.dataset = value;
+        if (take("duration", value)) run.duration_s = std::atof(value.c_str());
+        if (take("frames", value)) options.max_frames = std::strtoull(value.c_str(), nullptr, 10);
+        if (take("output", value)) options.rgb_root = options.dvs_root = value;
+        if (take("rgb-output", value)) options.rgb_root = value;
+        if (take("dvs-output", value)) options.dvs_root = value;
+        if (take("segment-dirs", value)) options.segments.directories = splitList(value);
+        if (take("segment-seconds", value)) options.segments.max_seconds = std::atof(value.c_str());
+        if (take("segment-mb", value)) options.segments.max_bytes = (uint64_t)(std::atof(value.c_str()) * 1e6);
+        if (take("sink", value)) {
+            if (value == "hdf5") options.rgb_sink = RGB::SinkType::Hdf5;
+            else if (value == "framelog") options.rgb_sink = RGB::SinkType::FrameLog;
+            else { printf("Unknown sink %s (hdf5 | framelog)\n", value.c_str()); return false; }
+        }
+        if (take("format", value)) {
+            if (value == "bgr") options.rgb_format = RGB::RecordFormat::BGR;
+            else if (value == "raw") options.rgb_format = RGB::RecordFormat::RawBayer;
+            else { printf("Unknown format %s (bgr | raw)\n", value.c_str()); return false; }
+        }
+        if (take("dvs", value)) {
+            if (value == "raw") options.dvs_format = DVS::RecordFormat::Raw;
+            else if (value == "hdf5") options.dvs_format = DVS::RecordFormat::Hdf5;
+            else if (value == "both") options.dvs_format = DVS::RecordFormat::RawAndHdf5;
+            else { printf("Unknown DVS format %s (raw | hdf5 | both)\n", value.c_str()); return false; }
+        }
+        if (take("workers", value)) options.pipeline.rgb.workers = (size_t)std::max(1, std::atoi(value.c_str()));
+        if (take("pin-workers", value)) options.pipeline.rgb.pin_workers = isTrue(value);
+        if (take("trigger-port", value)) options.trigger_options.port = value;
+        if (take("trigger-baud", value)) options.trigger_options.baud = std::atoi(value.c_str());
+        if (take("no-trigger", value)) options.trigger = !isTrue(value);
+        if (take("synthetic", value)) options.synthetic = isTrue(value);
+        if (take("synthetic-fps", value)) options.synthetic_fps = std::atof(value.c_str());
+        if (take("synthetic-width", value)) options.synthetic_width = (uint32_t)std::atoi(value.c_str());
+        if (take("synthetic-height", value)) options.synthetic_height = (uint32_t)std::atoi(value.c_str());
+        if (take("synthetic-event-rate", value)) options.synthetic_event_rate = std::atof(value.c_str());
+        if (take("summary", value)) run.summary_path = value;
+        // ϳ¼ԴԼҪ
+        if (options.synthetic) options.trigger = false;
+
+        if (take("calibrate", value)) run.calibrate = isTrue(value);
+        run.tune.target_fps = options.synthetic_fps;
+        if (take("target-fps", value)) run.tune.target_fps = std::atof(value.c_str());
+        if (take("trial-seconds", value)) run.tune.trial_seconds = std::atof(value.c_str());
+        if (take("max-workers", value)) run.tune.max_workers = (size_t)std::max(0, std::atoi(value.c_str()));
+        if (take("headroom", value)) run.tune.headroom = std::atof(value.c_str());
+        if (take("save-config", value)) run.save_config = value;
+        run.tune.width = options.synthetic_width;
+        run.tune.height = options.synthetic_height;
+        run.tune.event_rate = options.synthetic_event_rate;
+        run.tune.rgb_format = options.rgb_format;
+        run.tune.rgb_sink = options.rgb_sink;
+        // ϳ¼Դ¼ .raw궨ʱֻ dvs_events.h5
+        run.tune.dvs_format = options.dvs_format == DVS::RecordFormat::Raw ? DVS::RecordFormat::Raw : DVS::RecordFormat::Hdf5;
+        run.tune.directory = options.rgb_root;
+
+        //  key ǹ߲ (rgb.workersdvs.h5_queue_buffers...)
+        for (const auto& setting : settings) {
+            if (!PipelineConfig::hasKey(setting.first)) {
+                printf("Unknown option --%s\n", setting.first.c_str());
+                return false;
+            }
+            if (!options.pipeline.set(setting.first, setting.second)) return false;
+        }
+        if (run.calibrate) return run.tune.target_fps > 0 && run.tune.trial_seconds > 0;
+        if (options.dataset.empty()) {
+            printf("--dataset is required\n");
+            return false;
+        }
+        if (run.duration_s <= 0 && options.max_frames == 0) {
+            printf("One of --duration or --frames is required\n");
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::map<std::string, std::string> settings;
+    Recorder::Options options;
+    RunSettings run;
+    // Ĺ (궨)  --config жȡ
+    const std::string default_config = PipelineConfig::defaultPath();
+    if (std::filesystem::exists(default_config) && !options.pipeline.load(default_config)) return 1;
+    if (argc < 2 || !parseArguments(argc, argv, settings) || !buildOptions(settings, options, run)) {
+        printf("usage: %s --dataset NAME (--duration SEC | --frames N) [--config FILE] [--output DIR]\n"
+            "       [--rgb-output DIR] [--dvs-output DIR] [--segment-dirs A,B] [--segment-seconds S] [--segment-mb MB]\n"
+            "       [--sink hdf5|framelog] [--format bgr|raw] [--dvs raw|hdf5|both] [--workers N] [--pin-workers]\n"
+            "       [--trigger-port PORT] [--trigger-baud BAUD] [--no-trigger] [--synthetic] [--synthetic-fps FPS]\n"
+            "       [--synthetic-width W] [--synthetic-height H] [--synthetic-event-rate MEV_S] [--summary FILE]\n"
+            "       [--<pipeline key> VALUE ...]\n"
+            "       %s --calibrate [--target-fps FPS] [--trial-seconds S] [--max-workers N] [--headroom X] [--save-config FILE]\n",
+            argv[0], argv[0]);
+        return 1;
+    }
+
+    if (run.calibrate) {
+        PipelineTuner tuner(run.tune);
+        const PipelineTuner::Result result = tuner.run(options.pipeline);
+        result.config.write(stdout);
+        if (!result.ok) return 1;
+        if (!result.config.save(run.save_config)) return 1;
+        printf("Pipeline configuration written to %s\n", run.save_config.c_str());
+        return 0;
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    Recorder recorder(options);
+    if (!recorder.start()) return 1;
+    printf("Recording %s (%s)...\n", options.dataset.c_str(), options.max_frames > 0 ? "frame limit" : "time limit");
+    // ֡ RGB ֡ԴصִУ N ֮֡֡ߣһ㷢Ҳ¼
+    // ֹͣʱѽߵ֡ճд
+    while (!interrupted) {
+        if (run.duration_s > 0 && recorder.elapsedSeconds() >= run.duration_s) break;
+        if (recorder.frameLimitReached()) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.max_frames > 0 ? 5 : 100));
+    }
+    recorder.stop();
+
+    const Recorder::Summary summary = recorder.summary();
+    if (!run.summary_path.empty()) {
+        FILE* file = fopen(run.summary_path.c_str(), "w");
+        if (!file || !summary.writeJson(file)) {
+            printf("Failed to write summary to %s\n", run.summary_path.c_str());
+            if (file) fclose(file);
+            return 1;
+        }
+        fclose(file);
+    }
+    else {
+        summary.writeJson(stderr);
+    }
+    return summary.ok() ? 0 : 1;
+}
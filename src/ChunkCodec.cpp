@@ -0,0 +1,278 @@
+#include "ChunkCodec.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <mutex>
+
+#if defined(DUALCAMERA_HAVE_ZLIB)
+#include <zlib.h>
+#endif
+#if defined(DUALCAMERA_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+#if defined(DUALCAMERA_HAVE_LZ4)
+#include <lz4.h>
+#endif
+
+namespace {
+    const H5Z_filter_t kZstdFilter = 32015;
+    const H5Z_filter_t kLz4Filter = 32004;
+    const uint32_t kLz4MaxBlock = 1u << 30;  //  HDF5 lz4 ĬϿСһ
+
+    // HDF5 shuffle ŷʽ j ֽƽηԪصĵ j ֽڣ²һԪصֽԭĩβ
+    void shuffleBytes(const uint8_t* src, uint8_t* dst, size_t size, size_t element_size)
+    {
+        const size_t count = size / element_size;
+        for (size_t j = 0; j < element_size; ++j) {
+            uint8_t* plane = dst + j * count;
+            for (size_t i = 0; i < count; ++i) plane[i] = src[i * element_size + j];
+        }
+        memcpy(dst + count * element_size, src + count * element_size, size - count * element_size);
+    }
+
+#if defined(DUALCAMERA_HAVE_LZ4)
+    void storeBigEndian(uint8_t* p, uint64_t value, int bytes)
+    {
+        for (int i = bytes - 1; i >= 0; --i) {
+            p[i] = (uint8_t)(value & 0xFF);
+            value >>= 8;
+        }
+    }
+
+    uint64_t loadBigEndian(const uint8_t* p, int bytes)
+    {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) value = (value << 8) | p[i];
+        return value;
+    }
+#endif
+
+#if defined(DUALCAMERA_HAVE_ZSTD)
+    //  32015 ŲͬѹΪ zstd ֡cd_values[0] Ϊѹ
+    size_t zstdFilter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[],
+        size_t nbytes, size_t* buf_size, void** buf)
+    {
+        if (flags & H5Z_FLAG_REVERSE) {
+            unsigned long long original = ZSTD_getFrameContentSize(*buf, nbytes);
+            if (original == ZSTD_CONTENTSIZE_ERROR || original == ZSTD_CONTENTSIZE_UNKNOWN) return 0;
+            void* out = malloc((size_t)original);
+            if (!out) return 0;
+            size_t n = ZSTD_decompress(out, (size_t)original, *buf, nbytes);
+            if (ZSTD_isError(n)) {
+                free(out);
+                return 0;
+            }
+            free(*buf);
+            *buf = out;
+            *buf_size = (size_t)original;
+            return n;
+        }
+        const int level = cd_nelmts > 0 ? (int)cd_values[0] : 0;
+        const size_t bound = ZSTD_compressBound(nbytes);
+        void* out = malloc(bound);
+        if (!out) return 0;
+        size_t n = ZSTD_compress(out, bound, *buf, nbytes, level);
+        if (ZSTD_isError(n)) {
+            free(out);
+            return 0;
+        }
+        free(*buf);
+        *buf = out;
+        *buf_size = bound;
+        return n;
+    }
+#endif
+
+#if defined(DUALCAMERA_HAVE_LZ4)
+    //  32004 Ųͬ8 ֽԭʼ + 4 ֽڿС ()
+    // ֮ÿΪ 4 ֽѹ + ݣѹȵڿ鳤ʱʾÿδѹ
+    size_t lz4Compress(const uint8_t* src, size_t nbytes, uint32_t block_size, std::vector<uint8_t>& out)
+    {
+        const size_t blocks = nbytes == 0 ? 0 : (nbytes + block_size - 1) / block_size;
+        const int max_block = (int)std::min<size_t>(block_size, nbytes);
+        out.resize(12 + blocks * (4 + (size_t)LZ4_compressBound(max_block)));
+        storeBigEndian(out.data(), nbytes, 8);
+        storeBigEndian(out.data() + 8, block_size, 4);
+        size_t pos = 12;
+        for (size_t b = 0; b < blocks; ++b) {
+            const size_t offset = b * block_size;
+            const int length = (int)std::min<size_t>(block_size, nbytes - offset);
+            uint8_t* dst = out.data() + pos + 4;
+            int n = LZ4_compress_default((const char*)src + offset, (char*)dst, length, LZ4_compressBound(length));
+            if (n <= 0 || n >= length) {
+                memcpy(dst, src + offset, (size_t)length);
+                n = length;
+            }
+            storeBigEndian(out.data() + pos, (uint32_t)n, 4);
+            pos += 4 + (size_t)n;
+        }
+        out.resize(pos);
+        return pos;
+    }
+
+    size_t lz4Filter(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[],
+        size_t nbytes, size_t* buf_size, void** buf)
+    {
+        const uint8_t* in = (const uint8_t*)*buf;
+        if (flags & H5Z_FLAG_REVERSE) {
+            if (nbytes < 12) return 0;
+            const uint64_t original = loadBigEndian(in, 8);
+            const uint64_t block_size = loadBigEndian(in + 8, 4);
+            if (block_size == 0) return 0;
+            uint8_t* out = (uint8_t*)malloc((size_t)original);
+            if (!out && original) return 0;
+            size_t pos = 12;
+            for (uint64_t offset = 0; offset < original; offset += block_size) {
+                const int length = (int)std::min<uint64_t>(block_size, original - offset);
+                if (pos + 4 > nbytes) { free(out); return 0; }
+                const int n = (int)loadBigEndian(in + pos, 4);
+                pos += 4;
+                if (pos + (size_t)n > nbytes) { free(out); return 0; }
+                if (n == length) {
+                    memcpy(out + offset, in + pos, (size_t)n);
+                }
+                else if (LZ4_decompress_safe((const char*)in + pos, (char*)out + offset, n, length) != length) {
+                    free(out);
+                    return 0;
+                }
+                pos += (size_t)n;
+            }
+            free(*buf);
+            *buf = out;
+            *buf_size = (size_t)original;
+            return (size_t)original;
+        }
+        uint32_t block_size = cd_nelmts > 0 && cd_values[0] > 0 ? cd_values[0] : kLz4MaxBlock;
+        std::vector<uint8_t> out;
+        lz4Compress(in, nbytes, block_size, out);
+        void* result = malloc(out.size());
+        if (!result) return 0;
+        memcpy(result, out.data(), out.size());
+        free(*buf);
+        *buf = result;
+        *buf_size = out.size();
+        return out.size();
+    }
+#endif
+}
+
+const char* chunkCodecName(ChunkCodec codec)
+{
+    switch (codec) {
+    case ChunkCodec::None: return "none";
+    case ChunkCodec::Deflate: return "deflate";
+    case ChunkCodec::Zstd: return "zstd";
+    case ChunkCodec::Lz4: return "lz4";
+    }
+    return "unknown";
+}
+
+bool chunkCodecAvailable(ChunkCodec codec)
+{
+    switch (codec) {
+    case ChunkCodec::None: return true;
+#if defined(DUALCAMERA_HAVE_ZLIB)
+    case ChunkCodec::Deflate: return true;
+#endif
+#if defined(DUALCAMERA_HAVE_ZSTD)
+    case ChunkCodec::Zstd: return true;
+#endif
+#if defined(DUALCAMERA_HAVE_LZ4)
+    case ChunkCodec::Lz4: return true;
+#endif
+    default: return false;
+    }
+}
+
+bool registerChunkFilters()
+{
+    static std::once_flag once;
+    static bool ok = true;
+    std::call_once(once, [] {
+#if defined(DUALCAMERA_HAVE_ZSTD)
+        if (H5Zfilter_avail(kZstdFilter) <= 0) {
+            static const H5Z_class2_t zstd_class = { H5Z_CLASS_T_VERS, kZstdFilter, 1, 1, "zstd", NULL, NULL, zstdFilter };
+            ok = H5Zregister(&zstd_class) >= 0 && ok;
+        }
+#endif
+#if defined(DUALCAMERA_HAVE_LZ4)
+        if (H5Zfilter_avail(kLz4Filter) <= 0) {
+            static const H5Z_class2_t lz4_class = { H5Z_CLASS_T_VERS, kLz4Filter, 1, 1, "lz4", NULL, NULL, lz4Filter };
+            ok = H5Zregister(&lz4_class) >= 0 && ok;
+        }
+#endif
+    });
+    return ok;
+}
+
+bool setChunkFilters(H5::DSetCreatPropList& props, const ChunkCompression& compression)
+{
+    if (compression.codec == ChunkCodec::None) return true;
+    if (!chunkCodecAvailable(compression.codec)) {
+        printf("Chunk codec %s is not available in this build.\n", chunkCodecName(compression.codec));
+        return false;
+    }
+    registerChunkFilters();
+    try {
+        if (compression.shuffle) props.setShuffle();
+        if (compression.codec == ChunkCodec::Deflate) {
+            props.setDeflate(compression.level > 0 ? compression.level : 6);
+        }
+        else if (compression.codec == ChunkCodec::Zstd) {
+            const unsigned int level = (unsigned int)(compression.level > 0 ? compression.level : 3);
+            props.setFilter(kZstdFilter, H5Z_FLAG_MANDATORY, 1, &level);
+        }
+        else if (compression.codec == ChunkCodec::Lz4) {
+            const unsigned int block_size = kLz4MaxBlock;
+            props.setFilter(kLz4Filter, H5Z_FLAG_MANDATORY, 1, &block_size);
+        }
+    }
+    catch (H5::Exception& e) {
+        printf("Failed to set chunk filters: %s\n", e.getCDetailMsg());
+        return false;
+    }
+    return true;
+}
+
+bool compressChunk(const ChunkCompression& compression, size_t element_size,
+    const uint8_t* data, size_t size, std::vector<uint8_t>& out, std::vector<uint8_t>& scratch)
+{
+    const uint8_t* src = data;
+    if (compression.shuffle && element_size > 1) {
+        scratch.resize(size);
+        shuffleBytes(data, scratch.data(), size, element_size);
+        src = scratch.data();
+    }
+
+    switch (compression.codec) {
+    case ChunkCodec::None:
+        out.assign(src, src + size);
+        return true;
+#if defined(DUALCAMERA_HAVE_ZLIB)
+    case ChunkCodec::Deflate: {
+        uLongf n = compressBound((uLong)size);
+        out.resize(n);
+        if (compress2(out.data(), &n, src, (uLong)size, compression.level > 0 ? compression.level : 6) != Z_OK) return false;
+        out.resize(n);
+        return true;
+    }
+#endif
+#if defined(DUALCAMERA_HAVE_ZSTD)
+    case ChunkCodec::Zstd: {
+        out.resize(ZSTD_compressBound(size));
+        size_t n = ZSTD_compress(out.data(), out.size(), src, size, compression.level > 0 ? compression.level : 3);
+        if (ZSTD_isError(n)) return false;
+        out.resize(n);
+        return true;
+    }
+#endif
+#if defined(DUALCAMERA_HAVE_LZ4)
+    case ChunkCodec::Lz4:
+        lz4Compress(src, size, kLz4MaxBlock, out);
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
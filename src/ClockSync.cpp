@@ -0,0 +1,302 @@
+#include "ClockSync.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+    double median(std::vector<double>& values)
+    {
+        if (values.empty()) return 0;
+        const size_t mid = values.size() / 2;
+        std::nth_element(values.begin(), values.begin() + mid, values.end());
+        return values[mid];
+    }
+
+    void writeAttribute(H5::H5Object& object, const char* name, const H5::PredType& type, const void* value)
+    {
+        H5::DataSpace scalar_space(H5S_SCALAR);
+        H5::Attribute attribute = object.createAttribute(name, type, scalar_space);
+        attribute.write(type, value);
+    }
+}
+
+// ============================ RobustLineFit ============================
+
+void RobustLineFit::reset()
+{
+    restart();
+    samples_ = 0;
+    rejected_ = 0;
+    relocks_ = 0;
+}
+
+void RobustLineFit::restart()
+{
+    ready_ = false;
+    warm.clear();
+    ox = oy = 0;
+    sw = sx = sy = sxx = sxy = 0;
+    a = b = 0;
+    scale_ = 0;
+    consecutive_rejects = 0;
+}
+
+bool RobustLineFit::add(int64_t x, int64_t y)
+{
+    samples_++;
+    if (!ready_) {
+        warm.emplace_back(x, y);
+        if (warm.size() >= std::max<size_t>(options.warmup, 2)) initialize();
+        return true;
+    }
+
+    const double r = (double)y - predict(x);
+    const double abs_r = std::fabs(r);
+    if (abs_r > options.reject_k * scale_) {
+        rejected_++;
+        if (++consecutive_rejects >= options.relock_after) {
+            // Ӧϵ (綪һ)㿪ʼ³ʼ
+            relocks_++;
+            restart();
+            warm.emplace_back(x, y);
+        }
+        return false;
+    }
+    consecutive_rejects = 0;
+    const double limit = options.huber_k * scale_;
+    const double weight = abs_r <= limit ? 1.0 : limit / abs_r;
+    // в߶ȣضϺ |r| ָƽֲ̬ sigma = 1.2533 * E|r|
+    scale_ = std::max(options.min_scale, 0.98 * scale_ + 0.02 * 1.2533 * std::min(abs_r, limit));
+    accumulate(x, y, weight);
+    return true;
+}
+
+// Theil-Senбʵλȡؾλwarmup Ϊ O(n^2)ֻڳʼʱһ
+void RobustLineFit::initialize()
+{
+    const int64_t x0 = warm.back().first;
+    const int64_t y0 = warm.back().second;
+    std::vector<double> values;
+    for (size_t i = 0; i < warm.size(); ++i) {
+        for (size_t j = i + 1; j < warm.size(); ++j) {
+            const int64_t dx = warm[j].first - warm[i].first;
+            if (dx != 0) values.push_back((double)(warm[j].second - warm[i].second) / (double)dx);
+        }
+    }
+    if (values.empty()) {
+        // x ȫͬ (豸ʱ)ĵ
+        warm.erase(warm.begin());
+        return;
+    }
+    const double slope = median(values);
+    values.clear();
+    for (const auto& p : warm) values.push_back((double)(p.second - y0) - slope * (double)(p.first - x0));
+    const double intercept = median(values);
+    for (double& v : values) v = std::fabs(v - intercept);
+    const double mad = median(values);
+
+    ox = x0;
+    oy = y0;
+    a = intercept;
+    b = slope;
+    scale_ = std::max(options.min_scale, 1.4826 * mad);
+    ready_ = true;
+    consecutive_rejects = 0;
+
+    // ڵһμȨСˣõԼƵۼ
+    std::vector<std::pair<int64_t, int64_t>> points;
+    points.swap(warm);
+    const double line_a = a, line_b = b;
+    for (const auto& p : points) {
+        const double r = (double)(p.second - y0) - (line_a + line_b * (double)(p.first - x0));
+        if (std::fabs(r) <= options.reject_k * scale_) accumulate(p.first, p.second, 1.0);
+        else rejected_++;
+    }
+}
+
+void RobustLineFit::accumulate(int64_t x, int64_t y, double weight)
+{
+    // ԭƵ (x, y)ƽۼֱߣµ (µԭΪ 0)
+    const double dx = (double)(x - ox);
+    const double dy = (double)(y - oy);
+    sxx = sxx - 2 * dx * sx + dx * dx * sw;
+    sxy = sxy - dx * sy - dy * sx + dx * dy * sw;
+    sx -= dx * sw;
+    sy -= dy * sw;
+    a = a + b * dx - dy;
+    ox = x;
+    oy = y;
+
+    const double lambda = options.forgetting;
+    sw = sw * lambda + weight;
+    sx *= lambda;
+    sy *= lambda;
+    sxx *= lambda;
+    sxy *= lambda;
+
+    const double det = sw * sxx - sx * sx;
+    if (det > 1e-12 * sw * sxx && sw > 0) {
+        b = (sw * sxy - sx * sy) / det;
+        a = (sy - b * sx) / sw;
+    }
+}
+
+// ============================ ClockSync ============================
+
+// ʱ -> ¼ʱӵϣ֡صĵʱ̶Ϊ뼶в߶޷ſ 200 us
+ClockSync::Options ClockSync::defaultOptions()
+{
+    Options options;
+    options.host_fit.min_scale = 200;
+    return options;
+}
+
+ClockSync::ClockSync() : ClockSync(defaultOptions())
+{
+}
+
+ClockSync::ClockSync(const Options& options) : options(options), device_fit(options.device_fit), host_fit(options.host_fit)
+{
+}
+
+void ClockSync::setOptions(const Options& new_options)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    options = new_options;
+    device_fit.setOptions(options.device_fit);
+    host_fit.setOptions(options.host_fit);
+}
+
+void ClockSync::reset()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    device_fit = RobustLineFit(options.device_fit);
+    host_fit = RobustLineFit(options.host_fit);
+    pulses = 0;
+    have_rgb = false;
+    first_frame_number = 0;
+    rgb_frames = 0;
+    pairs = 0;
+    pending_pulses.clear();
+    pending_frames.clear();
+}
+
+void ClockSync::addTriggers(const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (const Metavision::EventExtTrigger* e = begin; e != end; ++e) {
+        if (options.channel >= 0 && e->id != options.channel) continue;
+        if ((e->p != 0) != options.rising_starts) continue;
+        const uint64_t k = pulses++;
+        auto frame = pending_frames.find(k);
+        if (frame != pending_frames.end()) {
+            pair(e->t, frame->second);
+            pending_frames.erase(frame);
+        }
+        else {
+            pending_pulses[k] = e->t;
+            if (pending_pulses.size() > options.max_pending) pending_pulses.erase(pending_pulses.begin());
+        }
+    }
+}
+
+void ClockSync::addRgbFrame(uint64_t frame_number, uint64_t host_timestamp_ns, uint64_t device_timestamp)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    rgb_frames++;
+    if (!have_rgb) {
+        have_rgb = true;
+        first_frame_number = frame_number;
+    }
+    if (frame_number < first_frame_number) return;
+    const uint64_t k = frame_number - first_frame_number;
+    const Frame frame{ host_timestamp_ns, device_timestamp };
+    auto pulse = pending_pulses.find(k);
+    if (pulse != pending_pulses.end()) {
+        pair(pulse->second, frame);
+        pending_pulses.erase(pulse);
+    }
+    else {
+        pending_frames[k] = frame;
+        if (pending_frames.size() > options.max_pending) pending_frames.erase(pending_frames.begin());
+    }
+}
+
+// ѳ mutex
+void ClockSync::pair(int64_t t, const Frame& frame)
+{
+    pairs++;
+    if (frame.device_timestamp != 0) device_fit.add((int64_t)frame.device_timestamp, t);
+    host_fit.add((int64_t)frame.host_ns, t);
+}
+
+ClockSync::Estimate ClockSync::align(uint64_t frame_number, uint64_t host_timestamp_ns, uint64_t device_timestamp) const
+{
+    (void)frame_number;
+    std::lock_guard<std::mutex> lock(mutex);
+    Estimate estimate;
+    if (device_timestamp != 0 && device_fit.ready()) {
+        estimate.t_us = (int64_t)std::llround(device_fit.predict((int64_t)device_timestamp));
+        estimate.source = Source::Device;
+    }
+    else if (host_fit.ready()) {
+        estimate.t_us = (int64_t)std::llround(host_fit.predict((int64_t)host_timestamp_ns));
+        estimate.source = Source::Host;
+    }
+    return estimate;
+}
+
+bool ClockSync::write(H5::Group& parent) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    try {
+        H5::Group group = parent.createGroup("clock");
+        // event_us(x) = event_at_origin + slope * (x - origin)x Ϊ豸ʱ /  ns
+        const struct {
+            const char* prefix;
+            const RobustLineFit& fit;
+        } fits[] = { { "device", device_fit }, { "host", host_fit } };
+        for (const auto& f : fits) {
+            const std::string prefix = f.prefix;
+            const uint8_t ready = f.fit.ready() ? 1 : 0;
+            const int64_t origin = f.fit.originX();
+            const double at_origin = f.fit.ready() ? f.fit.predict(origin) : 0;
+            const double slope = f.fit.slope();
+            const double residual = f.fit.scale();
+            const uint64_t samples = f.fit.samples();
+            const uint64_t rejected = f.fit.rejected();
+            writeAttribute(group, (prefix + "_ready").c_str(), H5::PredType::NATIVE_UINT8, &ready);
+            writeAttribute(group, (prefix + "_origin").c_str(), H5::PredType::NATIVE_INT64, &origin);
+            writeAttribute(group, (prefix + "_event_at_origin").c_str(), H5::PredType::NATIVE_DOUBLE, &at_origin);
+            writeAttribute(group, (prefix + "_slope").c_str(), H5::PredType::NATIVE_DOUBLE, &slope);
+            writeAttribute(group, (prefix + "_residual_us").c_str(), H5::PredType::NATIVE_DOUBLE, &residual);
+            writeAttribute(group, (prefix + "_samples").c_str(), H5::PredType::NATIVE_UINT64, &samples);
+            writeAttribute(group, (prefix + "_rejected").c_str(), H5::PredType::NATIVE_UINT64, &rejected);
+        }
+        writeAttribute(group, "pairs", H5::PredType::NATIVE_UINT64, &pairs);
+    }
+    catch (H5::Exception& e) {
+        printf("Failed to write clock alignment: %s\n", e.getCDetailMsg());
+        return false;
+    }
+    return true;
+}
+
+ClockSync::Stats ClockSync::stats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats s;
+    s.pulses = pulses;
+    s.rgb_frames = rgb_frames;
+    s.pairs = pairs;
+    s.device_rejected = device_fit.rejected();
+    s.host_rejected = host_fit.rejected();
+    s.relocks = device_fit.relocks() + host_fit.relocks();
+    s.device_ready = device_fit.ready();
+    s.host_ready = host_fit.ready();
+    s.device_slope = device_fit.slope();
+    s.device_residual_us = device_fit.scale();
+    s.host_slope = host_fit.slope();
+    s.host_residual_us = host_fit.scale();
+    return s;
+}
@@ -1,118 +1,307 @@
 #include "../include/DVS.h" //  .h ļ include Ŀ¼
+#include "MetavisionEventSource.h"
+#include "SteadyClock.h"
+#include <chrono>
+#include <filesystem>
+
+namespace {
+    uint64_t fileBytes(const std::string& path)
+    {
+        std::error_code ec;
+        const uintmax_t size = std::filesystem::file_size(path, ec);
+        return ec ? 0 : (uint64_t)size;
+    }
+}
 
 // 캯ʼ DVS ģ
-DVS::DVS() {
-    // ϵͳҵһõ Metavision 
-    cam = Metavision::Camera::from_first_available();
+DVS::DVS() : DVS(std::make_unique<MetavisionEventSource>()) {
+}
 
-    // ⲿͨڽⲿźţ
-    cam.get_device().get_facility<Metavision::I_TriggerIn>()->enable(Metavision::I_TriggerIn::Channel::Main);
+DVS::DVS(std::unique_ptr<EventSource> event_source) : source(std::move(event_source)) {
+    // ¼Դ (ҵһõ Metavision ⲿ)
+    if (!source || !source->open()) {
+        printf("DVS event source not available.\n");
+        return;
+    }
 
     // ȡֱ
-    camera_width = cam.geometry().width();
-    camera_height = cam.geometry().height();
-
-    // ֡ɵĲ
-    acc = 20000;   // ۻʱ (us)ƶʱڵ¼һ֡
-    fps = 50;      // ֡ (frames per second)
-
-    // ֡ڽ¼תΪ̶֡ʵƵ֡
-    frame_gen = new Metavision::PeriodicFrameGenerationAlgorithm(camera_width, camera_height, acc, fps);
-
-    // ¼֡CDFrameGenerator¼תΪ OpenCV ͼ
-    cd_frame_generator = new Metavision::CDFrameGenerator(camera_width, camera_height);
-    cd_frame_generator->set_display_accumulation_time_us(30000); // ʾ¼ۻʱ䴰 (us)
-
-    // *** ޸ (1): Ļص ***
-    // ֡ûص
-    cd_frame_generator->start(
-        30, // ԴԼ 30 fps ûص
-
-        // [ɵĻص¿]
-        // [this](const Metavision::timestamp& ts, const cv::Mat& frame) {
-        //     cv::Mat frame_(frame);
-        //     queue.push(frame_); // <-- ֮ǰ
-        // }
-
-        // [µĻص]
-        [this](const Metavision::timestamp& ts, const cv::Mat& frame) {
-            // ֡ʱ
-            std::lock_guard<std::mutex> lock(m_frame_mutex);
-            // ֡ (clone)  m_latest_frame Ա
-            m_latest_frame = frame.clone();
-        });
+    camera_width = source->width();
+    camera_height = source->height();
+
+    // ʾ֡30 fps30ms ۻڣɫԭ CDFrameGenerator ͬ
+    // (ԭ PeriodicFrameGenerationAlgorithm ûصδʹãٱ)
+    accumulator = std::make_unique<EventAccumulator>(camera_width, camera_height);
+    setDisplay(30, 30000);
+}
+
+void DVS::setDisplay(double fps, Metavision::timestamp accumulation_us) {
+    if (!accumulator) return;
+    EventAccumulator::DisplayOptions display;
+    display.fps = fps;
+    display.accumulation_us = accumulation_us;
+    if (fps <= 0) {
+        accumulator->setDisplayOutput(display, nullptr);
+        return;
+    }
+    accumulator->setDisplayOutput(display, [this](const EventImage& image) {
+        // ۼĻᱻã뿽һΣд˻ߴ粻ʱ copyTo ·
+        cv::Mat frame(image.height, image.width, CV_8UC3, const_cast<uint8_t*>(image.data), image.stride);
+        frame.copyTo(m_live_frame.writeBuffer());
+        m_live_frame.publish();
+    });
+}
 
-    // ע CD ¼ص¼ʱ䴫֡
-    // (ⲿֱֲ)
-    cam.cd().add_callback([&](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
-        frame_gen->process_events(begin, end);      // ֡
-        cd_frame_generator->add_events(begin, end);  //  CD ֡
+// CD ¼ص¼Դ¼ʱһαۼ (ʾ֡ / ֱͼ / ʱ)
+void DVS::onEvents(const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+    accumulator->processEvents(begin, end);
+    if (writing_events.load(std::memory_order_acquire)) {
+        event_writer.write(begin, end); // ֻдĻ壬һ
+        trigger_index.addEvents(begin, end); // ¼ţرʱд任к
+    }
+}
 
-        // (ע⣺֮ǰĴûн¼ raw_queue
-        // Ҫԭʼ¼Ҫ raw_queue.push(...))
+// ⲿص CD صͬһ߳
+void DVS::onTriggers(const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end) {
+    const uint64_t host_timestamp_ns = steadyNowNs();
+    clock_sync.addTriggers(begin, end);
+    if (writing_events.load(std::memory_order_acquire)) {
+        trigger_index.addTriggers(begin, end, host_timestamp_ns);
+    }
+}
+
+void DVS::onRgbFrame(uint64_t frame_number, uint64_t host_timestamp_ns, uint64_t device_timestamp) {
+    clock_sync.addRgbFrame(frame_number, host_timestamp_ns, device_timestamp);
+    if (writing_events.load(std::memory_order_acquire)) {
+        trigger_index.addRgbFrame(frame_number);
+    }
+}
+
+void DVS::alignRgbFrame(FrameRecord& record) const {
+    const ClockSync::Estimate estimate = clock_sync.align(record.frame_number, record.host_timestamp_ns, record.device_timestamp);
+    record.event_timestamp_us = estimate.t_us;
+    record.event_timestamp_source = (uint8_t)estimate.source;
+}
+
+void DVS::setTriggerIndex(const TriggerIndex::Options& options) {
+    trigger_index.setOptions(options);
+    ClockSync::Options clock_options = ClockSync::defaultOptions();
+    clock_options.rising_starts = options.rising_starts;
+    clock_options.channel = options.channel;
+    clock_sync.setOptions(clock_options);
+}
+
+// ¼ (ص¼Դ߳)
+bool DVS::startStream() {
+    if (!accumulator) {
+        printf("DVS event source not open. Cannot start.\n");
+        return false;
+    }
+    accumulator->reset(); // ط / ¿ʼʱʱͷʼ
+    source->setTriggerCallback([this](const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end) {
+        onTriggers(begin, end);
+        });
+    return source->start([this](const Metavision::EventCD* begin, const Metavision::EventCD* end) {
+        onEvents(begin, end);
         });
 }
 
 // ͷԴ
 DVS::~DVS() {
-    if (cam.is_running()) {
-        cam.stop(); // ֹͣɼ
+    stopSegments(); // ֶ¼бʱҲҪջж߳
+    if (source) {
+        source->stop(); // ֹͣɼ֮󲻻¼ص
+        source->close();
     }
-    if (frame_gen)
-        delete frame_gen; // ͷ֡
-    if (cd_frame_generator)
-        delete cd_frame_generator; // ͷ¼֡
 }
 
-// *** ޸ (2):  getFrame()  ***
-// ȡһ֡ͼ񣨴 m_latest_frame ػȡ
-cv::Mat DVS::getFrame() {
-    // [ɵʵ֣¿]
-    // cv::Mat output;
-    // queue.wait_pop(output); // <--  GUI ߳
-    // return output;
+// ȡµһ֡ ()
+bool DVS::getFrame(cv::Mat& frame) {
+    if (!m_live_frame.update()) return false; // û֡
+    frame = m_live_frame.readBuffer();
+    return !frame.empty();
+}
 
-    // [µʵ֣]
-    cv::Mat output; // һյ Mat
+void DVS::setSegmentation(const SegmentPolicy& policy) {
+    segment_policy = policy;
+}
 
-    // һʱԱ lock_guard ʱͷ
-    {
-        std::lock_guard<std::mutex> lock(m_frame_mutex);
+void DVS::setRecordFormat(RecordFormat format) {
+    record_format = format;
+}
 
-        //  m_latest_frame ǷѾ
-        if (!m_latest_frame.empty()) {
-            //  (clone) µ֡ output
-            output = m_latest_frame.clone();
-        }
-    }
-    // (ڴ˴Զͷ)
+void DVS::setEventWriterOptions(const H5EventWriter::Options& options) {
+    event_writer.setOptions(options);
+}
 
-    //  output
-    //  m_latest_frame û׼ãһ Mat
-    //  Gui.cpp е updateDvsDisplaySlot() Ѿ
-    // if (temp.empty()) ļ飬ǰȫġ
-    return output;
+// ¼ԴѾֹͣ (ٵ write) ֮
+void DVS::closeEventFile() {
+    if (!event_writer.isOpen()) return;
+    writing_events = false;
+    trigger_index.finish();
+    event_writer.close([this](H5::Group& group) {
+        trigger_index.mapEventRows([this](uint64_t event) { return event_writer.rowOf(event); });
+        const bool ok = trigger_index.write(group, event_writer.stats().dropped_events);
+        return clock_sync.write(group) && ok;
+    });
+    const TriggerIndex::Stats stats = trigger_index.stats();
+    printf("DVS trigger index: %llu pulses, %llu RGB frames, %llu approximate.\n", (unsigned long long)stats.pulses,
+        (unsigned long long)stats.rgb_frames, (unsigned long long)stats.approximate);
+    const ClockSync::Stats clock = clock_sync.stats();
+    printf("DVS clock sync: %llu pairs, device fit %s (residual %.1f us, %llu rejected), host fit %s (residual %.0f us).\n",
+        (unsigned long long)clock.pairs, clock.device_ready ? "ready" : "not ready", clock.device_residual_us,
+        (unsigned long long)clock.device_rejected, clock.host_ready ? "ready" : "not ready", clock.host_residual_us);
 }
 
 // ʼɼ¼
-// (ֲ)
-void DVS::start(const std::string& name) {
+void DVS::start(const std::string& name, const std::string& root) {
+    dataset_folder = (root.empty() ? std::string(".") : root) + "/" + name;
     // ñļ·Ϊ raw ʽ
-    save_folder = "./" + name + "/" + name + ".raw";
+    save_folder = dataset_folder + "/" + name + ".raw";
+    clock_sync.reset();  //  k Ӧβɼĵ k ֡ͷ
+    raw_output = RawOutput::None;
+    events_file_opened = false;
+
+    // HDF5 ¼֮ǰ򿪣һ¼дȥ
+    if (record_format != RecordFormat::Raw && accumulator) {
+        std::error_code ec;
+        std::filesystem::create_directories(dataset_folder, ec);
+        if (event_writer.open(dataset_folder + "/" + H5EventWriter::kFileName, camera_width, camera_height)) {
+            trigger_index.reset();
+            writing_events = true;
+            events_file_opened = true;
+        }
+    }
+
+    if (!startStream()) {  // 
+        closeEventFile();
+        return;
+    }
+    if (record_format == RecordFormat::Hdf5) return;
+    if (!source->canRecord()) {
+        // ط / ϳ¼Դֻʾδ .raw
+        printf("DVS %s source does not record .raw files.\n", source->name());
+        return;
+    }
+
+    if (!segment_policy.enabled()) {
+        source->startRecording(save_folder); // ʼ¼¼ݵָ·
+        raw_output = RawOutput::Single;
+        return;
+    }
+
+    segment_manifest = SegmentManifest();
+    segment_manifest.stream = "dvs";
+    segment_manifest.file_name = name + ".raw";
+    segment_manifest.format.width = camera_width;
+    segment_manifest.format.height = camera_height;
+    segment_manifest.format.channels = 0;
+    segment_manifest.format.pixel_format = "events";
 
-    cam.start(); // 
-    cam.start_recording(save_folder); // ʼ¼¼ݵָ·
+    SegmentInfo first;
+    current_segment_path = segmentPath(0, first.path);
+    first.first_host_timestamp_ns = steadyNowNs();
+    segment_manifest.segments.push_back(first);
+    writeSegmentManifest(dataset_folder + "/dvs_manifest.json", segment_manifest);
+
+    source->startRecording(current_segment_path);
+    segment_stop = false;
+    segment_thread = std::thread(&DVS::segmentLoop, this);
+    raw_output = RawOutput::Segmented;
+}
+
+uint64_t DVS::recordedBytes() const {
+    uint64_t bytes = 0;
+    if (raw_output == RawOutput::Single) {
+        bytes += fileBytes(save_folder);
+    }
+    else if (raw_output == RawOutput::Segmented) {
+        for (const SegmentInfo& segment : segment_manifest.segments) bytes += segment.bytes; // ιرʱµĴС
+    }
+    if (events_file_opened) bytes += fileBytes(dataset_folder + "/" + H5EventWriter::kFileName);
+    return bytes;
+}
+
+//  index εļ·manifest_path Ϊд嵥· (ݼĿ¼Ϊ·)
+std::string DVS::segmentPath(uint32_t index, std::string& manifest_path) const {
+    namespace fs = std::filesystem;
+    const std::string file_name = segmentFileName(segment_manifest.file_name, index);
+    if (segment_policy.directories.empty()) {
+        manifest_path = file_name;
+        return dataset_folder + "/" + file_name;
+    }
+    const fs::path directory = fs::path(segment_policy.directories[index % segment_policy.directories.size()]) /
+        fs::path(dataset_folder).lexically_normal().filename();
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    if (ec) printf("Failed to create segment directory %s: %s\n", directory.string().c_str(), ec.message().c_str());
+    manifest_path = fs::absolute(directory / file_name).string();
+    return (directory / file_name).string();
+}
+
+void DVS::closeSegment(SegmentInfo& info) {
+    info.bytes = fileBytes(current_segment_path);
+    info.last_host_timestamp_ns = steadyNowNs();
+    info.closed = true;
+}
+
+// ÿ 100ms һεǰεʱļС޾еһ
+void DVS::segmentLoop() {
+    std::unique_lock<std::mutex> lock(segment_mutex);
+    while (!segment_stop) {
+        segment_cv.wait_for(lock, std::chrono::milliseconds(100));
+        if (segment_stop) break;
+
+        SegmentInfo& info = segment_manifest.segments.back();
+        std::error_code ec;
+        const uintmax_t size = std::filesystem::file_size(current_segment_path, ec);
+        const double seconds = (steadyNowNs() - info.first_host_timestamp_ns) / 1e9;
+        const bool rotate = (segment_policy.max_seconds > 0 && seconds >= segment_policy.max_seconds) ||
+            (segment_policy.max_bytes > 0 && !ec && size >= segment_policy.max_bytes);
+        if (!rotate) continue;
+
+        SegmentInfo next;
+        next.index = info.index + 1;
+        const std::string next_path = segmentPath(next.index, next.path);
+        // ȿļͣļ (SDK ֧ͬʱ¼ƶļ)лص¼ᶪ¼
+        source->startRecording(next_path);
+        next.first_host_timestamp_ns = steadyNowNs();
+        source->stopRecording(current_segment_path);
+        closeSegment(info);
+        current_segment_path = next_path;
+        segment_manifest.segments.push_back(next);
+        writeSegmentManifest(dataset_folder + "/dvs_manifest.json", segment_manifest);
+    }
+}
+
+// ֹͣж̲߳嵥 (ֹͣǰε¼)ûзֶ¼ʱʲôҲ
+void DVS::stopSegments() {
+    if (!segment_thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(segment_mutex);
+        segment_stop = true;
+    }
+    segment_cv.notify_all();
+    segment_thread.join();
+    source->stopRecording(); // ֹͣ¼
+    closeSegment(segment_manifest.segments.back());
+    segment_manifest.complete = true;
+    writeSegmentManifest(dataset_folder + "/dvs_manifest.json", segment_manifest);
 }
 
 // ֹͣɼ
 // (ֲ)
 void DVS::stop() {
-    cam.stop();
+    stopSegments();
+    if (source) source->stop();
+    closeEventFile();
 }
 
 // ֹͣ¼Ʋر
 // (ֲ)
 void DVS::stopRecord() {
-    cam.stop_recording(); // ֹͣ¼
-    cam.stop();           // ֹͣ
+    if (!source) return;
+    if (segment_thread.joinable()) stopSegments();
+    else if (source->canRecord()) source->stopRecording(); // ֹͣ¼
+    source->stop();           // ֹͣ
+    closeEventFile();         // ¼Դֹͣдʣ¼
 }
\ No newline at end of file
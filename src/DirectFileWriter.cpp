@@ -0,0 +1,471 @@
+#include "DirectFileWriter.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <malloc.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#if defined(__linux__)
+#include <atomic>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+#endif
+
+namespace {
+    const uint64_t kPreallocateStep = 256ull << 20;  // ÿԤ 256MBļչԪݸ
+
+    size_t alignUp(size_t value)
+    {
+        return (value + DirectFileWriter::kAlignment - 1) / DirectFileWriter::kAlignment * DirectFileWriter::kAlignment;
+    }
+
+    uint8_t* alignedAlloc(size_t bytes)
+    {
+#if defined(_WIN32)
+        return (uint8_t*)_aligned_malloc(bytes, DirectFileWriter::kAlignment);
+#else
+        void* p = nullptr;
+        if (posix_memalign(&p, DirectFileWriter::kAlignment, bytes) != 0) return nullptr;
+        return (uint8_t*)p;
+#endif
+    }
+
+    void alignedFree(uint8_t* p)
+    {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+}
+
+#if defined(__linux__)
+// io_uring СװһύСһɶУֻ IORING_OP_WRITE
+struct DirectFileWriter::Ring {
+    int fd = -1;
+    void* sq_ptr = nullptr;
+    size_t sq_size = 0;
+    void* cq_ptr = nullptr;
+    size_t cq_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+
+    unsigned* sq_tail = nullptr;
+    unsigned* sq_mask = nullptr;
+    unsigned* sq_array = nullptr;
+    unsigned* cq_head = nullptr;
+    unsigned* cq_tail = nullptr;
+    unsigned* cq_mask = nullptr;
+    io_uring_cqe* cqes = nullptr;
+
+    bool setup(unsigned entries)
+    {
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0) return false;
+
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        const bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap) sq_size = cq_size = (sq_size > cq_size ? sq_size : cq_size);
+
+        sq_ptr = mmap(nullptr, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED) { sq_ptr = nullptr; return false; }
+        if (single_mmap) {
+            cq_ptr = sq_ptr;
+        }
+        else {
+            cq_ptr = mmap(nullptr, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED) { cq_ptr = nullptr; return false; }
+        }
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        sqes = (io_uring_sqe*)mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) { sqes = nullptr; return false; }
+
+        uint8_t* sq = (uint8_t*)sq_ptr;
+        uint8_t* cq = (uint8_t*)cq_ptr;
+        sq_tail = (unsigned*)(sq + params.sq_off.tail);
+        sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+        sq_array = (unsigned*)(sq + params.sq_off.array);
+        cq_head = (unsigned*)(cq + params.cq_off.head);
+        cq_tail = (unsigned*)(cq + params.cq_off.tail);
+        cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+        cqes = (io_uring_cqe*)(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    void teardown()
+    {
+        if (sqes) munmap(sqes, sqes_size);
+        if (cq_ptr && cq_ptr != sq_ptr) munmap(cq_ptr, cq_size);
+        if (sq_ptr) munmap(sq_ptr, sq_size);
+        if (fd >= 0) ::close(fd);
+        sqes = nullptr;
+        sq_ptr = cq_ptr = nullptr;
+        fd = -1;
+    }
+
+    bool submitWrite(int file_fd, const void* buffer, unsigned bytes, uint64_t offset, uint64_t user_data)
+    {
+        const unsigned tail = *sq_tail;
+        const unsigned index = tail & *sq_mask;
+        io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = IORING_OP_WRITE;
+        sqe->fd = file_fd;
+        sqe->addr = (uint64_t)(uintptr_t)buffer;
+        sqe->len = bytes;
+        sqe->off = offset;
+        sqe->user_data = user_data;
+        sq_array[index] = index;
+        __atomic_store_n(sq_tail, tail + 1, __ATOMIC_RELEASE);
+        while (true) {
+            const long n = syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0);
+            if (n == 1) return true;
+            if (n < 0 && errno == EINTR) continue;
+            if (n == 0) errno = EAGAIN;
+            return false;
+        }
+    }
+
+    // ȡһ¼wait Ϊ true ʱһ
+    bool reap(bool wait, uint64_t& user_data, int64_t& result)
+    {
+        while (true) {
+            const unsigned head = *cq_head;
+            if (head != __atomic_load_n(cq_tail, __ATOMIC_ACQUIRE)) {
+                const io_uring_cqe& cqe = cqes[head & *cq_mask];
+                user_data = cqe.user_data;
+                result = cqe.res;
+                __atomic_store_n(cq_head, head + 1, __ATOMIC_RELEASE);
+                return true;
+            }
+            if (!wait) return false;
+            if (syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR) {
+                return false;
+            }
+        }
+    }
+};
+#endif
+
+DirectFileWriter::~DirectFileWriter()
+{
+    close();
+}
+
+bool DirectFileWriter::open(const std::string& path, size_t queue_depth, size_t bytes_per_buffer, Backend backend)
+{
+    close();
+    stats_ = Stats();
+    buffer_bytes = alignUp(bytes_per_buffer);
+    next_offset = 0;
+    allocated = 0;
+    in_flight = 0;
+    next_slot = 0;
+    slots.assign(queue_depth == 0 ? 1 : queue_depth, Slot());
+    for (Slot& slot : slots) {
+        slot.buffer = alignedAlloc(buffer_bytes);
+        if (!slot.buffer) {
+            printf("Failed to allocate %zu byte aligned buffer.\n", buffer_bytes);
+            releaseBuffers();
+            return false;
+        }
+    }
+
+#if defined(_WIN32)
+    HANDLE h = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_NO_BUFFERING | FILE_FLAG_OVERLAPPED, NULL);
+    if (h == INVALID_HANDLE_VALUE) {
+        printf("Failed to open %s (error %lu).\n", path.c_str(), GetLastError());
+        releaseBuffers();
+        return false;
+    }
+    handle = h;
+    // ص I/O ͬʱҲʵͬд (ύȴ)
+    for (Slot& slot : slots) {
+        OVERLAPPED* ov = new OVERLAPPED();
+        ov->hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+        slot.overlapped = ov;
+    }
+    active = backend == Backend::Sync ? Backend::Sync : Backend::Overlapped;
+#else
+    int flags = O_WRONLY | O_CREAT | O_TRUNC;
+#if defined(O_DIRECT)
+    fd = ::open(path.c_str(), flags | O_DIRECT, 0644);
+    if (fd < 0 && errno == EINVAL) {
+        printf("O_DIRECT is not supported for %s, falling back to buffered writes.\n", path.c_str());
+    }
+#endif
+    if (fd < 0) fd = ::open(path.c_str(), flags, 0644);
+    if (fd < 0) {
+        printf("Failed to open %s: %s\n", path.c_str(), strerror(errno));
+        releaseBuffers();
+        return false;
+    }
+    active = Backend::Sync;
+#if defined(__linux__)
+    if (backend == Backend::Auto || backend == Backend::IoUring) {
+        ring = new Ring();
+        if (ring->setup((unsigned)slots.size())) {
+            active = Backend::IoUring;
+        }
+        else {
+            printf("io_uring is not available (%s), using synchronous writes.\n", strerror(errno));
+            ring->teardown();
+            delete ring;
+            ring = nullptr;
+        }
+    }
+#endif
+#endif
+    is_open = true;
+    return true;
+}
+
+const char* DirectFileWriter::backendName() const
+{
+    switch (active) {
+    case Backend::IoUring: return "io_uring";
+    case Backend::Overlapped: return "overlapped";
+    case Backend::Sync: return "sync";
+    default: return "auto";
+    }
+}
+
+uint8_t* DirectFileWriter::acquire()
+{
+    if (!is_open || broken) return nullptr;
+    for (size_t k = 0; k < slots.size(); ++k) {
+        Slot& slot = slots[(next_slot + k) % slots.size()];
+        if (!slot.in_flight) {
+            next_slot = (next_slot + k + 1) % slots.size();
+            return slot.buffer;
+        }
+    }
+    stats_.waits++;
+    if (!waitOne()) return nullptr;
+    return acquire();
+}
+
+bool DirectFileWriter::submit(uint8_t* buffer, size_t bytes)
+{
+    if (!is_open || broken || bytes == 0 || bytes % kAlignment != 0 || bytes > buffer_bytes) return false;
+    size_t index = 0;
+    while (index < slots.size() && slots[index].buffer != buffer) ++index;
+    if (index == slots.size() || slots[index].in_flight) return false;
+    Slot& slot = slots[index];
+    const uint64_t offset = next_offset;
+    next_offset += bytes;
+
+#if defined(__linux__)
+    // 󲽳Ԥ䣬ÿ׷Ӷ޸ļȵԪ (ʧܲӰд)
+    if (next_offset > allocated) {
+        const uint64_t target = next_offset + kPreallocateStep;
+        if (fallocate(fd, FALLOC_FL_KEEP_SIZE, (off_t)allocated, (off_t)(target - allocated)) == 0) {
+            allocated = target;
+        }
+        else {
+            allocated = UINT64_MAX;  // ļϵͳ֧֣ٳ
+        }
+    }
+    if (active == Backend::IoUring) {
+        slot.in_flight = true;
+        slot.bytes = bytes;
+        in_flight++;
+        if (!ring->submitWrite(fd, buffer, (unsigned)bytes, offset, index)) {
+            printf("io_uring submit failed: %s, no further writes to this file.\n", strerror(errno));
+            abandonRing();
+            return false;
+        }
+        return true;
+    }
+#elif defined(_WIN32)
+    if (active == Backend::Overlapped) {
+        OVERLAPPED* ov = (OVERLAPPED*)slot.overlapped;
+        ResetEvent(ov->hEvent);
+        ov->Offset = (DWORD)(offset & 0xFFFFFFFF);
+        ov->OffsetHigh = (DWORD)(offset >> 32);
+        slot.in_flight = true;
+        slot.bytes = bytes;
+        in_flight++;
+        if (!WriteFile((HANDLE)handle, buffer, (DWORD)bytes, NULL, ov) && GetLastError() != ERROR_IO_PENDING) {
+            printf("WriteFile failed (error %lu).\n", GetLastError());
+            complete(index, -1);
+            return false;
+        }
+        return true;
+    }
+#endif
+    return submitSync(slot, bytes, offset);
+}
+
+bool DirectFileWriter::submitSync(Slot& slot, size_t bytes, uint64_t offset)
+{
+#if defined(_WIN32)
+    OVERLAPPED* ov = (OVERLAPPED*)slot.overlapped;
+    ResetEvent(ov->hEvent);
+    ov->Offset = (DWORD)(offset & 0xFFFFFFFF);
+    ov->OffsetHigh = (DWORD)(offset >> 32);
+    DWORD written = 0;
+    BOOL ok = WriteFile((HANDLE)handle, slot.buffer, (DWORD)bytes, NULL, ov);
+    if (!ok && GetLastError() == ERROR_IO_PENDING) ok = GetOverlappedResult((HANDLE)handle, ov, &written, TRUE);
+    else if (ok) GetOverlappedResult((HANDLE)handle, ov, &written, FALSE);
+    if (!ok || written != bytes) {
+        stats_.errors++;
+        return false;
+    }
+#else
+    size_t done = 0;
+    while (done < bytes) {
+        ssize_t n = pwrite(fd, slot.buffer + done, bytes - done, (off_t)(offset + done));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            printf("pwrite failed: %s\n", strerror(errno));
+            stats_.errors++;
+            return false;
+        }
+        done += (size_t)n;
+    }
+#endif
+    stats_.writes++;
+    stats_.bytes += bytes;
+    return true;
+}
+
+void DirectFileWriter::complete(size_t index, int64_t result)
+{
+    Slot& slot = slots[index];
+    if (result != (int64_t)slot.bytes) {
+        if (result >= 0) printf("Short direct write: %lld of %zu bytes.\n", (long long)result, slot.bytes);
+        stats_.errors++;
+    }
+    else {
+        stats_.writes++;
+        stats_.bytes += slot.bytes;
+    }
+    slot.in_flight = false;
+    in_flight--;
+}
+
+#if defined(__linux__)
+// SQE ѾύСio_uring_enter ȴûнʱڶһ enter ͬ
+// ѾյĲλƫһύԵǰύ¼ ring֮дȫʧ
+void DirectFileWriter::abandonRing()
+{
+    uint64_t user_data = 0;
+    int64_t result = 0;
+    size_t submitted = in_flight - 1;   // һûбں˽
+    while (submitted > 0 && ring->reap(true, user_data, result)) {
+        complete((size_t)user_data, result);
+        submitted--;
+    }
+    ring->teardown();
+    delete ring;
+    ring = nullptr;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i].in_flight) complete(i, -1);
+    }
+    broken = true;
+}
+#endif
+
+bool DirectFileWriter::waitOne()
+{
+    if (in_flight == 0) return true;
+#if defined(__linux__)
+    if (active == Backend::IoUring) {
+        uint64_t user_data = 0;
+        int64_t result = 0;
+        if (!ring->reap(true, user_data, result)) {
+            printf("io_uring wait failed: %s\n", strerror(errno));
+            return false;
+        }
+        complete((size_t)user_data, result);
+        // ˳յɵ
+        while (ring->reap(false, user_data, result)) complete((size_t)user_data, result);
+        return true;
+    }
+#elif defined(_WIN32)
+    if (active == Backend::Overlapped) {
+        std::vector<HANDLE> events;
+        std::vector<size_t> indices;
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (!slots[i].in_flight) continue;
+            events.push_back(((OVERLAPPED*)slots[i].overlapped)->hEvent);
+            indices.push_back(i);
+        }
+        DWORD r = WaitForMultipleObjects((DWORD)events.size(), events.data(), FALSE, INFINITE);
+        if (r >= WAIT_OBJECT_0 + events.size()) return false;
+        for (size_t k = 0; k < indices.size(); ++k) {
+            Slot& slot = slots[indices[k]];
+            DWORD written = 0;
+            if (GetOverlappedResult((HANDLE)handle, (OVERLAPPED*)slot.overlapped, &written, FALSE)) {
+                complete(indices[k], (int64_t)written);
+            }
+            else if (GetLastError() != ERROR_IO_INCOMPLETE) {
+                complete(indices[k], -1);
+            }
+        }
+        return true;
+    }
+#endif
+    return true;
+}
+
+bool DirectFileWriter::close()
+{
+    if (!is_open) return true;
+    while (in_flight > 0 && !broken) {
+        if (!waitOne()) break;
+    }
+    bool ok = stats_.errors == 0 && in_flight == 0;
+#if defined(_WIN32)
+    for (Slot& slot : slots) {
+        if (slot.overlapped) {
+            CloseHandle(((OVERLAPPED*)slot.overlapped)->hEvent);
+            delete (OVERLAPPED*)slot.overlapped;
+            slot.overlapped = nullptr;
+        }
+    }
+    CloseHandle((HANDLE)handle);
+    handle = nullptr;
+#else
+#if defined(__linux__)
+    if (ring) {
+        ring->teardown();
+        delete ring;
+        ring = nullptr;
+    }
+    // ȥ KEEP_SIZE Ԥ䵫ûõĲ
+    if (allocated != UINT64_MAX && allocated > next_offset) {
+        if (ftruncate(fd, (off_t)next_offset) != 0) ok = false;
+    }
+#endif
+    if (::close(fd) != 0) ok = false;
+    fd = -1;
+#endif
+    releaseBuffers();
+    is_open = false;
+    broken = false;
+    return ok;
+}
+
+void DirectFileWriter::releaseBuffers()
+{
+    for (Slot& slot : slots) {
+        if (slot.buffer) alignedFree(slot.buffer);
+        slot.buffer = nullptr;
+    }
+    slots.clear();
+}
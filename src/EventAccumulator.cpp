@@ -0,0 +1,235 @@
+#include "EventAccumulator.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // ʱռ 31 λ kRebaseAt ʱ base ǰƣֻ kKeep ʷ
+    constexpr int64_t kRebaseAt = (int64_t)1 << 30;
+    constexpr int64_t kKeep = (int64_t)1 << 28;
+
+    Metavision::timestamp periodFromFps(double fps)
+    {
+        return fps > 0 ? std::max<Metavision::timestamp>(1, (Metavision::timestamp)(1e6 / fps + 0.5)) : 0;
+    }
+}
+
+EventAccumulator::EventAccumulator(int width, int height)
+    : width_(std::max(width, 1)), height_(std::max(height, 1)),
+      last_event((size_t)width_ * height_, 0)
+{
+}
+
+void EventAccumulator::setDisplayOutput(const DisplayOptions& options, OutputCallback callback)
+{
+    display_options = options;
+    Output& out = outputs[kDisplay];
+    out.period_us = periodFromFps(options.fps);
+    out.enabled = out.period_us > 0 && callback != nullptr;
+    out.callback = std::move(callback);
+    display.assign(out.enabled ? (size_t)width_ * height_ * 3 : 0, 0);
+}
+
+void EventAccumulator::setHistogramOutput(double fps, OutputCallback callback)
+{
+    Output& out = outputs[kHistogram];
+    out.period_us = periodFromFps(fps);
+    out.enabled = out.period_us > 0 && callback != nullptr;
+    out.callback = std::move(callback);
+    histogram.assign(out.enabled ? (size_t)width_ * height_ * 2 : 0, 0);
+}
+
+void EventAccumulator::setTimeSurfaceOutput(double fps, Metavision::timestamp decay, OutputCallback callback)
+{
+    Output& out = outputs[kTimeSurface];
+    out.period_us = periodFromFps(fps);
+    out.enabled = out.period_us > 0 && callback != nullptr;
+    out.callback = std::move(callback);
+    decay_us = std::max<Metavision::timestamp>(decay, 1);
+    time_surface.assign(out.enabled ? (size_t)width_ * height_ : 0, 0);
+}
+
+void EventAccumulator::reset()
+{
+    std::fill(last_event.begin(), last_event.end(), 0u);
+    std::fill(histogram.begin(), histogram.end(), (uint16_t)0);
+    started = false;
+    base = 0;
+}
+
+void EventAccumulator::processEvents(const Metavision::EventCD* begin, const Metavision::EventCD* end)
+{
+    if (begin == end) return;
+    stats_.batches++;
+    stats_.events += (uint64_t)(end - begin);
+    // ûκ (޽¼) ʱֻۼ
+    if (!outputs[kDisplay].enabled && !outputs[kHistogram].enabled && !outputs[kTimeSurface].enabled) return;
+
+    if (!started) {
+        // ʱ 0  "δ¼" base ȵһ¼ 1usһڿʼ
+        base = begin->t - 1;
+        for (Output& out : outputs) {
+            if (out.enabled) out.next_t = (begin->t / out.period_us + 1) * out.period_us;
+        }
+        started = true;
+    }
+
+    while (begin != end) {
+        Metavision::timestamp due = INT64_MAX;
+        for (const Output& out : outputs) {
+            if (out.enabled) due = std::min(due, out.next_t);
+        }
+        // ¼ʱһʱ֮ǰʱֱۼ ()
+        if ((end - 1)->t < due) {
+            accumulate(begin, end);
+            break;
+        }
+        const Metavision::EventCD* split = std::partition_point(begin, end,
+            [due](const Metavision::EventCD& e) { return e.t < due; });
+        accumulate(begin, split);
+        emitDue(split != end ? split->t : due);
+        begin = split;
+    }
+}
+
+// ѭÿ¼һд last_event (ֱͼʱټһμ)
+void EventAccumulator::accumulate(const Metavision::EventCD* begin, const Metavision::EventCD* end)
+{
+    if (begin == end) return;
+    if ((end - 1)->t - base >= kRebaseAt) rebase((end - 1)->t);
+
+    uint32_t* map = last_event.data();
+    const int w = width_;
+    const int h = height_;
+    const Metavision::timestamp b = base;
+    if (histogram.empty()) {
+        for (const Metavision::EventCD* e = begin; e != end; ++e) {
+            if (e->x >= w || e->y >= h) continue;
+            map[(size_t)e->y * w + e->x] = ((uint32_t)(e->t - b) << 1) | (uint32_t)(e->p & 1);
+        }
+    }
+    else {
+        uint16_t* hist = histogram.data();
+        for (const Metavision::EventCD* e = begin; e != end; ++e) {
+            if (e->x >= w || e->y >= h) continue;
+            const size_t i = (size_t)e->y * w + e->x;
+            const uint32_t p = (uint32_t)(e->p & 1);
+            map[i] = ((uint32_t)(e->t - b) << 1) | p;
+            uint16_t& c = hist[2 * i + p];
+            c = (uint16_t)(c + (c != 0xFFFF));
+        }
+    }
+}
+
+void EventAccumulator::rebase(Metavision::timestamp t)
+{
+    //  base ֮ǰѾԶԶκۼӴڣֱ
+    const Metavision::timestamp new_base = t - kKeep;
+    const uint32_t shift = (uint32_t)(new_base - base);
+    for (uint32_t& v : last_event) {
+        const uint32_t rel = v >> 1;
+        v = rel > shift ? ((rel - shift) << 1) | (v & 1) : 0;
+    }
+    base = new_base;
+    stats_.rebases++;
+}
+
+uint32_t EventAccumulator::relative(Metavision::timestamp t) const
+{
+    const Metavision::timestamp r = t - base;
+    return r <= 0 ? 0 : (uint32_t)std::min<Metavision::timestamp>(r, ((int64_t)1 << 31) - 1);
+}
+
+void EventAccumulator::emitDue(Metavision::timestamp t)
+{
+    for (int k = 0; k < kOutputs; ++k) {
+        Output& out = outputs[k];
+        if (!out.enabled || out.next_t > t) continue;
+        // ڼƻʱȾ (˿֮ǰ¼ۼ)
+        const Metavision::timestamp render_t = out.next_t;
+        if (k == kDisplay) renderDisplay(render_t);
+        else if (k == kHistogram) renderHistogram(render_t);
+        else renderTimeSurface(render_t);
+        // ¼жʱ
+        out.next_t = std::max(out.next_t + out.period_us, (t / out.period_us + 1) * out.period_us);
+    }
+}
+
+void EventAccumulator::renderDisplay(Metavision::timestamp t)
+{
+    const uint32_t now = relative(t);
+    const int64_t from = (int64_t)now - display_options.accumulation_us;
+    // rel > threshold ڴڣthreshold Ϊ 0δ¼ (ֵΪ 0) Զڴ
+    const uint32_t threshold = from > 0 ? (uint32_t)from : 0;
+    const uint8_t* bg = display_options.background;
+    const uint8_t* on = display_options.on_color;
+    const uint8_t* off = display_options.off_color;
+
+    const size_t n = last_event.size();
+    const uint32_t* map = last_event.data();
+    uint8_t* out = display.data();
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t v = map[i];
+        // ȫѡ޷֧
+        const uint32_t active = 0u - (uint32_t)((v >> 1) > threshold && (v >> 1) <= now);
+        const uint32_t is_on = 0u - (v & 1);
+        for (int c = 0; c < 3; ++c) {
+            const uint32_t color = (on[c] & is_on) | (off[c] & ~is_on);
+            out[3 * i + c] = (uint8_t)((color & active) | (bg[c] & ~active));
+        }
+    }
+
+    EventImage image;
+    image.data = display.data();
+    image.stride = (size_t)width_ * 3;
+    image.width = width_;
+    image.height = height_;
+    image.channels = 3;
+    image.bytes_per_channel = 1;
+    image.t = t;
+    outputs[kDisplay].callback(image);
+    stats_.display_frames++;
+}
+
+void EventAccumulator::renderHistogram(Metavision::timestamp t)
+{
+    EventImage image;
+    image.data = reinterpret_cast<const uint8_t*>(histogram.data());
+    image.stride = (size_t)width_ * 2 * sizeof(uint16_t);
+    image.width = width_;
+    image.height = height_;
+    image.channels = 2;
+    image.bytes_per_channel = 2;
+    image.t = t;
+    outputs[kHistogram].callback(image);
+    std::fill(histogram.begin(), histogram.end(), (uint16_t)0);
+    stats_.histogram_frames++;
+}
+
+void EventAccumulator::renderTimeSurface(Metavision::timestamp t)
+{
+    const uint32_t now = relative(t);
+    // 255 * (1 - age / decay) 16 λĵس
+    const uint32_t decay = (uint32_t)std::min<Metavision::timestamp>(decay_us, ((int64_t)1 << 31) - 1);
+    const uint64_t scale = ((uint64_t)255 << 16) / decay;
+    const size_t n = last_event.size();
+    const uint32_t* map = last_event.data();
+    uint8_t* out = time_surface.data();
+    for (size_t i = 0; i < n; ++i) {
+        const uint32_t rel = map[i] >> 1;
+        const uint32_t age = now - rel;
+        const bool fresh = rel != 0 && rel <= now && age < decay;
+        const uint32_t value = 255u - (uint32_t)(((uint64_t)age * scale) >> 16);
+        out[i] = fresh ? (uint8_t)value : 0;
+    }
+
+    EventImage image;
+    image.data = time_surface.data();
+    image.stride = (size_t)width_;
+    image.width = width_;
+    image.height = height_;
+    image.channels = 1;
+    image.bytes_per_channel = 1;
+    image.t = t;
+    outputs[kTimeSurface].callback(image);
+    stats_.time_surface_frames++;
+}
@@ -0,0 +1,324 @@
+#include "EventCodec.h"
+#include "BitPack.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    constexpr uint32_t kMagic = 0x42454344;  // "DCEB"
+    constexpr uint8_t kVersion = 1;
+    constexpr uint8_t kEscapeWidth = 255;
+    constexpr size_t kGroup = kBitPackGroup;
+
+    enum : uint8_t { kPolarityPacked = 0, kPolarityRuns = 1 };
+
+    template <typename T>
+    void putLE(uint8_t* p, T v)
+    {
+        for (size_t i = 0; i < sizeof(T); ++i) p[i] = (uint8_t)((uint64_t)v >> (8 * i));
+    }
+
+    template <typename T>
+    T getLE(const uint8_t* p)
+    {
+        uint64_t v = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) v |= (uint64_t)p[i] << (8 * i);
+        return (T)v;
+    }
+
+    inline uint64_t zigzag(int64_t v) { return ((uint64_t)v << 1) ^ (uint64_t)(v >> 63); }
+    inline int64_t unzigzag(uint64_t v) { return (int64_t)(v >> 1) ^ -(int64_t)(v & 1); }
+
+    inline size_t varintBytes(uint64_t v)
+    {
+        size_t n = 1;
+        while (v >= 0x80) {
+            v >>= 7;
+            n++;
+        }
+        return n;
+    }
+
+    inline void putVarint(std::vector<uint8_t>& out, uint64_t v)
+    {
+        while (v >= 0x80) {
+            out.push_back((uint8_t)(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back((uint8_t)v);
+    }
+
+    // Խ򳬹 10 ֽʱ false
+    inline bool getVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v)
+    {
+        v = 0;
+        for (int shift = 0; shift < 64 && p < end; shift += 7) {
+            const uint8_t b = *p++;
+            v |= (uint64_t)(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    inline int bitWidth(uint32_t range)
+    {
+        int w = 0;
+        while (range) {
+            range >>= 1;
+            w++;
+        }
+        return w;
+    }
+
+    // ׷һж
+    void appendPacked(std::vector<uint8_t>& out, const uint32_t* values, int width, SimdLevel level)
+    {
+        if (width == 0) return;
+        const size_t at = out.size();
+        out.resize(at + bitPackedBytes(width));
+        packBits256(values, width, out.data() + at, level);
+    }
+}
+
+size_t encodeEventBlock(const Metavision::EventCD* events, size_t count, std::vector<uint8_t>& out, SimdLevel level)
+{
+    if (count == 0 || count > kEventBlockMaxEvents) return 0;
+    const size_t start = out.size();
+    out.resize(start + kEventBlockHeaderBytes);
+
+    // ԣγ̱ʾλ (ÿǳ 32 ֽ) ȽϴС
+    uint64_t runs = 1;
+    size_t run_bytes = 0;
+    size_t packed_bytes = 0;
+    {
+        size_t run = 1;
+        for (size_t i = 1; i < count; ++i) {
+            if ((events[i].p & 1) == (events[i - 1].p & 1)) {
+                run++;
+                continue;
+            }
+            run_bytes += varintBytes(run - 1);
+            run = 1;
+            runs++;
+        }
+        run_bytes += varintBytes(run - 1) + varintBytes(runs);
+        for (size_t g = 0; g < count; g += kGroup) {
+            const size_t n = std::min(kGroup, count - g);
+            const int16_t p0 = events[g].p & 1;
+            for (size_t i = 1; i < n; ++i) {
+                if ((events[g + i].p & 1) != p0) {
+                    packed_bytes += bitPackedBytes(1);
+                    break;
+                }
+            }
+        }
+    }
+    const uint8_t p_mode = run_bytes < packed_bytes ? kPolarityRuns : kPolarityPacked;
+    if (p_mode == kPolarityRuns) {
+        putVarint(out, runs);
+        size_t run = 1;
+        for (size_t i = 1; i < count; ++i) {
+            if ((events[i].p & 1) == (events[i - 1].p & 1)) {
+                run++;
+                continue;
+            }
+            putVarint(out, run - 1);
+            run = 1;
+        }
+        putVarint(out, run - 1);
+    }
+
+    alignas(32) uint32_t dt[kGroup];
+    alignas(32) uint32_t xs[kGroup];
+    alignas(32) uint32_t ys[kGroup];
+    alignas(32) uint32_t ps[kGroup];
+    int64_t deltas[kGroup];
+    Metavision::timestamp prev_t = events[0].t;
+    for (size_t g = 0; g < count; g += kGroup) {
+        const size_t n = std::min(kGroup, count - g);
+        const Metavision::EventCD* e = events + g;
+
+        int64_t min_dt = INT64_MAX, max_dt = INT64_MIN;
+        uint32_t min_x = UINT32_MAX, max_x = 0, min_y = UINT32_MAX, max_y = 0;
+        uint32_t or_p = 0, and_p = 1;
+        for (size_t i = 0; i < n; ++i) {
+            deltas[i] = e[i].t - prev_t;
+            prev_t = e[i].t;
+            min_dt = std::min(min_dt, deltas[i]);
+            max_dt = std::max(max_dt, deltas[i]);
+            xs[i] = e[i].x;
+            ys[i] = e[i].y;
+            ps[i] = (uint32_t)(e[i].p & 1);
+            min_x = std::min(min_x, xs[i]);
+            max_x = std::max(max_x, xs[i]);
+            min_y = std::min(min_y, ys[i]);
+            max_y = std::max(max_y, ys[i]);
+            or_p |= ps[i];
+            and_p &= ps[i];
+        }
+        // ȥ׼ֵβ 0 (׼ֵ)⼸ѭֱ
+        const bool escape = (uint64_t)(max_dt - min_dt) > UINT32_MAX;
+        for (size_t i = 0; i < n; ++i) {
+            dt[i] = (uint32_t)(deltas[i] - min_dt);
+            xs[i] -= min_x;
+            ys[i] -= min_y;
+            ps[i] -= and_p;
+        }
+        std::fill(dt + n, dt + kGroup, 0u);
+        std::fill(xs + n, xs + kGroup, 0u);
+        std::fill(ys + n, ys + kGroup, 0u);
+        std::fill(ps + n, ps + kGroup, 0u);
+
+        const int w_dt = escape ? kEscapeWidth : bitWidth((uint32_t)(max_dt - min_dt));
+        const int w_x = bitWidth(max_x - min_x);
+        const int w_y = bitWidth(max_y - min_y);
+        const int w_p = or_p != and_p ? 1 : 0;
+        out.push_back((uint8_t)w_dt);
+        out.push_back((uint8_t)w_x);
+        out.push_back((uint8_t)w_y);
+        out.push_back((uint8_t)(p_mode == kPolarityPacked ? (w_p | (and_p << 7)) : 0));
+        putVarint(out, zigzag(escape ? 0 : min_dt));
+        putVarint(out, min_x);
+        putVarint(out, min_y);
+
+        if (escape) {
+            for (size_t i = 0; i < n; ++i) putVarint(out, zigzag(deltas[i]));
+        }
+        else {
+            appendPacked(out, dt, w_dt, level);
+        }
+        appendPacked(out, xs, w_x, level);
+        appendPacked(out, ys, w_y, level);
+        if (p_mode == kPolarityPacked) appendPacked(out, ps, w_p, level);
+    }
+
+    const size_t bytes = out.size() - start;
+    uint8_t* h = out.data() + start;
+    putLE<uint32_t>(h, kMagic);
+    putLE<uint32_t>(h + 4, (uint32_t)bytes);
+    putLE<uint32_t>(h + 8, (uint32_t)count);
+    h[12] = kVersion;
+    h[13] = p_mode;
+    h[14] = (uint8_t)(events[0].p & 1);
+    h[15] = 0;
+    putLE<int64_t>(h + 16, events[0].t);
+    putLE<int64_t>(h + 24, events[count - 1].t);
+    return bytes;
+}
+
+bool readEventBlockInfo(const uint8_t* data, size_t size, EventBlockInfo& info)
+{
+    if (size < kEventBlockHeaderBytes) return false;
+    if (getLE<uint32_t>(data) != kMagic || data[12] != kVersion) return false;
+    info.bytes = getLE<uint32_t>(data + 4);
+    info.events = getLE<uint32_t>(data + 8);
+    info.t_first = getLE<int64_t>(data + 16);
+    info.t_last = getLE<int64_t>(data + 24);
+    return info.bytes >= kEventBlockHeaderBytes && info.bytes <= size &&
+        info.events > 0 && info.events <= kEventBlockMaxEvents && data[13] <= kPolarityRuns;
+}
+
+bool decodeEventBlock(const uint8_t* data, size_t size, Metavision::EventCD* out, SimdLevel level)
+{
+    EventBlockInfo info;
+    if (!readEventBlockInfo(data, size, info)) return false;
+    const size_t count = info.events;
+    const uint8_t p_mode = data[13];
+    const uint8_t* p = data + kEventBlockHeaderBytes;
+    const uint8_t* end = data + info.bytes;
+
+    if (p_mode == kPolarityRuns) {
+        uint64_t runs = 0;
+        if (!getVarint(p, end, runs) || runs == 0 || runs > count) return false;
+        int16_t polarity = data[14] & 1;
+        size_t i = 0;
+        for (uint64_t r = 0; r < runs; ++r) {
+            uint64_t len = 0;
+            if (!getVarint(p, end, len) || len >= count - i) return false;
+            for (const size_t stop = i + (size_t)len + 1; i < stop; ++i) out[i].p = polarity;
+            polarity ^= 1;
+        }
+        if (i != count) return false;
+    }
+
+    alignas(32) uint32_t dt[kGroup];
+    alignas(32) uint32_t xs[kGroup];
+    alignas(32) uint32_t ys[kGroup];
+    alignas(32) uint32_t ps[kGroup];
+    Metavision::timestamp t = info.t_first;
+    for (size_t g = 0; g < count; g += kGroup) {
+        const size_t n = std::min(kGroup, count - g);
+        Metavision::EventCD* e = out + g;
+        if (end - p < 4) return false;
+        const int w_dt = p[0], w_x = p[1], w_y = p[2], w_p = p[3] & 0x7F;
+        const uint32_t base_p = p[3] >> 7;
+        p += 4;
+        uint64_t zz_dt = 0, base_x = 0, base_y = 0;
+        if (!getVarint(p, end, zz_dt) || !getVarint(p, end, base_x) || !getVarint(p, end, base_y)) return false;
+        if ((w_dt > 32 && w_dt != kEscapeWidth) || w_x > 16 || w_y > 16 || w_p > 1) return false;
+
+        if (w_dt == kEscapeWidth) {
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t v = 0;
+                if (!getVarint(p, end, v)) return false;
+                t += unzigzag(v);
+                e[i].t = t;
+            }
+        }
+        else {
+            if ((size_t)(end - p) < bitPackedBytes(w_dt)) return false;
+            unpackBits256(p, w_dt, dt, level);
+            p += bitPackedBytes(w_dt);
+            const int64_t base_dt = unzigzag(zz_dt);
+            for (size_t i = 0; i < n; ++i) {
+                t += base_dt + dt[i];
+                e[i].t = t;
+            }
+        }
+        const size_t column_bytes = bitPackedBytes(w_x) + bitPackedBytes(w_y) +
+            (p_mode == kPolarityPacked ? bitPackedBytes(w_p) : 0);
+        if ((size_t)(end - p) < column_bytes) return false;
+        unpackBits256(p, w_x, xs, level);
+        p += bitPackedBytes(w_x);
+        unpackBits256(p, w_y, ys, level);
+        p += bitPackedBytes(w_y);
+        for (size_t i = 0; i < n; ++i) {
+            e[i].x = (uint16_t)(base_x + xs[i]);
+            e[i].y = (uint16_t)(base_y + ys[i]);
+        }
+        if (p_mode == kPolarityPacked) {
+            unpackBits256(p, w_p, ps, level);
+            p += bitPackedBytes(w_p);
+            for (size_t i = 0; i < n; ++i) e[i].p = (int16_t)(base_p + ps[i]);
+        }
+    }
+    return p == end && t == info.t_last;
+}
+
+size_t encodeEvents(const Metavision::EventCD* events, size_t count, std::vector<uint8_t>& out,
+    size_t block_events, SimdLevel level)
+{
+    block_events = std::max<size_t>(1, std::min(block_events, kEventBlockMaxEvents));
+    size_t blocks = 0;
+    for (size_t i = 0; i < count; i += block_events) {
+        if (encodeEventBlock(events + i, std::min(block_events, count - i), out, level) == 0) break;
+        blocks++;
+    }
+    return blocks;
+}
+
+bool scanEventBlocks(const uint8_t* data, size_t size, std::vector<EventBlockInfo>& blocks)
+{
+    blocks.clear();
+    uint64_t offset = 0;
+    uint64_t first_event = 0;
+    while (offset < size) {
+        EventBlockInfo info;
+        if (!readEventBlockInfo(data + offset, size - (size_t)offset, info)) return false;
+        info.offset = offset;
+        info.first_event = first_event;
+        blocks.push_back(info);
+        offset += info.bytes;
+        first_event += info.events;
+    }
+    return true;
+}
@@ -0,0 +1,178 @@
+#include "FakeUno.h"
+#include "SteadyClock.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    void sleepUntilNs(uint64_t t_ns)
+    {
+        const uint64_t now = steadyNowNs();
+        if (t_ns > now) std::this_thread::sleep_for(std::chrono::nanoseconds(t_ns - now));
+    }
+}
+
+FakeUno::~FakeUno()
+{
+    close();
+}
+
+#if defined(_WIN32)
+
+bool FakeUno::open()
+{
+    printf("FakeUno: pseudo terminals are not available on Windows.\n");
+    return false;
+}
+
+void FakeUno::close()
+{
+}
+
+void FakeUno::run()
+{
+}
+
+void FakeUno::reply(const std::string&)
+{
+}
+
+#else
+
+bool FakeUno::open()
+{
+    close();
+    if (options.baud <= 0 || options.trigger_hz <= 0) {
+        printf("FakeUno: invalid baud %d or trigger rate %.1f Hz.\n", options.baud, options.trigger_hz);
+        return false;
+    }
+    master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+        printf("FakeUno: failed to create pseudo terminal: %s\n", strerror(errno));
+        close();
+        return false;
+    }
+    const char* name = ptsname(master);
+    if (!name) {
+        close();
+        return false;
+    }
+    port_name = name;
+    // Ӷԭʼģʽһֱ򿪣UNO ֮ǰдӦ𲻻ᱻԣUNO رʱҲ EIO
+    slave = ::open(port_name.c_str(), O_RDWR | O_NOCTTY);
+    termios tty;
+    if (slave < 0 || tcgetattr(slave, &tty) != 0) {
+        printf("FakeUno: failed to open %s: %s\n", port_name.c_str(), strerror(errno));
+        close();
+        return false;
+    }
+    cfmakeraw(&tty);
+    tcsetattr(slave, TCSANOW, &tty);
+
+    boot_ns = steadyNowNs();
+    output_on = false;
+    {
+        std::lock_guard<std::mutex> lock(truth_mutex);
+        truth_ = Truth();
+    }
+    running = true;
+    thread = std::thread(&FakeUno::run, this);
+    return true;
+}
+
+void FakeUno::close()
+{
+    running = false;
+    if (thread.joinable()) thread.join();
+    if (slave >= 0) ::close(slave);
+    if (master >= 0) ::close(master);
+    slave = master = -1;
+}
+
+// ̼ Serial.print ͻͷأֽڷ "" дαն
+void FakeUno::reply(const std::string& line)
+{
+    if (options.legacy) return;
+    const std::string bytes = line + "\n";
+    const uint64_t start = std::max(steadyNowNs(), tx_free_ns);
+    tx_free_ns = start + (uint64_t)(bytes.size() * 10 * 1e9 / options.baud);
+    sleepUntilNs(tx_free_ns);
+    if (::write(master, bytes.data(), bytes.size()) != (ssize_t)bytes.size()) {
+        printf("FakeUno: write failed: %s\n", strerror(errno));
+    }
+}
+
+void FakeUno::run()
+{
+    const uint64_t byte_ns = (uint64_t)(10 * 1e9 / options.baud);
+    while (running) {
+        pollfd pfd = { master, POLLIN, 0 };
+        if (poll(&pfd, 1, 5) <= 0) continue;
+        char command;
+        if (::read(master, &command, 1) != 1) continue;
+        // ֽϴ㵽
+        const uint64_t arrive_ns = steadyNowNs() + byte_ns;
+        sleepUntilNs(arrive_ns);
+
+        if (command == 'a') {
+            const uint64_t first_ns = arrive_ns + (uint64_t)options.first_pulse_delay_us * 1000;
+            {
+                std::lock_guard<std::mutex> lock(truth_mutex);
+                truth_.command_ns = arrive_ns;
+                truth_.first_pulse_ns = first_ns;
+                truth_.stop_ns = 0;
+                truth_.pulses = 0;
+                truth_.starts++;
+            }
+            output_on = true;
+            reply("A " + std::to_string(micros(arrive_ns)));
+            sleepUntilNs(first_ns);  // һ֮ǰܱ
+            reply("P " + std::to_string(micros(first_ns)));
+        }
+        else if (command == 'q') {
+            uint32_t pulses = 0;
+            {
+                std::lock_guard<std::mutex> lock(truth_mutex);
+                if (output_on) pulses = pulsesUntil(arrive_ns);
+                truth_.stop_ns = arrive_ns;
+                truth_.pulses = pulses;
+            }
+            output_on = false;
+            reply("Q " + std::to_string(micros(arrive_ns)) + " " + std::to_string(pulses));
+        }
+        else if (command == 'v') {
+            reply("V 1");
+        }
+    }
+}
+
+#endif
+
+uint32_t FakeUno::micros(uint64_t t_ns) const
+{
+    return (uint32_t)((t_ns - boot_ns) / 1000);
+}
+
+// ѳ truth_mutex
+uint32_t FakeUno::pulsesUntil(uint64_t t_ns) const
+{
+    if (t_ns < truth_.first_pulse_ns) return 0;
+    const double period_ns = 1e9 / options.trigger_hz;
+    return (uint32_t)((t_ns - truth_.first_pulse_ns) / period_ns) + 1;
+}
+
+FakeUno::Truth FakeUno::truth() const
+{
+    std::lock_guard<std::mutex> lock(truth_mutex);
+    return truth_;
+}
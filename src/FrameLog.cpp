@@ -0,0 +1,209 @@
+#include "FrameLog.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#define fseek64 _fseeki64
+#define ftell64 _ftelli64
+#else
+#define fseek64 fseeko
+#define ftell64 ftello
+#endif
+
+const char* const FrameLogSink::kFileName = "rgb_frames.dcfl";
+
+uint64_t framelog::recordBytes(uint64_t frame_bytes)
+{
+    const uint64_t a = DirectFileWriter::kAlignment;
+    return (kRecordHeaderBytes + frame_bytes + a - 1) / a * a;
+}
+
+// =============================================
+// FrameLogSink
+// =============================================
+
+FrameLogSink::~FrameLogSink()
+{
+    close();
+}
+
+bool FrameLogSink::openFile(const std::string& file_path, const FrameFormat& frame_format)
+{
+    close();
+    format = frame_format;
+    frame_bytes = format.frameBytes();
+    record_bytes = framelog::recordBytes(frame_bytes);
+    options.records_per_write = std::max<size_t>(options.records_per_write, 1);
+    sequence = 0;
+    filled = 0;
+    stats_ = FrameSinkStats();
+    size_mismatches = 0;
+
+    if (!writer.open(file_path, options.queue_depth, record_bytes * options.records_per_write, options.backend)) {
+        return false;
+    }
+
+    // ļͷռһ 4096 ֽڵĿ
+    uint8_t* block = writer.acquire();
+    memset(block, 0, framelog::kHeaderBytes);
+    framelog::FileHeader header{};
+    memcpy(header.magic, framelog::kMagic, sizeof(header.magic));
+    header.version = framelog::kVersion;
+    header.header_bytes = framelog::kHeaderBytes;
+    header.width = format.width;
+    header.height = format.height;
+    header.channels = format.channels;
+    header.mvs_pixel_type = format.mvs_pixel_type;
+    header.frame_bytes = frame_bytes;
+    header.record_bytes = record_bytes;
+    strncpy(header.pixel_format, format.pixel_format.c_str(), sizeof(header.pixel_format) - 1);
+    memcpy(block, &header, sizeof(header));
+    if (!writer.submit(block, framelog::kHeaderBytes)) {
+        writer.close();
+        return false;
+    }
+    printf("Frame log %s: %llu bytes per record, %zu records per write, queue depth %zu (%s).\n",
+        file_path.c_str(), (unsigned long long)record_bytes, options.records_per_write, options.queue_depth,
+        writer.backendName());
+    return true;
+}
+
+bool FrameLogSink::write(const FrameRecord& record)
+{
+    if (!writer.isOpen()) return false;
+    if (!checkFrameBytes(record, (size_t)frame_bytes, size_mismatches)) {
+        stats_.errors++;
+        return false;
+    }
+    if (!current) {
+        current = writer.acquire();
+        if (!current) {
+            stats_.errors++;
+            return false;
+        }
+    }
+
+    uint8_t* dst = current + filled * record_bytes;
+    framelog::RecordHeader header{};
+    header.magic = framelog::kRecordMagic;
+    header.payload_bytes = (uint32_t)frame_bytes;
+    header.sequence = sequence++;
+    header.frame_number = record.frame_number;
+    header.host_timestamp_ns = record.host_timestamp_ns;
+    header.device_timestamp = record.device_timestamp;
+    if (record.event_timestamp_source != 0) {
+        header.event_timestamp_us = record.event_timestamp_us;
+        header.flags = record.event_timestamp_source;
+    }
+    memcpy(dst, &header, sizeof(header));
+    memcpy(dst + framelog::kRecordHeaderBytes, record.data, frame_bytes);
+    // 䲿㣬һεĻдļ
+    memset(dst + framelog::kRecordHeaderBytes + frame_bytes, 0, record_bytes - framelog::kRecordHeaderBytes - frame_bytes);
+
+    stats_.frames++;
+    stats_.bytes += frame_bytes;
+    if (++filled == options.records_per_write) {
+        return flush();
+    }
+    return true;
+}
+
+bool FrameLogSink::flush()
+{
+    if (!current || filled == 0) return true;
+    const size_t bytes = filled * record_bytes;
+    uint8_t* buffer = current;
+    current = nullptr;
+    filled = 0;
+    if (!writer.submit(buffer, bytes)) {
+        stats_.errors++;
+        return false;
+    }
+    stats_.stored_bytes += bytes;
+    return true;
+}
+
+bool FrameLogSink::close()
+{
+    if (!writer.isOpen()) return true;
+    bool ok = flush();
+    // ȴ;дɣwriter ļһ open
+    ok = writer.close() && ok;
+    stats_.writes = writer.stats().writes;
+    stats_.errors += writer.stats().errors;
+    return ok;
+}
+
+FrameSinkStats FrameLogSink::stats() const
+{
+    FrameSinkStats s = stats_;
+    if (writer.isOpen()) {
+        s.writes = writer.stats().writes;
+        s.errors += writer.stats().errors;
+    }
+    return s;
+}
+
+// =============================================
+// FrameLogReader
+// =============================================
+
+FrameLogReader::~FrameLogReader()
+{
+    close();
+}
+
+bool FrameLogReader::open(const std::string& file_path)
+{
+    close();
+    file = fopen(file_path.c_str(), "rb");
+    if (!file) {
+        printf("Failed to open %s\n", file_path.c_str());
+        return false;
+    }
+    if (fread(&header, sizeof(header), 1, file) != 1 ||
+        memcmp(header.magic, framelog::kMagic, sizeof(header.magic)) != 0) {
+        printf("%s is not a frame log.\n", file_path.c_str());
+        close();
+        return false;
+    }
+    if (header.version != framelog::kVersion || header.record_bytes < framelog::kRecordHeaderBytes + header.frame_bytes) {
+        printf("Unsupported frame log version %u.\n", header.version);
+        close();
+        return false;
+    }
+
+    format_.width = header.width;
+    format_.height = header.height;
+    format_.channels = header.channels;
+    header.pixel_format[sizeof(header.pixel_format) - 1] = '\0';
+    format_.pixel_format = header.pixel_format;
+    format_.mvs_pixel_type = header.mvs_pixel_type;
+
+    // ֻͳļ¼
+    fseek64(file, 0, SEEK_END);
+    const uint64_t size = (uint64_t)ftell64(file);
+    frame_count = size > header.header_bytes ? (size - header.header_bytes) / header.record_bytes : 0;
+    return true;
+}
+
+void FrameLogReader::close()
+{
+    if (file) fclose(file);
+    file = nullptr;
+    frame_count = 0;
+}
+
+bool FrameLogReader::read(uint64_t index, framelog::RecordHeader& record, uint8_t* pixels)
+{
+    if (!file || index >= frame_count) return false;
+    const uint64_t offset = header.header_bytes + index * header.record_bytes;
+    if (fseek64(file, (long long)offset, SEEK_SET) != 0 ||
+        fread(&record, sizeof(record), 1, file) != 1) {
+        return false;
+    }
+    if (record.magic != framelog::kRecordMagic || record.sequence != index || record.payload_bytes != header.frame_bytes) {
+        return false;
+    }
+    return fread(pixels, 1, (size_t)header.frame_bytes, file) == header.frame_bytes;
+}
@@ -0,0 +1,255 @@
+#include "FramePool.h"
+#include <cstdio>
+#include <atomic>
+#include <cstring>
+#include <memory>
+#include <new>
+
+namespace {
+    // ҳ룬ֱ֮ӽҪ뻺д·
+    constexpr size_t kBufferAlign = 4096;
+
+    size_t alignUp(size_t v, size_t a) { return (v + a - 1) / a * a; }
+}
+
+// =============================================
+// ״̬ + ջ + 
+// =============================================
+
+class FramePool::PoolMatAllocator : public cv::MatAllocator {
+public:
+    explicit PoolMatAllocator(Shared* shared) : shared(shared) {}
+
+    cv::UMatData* allocate(int dims, const int* sizes, int type, void* data0, size_t* step,
+        cv::AccessFlag flags, cv::UMatUsageFlags usageFlags) const override;
+    bool allocate(cv::UMatData* u, cv::AccessFlag accessFlags, cv::UMatUsageFlags usageFlags) const override;
+    void deallocate(cv::UMatData* u) const override;
+
+private:
+    Shared* shared;
+};
+
+struct FramePool::Shared {
+    static constexpr uint32_t kEmpty = 0xFFFFFFFFu;
+
+    static uint64_t pack(uint32_t tag, uint32_t index) { return ((uint64_t)tag << 32) | index; }
+    static uint32_t indexOf(uint64_t head) { return (uint32_t)(head & 0xFFFFFFFFu); }
+    static uint32_t tagOf(uint64_t head) { return (uint32_t)(head >> 32); }
+
+    Shared(size_t buffer_size, size_t buffer_count);
+    ~Shared();
+
+    unsigned char* acquire();
+    void release(unsigned char* buffer);
+    bool owns(const void* ptr) const;
+    void unref();
+
+    size_t buffer_size;
+    size_t buffer_count;
+    unsigned char* arena = nullptr;
+    std::unique_ptr<std::atomic<uint32_t>[]> next_free;
+    PoolMatAllocator mat_allocator;
+
+    std::atomic<size_t> refs{ 1 };            // FramePool  + δͷŵ UMatData
+    std::atomic<uint64_t> free_head;
+    std::atomic<size_t> in_use{ 0 };
+    std::atomic<size_t> high_water{ 0 };
+    std::atomic<uint64_t> acquired_count{ 0 };
+    std::atomic<uint64_t> exhausted_count{ 0 };
+    std::atomic<uint64_t> oversize_count{ 0 };
+};
+
+FramePool::Shared::Shared(size_t buffer_size_, size_t buffer_count_)
+    : buffer_size(alignUp(buffer_size_ ? buffer_size_ : 1, kBufferAlign)),
+      buffer_count(buffer_count_),
+      mat_allocator(this),
+      free_head(pack(0, kEmpty))
+{
+    if (buffer_count == 0) return;
+
+    arena = static_cast<unsigned char*>(::operator new(buffer_size * buffer_count, std::align_val_t(kBufferAlign), std::nothrow));
+    if (!arena) {
+        printf("FramePool: failed to allocate %zu x %zu bytes, falling back to heap.\n", buffer_count, buffer_size);
+        buffer_count = 0;
+        return;
+    }
+    // Ԥȴҳ棬ɼȱҳ
+    memset(arena, 0, buffer_size * buffer_count);
+
+    next_free.reset(new std::atomic<uint32_t>[buffer_count]);
+    for (size_t i = 0; i < buffer_count; ++i) {
+        next_free[i].store(i + 1 < buffer_count ? (uint32_t)(i + 1) : kEmpty, std::memory_order_relaxed);
+    }
+    free_head.store(pack(0, 0), std::memory_order_release);
+}
+
+FramePool::Shared::~Shared()
+{
+    if (arena) ::operator delete(arena, std::align_val_t(kBufferAlign));
+}
+
+void FramePool::Shared::unref()
+{
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) delete this;
+}
+
+unsigned char* FramePool::Shared::acquire()
+{
+    uint64_t head = free_head.load(std::memory_order_acquire);
+    while (true) {
+        uint32_t index = indexOf(head);
+        if (index == kEmpty) {
+            exhausted_count.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        uint32_t next = next_free[index].load(std::memory_order_relaxed);
+        if (free_head.compare_exchange_weak(head, pack(tagOf(head) + 1, next),
+            std::memory_order_acq_rel, std::memory_order_acquire)) {
+            size_t now = in_use.fetch_add(1, std::memory_order_relaxed) + 1;
+            size_t peak = high_water.load(std::memory_order_relaxed);
+            while (now > peak && !high_water.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+            acquired_count.fetch_add(1, std::memory_order_relaxed);
+            return arena + (size_t)index * buffer_size;
+        }
+    }
+}
+
+void FramePool::Shared::release(unsigned char* buffer)
+{
+    if (!owns(buffer)) return;
+    uint32_t index = (uint32_t)((buffer - arena) / buffer_size);
+    uint64_t head = free_head.load(std::memory_order_relaxed);
+    do {
+        next_free[index].store(indexOf(head), std::memory_order_relaxed);
+    } while (!free_head.compare_exchange_weak(head, pack(tagOf(head) + 1, index),
+        std::memory_order_release, std::memory_order_relaxed));
+    in_use.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool FramePool::Shared::owns(const void* ptr) const
+{
+    const unsigned char* p = static_cast<const unsigned char*>(ptr);
+    return arena && p >= arena && p < arena + buffer_size * buffer_count;
+}
+
+// =============================================
+// cv::MatAllocator  ( OpenCV  StdMatAllocator)
+// =============================================
+
+cv::UMatData* FramePool::PoolMatAllocator::allocate(int dims, const int* sizes, int type, void* data0, size_t* step,
+    cv::AccessFlag /*flags*/, cv::UMatUsageFlags /*usageFlags*/) const
+{
+    size_t total = CV_ELEM_SIZE(type);
+    for (int i = dims - 1; i >= 0; i--) {
+        if (step) {
+            if (data0 && step[i] != CV_AUTOSTEP) {
+                CV_Assert(total <= step[i]);
+                total = step[i];
+            }
+            else {
+                step[i] = total;
+            }
+        }
+        total *= sizes[i];
+    }
+
+    uchar* data = (uchar*)data0;
+    if (!data) {
+        if (total <= shared->buffer_size) {
+            data = shared->acquire();
+        }
+        else {
+            shared->oversize_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (!data) data = (uchar*)cv::fastMalloc(total); // ؿջ򳬳ߴ磬˻ضѷ
+    }
+
+    // UMatData ͷʱҪصÿ UMatData й״̬һ
+    shared->refs.fetch_add(1, std::memory_order_relaxed);
+    cv::UMatData* u = new cv::UMatData(this);
+    u->data = u->origdata = data;
+    u->size = total;
+    if (data0) u->flags |= cv::UMatData::USER_ALLOCATED;
+    return u;
+}
+
+bool FramePool::PoolMatAllocator::allocate(cv::UMatData* u, cv::AccessFlag /*accessFlags*/, cv::UMatUsageFlags /*usageFlags*/) const
+{
+    return u != nullptr;
+}
+
+void FramePool::PoolMatAllocator::deallocate(cv::UMatData* u) const
+{
+    if (!u) return;
+    CV_Assert(u->urefcount == 0);
+    CV_Assert(u->refcount == 0);
+    if (!(u->flags & cv::UMatData::USER_ALLOCATED)) {
+        if (shared->owns(u->origdata)) {
+            shared->release(u->origdata);
+        }
+        else {
+            cv::fastFree(u->origdata);
+        }
+        u->origdata = nullptr;
+    }
+    delete u;
+    shared->unref();   //  shared (ͬ)֮ٷʳԱ
+}
+
+// =============================================
+// FramePool
+// =============================================
+
+FramePool::FramePool(size_t buffer_size, size_t buffer_count)
+    : shared(new Shared(buffer_size, buffer_count))
+{
+}
+
+FramePool::~FramePool()
+{
+    const size_t outstanding = shared->in_use.load();
+    if (outstanding != 0) {
+        //  cv::Mat óеĻ壺ͷǵñ֣һͷʱ
+        printf("FramePool: %zu buffers still in use at destruction, freed when the last cv::Mat is released.\n", outstanding);
+    }
+    shared->unref();
+}
+
+unsigned char* FramePool::acquire()
+{
+    return shared->acquire();
+}
+
+void FramePool::release(unsigned char* buffer)
+{
+    shared->release(buffer);
+}
+
+bool FramePool::owns(const void* ptr) const
+{
+    return shared->owns(ptr);
+}
+
+// PoolMatAllocator ֻڱļ壬תΪָ
+cv::MatAllocator* FramePool::allocator()
+{
+    return &shared->mat_allocator;
+}
+
+size_t FramePool::bufferSize() const
+{
+    return shared->buffer_size;
+}
+
+FramePool::Stats FramePool::stats() const
+{
+    Stats s;
+    s.buffer_size = shared->buffer_size;
+    s.capacity = shared->buffer_count;
+    s.in_use = shared->in_use.load(std::memory_order_relaxed);
+    s.high_water = shared->high_water.load(std::memory_order_relaxed);
+    s.acquired = shared->acquired_count.load(std::memory_order_relaxed);
+    s.exhausted = shared->exhausted_count.load(std::memory_order_relaxed);
+    s.oversize = shared->oversize_count.load(std::memory_order_relaxed);
+    return s;
+}
@@ -1,10 +1,14 @@
 #include "Gui.h" //  .h ļ include Ŀ¼
 #include <QDir>         //  QDir (ڴļ)
+#include <filesystem>
 
 // 캯
 GUI::GUI(QWidget* parent) : QMainWindow(parent) {
     // 1. 
     is_running = false;
+    // Ĺ (dualcamera-record --calibrate Ľ)ûʱĬֵ
+    const std::string config_path = PipelineConfig::defaultPath();
+    if (std::filesystem::exists(config_path)) config.load(config_path);
     setWindowTitle("DualCamera");
     resize(QSize(1920, 920));
     QFont font;
@@ -23,8 +27,8 @@ GUI::GUI(QWidget* parent) : QMainWindow(parent) {
 
     // *** ޸ ***
     // Сߴ磬ֹʱɼ
-    view_DVS->setMinimumSize(640, 540);
-    view_RGB->setMinimumSize(640, 540);
+    view_DVS->setMinimumSize(config.gui.view_width, config.gui.view_height);
+    view_RGB->setMinimumSize(config.gui.view_width, config.gui.view_height);
     //  QLabel Զ (ѭֶŸЧ)
     view_DVS->setScaledContents(true);
     view_RGB->setScaledContents(true);
@@ -70,6 +74,16 @@ GUI::GUI(QWidget* parent) : QMainWindow(parent) {
     // 6. *** ޸Ӷʱۺ ***
     connect(m_dvs_display_timer, &QTimer::timeout, this, &GUI::updateDvsDisplaySlot);
     connect(m_rgb_display_timer, &QTimer::timeout, this, &GUI::updateRgbDisplaySlot);
+
+    // 7. ¼ͬʱд .raw  dvs_events.h5RGB ֡Ž DVS봥һһӦ (д /dvs/frames)
+    //    ֡ʱʱӣÿ֡дʱ뵽¼ʱ (/rgb/event_timestamps)
+    dvs.setRecordFormat(DVS::RecordFormat::RawAndHdf5);
+    config.apply(dvs);
+    config.apply(rgb);
+    rgb.setFrameObserver([this](uint64_t frame_number, uint64_t host_timestamp_ns, uint64_t device_timestamp) {
+        dvs.onRgbFrame(frame_number, host_timestamp_ns, device_timestamp);
+    });
+    rgb.setTimestampAligner([this](FrameRecord& record) { dvs.alignRgbFrame(record); });
 }
 
 // 
@@ -78,6 +92,9 @@ GUI::~GUI() {
     if (is_running) {
         stoprecord();
     }
+    // ֮ͣͣѾرգûйϵ
+    uno.waitIdle();
+    stopCameras();
 }
 
 // ¼
@@ -96,18 +113,28 @@ void GUI::start() {
 
     // is_runningΪб־
     if (!is_running) {
+        if (cameras_running) {
+            statusBar()->showMessage(tr("Still stopping the previous recording, please try again."));
+            return;
+        }
         is_running = true;
+        cameras_running = true;
 
         // ˲ɼ߳ (Щ .start() ӦǷ)
         dvs.start(dataset_name);       // dvsʼ¼
         rgb.startCapture(folder_path); // RGBʼ¼
-        uno.start();                   // Ƭʼź
+        // Ƭʼźš ( UNO ꡢӦ͵һ) Ҫ룬
+        //  UNO ߳ճˢ
+        statusBar()->showMessage(tr("Starting trigger..."));
+        uno.startAsync([this](bool ok) {
+            QMetaObject::invokeMethod(this, [this, ok]() { showTriggerStatus(ok); }, Qt::QueuedConnection);
+        });
 
         // *** ޸ٴ std::thread QTimer ***
         // ˢʣDVS Էǳ ( 100 FPS)
         // RGB ƥ֡ ( 30 FPS)
-        m_dvs_display_timer->start(10); // 10ms
-        m_rgb_display_timer->start(33); // 33ms (~30 FPS)
+        m_dvs_display_timer->start(config.gui.dvs_refresh_ms); // Ĭ 10ms
+        m_rgb_display_timer->start(config.gui.rgb_refresh_ms); // Ĭ 33ms (~30 FPS)
 
         qDebug() << "Capture started. GUI timers running.";
     }
@@ -124,15 +151,46 @@ void GUI::stoprecord() {
         m_dvs_display_timer->stop();
         m_rgb_display_timer->stop();
 
-        // ֹͣ (Щ .stop() Ӧģȴ߳˳)
-        uno.stop();
-        dvs.stopRecord();
-        rgb.stopCapture();
+        // ̨ͣͣһ֡ͬһ塣
+        //  "Q" ӦҲ UNO ߳ϣӦ֮ص GUI ߳ͣ
+        statusBar()->showMessage(tr("Stopping trigger..."));
+        uno.stopAsync([this](bool) {
+            QMetaObject::invokeMethod(this, [this]() { stopCameras(); }, Qt::QueuedConnection);
+        });
+    }
+}
 
-        qDebug() << "Capture stopped. GUI timers stopped.";
-        view_DVS->setText("DVS Feed (Stopped)");
-        view_RGB->setText("RGB Feed (Stopped)");
+void GUI::showTriggerStatus(bool ok) {
+    if (!is_running) return; // Ѿֹͣ
+    const UNO::Stats trigger = uno.stats();
+    if (!ok) {
+        statusBar()->showMessage(tr("Trigger controller not available, cameras are not triggered."));
+    }
+    else if (!trigger.acked) {
+        statusBar()->showMessage(tr("Trigger started (no acknowledgement from the controller)."));
     }
+    else if (!trigger.pulse_seen) {
+        statusBar()->showMessage(tr("Trigger acknowledged after %1 ms, no pulse seen yet.").arg(trigger.ack_rtt_us / 1e3, 0, 'f', 2));
+    }
+    else {
+        statusBar()->showMessage(tr("Trigger running, first pulse %1 ms after the command.").arg(trigger.latency_us / 1e3, 0, 'f', 2));
+    }
+}
+
+void GUI::stopCameras() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!cameras_running) return;
+    cameras_running = false;
+
+    // ֹͣ (Щ .stop() Ӧģȴ߳˳)
+    dvs.stopRecord();
+    rgb.stopCapture();
+
+    qDebug() << "Capture stopped. GUI timers stopped.";
+    view_DVS->setText("DVS Feed (Stopped)");
+    view_RGB->setText("RGB Feed (Stopped)");
+    const UNO::Stats trigger = uno.stats();
+    statusBar()->showMessage(trigger.stopped ? tr("Stopped, %1 trigger pulses.").arg(trigger.pulses) : tr("Stopped."));
 }
 
 // *** ޸DVS ² ( GUI ߳) ***
@@ -140,15 +198,12 @@ void GUI::updateDvsDisplaySlot() {
     if (!is_running) return; // ־
 
     cv::Mat temp;
-    temp = dvs.getFrame(); //  DVS ˻ȡ֡
-
-    if (temp.empty()) {
-        return; // û֡
+    if (!dvs.getFrame(temp)) {
+        return; // û֡ػ
     }
 
     cv::Mat frame;
-    // ע⣺dsize Ӳ벻һϰߣʱѭĴ
-    cv::Size dsize = cv::Size(640, 540);
+    cv::Size dsize = cv::Size(config.gui.view_width, config.gui.view_height);
     cv::resize(temp, frame, dsize, 0, 0, cv::INTER_AREA);
 
     //  DVS ֡Ѿ RGB888 ʽ (ԭʼ)
@@ -168,28 +223,20 @@ void GUI::updateDvsDisplaySlot() {
 void GUI::updateRgbDisplaySlot() {
     if (!is_running) return; // ־
 
-    cv::Mat temp_bgr_frame; // ȷָ BGR
-    rgb.getLatestFrame(&temp_bgr_frame); //  RGB ˻ȡ֡ (BGR ʽ)
-
-    if (temp_bgr_frame.empty()) {
-        return; // û֡
+    // Ԥͼɹ߳Сת RGB888ֻȡá QImage
+    cv::Mat preview;
+    if (!rgb.getLatestPreview(preview)) {
+        return; // û֡ػ
     }
 
-    cv::Mat resized_bgr_frame;
-    cv::Mat display_rgb_frame;
-    cv::Size dsize = cv::Size(640, 540);
-    cv::resize(temp_bgr_frame, resized_bgr_frame, dsize, 0, 0, cv::INTER_AREA);
-
-    // *** ޸ɫ BGR תΪ RGB ***
-    cv::cvtColor(resized_bgr_frame, display_rgb_frame, cv::COLOR_BGR2RGB);
-
     // *** ޸棺frame.step  size_tQImage Ҫ int ***
-    auto qimg = QImage(display_rgb_frame.data,
-        display_rgb_frame.cols,
-        display_rgb_frame.rows,
-        static_cast<int>(display_rgb_frame.step), // <-- ޸
-        QImage::Format_RGB888); // ʽ RGB888
+    auto qimg = QImage(preview.data,
+        preview.cols,
+        preview.rows,
+        static_cast<int>(preview.step), // <-- ޸
+        QImage::Format_RGB888);
 
+    // QPixmap::fromImage Ḵݣpreview ڴ֮ǰһֱ
     view_RGB->setPixmap(QPixmap::fromImage(qimg));
 }
 
@@ -199,6 +246,8 @@ void GUI::closeEvent(QCloseEvent* event) {
     if (is_running) {
         stoprecord(); // ȷڹرմʱֹͣв
     }
+    uno.waitIdle();  // رմʱȷͣ£ֱͣ
+    stopCameras();
     event->accept(); // ܹر¼˳
     // _exit(0); // ʹ _exit(0)ǿֹ
 }
\ No newline at end of file
@@ -0,0 +1,196 @@
+#include "H5EventReader.h"
+#include "H5Lock.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    template <typename T>
+    T readAttribute(const H5::Group& group, const char* name, const H5::PredType& type, T fallback)
+    {
+        if (!group.attrExists(name)) return fallback;
+        T value = fallback;
+        group.openAttribute(name).read(type, &value);
+        return value;
+    }
+}
+
+H5EventReader::~H5EventReader()
+{
+    close();
+}
+
+bool H5EventReader::open(const std::string& file_path)
+{
+    close();
+    std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+    try {
+        file = std::make_unique<H5::H5File>(file_path, H5F_ACC_RDONLY);
+        H5::Group group = file->openGroup("/dvs");
+        width_ = readAttribute<int32_t>(group, "width", H5::PredType::NATIVE_INT32, 0);
+        height_ = readAttribute<int32_t>(group, "height", H5::PredType::NATIVE_INT32, 0);
+        index_us = readAttribute<int64_t>(group, "index_us", H5::PredType::NATIVE_INT64, 1000);
+        index_t0 = readAttribute<int64_t>(group, "index_t0", H5::PredType::NATIVE_INT64, 0);
+        if (index_us <= 0) index_us = 1000;
+
+        x_column = group.openDataSet("x");
+        y_column = group.openDataSet("y");
+        p_column = group.openDataSet("p");
+        t_column = group.openDataSet("t");
+        hsize_t count = 0;
+        t_column.getSpace().getSimpleExtentDims(&count);
+        event_count = count;
+
+        H5::DataSet index = group.openDataSet("time_index");
+        hsize_t entries = 0;
+        index.getSpace().getSimpleExtentDims(&entries);
+        time_index.resize((size_t)entries);
+        if (entries > 0) index.read(time_index.data(), H5::PredType::NATIVE_UINT64);
+
+        if (group.nameExists("frames")) {
+            H5::Group frames = group.openGroup("frames");
+            H5::DataSet begin = frames.openDataSet("event_begin");
+            hsize_t rows = 0;
+            begin.getSpace().getSimpleExtentDims(&rows);
+            frame_event_begin.resize((size_t)rows);
+            frame_event_end.resize((size_t)rows);
+            if (rows > 0) {
+                begin.read(frame_event_begin.data(), H5::PredType::NATIVE_UINT64);
+                frames.openDataSet("event_end").read(frame_event_end.data(), H5::PredType::NATIVE_UINT64);
+                // ÿһУֻ֡Ҫһе֡
+                H5::DataSet numbers = frames.openDataSet("frame_number");
+                H5::DataSpace file_space = numbers.getSpace();
+                const hsize_t offset = 0, one = 1;
+                file_space.selectHyperslab(H5S_SELECT_SET, &one, &offset);
+                H5::DataSpace mem_space(1, &one);
+                numbers.read(&first_frame_number, H5::PredType::NATIVE_UINT64, mem_space, file_space);
+            }
+        }
+    }
+    catch (H5::Exception& e) {
+        printf("Failed to open event file %s: %s\n", file_path.c_str(), e.getCDetailMsg());
+        close();
+        return false;
+    }
+    return true;
+}
+
+void H5EventReader::close()
+{
+    std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+    x_column = H5::DataSet();
+    y_column = H5::DataSet();
+    p_column = H5::DataSet();
+    t_column = H5::DataSet();
+    if (file) {
+        try {
+            file->close();
+        }
+        catch (H5::Exception& e) {
+            printf("Error closing event file: %s\n", e.getCDetailMsg());
+        }
+        file.reset();
+    }
+    time_index.clear();
+    frame_event_begin.clear();
+    frame_event_end.clear();
+    first_frame_number = 0;
+    event_count = 0;
+}
+
+bool H5EventReader::readColumn(H5::DataSet& dataset, const H5::PredType& type, uint64_t begin, uint64_t count, void* out)
+{
+    try {
+        H5::DataSpace file_space = dataset.getSpace();
+        const hsize_t offset = begin;
+        const hsize_t size = count;
+        file_space.selectHyperslab(H5S_SELECT_SET, &size, &offset);
+        H5::DataSpace mem_space(1, &size);
+        dataset.read(out, type, mem_space, file_space);
+    }
+    catch (H5::Exception& e) {
+        printf("Event read error at %llu (+%llu): %s\n", (unsigned long long)begin, (unsigned long long)count,
+            e.getCDetailMsg());
+        return false;
+    }
+    return true;
+}
+
+uint64_t H5EventReader::lowerBound(Metavision::timestamp t)
+{
+    if (!file || event_count == 0 || time_index.empty() || t <= index_t0) return 0;
+    // ڸ ktime_index[k] ֮ǰ¼ index_t0 + k * index_ustime_index[k + 1] 𶼲һ
+    const uint64_t k = (uint64_t)((t - index_t0) / index_us);
+    // һӦһ¼ĸӣ˵ t ¼
+    if (k >= time_index.size()) return event_count;
+    const uint64_t lo = time_index[k];
+    const uint64_t hi = k + 1 < time_index.size() ? time_index[k + 1] : event_count;
+    if (lo >= hi) return lo;
+
+    // һֻͨмǧ¼ٶֱ
+    t_scratch.resize((size_t)(hi - lo));
+    {
+        std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+        if (!readColumn(t_column, H5::PredType::NATIVE_INT64, lo, hi - lo, t_scratch.data())) return lo;
+    }
+    return lo + (uint64_t)(std::lower_bound(t_scratch.begin(), t_scratch.end(), t) - t_scratch.begin());
+}
+
+bool H5EventReader::findRange(Metavision::timestamp t0, Metavision::timestamp t1, uint64_t& begin, uint64_t& end)
+{
+    if (!file) return false;
+    begin = lowerBound(t0);
+    end = t1 > t0 ? std::max(begin, lowerBound(t1)) : begin;
+    return true;
+}
+
+bool H5EventReader::read(uint64_t begin, uint64_t end, std::vector<Metavision::EventCD>& out)
+{
+    out.clear();
+    if (!file) return false;
+    end = std::min(end, event_count);
+    if (begin >= end) return true;
+    const uint64_t n = end - begin;
+    std::vector<uint16_t> x((size_t)n), y((size_t)n);
+    std::vector<uint8_t> p((size_t)n);
+    std::vector<int64_t> t((size_t)n);
+    {
+        std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+        if (!readColumn(x_column, H5::PredType::NATIVE_UINT16, begin, n, x.data()) ||
+            !readColumn(y_column, H5::PredType::NATIVE_UINT16, begin, n, y.data()) ||
+            !readColumn(p_column, H5::PredType::NATIVE_UINT8, begin, n, p.data()) ||
+            !readColumn(t_column, H5::PredType::NATIVE_INT64, begin, n, t.data())) {
+            return false;
+        }
+    }
+    out.resize((size_t)n);
+    for (size_t i = 0; i < (size_t)n; ++i) {
+        out[i] = Metavision::EventCD(x[i], y[i], p[i], t[i]);
+    }
+    return true;
+}
+
+bool H5EventReader::readBetween(Metavision::timestamp t0, Metavision::timestamp t1, std::vector<Metavision::EventCD>& out)
+{
+    uint64_t begin = 0, end = 0;
+    return findRange(t0, t1, begin, end) && read(begin, end, out);
+}
+
+bool H5EventReader::frameRange(uint64_t frame_number, uint64_t& begin, uint64_t& end) const
+{
+    if (frame_number < first_frame_number) return false;
+    const uint64_t row = frame_number - first_frame_number;
+    if (row >= frame_event_begin.size()) return false;
+    begin = frame_event_begin[(size_t)row];
+    end = frame_event_end[(size_t)row];
+    return true;
+}
+
+bool H5EventReader::readFrame(uint64_t frame_number, std::vector<Metavision::EventCD>& out)
+{
+    uint64_t begin = 0, end = 0;
+    if (!frameRange(frame_number, begin, end)) {
+        out.clear();
+        return false;
+    }
+    return read(begin, end, out);
+}
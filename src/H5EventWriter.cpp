@@ -0,0 +1,292 @@
+#include "H5EventWriter.h"
+#include "H5Lock.h"
+#include <algorithm>
+#include <cstdio>
+
+const char* const H5EventWriter::kFileName = "dvs_events.h5";
+
+namespace {
+    constexpr uint64_t kBytesPerEvent = 2 + 2 + 1 + 8;  // x + y + p + t
+
+    void writeAttribute(H5::H5Object& object, const char* name, const H5::PredType& type, const void* value)
+    {
+        H5::DataSpace scalar_space(H5S_SCALAR);
+        H5::Attribute attribute = object.createAttribute(name, type, scalar_space);
+        attribute.write(type, value);
+    }
+}
+
+H5EventWriter::~H5EventWriter()
+{
+    close();
+    std::vector<EventBuffer*> buffers;
+    free_buffers.drain(buffers);
+    for (EventBuffer* buffer : buffers) delete buffer;
+}
+
+bool H5EventWriter::open(const std::string& file_path, int width, int height)
+{
+    close();
+    options.chunk_events = std::max<size_t>(options.chunk_events, 1024);
+    options.buffer_events = std::max<size_t>(options.buffer_events, 1);
+    options.queue_buffers = std::max<size_t>(options.queue_buffers, 1);
+    if (options.index_us <= 0) options.index_us = 1000;
+    width_ = width;
+    height_ = height;
+
+    {
+        std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+        try {
+            file = std::make_unique<H5::H5File>(file_path, H5F_ACC_TRUNC);
+            H5::Group group = file->createGroup("/dvs");
+
+            // ÿһ chunk_events ¼дԤչرʱü
+            H5FrameWriter::Options column;
+            column.chunk_frames = options.chunk_events;
+            column.batch_frames = options.chunk_events;
+            column.initial_frames = options.chunk_events * 4;
+            column.compression = options.compression;
+            H5FrameWriter::Options index;
+            index.chunk_frames = 4096;
+            index.batch_frames = 4096;
+            index.initial_frames = 4096;
+            if (!x_column.create(group, "x", H5::PredType::NATIVE_UINT16, {}, column) ||
+                !y_column.create(group, "y", H5::PredType::NATIVE_UINT16, {}, column) ||
+                !p_column.create(group, "p", H5::PredType::NATIVE_UINT8, {}, column) ||
+                !t_column.create(group, "t", H5::PredType::NATIVE_INT64, {}, column) ||
+                !time_index.create(group, "time_index", H5::PredType::NATIVE_UINT64, {}, index)) {
+                closeFile();
+                return false;
+            }
+            writeAttribute(group, "width", H5::PredType::NATIVE_INT32, &width_);
+            writeAttribute(group, "height", H5::PredType::NATIVE_INT32, &height_);
+            const int64_t index_us = options.index_us;
+            writeAttribute(group, "index_us", H5::PredType::NATIVE_INT64, &index_us);
+        }
+        catch (H5::Exception& e) {
+            printf("Failed to create event file %s: %s\n", file_path.c_str(), e.getCDetailMsg());
+            closeFile();
+            return false;
+        }
+    }
+
+    // ȴʱĿ disposer գÿպ÷ٴ
+    queue.configure(options.queue_buffers, QueuePolicy::Block, [this](EventBuffer*& buffer) {
+        dropped_events.fetch_add(buffer->size(), std::memory_order_relaxed);
+        recycle(buffer);
+        buffer = nullptr;
+    }, std::chrono::milliseconds(options.block_timeout_ms));
+    queue.resume();
+    queue.resetStats();
+    free_buffers.configure(options.queue_buffers, QueuePolicy::Reject);
+
+    events = 0;
+    written = 0;
+    dropped_events = 0;
+    errors = 0;
+    writes = 0;
+    index_entries = 0;
+    index_started = false;
+    stopping = false;
+    pushed_events = 0;
+    dropped_ranges.clear();
+    writer_thread = std::thread(&H5EventWriter::writeLoop, this);
+    is_open = true;
+    return true;
+}
+
+H5EventWriter::EventBuffer* H5EventWriter::takeBuffer()
+{
+    EventBuffer* buffer = nullptr;
+    if (!free_buffers.try_pop(buffer)) {
+        buffer = new EventBuffer();
+        buffer->reserve(options.buffer_events);
+    }
+    return buffer;
+}
+
+void H5EventWriter::recycle(EventBuffer* buffer)
+{
+    buffer->clear();
+    if (!free_buffers.push(buffer)) delete buffer;
+}
+
+void H5EventWriter::write(const Metavision::EventCD* begin, const Metavision::EventCD* end)
+{
+    if (!is_open || begin == end) return;
+    events.fetch_add((uint64_t)(end - begin), std::memory_order_relaxed);
+    while (begin != end) {
+        if (!pending) pending = takeBuffer();
+        const size_t n = std::min(options.buffer_events - pending->size(), (size_t)(end - begin));
+        pending->insert(pending->end(), begin, begin + n);
+        begin += n;
+        if (pending->size() >= options.buffer_events) pushPending();
+    }
+}
+
+void H5EventWriter::pushPending()
+{
+    if (!pending) return;
+    EventBuffer* buffer = pending;
+    pending = nullptr;
+    if (buffer->empty()) {
+        recycle(buffer);
+        return;
+    }
+    const uint64_t first = pushed_events;
+    const uint64_t count = buffer->size();
+    pushed_events += count;
+    if (queue.push(buffer)) return;
+    if (buffer) {
+        // ֹͣԹﴦ (ȴʱĿ disposer )
+        dropped_events.fetch_add(count, std::memory_order_relaxed);
+        recycle(buffer);
+    }
+    // 鰴ӣڵĶϲһ
+    if (!dropped_ranges.empty() && dropped_ranges.back().first + dropped_ranges.back().count == first) {
+        dropped_ranges.back().count += count;
+    }
+    else {
+        dropped_ranges.push_back(DroppedRange{ first, count });
+    }
+}
+
+uint64_t H5EventWriter::rowOf(uint64_t event) const
+{
+    uint64_t dropped = 0;
+    for (const DroppedRange& range : dropped_ranges) {
+        if (range.first >= event) break;
+        dropped += std::min(event, range.first + range.count) - range.first;
+    }
+    return event - dropped;
+}
+
+// д̣߳һȡ飬д
+void H5EventWriter::writeLoop()
+{
+    std::vector<EventBuffer*> batch;
+    while (true) {
+        batch.clear();
+        if (queue.pop_n(batch, 16, std::chrono::milliseconds(100)) == 0) {
+            // stopping ֮󲻻¿
+            if (stopping && queue.empty()) break;
+            continue;
+        }
+        for (EventBuffer* buffer : batch) {
+            if (!writeBuffer(*buffer)) errors.fetch_add(1, std::memory_order_relaxed);
+            recycle(buffer);
+        }
+    }
+}
+
+bool H5EventWriter::writeBuffer(const EventBuffer& buffer)
+{
+    const size_t n = buffer.size();
+    if (n == 0) return true;
+    x_scratch.resize(n);
+    y_scratch.resize(n);
+    p_scratch.resize(n);
+    t_scratch.resize(n);
+    index_scratch.clear();
+
+    const uint64_t first = written.load(std::memory_order_relaxed);
+    if (!index_started) {
+        // ӵһ¼ڵĸӿʼʱеɴյǰ
+        index_t0 = buffer[0].t / options.index_us * options.index_us;
+        next_index_t = index_t0;
+        index_started = true;
+    }
+    Metavision::timestamp next_t = next_index_t;
+    for (size_t i = 0; i < n; ++i) {
+        const Metavision::EventCD& e = buffer[i];
+        x_scratch[i] = e.x;
+        y_scratch[i] = e.y;
+        p_scratch[i] = (uint8_t)e.p;
+        t_scratch[i] = e.t;
+        // ÿӸһ (¼жʱָͬһ¼)
+        while (e.t >= next_t) {
+            index_scratch.push_back(first + i);
+            next_t += options.index_us;
+        }
+    }
+    next_index_t = next_t;
+
+    bool ok;
+    {
+        std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+        ok = x_column.appendFrames(x_scratch.data(), n, n * sizeof(uint16_t));
+        ok = y_column.appendFrames(y_scratch.data(), n, n * sizeof(uint16_t)) && ok;
+        ok = p_column.appendFrames(p_scratch.data(), n, n * sizeof(uint8_t)) && ok;
+        ok = t_column.appendFrames(t_scratch.data(), n, n * sizeof(int64_t)) && ok;
+        if (!index_scratch.empty()) {
+            ok = time_index.appendFrames(index_scratch.data(), index_scratch.size(), index_scratch.size() * sizeof(uint64_t)) && ok;
+        }
+        writes.store(x_column.stats().writes + y_column.stats().writes + p_column.stats().writes +
+            t_column.stats().writes + time_index.stats().writes, std::memory_order_relaxed);
+    }
+    index_entries.fetch_add(index_scratch.size(), std::memory_order_relaxed);
+    written.fetch_add(n, std::memory_order_relaxed);
+    return ok;
+}
+
+bool H5EventWriter::close(const CloseHook& before_close)
+{
+    if (!is_open) return true;
+    pushPending();
+    stopping = true;
+    queue.stopWait();
+    if (writer_thread.joinable()) writer_thread.join();
+
+    bool ok = errors.load() == 0;
+    ok = closeFile(before_close) && ok;
+    final_stats = stats();
+    is_open = false;
+    printf("DVS events: %llu written, %llu dropped, %llu index entries.\n", (unsigned long long)final_stats.written,
+        (unsigned long long)final_stats.dropped_events, (unsigned long long)final_stats.index_entries);
+    return ok;
+}
+
+bool H5EventWriter::closeFile(const CloseHook& before_close)
+{
+    std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+    bool ok = true;
+    try {
+        // дݴ¼Ԥչвüʵʳ
+        ok = x_column.close();
+        ok = y_column.close() && ok;
+        ok = p_column.close() && ok;
+        ok = t_column.close() && ok;
+        ok = time_index.close() && ok;
+        if (file) {
+            H5::Group group = file->openGroup("/dvs");
+            if (index_started) {
+                const int64_t t0 = index_t0;
+                writeAttribute(group, "index_t0", H5::PredType::NATIVE_INT64, &t0);
+            }
+            if (before_close) ok = before_close(group) && ok;
+            file->close();
+            file.reset();
+        }
+    }
+    catch (H5::Exception& e) {
+        printf("Error closing event file: %s\n", e.getCDetailMsg());
+        file.reset();
+        ok = false;
+    }
+    return ok;
+}
+
+H5EventWriter::Stats H5EventWriter::stats() const
+{
+    if (!is_open) return final_stats;
+    Stats s;
+    s.events = events.load(std::memory_order_relaxed);
+    s.written = written.load(std::memory_order_relaxed);
+    s.dropped_events = dropped_events.load(std::memory_order_relaxed);
+    s.bytes = s.written * kBytesPerEvent;
+    s.writes = writes.load(std::memory_order_relaxed);
+    s.index_entries = index_entries.load(std::memory_order_relaxed);
+    s.errors = errors.load(std::memory_order_relaxed);
+    s.queue = queue.stats();
+    return s;
+}
@@ -0,0 +1,157 @@
+#include "H5FrameSink.h"
+#include "H5Lock.h"
+#include <cstdio>
+
+const char* const H5FrameSink::kFileName = "rgb_data.h5";
+
+namespace {
+    // ÿ֡Ԫݵһάݼÿ 1024 ֵ 64 д
+    H5FrameWriter::Options metadataOptions()
+    {
+        H5FrameWriter::Options options;
+        options.batch_frames = 64;
+        options.chunk_frames = 1024;
+        options.initial_frames = 1024;
+        return options;
+    }
+}
+
+H5FrameSink::H5FrameSink(const H5FrameWriter::Options& options)
+    : options(options)
+{
+    // ѹڹ߳֡ɣһ֡
+    if (this->options.compression.codec != ChunkCodec::None && this->options.chunk_frames != 1) {
+        printf("Compression needs one frame per chunk, chunk_frames %zu -> 1.\n", this->options.chunk_frames);
+        this->options.chunk_frames = 1;
+    }
+}
+
+H5FrameSink::~H5FrameSink()
+{
+    close();
+}
+
+bool H5FrameSink::openFile(const std::string& file_path, const FrameFormat& format)
+{
+    std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+    close();
+    errors = 0;
+    size_mismatches = 0;
+    // HDF5 ׳쳣 try-catch
+    try {
+        file = std::make_unique<H5::H5File>(file_path, H5F_ACC_TRUNC);
+        H5::Group rgb_group = file->createGroup("/rgb");
+
+        // BGR: (N, H, W, C)ԭʼ: (N, H, W)N ά H5FrameWriter Ԥչرʱü
+        std::vector<hsize_t> frame_shape = { (hsize_t)format.height, (hsize_t)format.width };
+        if (format.channels != 1) frame_shape.push_back(format.channels);
+        if (!frames.create(rgb_group, "frames", H5::PredType::NATIVE_UINT8, frame_shape, options) ||
+            !frame_numbers.create(rgb_group, "frame_numbers", H5::PredType::NATIVE_UINT64, {}, metadataOptions()) ||
+            !host_timestamps.create(rgb_group, "host_timestamps", H5::PredType::NATIVE_UINT64, {}, metadataOptions()) ||
+            !device_timestamps.create(rgb_group, "device_timestamps", H5::PredType::NATIVE_UINT64, {}, metadataOptions()) ||
+            !event_timestamps.create(rgb_group, "event_timestamps", H5::PredType::NATIVE_INT64, {}, metadataOptions()) ||
+            !event_timestamp_sources.create(rgb_group, "event_timestamp_sources", H5::PredType::NATIVE_UINT8, {}, metadataOptions())) {
+            close();
+            return false;
+        }
+
+        // ظʽдԣȡ˾ݴ˾Ƿ / ȥ
+        H5::DataSet& dataset = frames.dataset();
+        H5::StrType str_type(H5::PredType::C_S1, H5T_VARIABLE);
+        H5::DataSpace scalar_space(H5S_SCALAR);
+        H5::Attribute format_attr = dataset.createAttribute("pixel_format", str_type, scalar_space);
+        format_attr.write(str_type, format.pixel_format);
+        if (format.channels == 1) {
+            H5::Attribute source_attr = dataset.createAttribute("mvs_pixel_type", H5::PredType::NATIVE_UINT32, scalar_space);
+            source_attr.write(H5::PredType::NATIVE_UINT32, &format.mvs_pixel_type);
+        }
+        H5::Attribute unit_attr = host_timestamps.dataset().createAttribute("unit", str_type, scalar_space);
+        unit_attr.write(str_type, std::string("ns (steady_clock)"));
+        H5::Attribute event_unit_attr = event_timestamps.dataset().createAttribute("unit", str_type, scalar_space);
+        event_unit_attr.write(str_type, std::string("us (DVS event clock)"));
+    }
+    catch (H5::Exception& e) {
+        printf("Failed to initialize HDF5: %s\n", e.getCDetailMsg());
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool H5FrameSink::write(const FrameRecord& record)
+{
+    std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+    // ѹҲһ֡ѹСʱͬд
+    if (!checkFrameBytes(record, frames.frameBytes(), size_mismatches)) {
+        errors++;
+        return false;
+    }
+    bool ok;
+    if (record.chunk && record.chunk_bytes > 0) {
+        ok = frames.appendChunk(record.chunk, record.chunk_bytes);
+    }
+    else {
+        // ֻдݴһд
+        ok = frames.append(record.data, record.data_bytes);
+    }
+    ok = frame_numbers.append(&record.frame_number, sizeof(record.frame_number)) && ok;
+    ok = host_timestamps.append(&record.host_timestamp_ns, sizeof(record.host_timestamp_ns)) && ok;
+    ok = device_timestamps.append(&record.device_timestamp, sizeof(record.device_timestamp)) && ok;
+    ok = event_timestamps.append(&record.event_timestamp_us, sizeof(record.event_timestamp_us)) && ok;
+    ok = event_timestamp_sources.append(&record.event_timestamp_source, sizeof(record.event_timestamp_source)) && ok;
+    if (!ok) errors++;
+    return ok;
+}
+
+bool H5FrameSink::flush()
+{
+    std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+    // Ԫݿֻ 8KBڿ黺һд벻ᷴ
+    bool ok = frames.flush();
+    ok = frame_numbers.flush() && ok;
+    ok = host_timestamps.flush() && ok;
+    ok = device_timestamps.flush() && ok;
+    ok = event_timestamps.flush() && ok;
+    ok = event_timestamp_sources.flush() && ok;
+    return ok;
+}
+
+bool H5FrameSink::close()
+{
+    std::lock_guard<std::recursive_mutex> lock(h5Mutex());
+    bool ok = true;
+    try {
+        // дʣݴ֡Ԥչݼüʵ֡
+        if (frames.isOpen()) {
+            ok = frames.close();
+            last_stats = frames.stats();
+        }
+        ok = frame_numbers.close() && ok;
+        ok = host_timestamps.close() && ok;
+        ok = device_timestamps.close() && ok;
+        ok = event_timestamps.close() && ok;
+        ok = event_timestamp_sources.close() && ok;
+        if (file) {
+            file->close();
+            file.reset();
+        }
+    }
+    catch (H5::Exception& e) {
+        printf("Error closing HDF5 file: %s\n", e.getCDetailMsg());
+        file.reset();
+        ok = false;
+    }
+    return ok;
+}
+
+FrameSinkStats H5FrameSink::stats() const
+{
+    const H5FrameWriter::Stats s = writerStats();
+    FrameSinkStats out;
+    out.frames = s.frames;
+    out.bytes = s.bytes;
+    out.stored_bytes = s.stored_bytes > 0 ? s.stored_bytes : s.bytes;
+    out.writes = s.writes;
+    out.errors = errors;
+    return out;
+}
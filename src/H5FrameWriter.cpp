@@ -0,0 +1,214 @@
+#include "H5FrameWriter.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+    uint64_t roundUp(uint64_t value, uint64_t multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+}
+
+H5FrameWriter::~H5FrameWriter()
+{
+    close();
+}
+
+bool H5FrameWriter::create(H5::Group& parent, const std::string& name, const H5::PredType& element_type,
+    const std::vector<hsize_t>& frame_shape, const Options& options)
+{
+    close();
+    opts = options;
+    opts.chunk_frames = std::max<size_t>(opts.chunk_frames, 1);
+    opts.batch_frames = (size_t)roundUp(std::max<size_t>(opts.batch_frames, 1), opts.chunk_frames);
+    type_id = element_type.getId();
+
+    frame_bytes = element_type.getSize();
+    for (hsize_t d : frame_shape) frame_bytes *= (size_t)d;
+
+    const uint64_t initial = opts.growth > 1.0 ? roundUp(opts.initial_frames, opts.chunk_frames) : 0;
+    dims.assign(1, (hsize_t)initial);
+    dims.insert(dims.end(), frame_shape.begin(), frame_shape.end());
+    std::vector<hsize_t> max_dims = dims;
+    max_dims[0] = H5S_UNLIMITED;
+    std::vector<hsize_t> chunk_dims = dims;
+    chunk_dims[0] = opts.chunk_frames;
+
+    try {
+        H5::DataSpace space((int)dims.size(), dims.data(), max_dims.data());
+        H5::DSetCreatPropList create_props;
+        create_props.setChunk((int)chunk_dims.size(), chunk_dims.data());
+        if (!setChunkFilters(create_props, opts.compression)) return false;
+
+        // ֿ֡ʱһ (ʱ) дֻǿһ֣ĬϿ黺ֻ 1MB
+        // ŲĿͻᷴд顣ֿ֡д飬ֱ̲졣
+        H5::DSetAccPropList access_props;
+        if (opts.chunk_frames > 1) {
+            const size_t chunk_bytes = frame_bytes * opts.chunk_frames;
+            access_props.setChunkCache(521, std::max<size_t>(2 * chunk_bytes, 1 << 20), 1.0);
+        }
+
+        ds = parent.createDataSet(name, element_type, space, create_props, access_props);
+    }
+    catch (H5::Exception& e) {
+        printf("Failed to create dataset %s: %s\n", name.c_str(), e.getCDetailMsg());
+        return false;
+    }
+
+    staging.resize(frame_bytes * opts.batch_frames);
+    staged = 0;
+    written = 0;
+    stats_ = Stats();
+    is_open = true;
+    return true;
+}
+
+bool H5FrameWriter::checkBytes(size_t bytes, size_t count)
+{
+    if (bytes == count * frame_bytes) return true;
+    printf("HDF5 append of %zu bytes does not match %zu frames of %zu bytes, not written.\n", bytes, count, frame_bytes);
+    return false;
+}
+
+bool H5FrameWriter::append(const void* data, size_t bytes)
+{
+    if (!is_open || !checkBytes(bytes, 1)) return false;
+    memcpy(staging.data() + staged * frame_bytes, data, frame_bytes);
+    if (++staged == opts.batch_frames) {
+        return flush();
+    }
+    return true;
+}
+
+bool H5FrameWriter::appendFrames(const void* data, size_t count, size_t bytes)
+{
+    if (!is_open || !checkBytes(bytes, count)) return false;
+    const uint8_t* src = static_cast<const uint8_t*>(data);
+    while (count > 0) {
+        // 뵽߽ʱĲֱӴӵ÷Ļд
+        if (staged == 0 && count >= opts.batch_frames) {
+            const size_t n = count / opts.batch_frames * opts.batch_frames;
+            if (!writeFrames(src, n)) return false;
+            src += n * frame_bytes;
+            count -= n;
+            continue;
+        }
+        const size_t n = std::min(count, opts.batch_frames - staged);
+        memcpy(staging.data() + staged * frame_bytes, src, n * frame_bytes);
+        staged += n;
+        src += n * frame_bytes;
+        count -= n;
+        if (staged == opts.batch_frames && !flush()) return false;
+    }
+    return true;
+}
+
+bool H5FrameWriter::setExtent(uint64_t frames)
+{
+    dims[0] = (hsize_t)frames;
+    if (H5Dset_extent(ds.getId(), dims.data()) < 0) {
+        printf("Failed to set dataset extent to %llu frames\n", (unsigned long long)frames);
+        return false;
+    }
+    stats_.extends++;
+    return true;
+}
+
+// ʱչ̯ԪݸµĿ
+bool H5FrameWriter::ensureCapacity(uint64_t needed)
+{
+    if (needed <= dims[0]) return true;
+    uint64_t capacity = needed;
+    if (opts.growth > 1.0) {
+        capacity = std::max<uint64_t>(needed, (uint64_t)(dims[0] * opts.growth));
+        capacity = roundUp(capacity, opts.chunk_frames);
+    }
+    return setExtent(capacity);
+}
+
+bool H5FrameWriter::appendChunk(const void* chunk, size_t chunk_bytes)
+{
+    if (!is_open) return false;
+    if (opts.chunk_frames != 1) {
+        printf("appendChunk requires one frame per chunk.\n");
+        return false;
+    }
+    if (!flush()) return false;  // ֡˳
+    if (!ensureCapacity(written + 1)) return false;
+
+    std::vector<hsize_t> offset(dims.size(), 0);
+    offset[0] = (hsize_t)written;
+    if (H5Dwrite_chunk(ds.getId(), H5P_DEFAULT, 0, offset.data(), chunk_bytes, chunk) < 0) {
+        printf("HDF5 direct chunk write failed at frame %llu\n", (unsigned long long)written);
+        return false;
+    }
+    written++;
+    stats_.frames++;
+    stats_.bytes += frame_bytes;
+    stats_.stored_bytes += chunk_bytes;
+    stats_.writes++;
+    return true;
+}
+
+bool H5FrameWriter::flush()
+{
+    if (!is_open || staged == 0) return true;
+
+    const size_t count = staged;
+    staged = 0;
+    return writeFrames(staging.data(), count);
+}
+
+//  count ֡дд֮
+bool H5FrameWriter::writeFrames(const void* data, size_t count)
+{
+    try {
+        if (!ensureCapacity(written + count)) return false;
+
+        H5::DataSpace file_space = ds.getSpace();
+        std::vector<hsize_t> offset(dims.size(), 0);
+        std::vector<hsize_t> slab = dims;
+        offset[0] = (hsize_t)written;
+        slab[0] = (hsize_t)count;
+        file_space.selectHyperslab(H5S_SELECT_SET, slab.data(), offset.data());
+
+        H5::DataSpace mem_space((int)slab.size(), slab.data(), NULL);
+        if (H5Dwrite(ds.getId(), type_id, mem_space.getId(), file_space.getId(), H5P_DEFAULT, data) < 0) {
+            printf("HDF5 batch write error (%zu frames)\n", count);
+            return false;
+        }
+    }
+    catch (H5::Exception& e) {
+        printf("HDF5 batch write error (%zu frames): %s\n", count, e.getCDetailMsg());
+        return false;
+    }
+
+    written += count;
+    stats_.frames += count;
+    stats_.bytes += (uint64_t)count * frame_bytes;
+    stats_.writes++;
+    return true;
+}
+
+bool H5FrameWriter::close()
+{
+    if (!is_open) return true;
+    bool ok = flush();
+    try {
+        // ȥԤչûдĲ
+        if (dims[0] != written) {
+            ok = setExtent(written) && ok;
+        }
+        ds.close();
+    }
+    catch (H5::Exception& e) {
+        printf("HDF5 dataset close error: %s\n", e.getCDetailMsg());
+        ok = false;
+    }
+    ds = H5::DataSet();
+    staging.clear();
+    staging.shrink_to_fit();
+    is_open = false;
+    return ok;
+}
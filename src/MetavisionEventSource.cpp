@@ -0,0 +1,130 @@
+#include "MetavisionEventSource.h"
+#include <metavision/hal/facilities/i_trigger_in.h>
+#include <cstdio>
+#include <exception>
+
+MetavisionEventSource::~MetavisionEventSource()
+{
+    stop();
+    close();
+}
+
+bool MetavisionEventSource::open()
+{
+    if (opened) return true;
+    try {
+        if (options.file.empty()) {
+            // ϵͳҵһõ Metavision 
+            cam = Metavision::Camera::from_first_available();
+
+            // ⲿͨڽⲿźţ
+            Metavision::I_TriggerIn* trigger_in = cam.get_device().get_facility<Metavision::I_TriggerIn>();
+            if (trigger_in) trigger_in->enable(Metavision::I_TriggerIn::Channel::Main);
+        }
+        else {
+            // طţreal_time_playback Ϊ false ʱ SDK ٰʱ
+            cam = Metavision::Camera::from_file(options.file,
+                Metavision::FileConfigHints().real_time_playback(options.real_time));
+        }
+
+        // ȡֱ
+        sensor_width = cam.geometry().width();
+        sensor_height = cam.geometry().height();
+
+        // ļʱ SDK ֹͣ״̬Ϊ STOPPED (Լ stop ʱ running Ѿ)
+        cam.add_status_change_callback([this](const Metavision::CameraStatus& status) {
+            if (status == Metavision::CameraStatus::STOPPED && running) end_of_file = true;
+        });
+    }
+    catch (const std::exception& e) {
+        printf("Failed to open %s: %s\n", options.file.empty() ? "DVS camera" : options.file.c_str(), e.what());
+        return false;
+    }
+    opened = true;
+    printf("DVS %s source: %dx%d%s\n", name(), sensor_width, sensor_height,
+        options.file.empty() ? "" : (options.real_time ? ", real-time playback" : ", max-speed playback"));
+    return true;
+}
+
+void MetavisionEventSource::close()
+{
+    stop();
+    opened = false;
+}
+
+bool MetavisionEventSource::start(Callback events_callback)
+{
+    if (!opened || running) return false;
+    try {
+        // ÿ start עᣬstop ʱƳصﲻҪ
+        cd_callback_id = cam.cd().add_callback(std::move(events_callback));
+        trigger_registered = false;
+        if (trigger_callback) {
+            // طŵļûд¼ⲻӰ CD ¼
+            try {
+                trigger_callback_id = cam.ext_trigger().add_callback(trigger_callback);
+                trigger_registered = true;
+            }
+            catch (const std::exception& e) {
+                printf("DVS %s source has no trigger events: %s\n", name(), e.what());
+            }
+        }
+        end_of_file = false;
+        running = true;
+        if (!cam.start()) {
+            running = false;
+            cam.cd().remove_callback(cd_callback_id);
+            if (trigger_registered) cam.ext_trigger().remove_callback(trigger_callback_id);
+            printf("Failed to start DVS %s source.\n", name());
+            return false;
+        }
+    }
+    catch (const std::exception& e) {
+        running = false;
+        printf("Failed to start DVS %s source: %s\n", name(), e.what());
+        return false;
+    }
+    return true;
+}
+
+void MetavisionEventSource::stop()
+{
+    if (!running) return;
+    running = false;
+    try {
+        if (cam.is_running()) cam.stop(); // ֹͣɼ
+        cam.cd().remove_callback(cd_callback_id);
+        if (trigger_registered) cam.ext_trigger().remove_callback(trigger_callback_id);
+        trigger_registered = false;
+    }
+    catch (const std::exception& e) {
+        printf("Failed to stop DVS %s source: %s\n", name(), e.what());
+    }
+}
+
+bool MetavisionEventSource::startRecording(const std::string& path)
+{
+    if (!canRecord()) {
+        printf("DVS %s source cannot record .raw files.\n", name());
+        return false;
+    }
+    try {
+        return cam.start_recording(path);
+    }
+    catch (const std::exception& e) {
+        printf("Failed to record %s: %s\n", path.c_str(), e.what());
+        return false;
+    }
+}
+
+bool MetavisionEventSource::stopRecording(const std::string& path)
+{
+    if (!canRecord()) return false;
+    try {
+        return cam.stop_recording(path);
+    }
+    catch (const std::exception& e) {
+        printf("Failed to stop recording %s: %s\n", path.c_str(), e.what());
+        return false;
+    }
+}
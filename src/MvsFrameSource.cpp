@@ -0,0 +1,213 @@
+#include "MvsFrameSource.h"
+#include <cstdio>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#if defined(DUALCAMERA_HAVE_MVS)
+#include <MvCameraControl.h>
+#endif
+
+MvsFrameSource::~MvsFrameSource()
+{
+    stop();
+    close();
+}
+
+std::string MvsFrameSource::pixelFormatName(unsigned int pixel_type)
+{
+    // PFNC ֵ룬 MvGvspPixelType ͬ
+    switch (pixel_type) {
+    case 0x0108000A: return "BayerGB8";
+    case 0x01080009: return "BayerRG8";
+    case 0x01080008: return "BayerGR8";
+    case 0x0108000B: return "BayerBG8";
+    case 0x01080001: return "Mono8";
+    case 0x02180015: return "BGR8";
+    case 0x02180014: return "RGB8";
+    default: return "Unknown";
+    }
+}
+
+#if defined(DUALCAMERA_HAVE_MVS)
+
+bool MvsFrameSource::open()
+{
+    if (camera_handle) return true;
+
+    //ʼ
+    int nRet = MV_CC_Initialize();
+    if (MV_OK != nRet) {
+        printf("Failed to initialize SDK! Error: [0x%x]\n", nRet);
+        return false;
+    }
+
+    //Ѱ豸
+    MV_CC_DEVICE_INFO_LIST device_list;
+    memset(&device_list, 0, sizeof(MV_CC_DEVICE_INFO_LIST));
+    nRet = MV_CC_EnumDevices(MV_GENTL_CXP_DEVICE, &device_list);
+    if (MV_OK != nRet) {
+        printf("Failed to enumerate devices! Error: [0x%x]\n", nRet);
+        return false;
+    }
+    if (device_list.nDeviceNum == 0) {
+        printf("No compatible cameras found!\n");
+        return false;
+    }
+
+    //ľ
+    nRet = MV_CC_CreateHandle(&camera_handle, device_list.pDeviceInfo[0]);
+    if (MV_OK != nRet) {
+        printf("Failed to create camera handle! Error: [0x%x]\n", nRet);
+        camera_handle = nullptr;
+        return false;
+    }
+    //豸
+    nRet = MV_CC_OpenDevice(camera_handle);
+    if (MV_OK != nRet) {
+        printf("Failed to open camera device! Error: [0x%x]\n", nRet);
+        MV_CC_DestroyHandle(camera_handle);
+        camera_handle = nullptr;
+        return false;
+    }
+
+    //ôʽ
+    const std::vector<std::tuple<const char*, int, const char*>> settings = {
+        {"TriggerMode", 1, "Trigger Mode"},
+        {"TriggerSource", 0, "Trigger Source"},
+        {"TriggerActivation", 0, "Trigger Activation"}, // Rising edge trigger
+        {"OverlapMode", 1, "Overlap Mode"}
+    };
+    for (const auto& [name, value, description] : settings) {
+        nRet = MV_CC_SetEnumValue(camera_handle, name, value);
+        if (MV_OK != nRet) {
+            printf("Failed to set %s! Error: [0x%x]\n", description, nRet);
+            close();
+            return false;
+        }
+    }
+
+    // Set image node number
+    nRet = MV_CC_SetImageNodeNum(camera_handle, options.image_node_count);
+    if (MV_OK != nRet) {
+        printf("Failed to set image node number! Error: [0x%x]\n", nRet);
+        close();
+        return false;
+    }
+    return true;
+}
+
+void MvsFrameSource::close()
+{
+    if (camera_handle == nullptr) return;
+    MV_CC_CloseDevice(camera_handle);
+    MV_CC_DestroyHandle(camera_handle);
+    camera_handle = nullptr;
+}
+
+bool MvsFrameSource::format(SourceFormat& format)
+{
+    if (camera_handle == nullptr) return false;
+    MVCC_INTVALUE width_info = { 0 }, height_info = { 0 };
+    if (MV_CC_GetIntValue(camera_handle, "Width", &width_info) != MV_OK ||
+        MV_CC_GetIntValue(camera_handle, "Height", &height_info) != MV_OK) {
+        return false;
+    }
+    format.width = (uint32_t)width_info.nCurValue;
+    format.height = (uint32_t)height_info.nCurValue;
+
+    MVCC_ENUMVALUE pixel_info = { 0 };
+    if (MV_CC_GetEnumValue(camera_handle, "PixelFormat", &pixel_info) == MV_OK) {
+        format.pixel_type = pixel_info.nCurValue;
+        format.pixel_format = pixelFormatName(pixel_info.nCurValue);
+    }
+    else {
+        format.pixel_type = 0;
+        format.pixel_format = "Unknown";
+    }
+    return true;
+}
+
+bool MvsFrameSource::start(Callback frame_callback)
+{
+    if (camera_handle == nullptr) return false;
+    callback = std::move(frame_callback);
+
+    // Register image callback ( SDK ȡ߳)
+    int nRet = MV_CC_RegisterImageCallBackEx(camera_handle,
+        [](unsigned char* image_data, MV_FRAME_OUT_INFO_EX* frame_info, void* user_data) {
+            if (!image_data || !frame_info || !user_data) return;
+            SourceFrame frame;
+            frame.data = image_data;
+            frame.bytes = (size_t)frame_info->nFrameLenEx;
+            frame.width = frame_info->nWidth;
+            frame.height = frame_info->nHeight;
+            frame.pixel_type = (uint32_t)frame_info->enPixelType;
+            frame.frame_number = frame_info->nFrameNum;
+            frame.device_timestamp = ((uint64_t)frame_info->nDevTimeStampHigh << 32) | frame_info->nDevTimeStampLow;
+            static_cast<MvsFrameSource*>(user_data)->deliver(frame);
+        }, this);
+    if (MV_OK != nRet) {
+        printf("Failed to register image callback! Error: [0x%x]\n", nRet);
+        return false;
+    }
+
+    // Start image acquisition
+    nRet = MV_CC_StartGrabbing(camera_handle);
+    if (MV_OK != nRet) {
+        printf("Failed to start image grabbing! Error: [0x%x]\n", nRet);
+        MV_CC_RegisterImageCallBackEx(camera_handle, NULL, NULL);
+        return false;
+    }
+    grabbing = true;
+    return true;
+}
+
+void MvsFrameSource::stop()
+{
+    if (!grabbing || camera_handle == nullptr) return;
+    MV_CC_StopGrabbing(camera_handle);
+    MV_CC_RegisterImageCallBackEx(camera_handle, NULL, NULL);
+    grabbing = false;
+}
+
+bool MvsFrameSource::convertToBgr(const SourceFrame& frame, uint8_t* dst, size_t dst_bytes)
+{
+    if (camera_handle == nullptr) return false;
+    MV_CC_PIXEL_CONVERT_PARAM convert_params = { 0 };
+    convert_params.enSrcPixelType = (MvGvspPixelType)frame.pixel_type;
+    convert_params.enDstPixelType = PixelType_Gvsp_BGR8_Packed; // תΪ BGR
+    convert_params.nWidth = (unsigned short)frame.width;
+    convert_params.nHeight = (unsigned short)frame.height;
+    convert_params.nSrcDataLen = (unsigned int)frame.bytes;
+    convert_params.pSrcData = const_cast<unsigned char*>(frame.data);
+    convert_params.pDstBuffer = dst;
+    convert_params.nDstBufferSize = (unsigned int)dst_bytes;
+
+    int result = MV_CC_ConvertPixelType(camera_handle, &convert_params);
+    if (MV_OK != result) {
+        printf("Failed to convert pixel type! Error: [0x%x]\n", result);
+        return false;
+    }
+    return true;
+}
+
+#else // û MVS SDKֻʹúϳ֡Դ
+
+bool MvsFrameSource::open()
+{
+    printf("Built without MVS SDK, no RGB camera available.\n");
+    return false;
+}
+
+void MvsFrameSource::close() {}
+
+bool MvsFrameSource::format(SourceFormat&) { return false; }
+
+bool MvsFrameSource::start(Callback) { return false; }
+
+void MvsFrameSource::stop() {}
+
+bool MvsFrameSource::convertToBgr(const SourceFrame&, uint8_t*, size_t) { return false; }
+
+#endif
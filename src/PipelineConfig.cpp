@@ -0,0 +1,222 @@
+#include "PipelineConfig.h"
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include "DVS.h"
+#include "RGB.h"
+
+namespace {
+    // ÿһ key ֻһΣset / write ű
+    template <typename Config, typename Visitor>
+    void visitFields(Config& c, Visitor&& v)
+    {
+        v("rgb.workers", c.rgb.workers);
+        v("rgb.pin_workers", c.rgb.pin_workers);
+        v("rgb.ring_frames", c.rgb.ring_frames);
+        v("rgb.dispatch_batch", c.rgb.dispatch_batch);
+        v("rgb.raw_pool_buffers", c.rgb.raw_pool_buffers);
+        v("rgb.bgr_pool_buffers", c.rgb.bgr_pool_buffers);
+        v("rgb.write_queue_frames", c.rgb.write_queue_frames);
+        v("rgb.write_queue_policy", c.rgb.write_queue_policy);
+        v("rgb.write_block_timeout_ms", c.rgb.write_block_timeout_ms);
+        v("rgb.reorder_window", c.rgb.reorder_window);
+        v("rgb.reorder_gap_timeout_ms", c.rgb.reorder_gap_timeout_ms);
+        v("rgb.hdf5_batch_frames", c.rgb.hdf5_batch_frames);
+        v("rgb.hdf5_chunk_frames", c.rgb.hdf5_chunk_frames);
+        v("rgb.preview_width", c.rgb.preview_width);
+        v("rgb.preview_height", c.rgb.preview_height);
+        v("rgb.preview_fps", c.rgb.preview_fps);
+        v("dvs.display_fps", c.dvs.display_fps);
+        v("dvs.display_accumulation_us", c.dvs.display_accumulation_us);
+        v("dvs.h5_buffer_events", c.dvs.h5_buffer_events);
+        v("dvs.h5_queue_buffers", c.dvs.h5_queue_buffers);
+        v("dvs.h5_chunk_events", c.dvs.h5_chunk_events);
+        v("gui.dvs_refresh_ms", c.gui.dvs_refresh_ms);
+        v("gui.rgb_refresh_ms", c.gui.rgb_refresh_ms);
+        v("gui.view_width", c.gui.view_width);
+        v("gui.view_height", c.gui.view_height);
+    }
+
+    const char* const kPolicyNames[] = { "block", "drop_oldest", "drop_newest", "reject" };
+
+    bool parseValue(const std::string& text, size_t& value)
+    {
+        if (text.empty() || text[0] == '-') return false;
+        char* end = nullptr;
+        errno = 0;
+        const unsigned long long v = std::strtoull(text.c_str(), &end, 10);
+        if (errno != 0 || *end != '\0') return false;
+        value = (size_t)v;
+        return true;
+    }
+
+    bool parseValue(const std::string& text, int64_t& value)
+    {
+        char* end = nullptr;
+        errno = 0;
+        const long long v = std::strtoll(text.c_str(), &end, 10);
+        if (text.empty() || errno != 0 || *end != '\0') return false;
+        value = (int64_t)v;
+        return true;
+    }
+
+    bool parseValue(const std::string& text, int& value)
+    {
+        int64_t v = 0;
+        if (!parseValue(text, v) || v < INT32_MIN || v > INT32_MAX) return false;
+        value = (int)v;
+        return true;
+    }
+
+    bool parseValue(const std::string& text, double& value)
+    {
+        char* end = nullptr;
+        const double v = std::strtod(text.c_str(), &end);
+        if (text.empty() || *end != '\0') return false;
+        value = v;
+        return true;
+    }
+
+    bool parseValue(const std::string& text, bool& value)
+    {
+        if (text == "true" || text == "1" || text == "yes" || text == "on") value = true;
+        else if (text == "false" || text == "0" || text == "no" || text == "off") value = false;
+        else return false;
+        return true;
+    }
+
+    bool parseValue(const std::string& text, QueuePolicy& value)
+    {
+        for (int i = 0; i < 4; ++i) {
+            if (text == kPolicyNames[i]) {
+                value = (QueuePolicy)i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::string formatValue(size_t value) { return std::to_string(value); }
+    std::string formatValue(int64_t value) { return std::to_string(value); }
+    std::string formatValue(int value) { return std::to_string(value); }
+    std::string formatValue(bool value) { return value ? "true" : "false"; }
+    std::string formatValue(QueuePolicy value) { return kPolicyNames[(int)value]; }
+    std::string formatValue(double value)
+    {
+        char text[32];
+        snprintf(text, sizeof(text), "%g", value);
+        return text;
+    }
+}
+
+bool PipelineConfig::set(const std::string& key, const std::string& value)
+{
+    bool found = false;
+    bool ok = false;
+    visitFields(*this, [&](const char* name, auto& field) {
+        if (found || key != name) return;
+        found = true;
+        ok = parseValue(value, field);
+    });
+    if (!found) printf("Unknown pipeline setting %s\n", key.c_str());
+    else if (!ok) printf("Invalid value \"%s\" for pipeline setting %s\n", value.c_str(), key.c_str());
+    return ok;
+}
+
+bool PipelineConfig::hasKey(const std::string& key)
+{
+    PipelineConfig config;
+    bool found = false;
+    visitFields(config, [&](const char* name, auto&) { found = found || key == name; });
+    return found;
+}
+
+std::string PipelineConfig::trim(const std::string& text)
+{
+    const size_t begin = text.find_first_not_of(" \t\r\n");
+    if (begin == std::string::npos) return std::string();
+    const size_t end = text.find_last_not_of(" \t\r\n");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool PipelineConfig::readKeyValues(const std::string& path, const KeyValueHandler& apply)
+{
+    std::ifstream file(path);
+    if (!file) {
+        printf("Failed to open config file %s\n", path.c_str());
+        return false;
+    }
+    bool ok = true;
+    std::string line;
+    int line_number = 0;
+    while (std::getline(file, line)) {
+        line_number++;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') continue;
+        const size_t eq = line.find('=');
+        if (eq == std::string::npos || !apply(trim(line.substr(0, eq)), trim(line.substr(eq + 1)))) {
+            printf("%s:%d: ignored \"%s\"\n", path.c_str(), line_number, line.c_str());
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+bool PipelineConfig::load(const std::string& path)
+{
+    return readKeyValues(path, [this](const std::string& key, const std::string& value) { return set(key, value); });
+}
+
+bool PipelineConfig::write(FILE* out) const
+{
+    bool ok = true;
+    visitFields(*this, [&](const char* name, const auto& field) {
+        ok = fprintf(out, "%s = %s\n", name, formatValue(field).c_str()) > 0 && ok;
+    });
+    return ok;
+}
+
+bool PipelineConfig::save(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        printf("Failed to write pipeline config %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    const bool ok = write(file);
+    return fclose(file) == 0 && ok;
+}
+
+void PipelineConfig::apply(RGB& target) const
+{
+    target.setWorkerCount(rgb.workers, rgb.pin_workers);
+    target.setFrameBuffers(rgb.ring_frames, rgb.raw_pool_buffers, rgb.bgr_pool_buffers);
+    target.setDispatchBatch(rgb.dispatch_batch);
+    target.setWriteQueue(rgb.write_queue_frames, rgb.write_queue_policy, rgb.write_block_timeout_ms);
+    target.setReorderWindow(rgb.reorder_window, rgb.reorder_gap_timeout_ms);
+    target.setHdf5Batching(rgb.hdf5_batch_frames, rgb.hdf5_chunk_frames);
+    target.setPreview(rgb.preview_width, rgb.preview_height, rgb.preview_fps);
+}
+
+void PipelineConfig::apply(DVS& target) const
+{
+    target.setDisplay(dvs.display_fps, dvs.display_accumulation_us);
+    H5EventWriter::Options options = target.getEventWriterOptions();
+    options.buffer_events = dvs.h5_buffer_events;
+    options.queue_buffers = dvs.h5_queue_buffers;
+    options.chunk_events = dvs.h5_chunk_events;
+    target.setEventWriterOptions(options);
+}
+
+uint64_t PipelineConfig::rgbBufferBytes(uint64_t raw_frame_bytes, uint64_t bgr_frame_bytes, uint64_t frame_bytes) const
+{
+    return rgb.raw_pool_buffers * raw_frame_bytes + rgb.bgr_pool_buffers * bgr_frame_bytes +
+        rgb.hdf5_batch_frames * frame_bytes;
+}
+
+std::string PipelineConfig::defaultPath()
+{
+    const char* path = std::getenv("DUALCAMERA_CONFIG");
+    return path && *path ? path : "dualcamera.conf";
+}
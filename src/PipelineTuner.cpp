@@ -0,0 +1,166 @@
+#include "PipelineTuner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <thread>
+
+PipelineTuner::PipelineTuner(const Options& tuner_options) : options(tuner_options)
+{
+}
+
+size_t PipelineTuner::withHeadroom(size_t peak, size_t minimum) const
+{
+    const size_t scaled = (size_t)std::ceil(peak * std::max(1.0, options.headroom));
+    return std::max({ minimum, scaled, peak + 2 });
+}
+
+uint64_t PipelineTuner::bufferBytes(const PipelineConfig& config) const
+{
+    // ϳ֡Դ 8 λˣ֡־ HDF5 ݴ滺
+    const uint64_t pixels = (uint64_t)options.width * options.height;
+    const uint64_t frame_bytes = options.rgb_format == RGB::RecordFormat::RawBayer ? pixels : pixels * 3;
+    return config.rgbBufferBytes(pixels, pixels * 3, options.rgb_sink == RGB::SinkType::Hdf5 ? frame_bytes : 0);
+}
+
+bool PipelineTuner::sustained(const Recorder::Summary& s) const
+{
+    // ֡ԴҲҪϣCPU ռʱϳ֡Դ֡ʱ֡Ҳ
+    const double expected = options.target_fps * s.seconds;
+    return s.rgb_received > 0 && s.rgb_received >= 0.9 * expected && s.rgb_frames == s.rgb_received &&
+        s.rgb_dropped == 0 && s.rgb_errors == 0 && s.reorder_gaps == 0 && s.dvs_dropped == 0 &&
+        s.pool_fallbacks == 0;   // ˻ضѷʱʵڴ bufferBytes Ķ࣬
+}
+
+PipelineTuner::Trial PipelineTuner::runTrial(const std::string& stage, const PipelineConfig& config)
+{
+    Recorder::Options recorder_options;
+    recorder_options.dataset = "tune_" + std::to_string(trial_index++);
+    recorder_options.rgb_root = recorder_options.dvs_root = options.directory;
+    recorder_options.rgb_format = options.rgb_format;
+    recorder_options.rgb_sink = options.rgb_sink;
+    recorder_options.dvs_format = options.dvs_format;
+    recorder_options.trigger = false;
+    recorder_options.synthetic = true;
+    recorder_options.synthetic_fps = options.target_fps;
+    recorder_options.synthetic_width = options.width;
+    recorder_options.synthetic_height = options.height;
+    recorder_options.synthetic_event_rate = options.event_rate;
+    recorder_options.pipeline = config;
+
+    Trial trial;
+    trial.stage = stage;
+    trial.config = config;
+    trial.buffer_bytes = bufferBytes(config);
+    {
+        Recorder recorder(recorder_options);
+        if (recorder.start()) {
+            while (recorder.elapsedSeconds() < options.trial_seconds) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            recorder.stop();
+            trial.summary = recorder.summary();
+            trial.sustained = sustained(trial.summary);
+        }
+    }
+    std::error_code ec;
+    std::filesystem::remove_all(std::filesystem::path(options.directory) / recorder_options.dataset, ec);
+
+    const Recorder::Summary& s = trial.summary;
+    printf("[tune] %-14s workers %zu, hdf5 batch %zu, dispatch %zu, pools %zu/%zu, queue %zu: "
+        "%.1f fps, dropped %llu, gaps %llu, pool fallbacks %llu, peaks raw %zu bgr %zu queue %zu reorder %zu, %.0f MB buffers -> %s\n",
+        stage.c_str(), config.rgb.workers, config.rgb.hdf5_batch_frames, config.rgb.dispatch_batch,
+        config.rgb.raw_pool_buffers, config.rgb.bgr_pool_buffers, config.rgb.write_queue_frames,
+        s.seconds > 0 ? s.rgb_frames / s.seconds : 0.0, (unsigned long long)s.rgb_dropped, (unsigned long long)s.reorder_gaps,
+        (unsigned long long)s.pool_fallbacks,
+        s.raw_pool_peak, s.bgr_pool_peak, s.write_queue_peak, s.reorder_peak, trial.buffer_bytes / 1e6,
+        trial.sustained ? "sustained" : "too slow");
+    return trial;
+}
+
+PipelineTuner::Result PipelineTuner::run(const PipelineConfig& base)
+{
+    Result result;
+    PipelineConfig config = base;
+    const size_t max_workers = options.max_workers > 0 ? options.max_workers :
+        std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    // 1. ߳
+    bool found = false;
+    const Trial* best = nullptr;
+    for (size_t workers = 1; workers <= max_workers && !found; ++workers) {
+        config.rgb.workers = workers;
+        result.trials.push_back(runTrial("workers", config));
+        found = result.trials.back().sustained;
+    }
+    if (!found) {
+        for (const Trial& trial : result.trials) {
+            if (!best || trial.summary.rgb_frames > best->summary.rgb_frames) best = &trial;
+        }
+        result.config = best->config;
+        result.buffer_bytes = best->buffer_bytes;
+        printf("[tune] no configuration sustains %.1f fps at %ux%u; best was %zu workers.\n",
+            options.target_fps, options.width, options.height, result.config.rgb.workers);
+        return result;
+    }
+    const size_t first_sustained = result.trials.size() - 1;
+
+    // 2. СʼֵСĺѡСԣʼֵѾ
+    auto tuneBatch = [&](const char* stage, size_t& value, std::initializer_list<size_t> candidates) {
+        const size_t start = value;
+        for (size_t candidate : candidates) {
+            if (candidate >= start) break;
+            value = candidate;
+            result.trials.push_back(runTrial(stage, config));
+            if (result.trials.back().sustained) return;
+        }
+        value = start;
+    };
+    if (options.rgb_sink == RGB::SinkType::Hdf5) tuneBatch("hdf5_batch", config.rgb.hdf5_batch_frames, { 1, 2, 4, 8, 16, 32, 64 });
+    tuneBatch("dispatch_batch", config.rgb.dispatch_batch, { 1, 2, 4, 8, 16 });
+
+    // 3. ȣȡϵ¼иķֵ
+    size_t raw_peak = 0, bgr_peak = 0, queue_peak = 0, reorder_peak = 0, dvs_queue_peak = 0;
+    for (size_t i = first_sustained; i < result.trials.size(); ++i) {
+        const Trial& trial = result.trials[i];
+        if (!trial.sustained) continue;
+        raw_peak = std::max(raw_peak, trial.summary.raw_pool_peak);
+        bgr_peak = std::max(bgr_peak, trial.summary.bgr_pool_peak);
+        queue_peak = std::max(queue_peak, trial.summary.write_queue_peak);
+        reorder_peak = std::max(reorder_peak, trial.summary.reorder_peak);
+        dvs_queue_peak = std::max(dvs_queue_peak, trial.summary.dvs_queue_peak);
+    }
+    size_t scale = 1;
+    for (int attempt = 0; attempt < 3 && !result.depths_confirmed; ++attempt, scale *= 2) {
+        PipelineConfig tuned = config;
+        tuned.rgb.raw_pool_buffers = withHeadroom(raw_peak, 4) * scale;
+        tuned.rgb.bgr_pool_buffers = withHeadroom(bgr_peak, 4) * scale;
+        tuned.rgb.ring_frames = tuned.rgb.raw_pool_buffers;   // ֡ռԭʼصĿ
+        tuned.rgb.write_queue_frames = withHeadroom(queue_peak, 4) * scale;
+        tuned.rgb.reorder_window = std::max(withHeadroom(reorder_peak, 4), tuned.rgb.workers * 2) * scale;
+        tuned.dvs.h5_queue_buffers = withHeadroom(dvs_queue_peak, 8) * scale;
+        result.trials.push_back(runTrial("depths", tuned));
+        if (result.trials.back().sustained) {
+            config = tuned;
+            result.depths_confirmed = true;
+        }
+    }
+    if (!result.depths_confirmed) {
+        printf("[tune] reduced buffer depths did not hold up, keeping the starting depths.\n");
+    }
+
+    // 4. Ҫдñ¼һΣϲ ok (ʼ + С֮ǰһԹ)
+    result.config = config;
+    result.buffer_bytes = bufferBytes(config);
+    result.trials.push_back(runTrial("final", config));
+    result.ok = result.trials.back().sustained;
+    if (!result.ok) {
+        printf("[tune] final confirmation of the tuned configuration did not sustain %.1f fps, not saving it.\n",
+            options.target_fps);
+        return result;
+    }
+    printf("[tune] %.1f fps at %ux%u: %zu workers, hdf5 batch %zu, dispatch batch %zu, %.0f MB of frame buffers (was %.0f MB).\n",
+        options.target_fps, options.width, options.height, config.rgb.workers, config.rgb.hdf5_batch_frames,
+        config.rgb.dispatch_batch, result.buffer_bytes / 1e6, bufferBytes(base) / 1e6);
+    return result;
+}
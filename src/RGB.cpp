@@ -1,4 +1,6 @@
 #include "RGB.h"
+#include "MvsFrameSource.h"
+#include "SteadyClock.h"
 #include <H5Cpp.h> //  HDF5 C++ API
 #include <memory>  //  std::make_unique
 
@@ -17,51 +19,33 @@ void RGB::initializeInternalParameters()
     task_stop = false; // (from your .h)
 
     // Clear data structures
-    image_queue.clear();
+    image_ring.reset();
     hdf5_write_queue.clear(); // +++ ADDED: ¶
 
-    // Initialize camera parameters
-    nRet = MV_OK;
-    camera_handle = nullptr;
-    nImageNodeNum = 200; // (from your .h, was 200 in old .cpp)
-
-    // Initialize buffers
-    rgb_buffer = nullptr;
-
-    // Initialize camera SDK structures
-    memset(&device_list, 0, sizeof(MV_CC_DEVICE_INFO_LIST));
-    memset(&pixel_convert_params, 0, sizeof(MV_CC_PIXEL_CONVERT_PARAM));
-    memset(&output_frame, 0, sizeof(MV_FRAME_OUT));
-    memset(&image_save_params, 0, sizeof(MV_CC_SAVE_IMAGE_PARAM));
-    // memset(&image_params, 0, sizeof(MV_CC_SAVE_IMAGE_PARAM)); // (in old .cpp, not in .h)
-    memset(&int_value_params, 0, sizeof(MVCC_INTVALUE));
-
     thread_pool = nullptr;
 
-    // +++ ADDED: Initialize HDF5 members
-    h5_file.reset(); // (h5_file is std::unique_ptr)
-    h5_rgb_dataset = H5::DataSet();   // ΪЧ
+    reorder_buffer.clear([](ProcessedFrame*& frame) { delete frame; });
+    clearReleases();
+
+    frame_sink.reset();
 }
 
 // 캯
 RGB::RGB()
+    : RGB(std::make_unique<MvsFrameSource>())
 {
-    initializeInternalParameters();
-
-    // Step 1: Initialize camera SDK
-    if (!initializeCameraSDK()) return;
-
-    // Step 2: Enumerate and select camera device
-    if (!enumerateAndSelectCamera()) return;
+}
 
-    // Step 3: Allocate image buffers
-    if (!allocateImageBuffers()) return;
+RGB::RGB(std::unique_ptr<FrameSource> source)
+    : frame_source(std::move(source))
+{
+    initializeInternalParameters();
 
-    // Step 4: Configure camera settings
-    if (!configureCameraSettings()) return;
+    // 򿪲֡Դ (ö豸򿪡ôʽ)
+    if (!frame_source || !frame_source->open()) return;
 
     is_initialized = true;
-    printf("RGB camera initialized successfully.\n");
+    printf("RGB camera initialized successfully (%s source).\n", frame_source->name());
 }
 
 // 
@@ -71,267 +55,346 @@ RGB::~RGB()
     if (is_saving) {
         stopCapture();
     }
-    cleanupResources();
+    if (frame_source) frame_source->close();
 }
 
 // =============================================
-// Camera Initialization Helpers
+// Resource Management
 // =============================================
 
-//ʼ
-bool RGB::initializeCameraSDK()
+void RGB::clearImageQueue()
 {
-    nRet = MV_CC_Initialize();
-    if (MV_OK != nRet) {
-        printf("Failed to initialize SDK! Error: [0x%x]\n", nRet);
-        return false;
+    ImageNode* node = nullptr;
+    while (image_ring.try_pop(node)) {
+        if (node) {
+            // ImageNode ʱ raw Զ黹 raw_pool
+            delete node;
+        }
     }
-    return true;
 }
 
-//Ѱ豸
-bool RGB::enumerateAndSelectCamera()
+// +++ ADDED: µHDF5
+void RGB::clearHDF5Queue()
 {
-    nRet = MV_CC_EnumDevices(MV_GENTL_CXP_DEVICE, &device_list);
-    if (MV_OK != nRet) {
-        printf("Failed to enumerate devices! Error: [0x%x]\n", nRet);
-        return false;
-    }
+    // е disposer  delete ʣµ ProcessedFrame
+    hdf5_write_queue.clear();
+}
+
+// =============================================
+// Camera Control
+// =============================================
 
-    if (device_list.nDeviceNum == 0) {
-        printf("No compatible cameras found!\n");
+bool RGB::startCapture(const std::string& save_path)
+{
+    if (!is_initialized || !frame_source) {
+        printf("Camera not properly initialized. Cannot start capture.\n");
         return false;
     }
-    //ľ
-    nRet = MV_CC_CreateHandle(&camera_handle, device_list.pDeviceInfo[0]);
-    if (MV_OK != nRet) {
-        printf("Failed to create camera handle! Error: [0x%x]\n", nRet);
+
+    //  sink_type 洢˲ļ
+    if (!openSink(save_path)) {
+        printf("Failed to open %s sink. Cannot start capture.\n", sink_type == SinkType::Hdf5 ? "HDF5" : "frame log");
         return false;
     }
-    //豸
-    nRet = MV_CC_OpenDevice(camera_handle);
-    if (MV_OK != nRet) {
-        printf("Failed to open camera device! Error: [0x%x]\n", nRet);
-        MV_CC_DestroyHandle(camera_handle);
-        camera_handle = nullptr;
+
+    // ǰֱԤ֡
+    if (!createFramePools()) {
+        printf("Failed to create frame buffer pools. Cannot start capture.\n");
+        closeSink();
         return false;
     }
 
-    return true;
-}
+    // Create thread pool (ȡ̳߳أ߳ setWorkerCount )
+    const size_t num_threads = worker_count;
+    thread_pool = new WorkStealingPool(num_threads, pin_workers);
 
+    // Set flags
+    is_saving = true;
+    should_exit = false;
+    writer_should_exit = false;
+    hdf5_write_queue.resume();
+    hdf5_write_queue.resetStats();
+    received_frames = 0;
+    image_ring.reset(image_ring_frames);  // ַ̺߳֡Դû֡Ҳ 0 ʼ
+    // µĲɼỰ֡Ŵͷʼһε״̬
+    reorder_buffer.clear([](ProcessedFrame*& frame) { delete frame; });
+    clearReleases();
 
-//ʱͼ񻺴
-bool RGB::allocateImageBuffers()
-{
-    // Get image dimensions from camera
-    MVCC_INTVALUE width = { 0 }, height = { 0 };
-    MV_CC_GetIntValue(camera_handle, "Width", &width);
-    MV_CC_GetIntValue(camera_handle, "Height", &height);
+    // Start task distribution thread
+    task_distribution_thread = std::thread(&RGB::distributeTasksThread, this);
+
+    // +++ ADDED: רõд߳
+    hdf5_writer_thread = std::thread(&RGB::hdf5WriteLoop, this);
 
-    // Allocate RGB buffer
-    size_t buffer_size = width.nCurValue * height.nCurValue * 3;
-    rgb_buffer = (unsigned char*)malloc(buffer_size);
-    if (rgb_buffer == nullptr) {
-        printf("Failed to allocate memory for RGB buffer!\n");
-        cleanupResources();
+    // ̶߳Ѿʼ֡ (ص֡Դ߳)
+    if (!frame_source->start([this](const SourceFrame& frame) { onSourceFrame(frame); })) {
+        printf("Failed to start %s frame source.\n", frame_source->name());
+        stopCapture();
         return false;
     }
 
+    printf("RGB Camera started successfully with %zu worker threads (%s sink, %s)!\n",
+        num_threads, frame_sink->name(), write_raw ? raw_pixel_format.c_str() : "BGR8");
     return true;
 }
 
-bool RGB::configureCameraSettings()
+void RGB::setWorkerCount(size_t count, bool pin_to_cores)
 {
-    //ôʽ
-    // Configure trigger settings
-    const std::vector<std::tuple<const char*, int, const char*>> settings = {
-        {"TriggerMode", 1, "Trigger Mode"},
-        {"TriggerSource", 0, "Trigger Source"},
-        {"TriggerActivation", 0, "Trigger Activation"}, // Rising edge trigger
-        {"OverlapMode", 1, "Overlap Mode"}
-    };
-
-    for (const auto& [name, value, description] : settings) {
-        nRet = MV_CC_SetEnumValue(camera_handle, name, value);
-        if (MV_OK != nRet) {
-            printf("Failed to set %s! Error: [0x%x]\n", description, nRet);
-            cleanupResources();
-            return false;
-        }
+    if (is_saving) {
+        printf("Cannot change worker count while capturing.\n");
+        return;
     }
+    worker_count = count == 0 ? 1 : count;
+    pin_workers = pin_to_cores;
+}
 
-    // Set image node number
-    nRet = MV_CC_SetImageNodeNum(camera_handle, nImageNodeNum);
-    if (MV_OK != nRet) {
-        printf("Failed to set image node number! Error: [0x%x]\n", nRet);
-        cleanupResources();
-        return false;
+void RGB::setFrameBuffers(size_t ring_frames, size_t raw_buffers, size_t bgr_buffers)
+{
+    if (is_saving) {
+        printf("Cannot change frame buffers while capturing.\n");
+        return;
     }
-
-    return true;
+    image_ring_frames = ring_frames < 2 ? 2 : ring_frames;
+    raw_pool_buffers = raw_buffers == 0 ? 1 : raw_buffers;
+    bgr_pool_buffers = bgr_buffers == 0 ? 1 : bgr_buffers;
 }
-// =============================================
-// Resource Management
-// =============================================
 
-void RGB::cleanupResources()
+void RGB::setDispatchBatch(size_t frames)
 {
-    // Release image buffer
-    if (rgb_buffer != nullptr) {
-        free(rgb_buffer);
-        rgb_buffer = nullptr;
+    if (is_saving) {
+        printf("Cannot change dispatch batch while capturing.\n");
+        return;
     }
+    dispatch_batch = frames == 0 ? 1 : frames;
+}
 
-    // Close camera handle
-    if (camera_handle != nullptr) {
-        MV_CC_CloseDevice(camera_handle);
-        MV_CC_DestroyHandle(camera_handle);
-        camera_handle = nullptr;
+void RGB::setRecordFormat(RecordFormat format)
+{
+    if (is_saving) {
+        printf("Cannot change record format while capturing.\n");
+        return;
     }
-
-    // Clear display stack
-    std::lock_guard<std::mutex> lock(display_mutex);
-    display_stack.clear();
+    record_format = format;
 }
 
-void RGB::clearImageQueue()
+void RGB::setColorConversion(ColorConversion conversion)
 {
-    ImageNode* node = nullptr;
-    while (image_queue.try_pop(node)) {
-        if (node) {
-            // ImageNode Զ free(node->image_data)
-            delete node;
-        }
+    if (is_saving) {
+        printf("Cannot change color conversion while capturing.\n");
+        return;
+    }
+    color_conversion = conversion;
+    if (conversion != ColorConversion::MvsSdk) {
+        printf("Using in-tree demosaic (%s).\n", simdLevelName(detectSimdLevel()));
     }
 }
 
-// +++ ADDED: µHDF5
-void RGB::clearHDF5Queue()
+void RGB::setHdf5Batching(size_t batch_frames, size_t chunk_frames)
 {
-    // <<< FIX: 
-    ProcessedFrame* frame_ptr = nullptr;
-    while (hdf5_write_queue.try_pop(frame_ptr)) {
-        if (frame_ptr) {
-            // ProcessedFrame һ cv::MatԶͷ
-            delete frame_ptr; // <<< FIX: ɾָ
-        }
+    if (is_saving) {
+        printf("Cannot change HDF5 batching while capturing.\n");
+        return;
     }
+    h5_write_options.batch_frames = batch_frames == 0 ? 1 : batch_frames;
+    h5_write_options.chunk_frames = chunk_frames == 0 ? 1 : chunk_frames;
 }
 
-// =============================================
-// Camera Control
-// =============================================
-
-void RGB::startCapture(const std::string& save_path)
+void RGB::setCompression(const ChunkCompression& compression)
 {
-    if (!is_initialized || camera_handle == nullptr) {
-        printf("Camera not properly initialized. Cannot start capture.\n");
+    if (is_saving) {
+        printf("Cannot change compression while capturing.\n");
         return;
     }
-
-    // +++ ADDED: ʼ HDF5 ļ
-    if (!initializeHDF5(save_path)) {
-        printf("Failed to initialize HDF5 file. Cannot start capture.\n");
+    if (!chunkCodecAvailable(compression.codec)) {
+        printf("Chunk codec %s is not available in this build, recording uncompressed.\n", chunkCodecName(compression.codec));
+        h5_write_options.compression = ChunkCompression();
         return;
     }
+    h5_write_options.compression = compression;
+}
 
-    // Create thread pool
-    const size_t num_threads = 6;
-    thread_pool = new ThreadPool(num_threads);
-
-    // Register image callback
-    nRet = MV_CC_RegisterImageCallBackEx(camera_handle, imageCallback, this);
-    if (MV_OK != nRet) {
-        printf("Failed to register image callback! Error: [0x%x]\n", nRet);
-        closeHDF5();
+void RGB::setSink(SinkType type, const FrameLogSink::Options& log_options)
+{
+    if (is_saving) {
+        printf("Cannot change sink while capturing.\n");
         return;
     }
+    sink_type = type;
+    frame_log_options = log_options;
+}
 
-    // Start image acquisition
-    nRet = MV_CC_StartGrabbing(camera_handle);
-    if (MV_OK != nRet) {
-        printf("Failed to start image grabbing! Error: [0x%x]\n", nRet);
-        closeHDF5();
+void RGB::setSegmentation(const SegmentPolicy& policy)
+{
+    if (is_saving) {
+        printf("Cannot change segmentation while capturing.\n");
         return;
     }
+    segment_policy = policy;
+}
 
-    // Set flags
-    is_saving = true;
-    should_exit = false;
-
-    // Start task distribution thread
-    task_distribution_thread = std::thread(&RGB::distributeTasksThread, this);
-
-    // +++ ADDED: רõ HDF5 д߳
-    hdf5_writer_thread = std::thread(&RGB::hdf5WriteLoop, this);
+void RGB::setReorderWindow(size_t window, int gap_timeout_ms)
+{
+    reorder_buffer.configure(window, std::chrono::milliseconds(gap_timeout_ms));
+}
 
-    printf("RGB Camera started successfully with %zu worker threads (HDF5 mode)!\n", num_threads);
+ReorderStats RGB::getReorderStats() const
+{
+    return reorder_buffer.stats();
 }
 
 void RGB::stopCapture()
 {
-    // 1. Signal all threads to exit
-    should_exit = true; // źŲɼص (imageCallback)
-    is_saving = false;  // źŷַ (distribute) д (hdf5WriteLoop) ߳
-
-    // 2. Wake up threads that might be waiting
-    image_semaphore.notifyAll(); // (from your .h)  distributeTasksThread
-    hdf5_write_queue.stopWait(); // +++ ADDED:  hdf5_writer_thread ( DataQueue д˷)
-    //  DataQueue ûУhdf5_writer_thread е is_saving ᴦ
-
-// 3. Join threads (order matters: consumers first)
-
-// +++ CHANGED: ֹͣȴ HDF5 ߳ ()
-    if (hdf5_writer_thread.joinable()) {
-        hdf5_writer_thread.join();
-        printf("HDF5 writer thread joined.\n");
-    }
+    // 1. Stop the frame source first: stop غлصͳ֡ image_ring ᶪ
+    if (frame_source) frame_source->stop();
+    should_exit = true; // źŲɼص (onSourceFrame)
+    is_saving = false;  // źỵַ̂߳ȡ image_ring ˳
 
-    // +++ CHANGED: Ȼֹͣȴַ߳ (м)
+    // 2. Join threads in pipeline order (producers first, so nothing in flight is lost)
+    // distributeTasksThread ѯ image_ring⵽ is_saving == false ҶΪպ˳
     if (task_distribution_thread.joinable()) {
         task_distribution_thread.join();
         printf("Task distributor thread joined.\n");
     }
 
+    // 3. ȴύתɣٰŻʣµ֡
+    if (thread_pool) {
+        delete thread_pool; // WorkStealingPool ȴύ
+        thread_pool = nullptr;
+    }
+    reorder_buffer.flushAll([this](ProcessedFrame*& frame) { stageRelease(frame); });
+    drainReleases();
 
-    // 4. Stop camera hardware
-    if (camera_handle != nullptr) {
-        MV_CC_StopGrabbing(camera_handle);
-        MV_CC_RegisterImageCallBackEx(camera_handle, NULL, NULL);
+    // 4. ֹͣд߳ ()дʣ֡
+    writer_should_exit = true;
+    hdf5_write_queue.stopWait();
+    if (hdf5_writer_thread.joinable()) {
+        hdf5_writer_thread.join();
+        printf("Writer thread joined.\n");
     }
 
-    // 5. Close HDF5 file
-    closeHDF5();
-    printf("HDF5 file closed.\n");
+    const ReorderStats reorder = reorder_buffer.stats();
+    printf("Reorder buffer: released %llu, gaps %llu, late %llu, max depth %zu.\n",
+        (unsigned long long)reorder.released, (unsigned long long)reorder.gaps,
+        (unsigned long long)reorder.late, reorder.max_depth);
+    const QueueStats queue = hdf5_write_queue.stats();
+    printf("Write queue: peak %zu/%zu, dropped %llu (timeouts %llu), rejected %llu, blocked %.1f ms.\n",
+        queue.high_water, queue.capacity, (unsigned long long)(queue.dropped_oldest + queue.dropped_newest),
+        (unsigned long long)queue.timeouts, (unsigned long long)queue.rejected, queue.blocked_ns / 1e6);
 
-    // 6. Clean up thread pool
-    if (thread_pool) {
-        delete thread_pool; // ThreadPool Ӧȴ
-        thread_pool = nullptr;
-    }
 
-    // 7. Clear remaining data in queues
+    // 5. Close the sink
+    closeSink();
+    printf("Sink closed: %llu frames, %llu MB stored, %llu writes, %llu errors.\n",
+        (unsigned long long)sink_stats.frames, (unsigned long long)(sink_stats.stored_bytes >> 20),
+        (unsigned long long)sink_stats.writes, (unsigned long long)sink_stats.errors);
+
+    // 6. Clear remaining data in queues
     clearImageQueue();
     clearHDF5Queue();
+
+    // 7. ггػ cv::Mat ͷţ黹֡
+    releaseFramePools();
+}
+
+// =============================================
+// Frame Buffer Pools
+// =============================================
+
+bool RGB::createFramePools()
+{
+    // source_format  openSink жȡԭʼݵλȡظʽĵ 16~23 λ (GenICam PFNC Լ)
+    const size_t pixels = (size_t)source_format.width * source_format.height;
+    if (pixels == 0) return false;
+
+    raw_pool = std::make_unique<FramePool>(source_format.frameBytes(), raw_pool_buffers);
+    bgr_pool = std::make_unique<FramePool>(pixels * 3, bgr_pool_buffers);
+    printf("Frame pools: raw %zu x %zu bytes, bgr %zu x %zu bytes.\n",
+        raw_pool_buffers, raw_pool->bufferSize(), bgr_pool_buffers, bgr_pool->bufferSize());
+    return true;
+}
+
+void RGB::releaseFramePools()
+{
+    const FramePool::Stats raw = getRawPoolStats();
+    const FramePool::Stats bgr = getBgrPoolStats();
+    last_raw_pool_stats = raw;
+    last_bgr_pool_stats = bgr;
+    printf("Raw pool: peak %zu/%zu, exhausted %llu, oversize %llu. BGR pool: peak %zu/%zu, exhausted %llu, oversize %llu.\n",
+        raw.high_water, raw.capacity, (unsigned long long)raw.exhausted, (unsigned long long)raw.oversize,
+        bgr.high_water, bgr.capacity, (unsigned long long)bgr.exhausted, (unsigned long long)bgr.oversize);
+    raw_pool.reset();
+    bgr_pool.reset();
+}
+
+FramePool::Stats RGB::getRawPoolStats() const
+{
+    return raw_pool ? raw_pool->stats() : last_raw_pool_stats;
+}
+
+FramePool::Stats RGB::getBgrPoolStats() const
+{
+    return bgr_pool ? bgr_pool->stats() : last_bgr_pool_stats;
 }
 
 // =============================================
 // Image Processing
 // =============================================
 
-void RGB::getLatestFrame(cv::Mat* output_frame)
+void RGB::setPreview(int width, int height, double fps)
 {
-    std::lock_guard<std::mutex> lock(display_mutex);
+    if (width > 0 && height > 0) {
+        preview_width = width;
+        preview_height = height;
+    }
+    preview_interval_ns = fps > 0 ? (int64_t)(1e9 / fps) : 0;
+}
 
-    cv::Mat latest_frame;
-    bool success = display_stack.top(latest_frame);
+bool RGB::getLatestPreview(cv::Mat& rgb_preview)
+{
+    if (!preview_buffer.update()) return false; // ûԤGUI ػ
+    rgb_preview = preview_buffer.readBuffer();
+    return !rgb_preview.empty();
+}
 
-    if (success && !latest_frame.empty()) {
-        *output_frame = latest_frame.clone();
-        // <<< REMOVED: cv::cvtColor(*output_frame, *output_frame, cv::COLOR_RGB2BGR);
-        //  processAndQueueFrame Ѿ BGR ʽ
+// preview_buffer ֻһߣ߳ͬʱʱֻõ preview_busy ǸԤ
+//  publishPreview ʱͷ
+bool RGB::claimPreview()
+{
+    if (preview_interval_ns <= 0) return false;
+    const int64_t now = (int64_t)steadyNowNs();
+    int64_t last = last_preview_ns.load(std::memory_order_relaxed);
+    if (now - last < preview_interval_ns) return false;
+    if (preview_busy.exchange(true, std::memory_order_acquire)) return false;
+    if (!last_preview_ns.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+        preview_busy.store(false, std::memory_order_release);
+        return false;
     }
+    return true;
+}
+
+// Сͨһ (ԭʼ˰ 2x2 Ԫֱȡɫ֡ȥ)
+// ֱддˣߴ粻ʱٷ
+void RGB::publishPreview(const cv::Mat& frame)
+{
+    if (frame.empty()) {
+        preview_busy.store(false, std::memory_order_release);
+        return;
+    }
+    cv::Mat& preview = preview_buffer.writeBuffer();
+    preview.create(preview_height, preview_width, CV_8UC3);
+    BayerPattern pattern;
+    if (frame.channels() == 3) {
+        previewFromBgr(frame.data, frame.step, frame.cols, frame.rows, preview.data, preview.step, preview.cols, preview.rows);
+    }
+    else if (bayerPatternFromName(raw_pixel_format, pattern)) {
+        previewFromBayer(frame.data, frame.step, frame.cols, frame.rows, pattern, preview.data, preview.step, preview.cols, preview.rows);
+    }
+    else {
+        previewFromMono(frame.data, frame.step, frame.cols, frame.rows, preview.data, preview.step, preview.cols, preview.rows);
+    }
+
+    preview_buffer.publish();
+    preview_busy.store(false, std::memory_order_release);
 }
 
 // =============================================
@@ -339,12 +402,23 @@ void RGB::getLatestFrame(cv::Mat* output_frame)
 // =============================================
 
 // ԪݣҽԪ
-void RGB::imageCallback(unsigned char* image_data, MV_FRAME_OUT_INFO_EX* frame_info, void* user_data)
+void RGB::onSourceFrame(const SourceFrame& frame)
 {
-    if (!frame_info || !image_data || !user_data) return;
-
-    RGB* camera = static_cast<RGB*>(user_data);
-    if (camera->should_exit) return; // ˳
+    if (!frame.data) return;
+    if (should_exit) return; // ˳
+    // ֡Դصֻһ߳ϵãļѽյ֡
+    if (frame_limit > 0 && received_frames.load(std::memory_order_relaxed) >= frame_limit) return;
+
+    const uint64_t host_timestamp_ns = steadyNowNs();
+    if (frame_observer) frame_observer(frame.frame_number, host_timestamp_ns, frame.device_timestamp);
+    received_frames.fetch_add(1, std::memory_order_relaxed);
+
+    // ֱӶõ malloc + memcpy
+    // (֡Դ߳ (SDK ȡ߳))
+    if (image_ring.full()) {
+        image_ring.mark_dropped();
+        return;
+    }
 
     // Create new image node
     ImageNode* image_node = new ImageNode();
@@ -354,242 +428,473 @@ void RGB::imageCallback(unsigned char* image_data, MV_FRAME_OUT_INFO_EX* frame_i
     }
 
     // Populate image node
-    image_node->pixel_type = frame_info->enPixelType;
-    image_node->data_length = frame_info->nFrameLenEx;
-    image_node->width = frame_info->nWidth;
-    image_node->height = frame_info->nHeight;
-    image_node->frame_number = frame_info->nFrameNum;
-
-    // Copy image data
-    image_node->image_data = (unsigned char*)malloc(image_node->data_length);
-    if (!image_node->image_data) {
-        printf("Failed to allocate memory for image data.\n");
-        delete image_node;
-        return;
+    image_node->pixel_type = frame.pixel_type;
+    image_node->data_length = frame.bytes;
+    image_node->width = frame.width;
+    image_node->height = frame.height;
+    image_node->frame_number = (unsigned int)frame.frame_number;
+    image_node->host_timestamp_ns = host_timestamp_ns;
+    image_node->device_timestamp = frame.device_timestamp;
+
+    // Copy image data (ԤĻȡؿʱ FramePool ˻ضѷ䲢)
+    if (raw_pool) image_node->raw.allocator = raw_pool->allocator();
+    image_node->raw.create(1, (int)image_node->data_length, CV_8UC1);
+    memcpy(image_node->raw.data, frame.data, image_node->data_length);
+
+    // Add to processing queue (޵ȴֻзַ߳һ)
+    if (!image_ring.try_push(image_node)) {
+        delete image_node; // try_push Ѽ붪֡
     }
-    memcpy(image_node->image_data, image_data, image_node->data_length);
-
-    // Add to processing queue
-    camera->image_queue.push(image_node);
-    camera->image_semaphore.notify();
 }
 
 // ַ߳ ( L1  -> ̳߳)
 void RGB::distributeTasksThread()
 {
-    while (is_saving || !image_queue.empty()) {
-        image_semaphore.wait(); // ȴ imageCallback ź
-
-        if (should_exit && image_queue.empty()) {
-            break;
+    // ص˲ٷźκ˱ܵ˯
+    // (200us ԶС֡ӿɸ֪ӳ)
+    // ÿְ image_ring е֡һȡ enqueueBatch ύټͻѴ
+    const size_t max_batch = dispatch_batch;
+    std::vector<SmallTask> batch;
+    batch.reserve(max_batch);
+    int idle_rounds = 0;
+    while (true) {
+        ImageNode* image_node = nullptr;
+        while (batch.size() < max_batch && image_ring.try_pop(image_node)) {
+            if (image_node == nullptr) continue;
+            if (write_raw && !compress_frames) {
+                queueRawFrame(image_node); // ѹʱַ̱߳Ͱɼ˳򣬲Ҫ̳߳غ
+                continue;
+            }
+            // ɼ˳Ǽǣ߳ɺ reorder_buffer ָ˳
+            reorder_buffer.expect(image_node->frame_number);
+            batch.emplace_back([this, image_node]() {
+                processAndQueueFrame(image_node);
+                delete image_node; // ڹ߳аȫɾ
+                });
         }
 
-        ImageNode* image_node = nullptr;
-        if (!image_queue.try_pop(image_node) || image_node == nullptr) {
+        if (batch.empty()) {
             if (!is_saving) break; // пˣֹͣˣ˳
+            if (++idle_rounds < 64) {
+                std::this_thread::yield();
+            }
+            else {
+                std::this_thread::sleep_for(std::chrono::microseconds(200));
+            }
             continue;
         }
+        idle_rounds = 0;
 
         // ύ̳߳
         if (thread_pool) {
-            thread_pool->enqueue([this, image_node]() {
-                // <<< CHANGED: º
-                processAndQueueFrame(image_node);
-                delete image_node; // ڹ߳аȫɾ
-                });
+            thread_pool->enqueueBatch(batch.begin(), batch.end());
         }
         else {
             // Fallback
-            processAndQueueFrame(image_node);
-            delete image_node;
+            for (SmallTask& task : batch) task();
         }
+        batch.clear();
+    }
+    if (image_ring.dropped() > 0) {
+        printf("RGB callback dropped %llu frames (image ring full).\n",
+            (unsigned long long)image_ring.dropped());
     }
     printf("Task distribution thread exited.\n");
 }
 
-// <<< REPLACED: ̳߳صĹ (ʽת + HDF5)
+// תֱд bgr_pool Ļ壻HDF5 кʾջһ (cv::Mat ü) clone
+bool RGB::convertToBgr(ImageNode* image_node, cv::Mat& bgr_frame)
+{
+    if (bgr_pool) bgr_frame.allocator = bgr_pool->allocator();
+    bgr_frame.create(image_node->height, image_node->width, CV_8UC3);
+
+    // 8 λ Bayer ʽĿڵȥˣ֡Դ (SDK)
+    BayerPattern pattern;
+    if (color_conversion != ColorConversion::MvsSdk &&
+        image_node->data_length == (uint64_t)image_node->width * image_node->height &&
+        image_node->pixel_type == source_format.pixel_type &&
+        bayerPatternFromName(source_format.pixel_format, pattern)) {
+        const DemosaicMethod method = color_conversion == ColorConversion::EdgeAware ?
+            DemosaicMethod::EdgeAware : DemosaicMethod::Bilinear;
+        demosaic(image_node->raw.data, image_node->width, bgr_frame.data, bgr_frame.step,
+            (int)image_node->width, (int)image_node->height, pattern, method);
+    }
+    else {
+        // Convert pixel format (MVS: MV_CC_ConvertPixelType)
+        SourceFrame frame;
+        frame.data = image_node->raw.data;
+        frame.bytes = (size_t)image_node->data_length;
+        frame.width = image_node->width;
+        frame.height = image_node->height;
+        frame.pixel_type = image_node->pixel_type;
+        frame.frame_number = image_node->frame_number;
+        frame.device_timestamp = image_node->device_timestamp;
+        if (!frame_source->convertToBgr(frame, bgr_frame.data, bgr_frame.total() * bgr_frame.elemSize())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// <<< REPLACED: ̳߳صĹ (ʽת + ѹ + HDF5)
 void RGB::processAndQueueFrame(ImageNode* image_node)
 {
-    // Allocate RGB buffer for conversion
-    size_t rgb_buffer_size = image_node->width * image_node->height * 3;
-    unsigned char* local_rgb_buffer = (unsigned char*)malloc(rgb_buffer_size);
-    if (!local_rgb_buffer) {
-        printf("Failed to allocate memory for RGB conversion.\n");
-        free(image_node->image_data); // ͷ
-        image_node->image_data = nullptr;
+    cv::Mat out_frame;
+    bool ok;
+    if (write_raw) {
+        // ԭʼֻҪѹʱŻ̳߳أﲻת
+        ok = image_node->data_length == (uint64_t)image_node->width * image_node->height;
+        if (ok) out_frame = image_node->raw.reshape(1, (int)image_node->height);
+    }
+    else {
+        ok = convertToBgr(image_node, out_frame);
+    }
+    if (!ok) {
+        // Żһ֡ˣѷĻʱԶ黹
+        reorder_buffer.skip(image_node->frame_number, [this](ProcessedFrame*& frame) { stageRelease(frame); });
+        drainReleases();
         return;
     }
 
-    // Convert pixel format
-    MV_CC_PIXEL_CONVERT_PARAM convert_params = { 0 };
-    convert_params.enSrcPixelType = image_node->pixel_type;
-    convert_params.enDstPixelType = PixelType_Gvsp_BGR8_Packed; // תΪ BGR
-    convert_params.nWidth = image_node->width;
-    convert_params.nHeight = image_node->height;
-    convert_params.nSrcDataLen = image_node->data_length;
-    convert_params.pSrcData = image_node->image_data;
-    convert_params.pDstBuffer = local_rgb_buffer;
-    convert_params.nDstBufferSize = rgb_buffer_size;
-
-    int result = MV_CC_ConvertPixelType(camera_handle, &convert_params);
-    if (MV_OK != result) {
-        printf("Failed to convert pixel type! Error: [0x%x]\n", result);
-        free(local_rgb_buffer);
-        free(image_node->image_data);
-        image_node->image_data = nullptr;
-        return;
+    // 1. µ ProcessedFrame
+    ProcessedFrame* p_frame = new ProcessedFrame();
+    p_frame->frame = out_frame; // ǳֻü
+    p_frame->frame_number = image_node->frame_number;
+    p_frame->host_timestamp_ns = image_node->host_timestamp_ns;
+    p_frame->device_timestamp = image_node->device_timestamp;
+
+    // ѹﲢɣдֻ߳ H5Dwrite_chunkѹʧʱ chunk Ϊգд̵߳ HDF5 
+    if (compress_frames) {
+        thread_local std::vector<uint8_t> shuffle_scratch;
+        if (!compressChunk(h5_write_options.compression, 1, out_frame.data, out_frame.total() * out_frame.elemSize(),
+            p_frame->chunk, shuffle_scratch)) {
+            p_frame->chunk.clear();
+        }
     }
 
-    // Create OpenCV image (wrapper, no copy)
-    cv::Mat image_wrapper(image_node->height, image_node->width, CV_8UC3, local_rgb_buffer);
+    // 2. Ż壬ɼ˳͵ HDF5 д (ѱ涪ʧĳٵֱ֡ͷ)
+    if (!reorder_buffer.insert(p_frame->frame_number, p_frame,
+        [this](ProcessedFrame*& frame) { stageRelease(frame); })) {
+        delete p_frame;
+    }
+    drainReleases();
 
-    // --- ޸ ---
+    // 3. ʾ֡ʳ֡Ԥout_frame Գлãp_frame ѱд߳ͷ
+    if (claimPreview()) publishPreview(out_frame);
+}
 
-    // --- ޸ ---
+// ԭʼģʽصĻֱΪдݣκת
+void RGB::queueRawFrame(ImageNode* image_node)
+{
+    if (image_node->data_length != (uint64_t)image_node->width * image_node->height) {
+        printf("Unexpected raw frame size %llu for %ux%u, frame %u dropped.\n",
+            (unsigned long long)image_node->data_length, image_node->width, image_node->height, image_node->frame_number);
+        delete image_node;
+        return;
+    }
 
-    // 1. µ ProcessedFrame
     ProcessedFrame* p_frame = new ProcessedFrame();
-    p_frame->frame = image_wrapper.clone(); // 
+    p_frame->frame = image_node->raw.reshape(1, (int)image_node->height); // 1 x (H*W) -> H x W
     p_frame->frame_number = image_node->frame_number;
+    p_frame->host_timestamp_ns = image_node->host_timestamp_ns;
+    p_frame->device_timestamp = image_node->device_timestamp;
+
+    // Ԥ̳߳ɣַ̲߳㣻ǰȡãӺ p_frame ʱܱͷ
+    if (thread_pool && claimPreview()) {
+        cv::Mat* mosaic = new cv::Mat(p_frame->frame);
+        thread_pool->enqueue([this, mosaic]() {
+            publishPreview(*mosaic);
+            delete mosaic;
+        });
+    }
+    delete image_node; // raw Ա p_frame->frame ã黹
+    releaseToWriter(p_frame);
+}
 
-    // 2. ͵ HDF5 д
-    hdf5_write_queue.push(p_frame);
+// Ż尴е֡ ( reorder_buffer ڵ)ֻǽ release_outboxκο
+void RGB::stageRelease(ProcessedFrame*& frame)
+{
+    std::lock_guard<std::mutex> lock(outbox_mutex);
+    release_outbox.push_back(frame);
+    frame = nullptr;
+}
 
-    // 3. (FIX) ͵ UI ʾ (޸UI)
-    {
-        std::lock_guard<std::mutex> lock(display_mutex);
-        display_stack.push(p_frame->frame); // ֡
-    }
+bool RGB::popRelease(ProcessedFrame*& frame)
+{
+    std::lock_guard<std::mutex> lock(outbox_mutex);
+    if (release_outbox.empty()) return false;
+    frame = release_outbox.front();
+    release_outbox.pop_front();
+    return true;
+}
 
-    // 4. 
-    free(local_rgb_buffer);
-    free(image_node->image_data);
-    image_node->image_data = nullptr; // ֹ ImageNode ͷ
+void RGB::clearReleases()
+{
+    std::lock_guard<std::mutex> lock(outbox_mutex);
+    for (ProcessedFrame* frame : release_outbox) delete frame;
+    release_outbox.clear();
 }
 
-// +++ ADDED: HDF5 д߳ѭ
-void RGB::hdf5WriteLoop()
+// Ż֮ã˳ release_outbox е֡д / 
+// release_mutex ֤ͬһʱֻһ߳ڰˣ̷߳е֡Ҳһߣ
+// ӻʱ߳Ŷӵȴѹ
+void RGB::drainReleases()
 {
-    printf("HDF5 writer thread started.\n");
-    while (is_saving || !hdf5_write_queue.empty())
-    {
-        ProcessedFrame* frame_to_save = nullptr;
-
-        // ʹ DataQueue -pop (дʱ wait_pop)
-        // bool got_frame = hdf5_write_queue.wait_pop(frame_to_save, 100); // 100ms ʱ
-
-        // ߣʹ try_pop ѯ
-        if (hdf5_write_queue.try_pop(frame_to_save)) {
-            if (frame_to_save) {
-                try {
-                    extendAndWriteHDF5(frame_to_save);
-                }
-                catch (H5::Exception& e) {
-                    printf("HDF5 write error: %s\n", e.getCDetailMsg());
-                }
-                delete frame_to_save;
-            }
-        }
-        else {
-            // Ϊ
-            if (!is_saving) {
-                break; // ֹͣ־λ  ѿգ˳
-            }
-            // Ϊգڱ棬Ϣһ
-            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    std::lock_guard<std::mutex> release_lock(release_mutex);
+    ProcessedFrame* frame = nullptr;
+    while (popRelease(frame)) releaseToWriter(frame);
+}
+
+// д / ڣ drainReleases ãԭʼģʽɷֱַ߳ӵá
+// ʱдϵѹΣûӵ֡ disposer ͷ (frame ÿ)
+// ֻ Reject ԻֹͣʱҪͷ
+void RGB::releaseToWriter(ProcessedFrame*& frame)
+{
+    std::unique_lock<std::mutex> spill_lock(spill_mutex, std::defer_lock);
+    if (spill_ring.isOpen()) {
+        spill_lock.lock();
+        // л֡ʱ֡ڻеľ֡д
+        // ʱ append һֱȵд̶߳߾ɼ¼ (wait_ms < 0)֡
+        // ֻе֡ʽ wait_ms ʱŻʧܣѼ SpillRing::Stats::dropped
+        if (spill_ring.shouldSpill((size_t)hdf5_write_queue.size())) {
+            spillFrame(frame);
+            delete frame;
+            frame = nullptr;
+            return;
         }
     }
-    printf("HDF5 writer thread exiting.\n");
+    if (!hdf5_write_queue.push(frame)) {
+        delete frame;
+        frame = nullptr;
+    }
 }
 
-// +++ ADDED: HDF5 ʼ
-bool RGB::initializeHDF5(const std::string& base_path)
+bool RGB::spillFrame(ProcessedFrame* frame)
 {
-    // HDF5 ׳쳣 try-catch
-    try {
-        // 1. ȡͼߴ ( initializeHDF5 »ȡȫ)
-        MVCC_INTVALUE width_info = { 0 }, height_info = { 0 };
-        nRet = MV_CC_GetIntValue(camera_handle, "Width", &width_info);
-        if (nRet != MV_OK) return false;
-        nRet = MV_CC_GetIntValue(camera_handle, "Height", &height_info);
-        if (nRet != MV_OK) return false;
-
-        uint64_t width = width_info.nCurValue;
-        uint64_t height = height_info.nCurValue;
-        unsigned int channels = 3;
-
-        // 2.  HDF5 ļ
-        std::string h5_filename = base_path + "/rgb_data.h5";
-        h5_file = std::make_unique<H5::H5File>(h5_filename, H5F_ACC_TRUNC);
+    if (!frame->frame.isContinuous()) {
+        frame->frame = frame->frame.clone();
+    }
+    FrameRecord record;
+    record.data = frame->frame.data;
+    record.data_bytes = frame->frame.total() * frame->frame.elemSize();
+    record.frame_number = frame->frame_number;
+    record.host_timestamp_ns = frame->host_timestamp_ns;
+    record.device_timestamp = frame->device_timestamp;
+    if (!frame->chunk.empty()) {
+        record.chunk = frame->chunk.data();
+        record.chunk_bytes = frame->chunk.size();
+    }
+    return spill_ring.append(record);
+}
 
-        // 3.  (Group)
-        H5::Group rgb_group = h5_file->createGroup("/rgb");
+// еļ¼ֱָӳڴ (owner Ϊ)sink  write ǰ֮ pop
+size_t RGB::restoreSpilled(size_t max_frames)
+{
+    size_t n = 0;
+    FrameRecord record;
+    while (n < max_frames && spill_ring.front(record)) {
+        if (timestamp_aligner) timestamp_aligner(record);
+        frame_sink->write(record);
+        spill_ring.pop();
+        n++;
+    }
+    return n;
+}
 
-        // 4. ͼݼ (/rgb/frames)
-        hsize_t rgb_dims[4] = { 0, (hsize_t)height, (hsize_t)width, (hsize_t)channels }; // ʼά (N, H, W, C)
-        hsize_t rgb_maxdims[4] = { H5S_UNLIMITED, (hsize_t)height, (hsize_t)width, (hsize_t)channels };
-        H5::DataSpace rgb_dataspace(4, rgb_dims, rgb_maxdims);
+void RGB::setSpill(const SpillRing::Options& options)
+{
+    spill_options = options;
+}
 
-        // -- ÷ֿ (Chunking) Աչ --
-        H5::DSetCreatPropList rgb_props;
-        hsize_t chunk_dims[4] = { 1, (hsize_t)height, (hsize_t)width, (hsize_t)channels }; // ÿд1֡
-        rgb_props.setChunk(4, chunk_dims);
-        // (ѡ: ѹ)
-        // rgb_props.setDeflate(6); 
+void RGB::setSinkThrottle(const ThrottledSink::Options& options)
+{
+    sink_throttle = options;
+}
 
-        h5_rgb_dataset = rgb_group.createDataSet("frames", H5::PredType::NATIVE_UINT8, rgb_dataspace, rgb_props);
-        h5_rgb_dims[0] = 0; // 洢ǰ֡
-        h5_rgb_dims[1] = height;
-        h5_rgb_dims[2] = width;
-        h5_rgb_dims[3] = channels;
+void RGB::setFrameLimit(uint64_t frames)
+{
+    if (is_saving) {
+        printf("Cannot change frame limit while capturing.\n");
+        return;
     }
-    catch (H5::Exception& e) {
-        printf("Failed to initialize HDF5: %s\n", e.getCDetailMsg());
-        return false;
+    frame_limit = frames;
+}
+
+void RGB::setFrameObserver(FrameObserver observer)
+{
+    if (is_saving) {
+        printf("Cannot change frame observer while capturing.\n");
+        return;
     }
-    return true;
+    frame_observer = std::move(observer);
 }
 
-// +++ ADDED: HDF5 д뵥֡
-void RGB::extendAndWriteHDF5(ProcessedFrame* frame)
+void RGB::setTimestampAligner(TimestampAligner aligner)
 {
-    // (˺ hdf5WriteLoop ߳еãҪ mutex)
-    try {
-        // дͼ 
-        h5_rgb_dims[0]++; // ֡+1
-        h5_rgb_dataset.extend(h5_rgb_dims); // չݼ
+    if (is_saving) {
+        printf("Cannot change timestamp aligner while capturing.\n");
+        return;
+    }
+    timestamp_aligner = std::move(aligner);
+}
 
-        H5::DataSpace file_space = h5_rgb_dataset.getSpace();
-        hsize_t offset[4] = { h5_rgb_dims[0] - 1, 0, 0, 0 }; // ƫ
-        hsize_t slab_dims[4] = { 1, (hsize_t)frame->frame.rows, (hsize_t)frame->frame.cols, (hsize_t)frame->frame.channels() };
-        file_space.selectHyperslab(H5S_SELECT_SET, slab_dims, offset);
+void RGB::setWriteQueue(size_t capacity, QueuePolicy policy, int block_timeout_ms)
+{
+    hdf5_write_queue.configure(capacity, policy,
+        [](ProcessedFrame*& frame) { delete frame; frame = nullptr; },
+        std::chrono::milliseconds(block_timeout_ms));
+}
 
-        H5::DataSpace mem_space(4, slab_dims, NULL);
-        h5_rgb_dataset.write(frame->frame.data, H5::PredType::NATIVE_UINT8, mem_space, file_space);
+// д߳ѭ (hdf5_write_queue -> frame_sink)
+void RGB::hdf5WriteLoop()
+{
+    printf("Writer thread started (%s sink).\n", frame_sink->name());
+    std::vector<ProcessedFrame*> batch;
+    while (!writer_should_exit || !hdf5_write_queue.empty() || spill_ring.records() > 0)
+    {
+        // һμȡһΪʱ 5 ms (֡)
+        // ڼ֡ڴ֡磬дڴٶ
+        batch.clear();
+        const bool spilled = spill_ring.records() > 0;
+        if (hdf5_write_queue.pop_n(batch, 64, std::chrono::milliseconds(spilled ? 0 : 5)) > 0) {
+            for (ProcessedFrame* frame : batch) {
+                if (frame) writeFrame(frame);
+            }
+        }
+        else if (spilled) {
+            restoreSpilled(64);
+        }
+        else {
+            // ΪգѹѾд꣬Ѳһ֡Ҳдȥʱݳʱͣڴ
+            frame_sink->flush();
+            if (writer_should_exit) {
+                break; // ȫ  ѿգ˳
+            }
+            // ֡ٳٲʱȱڣкѾ֡
+            writeExpired();
+        }
+    }
+    printf("Writer thread exiting.\n");
+}
 
+// д̣߳ʱеֱ֡дƽԼѵ hdf5_write_queue (֡ʱԼ֡)
+//  release_mutex ʱûб߳ӻдкͻи֡де֡˳򲻱䡣
+// ߳ڰʱȴ (ϵȱ߳)һοʱټ
+void RGB::writeExpired()
+{
+    std::unique_lock<std::mutex> release_lock(release_mutex, std::try_to_lock);
+    if (!release_lock.owns_lock()) return;
+    reorder_buffer.flushExpired([this](ProcessedFrame*& frame) { stageRelease(frame); });
+    ProcessedFrame* frame = nullptr;
+    if (!popRelease(frame)) return;
+
+    std::vector<ProcessedFrame*> batch;
+    while (hdf5_write_queue.pop_n(batch, 64) > 0) {
+        for (ProcessedFrame* queued : batch) {
+            if (queued) writeFrame(queued);
+        }
+        batch.clear();
     }
-    catch (H5::Exception& e) {
-        printf("HDF5 extend/write error: %s\n", e.getCDetailMsg());
-        // (Ҫһ־)
+    while (restoreSpilled(64) > 0) {
     }
+    do {
+        writeFrame(frame);
+    } while (popRelease(frame));
 }
 
-// +++ ADDED: HDF5 ر
-void RGB::closeHDF5()
+// ֡Ȩ record.ownerֱд sink ݴ漴ͷţ
+// ֶ sink һֱеĿĿ¼д߳д֮꣬֡Ź黹
+void RGB::writeFrame(ProcessedFrame* frame)
 {
-    std::lock_guard<std::mutex> lock(h5_mutex); //  HDF5 
-    try {
-        // ǷЧȻر
-        if (h5_rgb_dataset.getId() >= 0) {
-            h5_rgb_dataset.close();
-            h5_rgb_dataset = H5::DataSet(); // 
-        }
-        if (h5_file) {
-            h5_file->close();
-            h5_file.reset(); // ͷ unique_ptr
-        }
+    if (!frame->frame.isContinuous()) {
+        frame->frame = frame->frame.clone();
+    }
+    std::shared_ptr<ProcessedFrame> owner(frame);
+    FrameRecord record;
+    record.data = owner->frame.data;
+    record.data_bytes = owner->frame.total() * owner->frame.elemSize();
+    record.frame_number = frame->frame_number;
+    record.host_timestamp_ns = frame->host_timestamp_ns;
+    record.device_timestamp = frame->device_timestamp;
+    // ڹ߳ѹõĿֱд
+    if (!frame->chunk.empty()) {
+        record.chunk = frame->chunk.data();
+        record.chunk_bytes = frame->chunk.size();
+    }
+    record.owner = owner;
+    if (timestamp_aligner) timestamp_aligner(record);
+    frame_sink->write(record);
+}
+
+// ȡǰֱʺظʽ򿪴洢
+bool RGB::openSink(const std::string& base_path)
+{
+    // 1. ȡͼߴظʽ (ÿβɼǰ»ȡȫ)
+    if (!frame_source->format(source_format)) return false;
+    raw_pixel_format = source_format.pixel_format;
+
+    // ԭʼֻ֧ 8 λͨʽ򱾴˻ BGR
+    write_raw = (record_format == RecordFormat::RawBayer);
+    if (write_raw && !isRawMosaic8(raw_pixel_format)) {
+        printf("Pixel format %s cannot be stored raw, recording BGR instead.\n", raw_pixel_format.c_str());
+        write_raw = false;
+    }
+
+    FrameFormat format;
+    format.width = source_format.width;
+    format.height = source_format.height;
+    format.channels = write_raw ? 1 : 3;
+    format.pixel_format = write_raw ? raw_pixel_format : std::string("BGR8");
+    format.mvs_pixel_type = write_raw ? source_format.pixel_type : 0;
+
+    // 2.  sink ļ
+    // ֶ¼ʱÿһζ make_sink ½һ (ڸĿĿ¼д߳еã԰ֵ)
+    SinkType type = sink_type;
+    H5FrameWriter::Options h5_options = h5_write_options;
+    FrameLogSink::Options log_options = frame_log_options;
+    auto make_sink = [type, h5_options, log_options]() -> std::unique_ptr<FrameSink> {
+        if (type == SinkType::FrameLog) return std::make_unique<FrameLogSink>(log_options);
+        return std::make_unique<H5FrameSink>(h5_options);
+    };
+    std::lock_guard<std::mutex> lock(sink_mutex);
+    if (segment_policy.enabled()) {
+        frame_sink = std::make_unique<SegmentedSink>("rgb", make_sink, segment_policy);
+    }
+    else {
+        frame_sink = make_sink();
     }
-    catch (H5::Exception& e) {
-        printf("Error closing HDF5 file: %s\n", e.getCDetailMsg());
+    if (sink_throttle.enabled()) {
+        frame_sink = std::make_unique<ThrottledSink>(std::move(frame_sink), sink_throttle);
+    }
+    if (!frame_sink->open(base_path, format)) {
+        frame_sink.reset();
+        return false;
+    }
+    // 򲻿Ӱ¼ƣֻʧȥ㱣
+    if (!spill_options.directory.empty() && !spill_ring.open(spill_options)) {
+        printf("Spill ring disabled for this capture.\n");
+    }
+    compress_frames = frame_sink->acceptsCompressedChunks();
+    sink_stats = FrameSinkStats();
+    return true;
+}
+
+// дʣݴ֡رļ
+void RGB::closeSink()
+{
+    std::lock_guard<std::mutex> lock(sink_mutex);
+    if (!frame_sink) return;
+    if (!frame_sink->close()) {
+        printf("Error closing %s sink.\n", frame_sink->name());
+    }
+    sink_stats = frame_sink->stats();
+    frame_sink.reset();
+
+    if (spill_ring.isOpen()) {
+        const SpillRing::Stats spill = spill_ring.stats();
+        printf("Spill ring: spilled %llu, restored %llu, dropped %llu frames, peak %llu MB, producer waited %.1f ms.\n",
+            (unsigned long long)spill.spilled, (unsigned long long)spill.restored, (unsigned long long)spill.dropped,
+            (unsigned long long)(spill.peak_bytes >> 20), spill.wait_ns / 1e6);
+        spill_ring.close();
     }
 }
\ No newline at end of file
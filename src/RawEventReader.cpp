@@ -0,0 +1,446 @@
+#include "RawEventReader.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <thread>
+
+#if defined(_WIN32)
+#define fseek64 _fseeki64
+#define ftell64 _ftelli64
+#else
+#define fseek64 fseeko
+#define ftell64 ftello
+#endif
+
+namespace {
+    constexpr uint32_t kSidecarMagic = 0x58524344;  // "DCRX"
+    constexpr uint32_t kSidecarVersion = 1;
+
+    // ʱλ£bits λԭʼֵ shift λõ΢롣
+    // ֵȾֵСʱΪ ( SDK ͬطʱλ΢)
+    inline void setTimeHigh(RawEventReader::DecoderState& s, uint32_t raw, int bits, int shift)
+    {
+        const int64_t period = (int64_t)1 << (bits + shift);
+        const uint32_t mask = (1u << bits) - 1;
+        const uint32_t old = (uint32_t)(s.time_high >> shift) & mask;
+        if (s.started && raw < old && old - raw > mask / 2) s.time_high += period;
+        s.time_high = (s.time_high & ~(period - 1)) | ((int64_t)raw << shift);
+        s.started = 1;
+    }
+
+    // EVT 2.032 λ֣ 4 λΪ
+    //   0x0 / 0x1 CD_OFF / CD_ON: [27:22] ʱ 6 λ, [21:11] x, [10:0] y
+    //   0x8 EV_TIME_HIGH: [27:0] ʱ 28 λ
+    template <typename Emit>
+    void decodeEvt2(const uint8_t* data, size_t size, RawEventReader::DecoderState& s, Emit&& emit)
+    {
+        for (size_t i = 0; i + 4 <= size; i += 4) {
+            uint32_t w;
+            memcpy(&w, data + i, 4);
+            const uint32_t type = w >> 28;
+            if (type <= 0x1) {
+                if (s.started) emit((uint16_t)((w >> 11) & 0x7FF), (uint16_t)(w & 0x7FF), (int16_t)type,
+                    s.time_high | (int64_t)((w >> 22) & 0x3F));
+            }
+            else if (type == 0x8) {
+                setTimeHigh(s, w & 0x0FFFFFFF, 28, 6);
+            }
+        }
+    }
+
+    // EVT 3.016 λ֣ 4 λΪͣ״̬
+    //   0x0 EVT_ADDR_Y: [10:0] y        0x2 EVT_ADDR_X: [11] , [10:0] x (¼)
+    //   0x3 VECT_BASE_X: [11] , [10:0] ʼ
+    //   0x4 VECT_12 / 0x5 VECT_8: ʼпʼ 12 / 8 λ룬֮ʼǰ 12 / 8
+    //   0x6 EVT_TIME_LOW: [11:0]        0x8 EVT_TIME_HIGH: [11:0] (24 λʱĸ 12 λ)
+    template <typename Emit>
+    void decodeEvt3(const uint8_t* data, size_t size, RawEventReader::DecoderState& s, Emit&& emit)
+    {
+        for (size_t i = 0; i + 2 <= size; i += 2) {
+            uint16_t w;
+            memcpy(&w, data + i, 2);
+            switch (w >> 12) {
+            case 0x0:
+                s.y = w & 0x7FF;
+                break;
+            case 0x2:
+                if (s.started) emit((uint16_t)(w & 0x7FF), s.y, (int16_t)((w >> 11) & 1), s.time_high + s.time_low);
+                break;
+            case 0x3:
+                s.base_x = w & 0x7FF;
+                s.polarity = (uint8_t)((w >> 11) & 1);
+                break;
+            case 0x4:
+            case 0x5: {
+                const int n = (w >> 12) == 0x4 ? 12 : 8;
+                if (s.started) {
+                    const int64_t t = s.time_high + s.time_low;
+                    for (uint32_t m = w & ((1u << n) - 1); m; m &= m - 1) {
+                        int bit = 0;
+                        while (!((m >> bit) & 1)) bit++;
+                        emit((uint16_t)(s.base_x + bit), s.y, (int16_t)s.polarity, t);
+                    }
+                }
+                s.base_x = (uint16_t)(s.base_x + n);
+                break;
+            }
+            case 0x6:
+                s.time_low = w & 0xFFF;
+                break;
+            case 0x8:
+                setTimeHigh(s, w & 0xFFF, 12, 12);
+                break;
+            default:
+                break;  // ⲿ / OTHERS / CONTINUED
+            }
+        }
+    }
+
+    template <typename Emit>
+    void decodeRaw(RawEventReader::Format format, const uint8_t* data, size_t size,
+        RawEventReader::DecoderState& s, Emit&& emit)
+    {
+        if (format == RawEventReader::Format::Evt2) decodeEvt2(data, size, s, emit);
+        else decodeEvt3(data, size, s, emit);
+    }
+
+    template <typename T>
+    void put(std::vector<uint8_t>& out, T v)
+    {
+        const size_t at = out.size();
+        out.resize(at + sizeof(T));
+        memcpy(out.data() + at, &v, sizeof(T));
+    }
+
+    template <typename T>
+    bool get(const uint8_t*& p, const uint8_t* end, T& v)
+    {
+        if ((size_t)(end - p) < sizeof(T)) return false;
+        memcpy(&v, p, sizeof(T));
+        p += sizeof(T);
+        return true;
+    }
+}
+
+const char* RawEventReader::formatName(Format format)
+{
+    switch (format) {
+    case Format::Evt2: return "EVT2";
+    case Format::Evt3: return "EVT3";
+    default: return "unknown";
+    }
+}
+
+bool RawEventReader::open(const std::string& path)
+{
+    close();
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        printf("Failed to open %s.\n", path.c_str());
+        return false;
+    }
+    std::error_code ec;
+    file_size = std::filesystem::file_size(path, ec);
+    path_ = path;
+    if (ec || !parseHeader(file)) {
+        std::fclose(file);
+        close();
+        return false;
+    }
+    options.block_bytes = std::max<size_t>(options.block_bytes / 4 * 4, 4096);
+
+    const std::string sidecar = path + ".idx";
+    index_loaded = options.use_sidecar && loadSidecar(sidecar);
+    if (!index_loaded) {
+        if (!buildIndex(file)) {
+            std::fclose(file);
+            close();
+            return false;
+        }
+        if (options.use_sidecar) saveSidecar(sidecar);
+    }
+    std::fclose(file);
+    finishIndex();
+    printf("%s: %s %dx%d, %llu events, %zu blocks%s\n", path.c_str(), formatName(format_), width_, height_,
+        (unsigned long long)event_count, blocks.size(), index_loaded ? " (index from sidecar)" : "");
+    return true;
+}
+
+void RawEventReader::close()
+{
+    format_ = Format::Unknown;
+    width_ = height_ = 0;
+    data_offset = 0;
+    event_count = 0;
+    index_loaded = false;
+    blocks.clear();
+    prefix_max.clear();
+    suffix_min.clear();
+}
+
+// ļͷΪ '%' ͷıУ "% end"  (ļûУԵһ '%' ֽΪ׼)
+//   % evt 3.0 / % format EVT3;height=720;width=1280 / % geometry 1280x720
+bool RawEventReader::parseHeader(std::FILE* file)
+{
+    char line[1024];
+    while (true) {
+        const int c = std::fgetc(file);
+        if (c == EOF) break;
+        if (c != '%') {
+            std::ungetc(c, file);
+            break;
+        }
+        if (!std::fgets(line, sizeof(line), file)) break;
+        const std::string text(line);
+        int w = 0, h = 0;
+        if (text.find(" format ") == 0) {
+            if (text.find("EVT3") != std::string::npos) format_ = Format::Evt3;
+            else if (text.find("EVT21") != std::string::npos) format_ = Format::Unknown;
+            else if (text.find("EVT2") != std::string::npos) format_ = Format::Evt2;
+            const size_t pw = text.find("width="), ph = text.find("height=");
+            if (pw != std::string::npos) width_ = std::atoi(text.c_str() + pw + 6);
+            if (ph != std::string::npos) height_ = std::atoi(text.c_str() + ph + 7);
+            if (format_ == Format::Unknown) break;
+        }
+        else if (text.find(" evt ") == 0 && format_ == Format::Unknown) {
+            if (text.find("3.0") != std::string::npos) format_ = Format::Evt3;
+            else if (text.find("2.0") != std::string::npos) format_ = Format::Evt2;
+        }
+        else if (std::sscanf(text.c_str(), " geometry %dx%d", &w, &h) == 2) {
+            width_ = w;
+            height_ = h;
+        }
+        else if (text.find(" end") == 0) {
+            break;
+        }
+    }
+    data_offset = (uint64_t)ftell64(file);
+    if (format_ == Format::Unknown) {
+        printf("%s: unsupported or missing event format (EVT 2.0 / 3.0 expected).\n", path_.c_str());
+        return false;
+    }
+    if (width_ <= 0 || height_ <= 0) {
+        // ļͷûгߴʱ EVT3 / EVT2 ĳ
+        width_ = format_ == Format::Evt3 ? 1280 : 640;
+        height_ = format_ == Format::Evt3 ? 720 : 480;
+    }
+    return true;
+}
+
+bool RawEventReader::buildIndex(std::FILE* file)
+{
+    if (fseek64(file, (int64_t)data_offset, SEEK_SET) != 0) return false;
+    std::vector<uint8_t> buffer(options.block_bytes);
+    DecoderState state;
+    uint64_t offset = 0;
+    while (true) {
+        const size_t bytes = std::fread(buffer.data(), 1, buffer.size(), file);
+        if (bytes == 0) break;
+        Block block;
+        block.offset = offset;
+        block.bytes = bytes;
+        block.first_event = event_count;
+        block.state = state;
+        decodeRaw(format_, buffer.data(), bytes, state, [&block](uint16_t, uint16_t, int16_t, int64_t t) {
+            block.events++;
+            block.t_min = std::min(block.t_min, t);
+            block.t_max = std::max(block.t_max, t);
+        });
+        event_count += block.events;
+        blocks.push_back(block);
+        offset += bytes;
+        if (bytes < buffer.size()) break;
+    }
+    if (std::ferror(file)) {
+        printf("%s: read error while indexing.\n", path_.c_str());
+        return false;
+    }
+    return true;
+}
+
+void RawEventReader::finishIndex()
+{
+    prefix_max.resize(blocks.size());
+    suffix_min.resize(blocks.size());
+    int64_t hi = INT64_MIN;
+    for (size_t i = 0; i < blocks.size(); ++i) prefix_max[i] = hi = std::max(hi, blocks[i].t_max);
+    int64_t lo = INT64_MAX;
+    for (size_t i = blocks.size(); i-- > 0;) suffix_min[i] = lo = std::min(lo, blocks[i].t_min);
+}
+
+bool RawEventReader::loadSidecar(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    std::vector<uint8_t> data;
+    uint8_t chunk[65536];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + n);
+    std::fclose(file);
+
+    const uint8_t* p = data.data();
+    const uint8_t* end = p + data.size();
+    uint32_t magic = 0, version = 0, format = 0;
+    uint64_t size = 0, offset = 0, block_bytes = 0, count = 0, events = 0;
+    int32_t w = 0, h = 0;
+    if (!get(p, end, magic) || !get(p, end, version) || !get(p, end, size) || !get(p, end, offset) ||
+        !get(p, end, block_bytes) || !get(p, end, format) || !get(p, end, w) || !get(p, end, h) ||
+        !get(p, end, events) || !get(p, end, count)) return false;
+    // ¼ļд˿Сʱɨ
+    if (magic != kSidecarMagic || version != kSidecarVersion || size != file_size || offset != data_offset ||
+        block_bytes != options.block_bytes || format != (uint32_t)format_) return false;
+
+    std::vector<Block> loaded(count);
+    uint64_t total = 0;
+    for (Block& b : loaded) {
+        if (!get(p, end, b.offset) || !get(p, end, b.bytes) || !get(p, end, b.first_event) || !get(p, end, b.events) ||
+            !get(p, end, b.t_min) || !get(p, end, b.t_max) || !get(p, end, b.state.time_high) ||
+            !get(p, end, b.state.time_low) || !get(p, end, b.state.y) || !get(p, end, b.state.base_x) ||
+            !get(p, end, b.state.polarity) || !get(p, end, b.state.started)) return false;
+        if (b.first_event != total || b.offset + b.bytes > file_size - data_offset) return false;
+        total += b.events;
+    }
+    if (p != end || total != events) return false;
+    blocks = std::move(loaded);
+    event_count = events;
+    width_ = w;
+    height_ = h;
+    return true;
+}
+
+void RawEventReader::saveSidecar(const std::string& path) const
+{
+    std::vector<uint8_t> data;
+    put(data, kSidecarMagic);
+    put(data, kSidecarVersion);
+    put(data, file_size);
+    put(data, data_offset);
+    put(data, (uint64_t)options.block_bytes);
+    put(data, (uint32_t)format_);
+    put(data, (int32_t)width_);
+    put(data, (int32_t)height_);
+    put(data, event_count);
+    put(data, (uint64_t)blocks.size());
+    for (const Block& b : blocks) {
+        put(data, b.offset);
+        put(data, b.bytes);
+        put(data, b.first_event);
+        put(data, b.events);
+        put(data, b.t_min);
+        put(data, b.t_max);
+        put(data, b.state.time_high);
+        put(data, b.state.time_low);
+        put(data, b.state.y);
+        put(data, b.state.base_x);
+        put(data, b.state.polarity);
+        put(data, b.state.started);
+    }
+    // дʱļٸ;ʧܲ°
+    const std::string tmp = path + ".tmp";
+    std::FILE* file = std::fopen(tmp.c_str(), "wb");
+    bool ok = file && std::fwrite(data.data(), 1, data.size(), file) == data.size();
+    if (file) ok = (std::fclose(file) == 0) && ok;
+    std::error_code ec;
+    if (ok) std::filesystem::rename(tmp, path, ec);
+    if (!ok || ec) {
+        std::filesystem::remove(tmp, ec);
+        printf("Could not write event index %s; keeping it in memory only.\n", path.c_str());
+    }
+}
+
+int RawEventReader::threadCount(size_t count) const
+{
+    const int hw = (int)std::max(1u, std::thread::hardware_concurrency());
+    const int threads = options.threads > 0 ? options.threads : hw;
+    return (int)std::max<size_t>(1, std::min<size_t>((size_t)threads, count));
+}
+
+bool RawEventReader::decodeBlock(std::FILE* file, const Block& block, std::vector<uint8_t>& buffer,
+    Metavision::EventCD* out) const
+{
+    buffer.resize((size_t)block.bytes);
+    if (fseek64(file, (int64_t)(data_offset + block.offset), SEEK_SET) != 0 ||
+        std::fread(buffer.data(), 1, buffer.size(), file) != buffer.size()) return false;
+    DecoderState state = block.state;
+    uint64_t n = 0;
+    const uint64_t limit = block.events;
+    decodeRaw(format_, buffer.data(), buffer.size(), state, [&](uint16_t x, uint16_t y, int16_t p, int64_t t) {
+        if (n < limit) out[n] = Metavision::EventCD(x, y, p, t);
+        n++;
+    });
+    return n == limit;
+}
+
+bool RawEventReader::decodeBlocks(size_t first, size_t last, Metavision::EventCD* out) const
+{
+    const uint64_t base = blocks[first].first_event;
+    std::atomic<size_t> next{ first };
+    std::atomic<bool> ok{ true };
+    auto worker = [&]() {
+        std::FILE* file = std::fopen(path_.c_str(), "rb");
+        if (!file) {
+            ok = false;
+            return;
+        }
+        std::vector<uint8_t> buffer;
+        // 鰴˳ȡ̼߳Ȼؾ
+        for (size_t i = next++; i <= last && ok; i = next++) {
+            if (!decodeBlock(file, blocks[i], buffer, out + (blocks[i].first_event - base))) ok = false;
+        }
+        std::fclose(file);
+    };
+    const int threads = threadCount(last - first + 1);
+    std::vector<std::thread> workers;
+    for (int k = 1; k < threads; ++k) workers.emplace_back(worker);
+    worker();
+    for (std::thread& w : workers) w.join();
+    if (!ok) printf("%s: failed to decode events (file changed since indexing?).\n", path_.c_str());
+    return ok;
+}
+
+bool RawEventReader::readAll(std::vector<Metavision::EventCD>& out) const
+{
+    out.clear();
+    if (!isOpen()) return false;
+    if (event_count == 0) return true;
+    out.resize((size_t)event_count);
+    return decodeBlocks(0, blocks.size() - 1, out.data());
+}
+
+bool RawEventReader::readBlock(size_t block, std::vector<Metavision::EventCD>& out) const
+{
+    if (!isOpen() || block >= blocks.size()) return false;
+    std::FILE* file = std::fopen(path_.c_str(), "rb");
+    if (!file) return false;
+    const size_t at = out.size();
+    out.resize(at + (size_t)blocks[block].events);
+    std::vector<uint8_t> buffer;
+    const bool ok = decodeBlock(file, blocks[block], buffer, out.data() + at);
+    std::fclose(file);
+    if (!ok) out.resize(at);
+    return ok;
+}
+
+bool RawEventReader::eventsBetween(int64_t t0, int64_t t1, std::vector<Metavision::EventCD>& out) const
+{
+    out.clear();
+    if (!isOpen()) return false;
+    if (t1 <= t0 || event_count == 0) return true;
+    // һ max t >= t0 Ŀ飬һ min t < t1 Ŀ
+    const size_t first = (size_t)(std::lower_bound(prefix_max.begin(), prefix_max.end(), t0) - prefix_max.begin());
+    const size_t end = (size_t)(std::lower_bound(suffix_min.begin(), suffix_min.end(), t1) - suffix_min.begin());
+    if (first >= end) return true;
+    const size_t last = end - 1;
+    out.resize((size_t)(blocks[last].first_event + blocks[last].events - blocks[first].first_event));
+    if (out.empty()) return true;
+    if (!decodeBlocks(first, last, out.data())) {
+        out.clear();
+        return false;
+    }
+    // β (Լʱ΢Ŀ) зΧ¼
+    out.erase(std::remove_if(out.begin(), out.end(),
+        [t0, t1](const Metavision::EventCD& e) { return e.t < t0 || e.t >= t1; }), out.end());
+    return true;
+}
@@ -0,0 +1,170 @@
+#include "Recorder.h"
+#include "JsonEscape.h"
+#include "SteadyClock.h"
+#include <filesystem>
+#include "SyntheticEventSource.h"
+#include "SyntheticFrameSource.h"
+
+Recorder::Recorder(const Options& recorder_options) : options(recorder_options)
+{
+    if (options.synthetic) {
+        SyntheticFrameSource::Options frames;
+        frames.width = options.synthetic_width;
+        frames.height = options.synthetic_height;
+        frames.fps = options.synthetic_fps;
+        rgb = std::make_unique<RGB>(std::make_unique<SyntheticFrameSource>(frames));
+
+        SyntheticEventSource::Options events;
+        events.rate_mev_s = options.synthetic_event_rate;
+        events.distribution = SyntheticEventSource::Distribution::MovingEdge;
+        events.trigger_hz = options.synthetic_fps;
+        dvs = std::make_unique<DVS>(std::make_unique<SyntheticEventSource>(events));
+    }
+    else {
+        dvs = std::make_unique<DVS>();
+        rgb = std::make_unique<RGB>();
+    }
+    if (options.trigger) uno = std::make_unique<UNO>(options.trigger_options);
+
+    options.pipeline.apply(*rgb);
+    options.pipeline.apply(*dvs);
+    // ʾ֡Ԥû˿ʡµ¼Դ̺߳͹̵߳ʱ
+    dvs->setDisplay(0, 0);
+    rgb->setPreview(0, 0, 0);
+
+    dvs->setRecordFormat(options.dvs_format);
+    dvs->setSegmentation(options.segments);
+    rgb->setRecordFormat(options.rgb_format);
+    rgb->setSink(options.rgb_sink);
+    rgb->setSegmentation(options.segments);
+    rgb->setFrameLimit(options.max_frames);
+    DVS* events = dvs.get();
+    rgb->setFrameObserver([events](uint64_t frame_number, uint64_t host_timestamp_ns, uint64_t device_timestamp) {
+        events->onRgbFrame(frame_number, host_timestamp_ns, device_timestamp);
+    });
+    rgb->setTimestampAligner([events](FrameRecord& record) { events->alignRgbFrame(record); });
+}
+
+Recorder::~Recorder()
+{
+    if (running) stop();
+}
+
+bool Recorder::start()
+{
+    if (running) return false;
+    if (options.dataset.empty()) {
+        printf("Recorder: dataset name is empty.\n");
+        return false;
+    }
+    if (!dvs->eventSource() || !dvs->eventSource()->isOpen() || !rgb->frameSource() || !rgb->frameSource()->isOpen()) {
+        printf("Recorder: %s not available.\n", dvs->eventSource() && dvs->eventSource()->isOpen() ? "RGB camera" : "DVS camera");
+        return false;
+    }
+    if (uno && !uno->isOpen()) {
+        printf("Recorder: trigger controller %s not available.\n", options.trigger_options.port.c_str());
+        return false;
+    }
+
+    namespace fs = std::filesystem;
+    const std::string rgb_folder = options.rgb_root + "/" + options.dataset;
+    std::error_code ec;
+    fs::create_directories(rgb_folder, ec);
+    fs::create_directories(options.dvs_root + "/" + options.dataset, ec);
+    if (ec) {
+        printf("Recorder: failed to create output directories: %s\n", ec.message().c_str());
+        return false;
+    }
+
+    //  GUI::start ̨ͬڵȴ֮
+    summary_ = Summary();
+    summary_.dataset = options.dataset;
+    start_ns = steadyNowNs();
+    dvs->start(options.dataset, options.dvs_root);
+    if (!rgb->startCapture(rgb_folder)) {
+        dvs->stopRecord();
+        return false;
+    }
+    if (uno) uno->start();
+    running = true;
+    return true;
+}
+
+void Recorder::stop()
+{
+    if (!running) return;
+    running = false;
+    //  GUI::stoprecord ̨ͬͣһ֡ͬһ
+    if (uno) uno->stop();
+    dvs->stopRecord();
+    rgb->stopCapture();
+    summary_.seconds = (steadyNowNs() - start_ns) / 1e9;
+
+    const FrameSinkStats sink = rgb->getSinkStats();
+    const QueueStats queue = rgb->getWriteQueueStats();
+    summary_.rgb_received = rgb->getReceivedFrameCount();
+    summary_.rgb_frames = sink.frames;
+    summary_.rgb_dropped = rgb->getDroppedFrameCount() + queue.dropped_oldest + queue.dropped_newest + queue.rejected +
+        rgb->getSpillStats().dropped;
+    summary_.rgb_bytes = sink.bytes;
+    summary_.rgb_stored_bytes = sink.stored_bytes;
+    summary_.rgb_errors = sink.errors;
+    const FramePool::Stats raw_pool = rgb->getRawPoolStats();
+    const FramePool::Stats bgr_pool = rgb->getBgrPoolStats();
+    const ReorderStats reorder = rgb->getReorderStats();
+    summary_.raw_pool_peak = raw_pool.high_water;
+    summary_.bgr_pool_peak = bgr_pool.high_water;
+    summary_.pool_fallbacks = raw_pool.exhausted + raw_pool.oversize + bgr_pool.exhausted + bgr_pool.oversize;
+    summary_.write_queue_peak = queue.high_water;
+    summary_.reorder_peak = reorder.max_depth;
+    summary_.reorder_gaps = reorder.gaps;
+
+    if (dvs->eventAccumulator()) summary_.dvs_events = dvs->eventAccumulator()->stats().events;
+    const H5EventWriter::Stats event_writer = dvs->getEventWriterStats();
+    summary_.dvs_dropped = event_writer.dropped_events;
+    summary_.dvs_queue_peak = event_writer.queue.high_water;
+    summary_.dvs_bytes = dvs->recordedBytes();  // rgb_root  dvs_root ͬʱĿ¼ﻹ RGB ļܰĿ¼ͳ
+
+    if (uno) {
+        const UNO::Stats trigger = uno->stats();
+        summary_.trigger_acked = trigger.acked;
+        summary_.trigger_latency_ms = trigger.pulse_seen ? trigger.latency_us / 1e3 : -1;
+        summary_.trigger_pulses = trigger.pulses;
+    }
+    const ClockSync::Stats clock = dvs->getClockSyncStats();
+    summary_.clock_pairs = clock.pairs;
+    summary_.clock_residual_us = clock.device_ready ? clock.device_residual_us : -1;
+}
+
+double Recorder::elapsedSeconds() const
+{
+    return running ? (steadyNowNs() - start_ns) / 1e9 : summary_.seconds;
+}
+
+bool Recorder::Summary::writeJson(FILE* out) const
+{
+    const int n = fprintf(out,
+        "{\n"
+        "  \"dataset\": \"%s\",\n"
+        "  \"ok\": %s,\n"
+        "  \"seconds\": %.3f,\n"
+        "  \"rgb\": { \"received\": %llu, \"frames\": %llu, \"dropped\": %llu, \"errors\": %llu,"
+        " \"mb\": %.3f, \"stored_mb\": %.3f, \"mb_per_s\": %.3f, \"fps\": %.3f },\n"
+        "  \"dvs\": { \"events\": %llu, \"dropped\": %llu, \"mb\": %.3f },\n"
+        "  \"trigger\": { \"acked\": %s, \"latency_ms\": %.3f, \"pulses\": %u },\n"
+        "  \"clock\": { \"pairs\": %llu, \"residual_us\": %.3f },\n"
+        "  \"peaks\": { \"raw_pool\": %zu, \"bgr_pool\": %zu, \"pool_fallbacks\": %llu, \"write_queue\": %zu,"
+        " \"reorder\": %zu, \"reorder_gaps\": %llu, \"dvs_queue\": %zu }\n"
+        "}\n",
+        escapeJson(dataset).c_str(), ok() ? "true" : "false", seconds,
+        (unsigned long long)rgb_received, (unsigned long long)rgb_frames, (unsigned long long)rgb_dropped,
+        (unsigned long long)rgb_errors, rgb_bytes / 1e6, rgb_stored_bytes / 1e6, rgbMegabytesPerSecond(),
+        seconds > 0 ? rgb_frames / seconds : 0.0,
+        (unsigned long long)dvs_events, (unsigned long long)dvs_dropped, dvs_bytes / 1e6,
+        trigger_acked ? "true" : "false", trigger_latency_ms, trigger_pulses,
+        (unsigned long long)clock_pairs, clock_residual_us,
+        raw_pool_peak, bgr_pool_peak, (unsigned long long)pool_fallbacks, write_queue_peak,
+        reorder_peak, (unsigned long long)reorder_gaps, dvs_queue_peak);
+    fflush(out);
+    return n > 0;
+}
@@ -0,0 +1,184 @@
+#include "SegmentManifest.h"
+#include "JsonEscape.h"
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    // д벢ˢ̣֮ǰʱļݱѾ̣һյ嵥
+    bool writeDurably(const std::string& path, const std::string& text)
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) return false;
+        bool ok = fwrite(text.data(), 1, text.size(), file) == text.size() && fflush(file) == 0;
+#if defined(_WIN32)
+        ok = ok && _commit(_fileno(file)) == 0;
+#else
+        ok = ok && fsync(fileno(file)) == 0;
+#endif
+        return fclose(file) == 0 && ok;
+    }
+
+    // Ŀ¼Ŀ¼ҲҪˢһ (Windows  MoveFileEx ûжӦĲ)
+    void syncDirectory(const fs::path& directory)
+    {
+#if !defined(_WIN32)
+        const int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            fsync(fd);
+            ::close(fd);
+        }
+#endif
+    }
+
+    // 嵥ǱģԼдģȡʱֻҪֵͨõ JSON 
+    bool findValue(const std::string& text, size_t begin, size_t end, const char* key, size_t& value_pos)
+    {
+        const std::string quoted = std::string("\"") + key + "\"";
+        size_t pos = text.find(quoted, begin);
+        if (pos == std::string::npos || pos >= end) return false;
+        pos = text.find(':', pos + quoted.size());
+        if (pos == std::string::npos || pos >= end) return false;
+        pos = text.find_first_not_of(" \t\r\n", pos + 1);
+        if (pos == std::string::npos || pos >= end) return false;
+        value_pos = pos;
+        return true;
+    }
+
+    uint64_t readNumber(const std::string& text, size_t begin, size_t end, const char* key)
+    {
+        size_t pos;
+        if (!findValue(text, begin, end, key, pos)) return 0;
+        return std::strtoull(text.c_str() + pos, nullptr, 10);
+    }
+
+    bool readBool(const std::string& text, size_t begin, size_t end, const char* key)
+    {
+        size_t pos;
+        return findValue(text, begin, end, key, pos) && text.compare(pos, 4, "true") == 0;
+    }
+
+    std::string readString(const std::string& text, size_t begin, size_t end, const char* key)
+    {
+        size_t pos;
+        if (!findValue(text, begin, end, key, pos) || text[pos] != '"') return std::string();
+        std::string out;
+        for (size_t i = pos + 1; i < end && text[i] != '"'; ++i) {
+            if (text[i] == '\\' && i + 1 < end) ++i;
+            out += text[i];
+        }
+        return out;
+    }
+}
+
+std::string segmentFileName(const std::string& base_name, uint32_t index)
+{
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "_%05u", index);
+    const size_t dot = base_name.rfind('.');
+    if (dot == std::string::npos) return base_name + suffix;
+    return base_name.substr(0, dot) + suffix + base_name.substr(dot);
+}
+
+bool writeSegmentManifest(const std::string& path, const SegmentManifest& manifest)
+{
+    std::ostringstream out;
+    out << "{\n";
+    out << "  \"version\": 1,\n";
+    out << "  \"stream\": \"" << escapeJson(manifest.stream) << "\",\n";
+    out << "  \"file_name\": \"" << escapeJson(manifest.file_name) << "\",\n";
+    out << "  \"width\": " << manifest.format.width << ",\n";
+    out << "  \"height\": " << manifest.format.height << ",\n";
+    out << "  \"channels\": " << manifest.format.channels << ",\n";
+    out << "  \"pixel_format\": \"" << escapeJson(manifest.format.pixel_format) << "\",\n";
+    out << "  \"mvs_pixel_type\": " << manifest.format.mvs_pixel_type << ",\n";
+    out << "  \"complete\": " << (manifest.complete ? "true" : "false") << ",\n";
+    out << "  \"segments\": [";
+    for (size_t i = 0; i < manifest.segments.size(); ++i) {
+        const SegmentInfo& s = manifest.segments[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    { \"index\": " << s.index
+            << ", \"path\": \"" << escapeJson(s.path) << "\""
+            << ", \"first_frame\": " << s.first_frame
+            << ", \"frames\": " << s.frames
+            << ", \"bytes\": " << s.bytes
+            << ", \"first_host_timestamp_ns\": " << s.first_host_timestamp_ns
+            << ", \"last_host_timestamp_ns\": " << s.last_host_timestamp_ns
+            << ", \"closed\": " << (s.closed ? "true" : "false") << " }";
+    }
+    out << "\n  ]\n}\n";
+
+    const std::string temp_path = path + ".tmp";
+    if (!writeDurably(temp_path, out.str())) {
+        printf("Failed to write manifest %s\n", temp_path.c_str());
+        return false;
+    }
+    std::error_code ec;
+    fs::rename(temp_path, path, ec);
+    if (ec) {
+        printf("Failed to replace manifest %s: %s\n", path.c_str(), ec.message().c_str());
+        return false;
+    }
+    syncDirectory(fs::path(path).parent_path());
+    return true;
+}
+
+bool readSegmentManifest(const std::string& path, SegmentManifest& manifest)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        printf("Failed to open manifest %s\n", path.c_str());
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+
+    const size_t array_pos = text.find("\"segments\"");
+    if (array_pos == std::string::npos) {
+        printf("%s is not a segment manifest.\n", path.c_str());
+        return false;
+    }
+    manifest = SegmentManifest();
+    manifest.stream = readString(text, 0, array_pos, "stream");
+    manifest.file_name = readString(text, 0, array_pos, "file_name");
+    manifest.format.width = (uint32_t)readNumber(text, 0, array_pos, "width");
+    manifest.format.height = (uint32_t)readNumber(text, 0, array_pos, "height");
+    manifest.format.channels = (uint32_t)readNumber(text, 0, array_pos, "channels");
+    manifest.format.pixel_format = readString(text, 0, array_pos, "pixel_format");
+    manifest.format.mvs_pixel_type = (uint32_t)readNumber(text, 0, array_pos, "mvs_pixel_type");
+    manifest.complete = readBool(text, 0, array_pos, "complete");
+
+    const fs::path base = fs::path(path).parent_path();
+    size_t pos = text.find('[', array_pos);
+    while (pos != std::string::npos) {
+        const size_t begin = text.find('{', pos);
+        if (begin == std::string::npos) break;
+        const size_t end = text.find('}', begin);
+        if (end == std::string::npos) break;
+        SegmentInfo s;
+        s.index = (uint32_t)readNumber(text, begin, end, "index");
+        s.path = readString(text, begin, end, "path");
+        s.first_frame = readNumber(text, begin, end, "first_frame");
+        s.frames = readNumber(text, begin, end, "frames");
+        s.bytes = readNumber(text, begin, end, "bytes");
+        s.first_host_timestamp_ns = readNumber(text, begin, end, "first_host_timestamp_ns");
+        s.last_host_timestamp_ns = readNumber(text, begin, end, "last_host_timestamp_ns");
+        s.closed = readBool(text, begin, end, "closed");
+        if (fs::path(s.path).is_relative()) s.path = (base / s.path).string();
+        manifest.segments.push_back(s);
+        pos = end + 1;
+    }
+    return true;
+}
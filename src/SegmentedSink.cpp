@@ -0,0 +1,311 @@
+#include "SegmentedSink.h"
+#include "SteadyClock.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+SegmentedSink::SegmentedSink(const std::string& stream, Factory factory, const SegmentPolicy& policy, size_t queue_frames)
+    : factory(std::move(factory)), policy(policy), queue_frames(queue_frames == 0 ? 1 : queue_frames), stream(stream)
+{
+    // Ƚһ sink ѯļǷѹ飬open ʱٰδ
+    std::unique_ptr<FrameSink> prototype = this->factory();
+    child_file_name = prototype->fileName();
+    accepts_chunks = prototype->acceptsCompressedChunks();
+    label = std::string("segmented ") + prototype->name();
+    manifest_name = stream + "_manifest.json";
+}
+
+SegmentedSink::~SegmentedSink()
+{
+    close();
+}
+
+bool SegmentedSink::openFile(const std::string& file_path, const FrameFormat& frame_format)
+{
+    close();
+    manifest_path = file_path;
+    base_path = fs::path(file_path).parent_path().string();
+    if (base_path.empty()) base_path = ".";
+    format = frame_format;
+
+    // ÿĿĿ¼½һݼͬĿ¼
+    std::vector<std::string> directories;
+    if (policy.directories.empty()) {
+        directories.push_back(base_path);
+    }
+    else {
+        const fs::path dataset_name = fs::path(base_path).lexically_normal().filename();
+        for (const std::string& root : policy.directories) {
+            directories.push_back((fs::path(root) / dataset_name).string());
+        }
+    }
+    for (const std::string& directory : directories) {
+        std::error_code ec;
+        fs::create_directories(directory, ec);
+        if (ec) {
+            printf("Failed to create segment directory %s: %s\n", directory.c_str(), ec.message().c_str());
+            return false;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(manifest_mutex);
+        manifest_ = SegmentManifest();
+        manifest_.stream = stream;
+        manifest_.file_name = child_file_name;
+        manifest_.format = format;
+        closed_stats = FrameSinkStats();
+    }
+    segment_open = false;
+    segment_index = 0;
+    total_frames = 0;
+    total_bytes = 0;
+    size_mismatches = 0;
+
+    for (const std::string& directory : directories) {
+        std::unique_ptr<Target> target = std::make_unique<Target>();
+        target->directory = directory;
+        Target* raw = target.get();
+        target->thread = std::thread([this, raw]() { targetLoop(*raw); });
+        targets.push_back(std::move(target));
+    }
+    is_open = true;
+    if (!saveManifest()) {
+        close();
+        return false;
+    }
+    printf("Segmented recording: %zu target directories, manifest %s.\n", targets.size(), manifest_path.c_str());
+    return true;
+}
+
+bool SegmentedSink::write(const FrameRecord& record)
+{
+    if (!is_open) return false;
+    const uint64_t frame_bytes = format.frameBytes();
+    if (!checkFrameBytes(record, (size_t)frame_bytes, size_mismatches)) return false;
+    const uint64_t timestamp = record.host_timestamp_ns != 0 ? record.host_timestamp_ns : steadyNowNs();
+
+    if (!segment_open) {
+        startSegment(timestamp);
+    }
+    else if ((policy.max_frames > 0 && segment_frames >= policy.max_frames) ||
+        (policy.max_bytes > 0 && segment_bytes + frame_bytes > policy.max_bytes) ||
+        (policy.max_seconds > 0 && timestamp - segment_start_ns >= (uint64_t)(policy.max_seconds * 1e9))) {
+        finishSegment();
+        startSegment(timestamp);
+    }
+
+    Item item;
+    item.kind = Item::Kind::Frame;
+    item.segment = segment_index;
+    item.record = record;
+    if (!record.owner) {
+        // ÷֤ write غڴȻЧһݽĿ߳
+        auto copy = std::make_shared<std::vector<uint8_t>>(frame_bytes + record.chunk_bytes);
+        memcpy(copy->data(), record.data, frame_bytes);
+        item.record.data = copy->data();
+        if (record.chunk && record.chunk_bytes > 0) {
+            memcpy(copy->data() + frame_bytes, record.chunk, record.chunk_bytes);
+            item.record.chunk = copy->data() + frame_bytes;
+        }
+        item.record.owner = copy;
+    }
+    push(*targets[segment_index % targets.size()], std::move(item));
+
+    segment_frames++;
+    segment_bytes += frame_bytes;
+    total_frames++;
+    total_bytes += frame_bytes;
+    {
+        std::lock_guard<std::mutex> lock(manifest_mutex);
+        SegmentInfo& info = manifest_.segments.back();
+        info.frames = segment_frames;
+        info.bytes = segment_bytes;
+        info.last_host_timestamp_ns = record.host_timestamp_ns;
+    }
+    return true;
+}
+
+void SegmentedSink::startSegment(uint64_t timestamp_ns)
+{
+    if (segment_open) segment_index++;
+    Target& target = *targets[segment_index % targets.size()];
+    const std::string file_name = segmentFileName(child_file_name, segment_index);
+    const std::string path = (fs::path(target.directory) / file_name).string();
+
+    SegmentInfo info;
+    info.index = segment_index;
+    // ݼĿ¼ڵķֶμ·Ŀ¼ߺ嵥ȻЧ
+    info.path = target.directory == base_path ? file_name : fs::absolute(path).string();
+    info.first_frame = total_frames;
+    info.first_host_timestamp_ns = timestamp_ns;
+    {
+        std::lock_guard<std::mutex> lock(manifest_mutex);
+        manifest_.segments.push_back(info);
+    }
+    saveManifest();
+
+    Item item;
+    item.kind = Item::Kind::Open;
+    item.segment = segment_index;
+    item.path = path;
+    push(target, std::move(item));
+
+    segment_open = true;
+    segment_frames = 0;
+    segment_bytes = 0;
+    segment_start_ns = timestamp_ns;
+}
+
+void SegmentedSink::finishSegment()
+{
+    if (!segment_open) return;
+    Item item;
+    item.kind = Item::Kind::Close;
+    item.segment = segment_index;
+    push(*targets[segment_index % targets.size()], std::move(item));
+}
+
+void SegmentedSink::push(Target& target, Item&& item)
+{
+    std::unique_lock<std::mutex> lock(target.m);
+    if (item.kind == Item::Kind::Frame) {
+        target.cv.wait(lock, [&]() { return target.queued_frames < queue_frames; });
+        target.queued_frames++;
+    }
+    target.items.push_back(std::move(item));
+    target.cv.notify_all();
+}
+
+void SegmentedSink::targetLoop(Target& target)
+{
+    std::unique_ptr<FrameSink> sink;
+    uint32_t segment = 0;
+    bool dirty = false;
+    uint64_t failed_frames = 0;
+    while (true) {
+        Item item;
+        {
+            std::unique_lock<std::mutex> lock(target.m);
+            if (target.items.empty() && dirty && sink) {
+                // пУ sink ݴ֡дȥ
+                lock.unlock();
+                sink->flush();
+                dirty = false;
+                lock.lock();
+            }
+            target.cv.wait(lock, [&]() { return target.stop || !target.items.empty(); });
+            if (target.items.empty()) break;  // stop Ҷѿ
+            item = std::move(target.items.front());
+            target.items.pop_front();
+            if (item.kind == Item::Kind::Frame) target.queued_frames--;
+            target.cv.notify_all();
+        }
+
+        switch (item.kind) {
+        case Item::Kind::Open:
+            segment = item.segment;
+            failed_frames = 0;
+            sink = factory();
+            if (!sink->openFile(item.path, format)) {
+                printf("Failed to open segment %s, its frames will be dropped.\n", item.path.c_str());
+                sink.reset();
+            }
+            break;
+        case Item::Kind::Frame:
+            if (!sink || !sink->write(item.record)) failed_frames++;
+            dirty = true;
+            break;
+        case Item::Kind::Close: {
+            FrameSinkStats segment_stats;
+            bool ok = false;
+            if (sink) {
+                ok = sink->close();
+                segment_stats = sink->stats();
+                sink.reset();
+            }
+            segment_stats.errors += failed_frames;
+            segmentClosed(segment, ok && failed_frames == 0, segment_stats);
+            dirty = false;
+            break;
+        }
+        }
+        // item.record.owner ֡黹
+    }
+}
+
+void SegmentedSink::segmentClosed(uint32_t segment, bool ok, const FrameSinkStats& segment_stats)
+{
+    {
+        std::lock_guard<std::mutex> lock(manifest_mutex);
+        for (SegmentInfo& info : manifest_.segments) {
+            if (info.index == segment) info.closed = ok;
+        }
+        closed_stats.stored_bytes += segment_stats.stored_bytes;
+        closed_stats.writes += segment_stats.writes;
+        closed_stats.errors += segment_stats.errors;
+    }
+    saveManifest();
+}
+
+bool SegmentedSink::saveManifest()
+{
+    std::lock_guard<std::mutex> lock(manifest_mutex);
+    return writeSegmentManifest(manifest_path, manifest_);
+}
+
+void SegmentedSink::stopTargets()
+{
+    for (std::unique_ptr<Target>& target : targets) {
+        {
+            std::lock_guard<std::mutex> lock(target->m);
+            target->stop = true;
+        }
+        target->cv.notify_all();
+    }
+    for (std::unique_ptr<Target>& target : targets) {
+        if (target->thread.joinable()) target->thread.join();
+    }
+    targets.clear();
+}
+
+bool SegmentedSink::close()
+{
+    if (!is_open) return true;
+    finishSegment();
+    segment_open = false;
+    stopTargets();  // Ŀ߳д겢رոԶʣµĶκ˳
+    is_open = false;
+
+    bool ok;
+    {
+        std::lock_guard<std::mutex> lock(manifest_mutex);
+        manifest_.complete = true;
+        for (const SegmentInfo& info : manifest_.segments) {
+            if (!info.closed) manifest_.complete = false;
+        }
+        ok = manifest_.complete && closed_stats.errors == 0 && size_mismatches == 0;
+    }
+    return saveManifest() && ok;
+}
+
+FrameSinkStats SegmentedSink::stats() const
+{
+    FrameSinkStats s;
+    {
+        std::lock_guard<std::mutex> lock(manifest_mutex);
+        s = closed_stats;
+    }
+    s.frames = total_frames;
+    s.bytes = total_bytes;
+    s.errors += size_mismatches;
+    return s;
+}
+
+SegmentManifest SegmentedSink::manifest() const
+{
+    std::lock_guard<std::mutex> lock(manifest_mutex);
+    return manifest_;
+}
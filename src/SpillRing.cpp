@@ -0,0 +1,295 @@
+#include "SpillRing.h"
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+    constexpr uint32_t kSpillMagic = 0x4C495053;  // "SPIL"
+    constexpr uint32_t kFlagWrap = 1;             // Ʊǣļͷ
+    constexpr uint64_t kRecordAlign = 64;
+    constexpr uint64_t kPageBytes = 4096;
+
+    uint64_t alignUp(uint64_t v, uint64_t a) { return (v + a - 1) / a * a; }
+    uint64_t alignDown(uint64_t v, uint64_t a) { return v / a * a; }
+
+    std::atomic<uint32_t> file_counter{ 0 };
+
+#pragma pack(push, 1)
+    struct RecordHeader {
+        uint32_t magic;
+        uint32_t flags;
+        uint64_t record_bytes;   // ¼ (ͷͶ) ĳ
+        uint64_t frame_number;
+        uint64_t host_timestamp_ns;
+        uint64_t device_timestamp;
+        uint64_t data_bytes;
+        uint64_t chunk_bytes;
+        uint8_t reserved[8];
+    };
+#pragma pack(pop)
+    static_assert(sizeof(RecordHeader) == kRecordAlign, "spill record header must be 64 bytes");
+
+    int currentPid()
+    {
+#if defined(_WIN32)
+        return _getpid();
+#else
+        return (int)getpid();
+#endif
+    }
+}
+
+SpillRing::~SpillRing()
+{
+    close();
+}
+
+bool SpillRing::open(const Options& opts)
+{
+    close();
+    options = opts;
+    if (options.directory.empty()) return false;
+
+    capacity = alignDown(options.capacity_bytes, kPageBytes);
+    if (capacity < (1ull << 20)) capacity = 1ull << 20;
+    char name[64];
+    snprintf(name, sizeof(name), "/dualcamera_spill_%d_%u.ring", currentPid(), file_counter.fetch_add(1));
+    file_path = options.directory + name;
+
+#if defined(_WIN32)
+    // ʱļڻرʱϵͳԶɾ
+    HANDLE file = CreateFileA(file_path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+        FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        printf("SpillRing: cannot create %s (error %lu).\n", file_path.c_str(), GetLastError());
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE, (DWORD)(capacity >> 32), (DWORD)capacity, nullptr);
+    void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, (SIZE_T)capacity) : nullptr;
+    if (!view) {
+        printf("SpillRing: cannot map %llu bytes of %s (error %lu).\n",
+            (unsigned long long)capacity, file_path.c_str(), GetLastError());
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    file_handle = file;
+    mapping_handle = mapping;
+    base = (uint8_t*)view;
+#else
+    fd = ::open(file_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        printf("SpillRing: cannot create %s.\n", file_path.c_str());
+        return false;
+    }
+    // ӳ佨ɾĿ¼쳣˳ʱļҲ
+    void* view = MAP_FAILED;
+    if (ftruncate(fd, (off_t)capacity) == 0) {
+        view = mmap(nullptr, (size_t)capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    unlink(file_path.c_str());
+    if (view == MAP_FAILED) {
+        printf("SpillRing: cannot map %llu bytes of %s.\n", (unsigned long long)capacity, file_path.c_str());
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+    base = (uint8_t*)view;
+#endif
+
+    tail.store(0);
+    head.store(0);
+    record_count.store(0);
+    front_bytes = 0;
+    spilled.store(0);
+    restored.store(0);
+    dropped.store(0);
+    spilled_bytes.store(0);
+    peak_bytes.store(0);
+    wait_ns.store(0);
+    printf("SpillRing: %llu MB at %s, spilling above %zu queued frames.\n",
+        (unsigned long long)(capacity >> 20), file_path.c_str(), options.high_water_frames);
+    return true;
+}
+
+void SpillRing::close()
+{
+    if (!base) return;
+    if (records() > 0) {
+        printf("SpillRing: discarding %llu unread frames.\n", (unsigned long long)records());
+    }
+#if defined(_WIN32)
+    UnmapViewOfFile(base);
+    CloseHandle((HANDLE)mapping_handle);
+    CloseHandle((HANDLE)file_handle);
+    mapping_handle = nullptr;
+    file_handle = nullptr;
+#else
+    munmap(base, (size_t)capacity);
+    ::close(fd);
+    fd = -1;
+#endif
+    base = nullptr;
+    record_count.store(0);
+}
+
+uint64_t SpillRing::freeBytes() const
+{
+    return capacity - (tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire));
+}
+
+bool SpillRing::append(const FrameRecord& record)
+{
+    if (!base) return false;
+    const size_t data_bytes = record.data ? record.data_bytes : 0;
+    const size_t chunk_bytes = record.chunk ? record.chunk_bytes : 0;
+    const uint64_t need = kRecordAlign + alignUp(data_bytes, kRecordAlign) + alignUp(chunk_bytes, kRecordAlign);
+    if (need > capacity) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t t = tail.load(std::memory_order_relaxed);
+    uint64_t pos = t % capacity;
+    const uint64_t pad = (capacity - pos < need) ? capacity - pos : 0;
+
+    // д̶߳㹻ļ¼
+    if (freeBytes() < pad + need) {
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto deadline = t0 + std::chrono::milliseconds(options.wait_ms);
+        while (freeBytes() < pad + need && (options.wait_ms < 0 || std::chrono::steady_clock::now() < deadline)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        wait_ns.fetch_add((uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - t0).count(), std::memory_order_relaxed);
+        if (freeBytes() < pad + need) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    if (pad > 0) {
+        RecordHeader* wrap = (RecordHeader*)(base + pos);
+        memset(wrap, 0, sizeof(RecordHeader));
+        wrap->magic = kSpillMagic;
+        wrap->flags = kFlagWrap;
+        wrap->record_bytes = pad;
+        t += pad;
+        pos = 0;
+    }
+
+    RecordHeader* hdr = (RecordHeader*)(base + pos);
+    memset(hdr, 0, sizeof(RecordHeader));
+    hdr->magic = kSpillMagic;
+    hdr->record_bytes = need;
+    hdr->frame_number = record.frame_number;
+    hdr->host_timestamp_ns = record.host_timestamp_ns;
+    hdr->device_timestamp = record.device_timestamp;
+    hdr->data_bytes = data_bytes;
+    hdr->chunk_bytes = chunk_bytes;
+    uint8_t* payload = base + pos + kRecordAlign;
+    if (data_bytes) memcpy(payload, record.data, data_bytes);
+    if (chunk_bytes) memcpy(payload + alignUp(data_bytes, kRecordAlign), record.chunk, chunk_bytes);
+    flushRange(pos, need);
+
+    tail.store(t + need, std::memory_order_release);
+    record_count.fetch_add(1, std::memory_order_release);
+
+    spilled.fetch_add(1, std::memory_order_relaxed);
+    spilled_bytes.fetch_add(need, std::memory_order_relaxed);
+    const uint64_t used = t + need - head.load(std::memory_order_relaxed);
+    if (used > peak_bytes.load(std::memory_order_relaxed)) peak_bytes.store(used, std::memory_order_relaxed);
+    return true;
+}
+
+bool SpillRing::front(FrameRecord& record)
+{
+    if (!base || records() == 0) return false;
+    uint64_t h = head.load(std::memory_order_relaxed);
+    const RecordHeader* hdr = (const RecordHeader*)(base + h % capacity);
+    if (hdr->flags & kFlagWrap) {
+        release(h, h + hdr->record_bytes);
+        h += hdr->record_bytes;
+        head.store(h, std::memory_order_release);
+        hdr = (const RecordHeader*)(base + h % capacity);
+    }
+    if (hdr->magic != kSpillMagic) {
+        printf("SpillRing: corrupt record at offset %llu.\n", (unsigned long long)(h % capacity));
+        return false;
+    }
+
+    const uint8_t* payload = (const uint8_t*)hdr + kRecordAlign;
+    record = FrameRecord();
+    record.data = payload;
+    record.data_bytes = (size_t)hdr->data_bytes;
+    record.chunk = hdr->chunk_bytes ? payload + alignUp(hdr->data_bytes, kRecordAlign) : nullptr;
+    record.chunk_bytes = (size_t)hdr->chunk_bytes;
+    record.frame_number = hdr->frame_number;
+    record.host_timestamp_ns = hdr->host_timestamp_ns;
+    record.device_timestamp = hdr->device_timestamp;
+    front_bytes = hdr->record_bytes;
+    return true;
+}
+
+void SpillRing::pop()
+{
+    if (!base || front_bytes == 0) return;
+    const uint64_t h = head.load(std::memory_order_relaxed);
+    // ڷµ head ֮ǰҳ棬֮߾Ϳдλ
+    release(h, h + front_bytes);
+    head.store(h + front_bytes, std::memory_order_release);
+    front_bytes = 0;
+    record_count.fetch_sub(1, std::memory_order_acq_rel);
+    restored.fetch_add(1, std::memory_order_relaxed);
+}
+
+// ҳ򶴣ҳֱӴҳ涪Ҳдش̡¼Խļĩβ[from, to) ͬһȦ
+void SpillRing::release(uint64_t from, uint64_t to)
+{
+#if defined(__linux__)
+    const uint64_t a = alignUp(from, kPageBytes);
+    const uint64_t b = alignDown(to, kPageBytes);
+    if (b > a) {
+        fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, (off_t)(a % capacity), (off_t)(b - a));
+    }
+#else
+    (void)from;
+    (void)to;
+#endif
+}
+
+// ʼдҳڴԽԽ (ȴд)
+void SpillRing::flushRange(uint64_t offset, uint64_t bytes)
+{
+#if defined(__linux__)
+    sync_file_range(fd, (off_t)offset, (off_t)bytes, SYNC_FILE_RANGE_WRITE);
+#elif defined(_WIN32)
+    FlushViewOfFile(base + offset, (SIZE_T)bytes);
+#else
+    (void)offset;
+    (void)bytes;
+#endif
+}
+
+SpillRing::Stats SpillRing::stats() const
+{
+    Stats s;
+    s.spilled = spilled.load(std::memory_order_relaxed);
+    s.restored = restored.load(std::memory_order_relaxed);
+    s.dropped = dropped.load(std::memory_order_relaxed);
+    s.bytes = spilled_bytes.load(std::memory_order_relaxed);
+    s.peak_bytes = peak_bytes.load(std::memory_order_relaxed);
+    s.wait_ns = wait_ns.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,202 @@
+#include "SyntheticEventSource.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+namespace {
+    constexpr size_t kTableSize = 1 << 18;  // 2^18 ꣬ѭʹãÿλÿʼԵظ
+}
+
+SyntheticEventSource::~SyntheticEventSource()
+{
+    stop();
+}
+
+const char* SyntheticEventSource::distributionName(Distribution distribution)
+{
+    switch (distribution) {
+    case Distribution::Uniform: return "uniform";
+    case Distribution::Gaussian: return "gaussian";
+    case Distribution::MovingEdge: return "moving-edge";
+    default: return "unknown";
+    }
+}
+
+bool SyntheticEventSource::open()
+{
+    if (opened) return true;
+    if (options.width < 2 || options.height < 2 || options.width > 32767 || options.height > 32767) {
+        printf("Synthetic events: invalid size %dx%d.\n", options.width, options.height);
+        return false;
+    }
+    if (options.rate_mev_s <= 0 || options.buffer_events == 0) {
+        printf("Synthetic events: invalid rate %.3f Mev/s or buffer size %zu.\n", options.rate_mev_s, options.buffer_events);
+        return false;
+    }
+
+    std::mt19937 rng(options.seed);
+    std::uniform_int_distribution<int> coin(0, 1);
+    std::uniform_int_distribution<int> any_x(0, options.width - 1);
+    std::uniform_int_distribution<int> any_y(0, options.height - 1);
+    std::normal_distribution<double> gauss(0.0, std::max(options.sigma, 0.5));
+    std::normal_distribution<double> edge_noise(0.0, 1.5);
+    const int cy = options.height / 2;
+
+    table.resize(kTableSize);
+    for (Offset& o : table) {
+        switch (options.distribution) {
+        case Distribution::Uniform:
+            o.dx = (int16_t)any_x(rng);
+            o.dy = (int16_t)any_y(rng);
+            o.p = (int16_t)coin(rng);
+            break;
+        case Distribution::Gaussian: {
+            // ڴĵ²
+            int dx, y;
+            do {
+                dx = (int)std::lround(gauss(rng));
+                y = cy + (int)std::lround(gauss(rng));
+            } while (dx <= -options.width || dx >= options.width || y < 0 || y >= options.height);
+            o.dx = (int16_t)dx;
+            o.dy = (int16_t)y;
+            o.p = (int16_t)coin(rng);
+            break;
+        }
+        case Distribution::MovingEdge: {
+            // ǰ (λ 0) Ϊ ON (λ -sigma) 䰵Ϊ OFF
+            const int on = coin(rng);
+            int dx = (int)std::lround(edge_noise(rng)) - (on ? 0 : (int)options.sigma);
+            dx = std::max(-options.width + 1, std::min(options.width - 1, dx));
+            o.dx = (int16_t)dx;
+            o.dy = (int16_t)any_y(rng);
+            o.p = (int16_t)on;
+            break;
+        }
+        }
+    }
+    opened = true;
+    printf("Synthetic events: %dx%d, %.2f Mev/s, %s (sigma %.0f px, %.0f px/s), %zu events per buffer%s.\n",
+        options.width, options.height, options.rate_mev_s, distributionName(options.distribution),
+        options.sigma, options.speed_px_s, options.buffer_events, options.real_time ? "" : ", max speed");
+    return true;
+}
+
+void SyntheticEventSource::close()
+{
+    stop();
+    table.clear();
+    table.shrink_to_fit();
+    opened = false;
+}
+
+bool SyntheticEventSource::start(Callback events_callback)
+{
+    if (!opened || running) return false;
+    callback = std::move(events_callback);
+    events = 0;
+    buffers = 0;
+    late = 0;
+    last_timestamp = 0;
+    done = false;
+    running = true;
+    thread = std::thread(&SyntheticEventSource::run, this);
+    return true;
+}
+
+void SyntheticEventSource::stop()
+{
+    running = false;
+    if (thread.joinable()) thread.join();
+}
+
+void SyntheticEventSource::run()
+{
+    using Clock = std::chrono::steady_clock;
+    std::mt19937 rng(options.seed ^ 0x9E3779B9u);
+    std::vector<Metavision::EventCD> buffer(options.buffer_events);
+    const double us_per_event = 1.0 / options.rate_mev_s;  // Mev/s == ¼ / ΢
+    const bool moving = options.distribution != Distribution::Uniform;
+    const int width = options.width;
+    const double batch_us = options.buffer_events * us_per_event;
+
+    //  k  k * period½ k * period + high
+    const bool triggers = options.trigger_hz > 0 && trigger_callback;
+    const double trigger_period_us = triggers ? 1e6 / options.trigger_hz : 0;
+    const double trigger_high_us = trigger_period_us * std::min(std::max(options.trigger_duty, 0.01), 0.99);
+    uint64_t next_edge = 0;  // żΪأΪ½
+    std::vector<Metavision::EventExtTrigger> edges;
+
+    const Clock::time_point t0 = Clock::now();
+    uint64_t n = 0;
+    while (running) {
+        size_t count = options.buffer_events;
+        if (options.max_events > 0) {
+            if (n >= options.max_events) {
+                done.store(true, std::memory_order_release);
+                break;
+            }
+            count = (size_t)std::min<uint64_t>(count, options.max_events - n);
+        }
+
+        // һķֲģʼ¼ʱˮƽƽƣƵһ
+        int shift = 0;
+        if (moving) {
+            const double seconds = n * us_per_event * 1e-6;
+            shift = (int)std::fmod(width / 2 + options.speed_px_s * seconds, (double)width);
+        }
+        size_t idx = rng() & (kTableSize - 1);
+        for (size_t i = 0; i < count; ++i) {
+            const Offset& o = table[idx];
+            idx = (idx + 1) & (kTableSize - 1);
+            int x = o.dx + shift;
+            if (x < 0) x += width;
+            else if (x >= width) x -= width;
+            Metavision::EventCD& e = buffer[i];
+            e.x = (uint16_t)x;
+            e.y = (uint16_t)o.dy;
+            e.p = o.p;
+            e.t = (Metavision::timestamp)((n + i) * us_per_event);
+        }
+        const Metavision::timestamp last_t = buffer[count - 1].t;
+
+        if (options.real_time) {
+            const Clock::time_point due = t0 + std::chrono::microseconds(last_t);
+            const Clock::time_point now = Clock::now();
+            if (now < due) {
+                std::this_thread::sleep_until(due);
+            }
+            else if (now - due > std::chrono::microseconds((int64_t)batch_us + 1000)) {
+                late.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        if (callback) callback(buffer.data(), buffer.data() + count);
+        if (triggers) {
+            edges.clear();
+            while (true) {
+                const double edge_us = (next_edge / 2) * trigger_period_us + ((next_edge & 1) ? trigger_high_us : 0);
+                const Metavision::timestamp t = (Metavision::timestamp)edge_us;
+                if (t > last_t) break;
+                edges.emplace_back((int16_t)((next_edge & 1) ? 0 : 1), t, (int16_t)0);
+                next_edge++;
+            }
+            if (!edges.empty()) trigger_callback(edges.data(), edges.data() + edges.size());
+        }
+        n += count;
+        events.store(n, std::memory_order_relaxed);
+        buffers.fetch_add(1, std::memory_order_relaxed);
+        last_timestamp.store(last_t, std::memory_order_relaxed);
+    }
+}
+
+SyntheticEventSource::Stats SyntheticEventSource::stats() const
+{
+    Stats s;
+    s.events = events.load(std::memory_order_relaxed);
+    s.buffers = buffers.load(std::memory_order_relaxed);
+    s.late = late.load(std::memory_order_relaxed);
+    s.last_timestamp = last_timestamp.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,190 @@
+#include "SyntheticFrameSource.h"
+#include "Demosaic.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+namespace {
+    // PFNC ֵ ( MvGvspPixelType ͬ)
+    uint32_t pixelTypeFromName(const std::string& name)
+    {
+        if (name == "BayerGB8") return 0x0108000A;
+        if (name == "BayerRG8") return 0x01080009;
+        if (name == "BayerGR8") return 0x01080008;
+        if (name == "BayerBG8") return 0x0108000B;
+        if (name == "Mono8") return 0x01080001;
+        return 0;
+    }
+}
+
+SyntheticFrameSource::~SyntheticFrameSource()
+{
+    stop();
+    close();
+}
+
+bool SyntheticFrameSource::open()
+{
+    if (opened) return true;
+    const uint32_t pixel_type = pixelTypeFromName(options.pixel_format);
+    if (pixel_type == 0) {
+        printf("Synthetic source: unsupported pixel format %s.\n", options.pixel_format.c_str());
+        return false;
+    }
+    if (options.width < 2 || options.height < 2) {
+        printf("Synthetic source: invalid size %ux%u.\n", options.width, options.height);
+        return false;
+    }
+    source_format.width = options.width;
+    source_format.height = options.height;
+    source_format.pixel_format = options.pixel_format;
+    source_format.pixel_type = pixel_type;
+
+    // ԤɼͼѭʹãԽǽ֡ƽƣ 16 ص̸
+    const size_t count = (size_t)std::max(1, options.pattern_frames);
+    patterns.assign(count, std::vector<uint8_t>(source_format.frameBytes()));
+    for (size_t k = 0; k < count; ++k) {
+        uint8_t* p = patterns[k].data();
+        for (uint32_t y = 0; y < options.height; ++y) {
+            for (uint32_t x = 0; x < options.width; ++x) {
+                const uint32_t checker = (((x >> 4) + (y >> 4)) & 1) ? 48 : 0;
+                *p++ = (uint8_t)(((x + y + k * 8) & 0xFF) / 2 + checker);
+            }
+        }
+    }
+    opened = true;
+    printf("Synthetic source: %ux%u %s at %.1f fps (jitter %d us, burst %d/%d, drop every %d + %.3f).\n",
+        options.width, options.height, options.pixel_format.c_str(), options.fps, options.jitter_us,
+        options.burst_frames, options.burst_every, options.drop_every, options.drop_probability);
+    return true;
+}
+
+void SyntheticFrameSource::close()
+{
+    stop();
+    patterns.clear();
+    patterns.shrink_to_fit();
+    opened = false;
+}
+
+bool SyntheticFrameSource::format(SourceFormat& format)
+{
+    if (!opened) return false;
+    format = source_format;
+    return true;
+}
+
+bool SyntheticFrameSource::start(Callback frame_callback)
+{
+    if (!opened || running) return false;
+    callback = std::move(frame_callback);
+    generated = 0;
+    delivered = 0;
+    dropped = 0;
+    late = 0;
+    max_late_ns = 0;
+    done = false;
+    running = true;
+    thread = std::thread(&SyntheticFrameSource::run, this);
+    return true;
+}
+
+void SyntheticFrameSource::stop()
+{
+    running = false;
+    if (thread.joinable()) thread.join();
+}
+
+void SyntheticFrameSource::run()
+{
+    using Clock = std::chrono::steady_clock;
+    std::mt19937 rng(options.seed);
+    std::uniform_int_distribution<int> jitter(-options.jitter_us, options.jitter_us);
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    const bool paced = options.fps > 0;
+    const double period_ns = paced ? 1e9 / options.fps : 0;
+
+    const Clock::time_point t0 = Clock::now();
+    for (uint64_t n = 0; running; ++n) {
+        if (options.max_frames > 0 && delivered.load(std::memory_order_relaxed) >= options.max_frames) {
+            done.store(true, std::memory_order_release);
+            break;
+        }
+
+        // 1. ȵһ֡ļƻʱ (崮е֡ȴ)
+        const bool in_burst = options.burst_every > 0 && (int)(n % options.burst_every) < options.burst_frames;
+        if (paced && !in_burst) {
+            int64_t due_ns = (int64_t)(n * period_ns);
+            if (options.jitter_us > 0) due_ns += (int64_t)jitter(rng) * 1000;
+            const Clock::time_point due = t0 + std::chrono::nanoseconds(std::max<int64_t>(due_ns, 0));
+            const Clock::time_point now = Clock::now();
+            if (now < due) {
+                // ȴ sleep 200us ϵͳʱȴƫ
+                if (due - now > std::chrono::microseconds(300)) {
+                    std::this_thread::sleep_until(due - std::chrono::microseconds(200));
+                }
+                while (Clock::now() < due) std::this_thread::yield();
+            }
+            else if (now - due > std::chrono::nanoseconds((int64_t)period_ns)) {
+                const int64_t behind = std::chrono::duration_cast<std::chrono::nanoseconds>(now - due).count();
+                late.fetch_add(1, std::memory_order_relaxed);
+                if (behind > max_late_ns.load(std::memory_order_relaxed)) max_late_ns.store(behind, std::memory_order_relaxed);
+            }
+        }
+        generated.fetch_add(1, std::memory_order_relaxed);
+
+        // 2. ֡ע룺֡ճ
+        if ((options.drop_every > 0 && n % options.drop_every == (uint64_t)options.drop_every - 1) ||
+            (options.drop_probability > 0 && coin(rng) < options.drop_probability)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        // 3. ֡дǰ 8 ֽڣοУ˳
+        std::vector<uint8_t>& pixels = patterns[n % patterns.size()];
+        memcpy(pixels.data(), &n, std::min(sizeof(n), pixels.size()));
+
+        SourceFrame frame;
+        frame.data = pixels.data();
+        frame.bytes = pixels.size();
+        frame.width = source_format.width;
+        frame.height = source_format.height;
+        frame.pixel_type = source_format.pixel_type;
+        frame.frame_number = n;
+        frame.device_timestamp = paced ? (uint64_t)(n * period_ns) :
+            (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count();
+        if (callback) callback(frame);
+        delivered.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+bool SyntheticFrameSource::convertToBgr(const SourceFrame& frame, uint8_t* dst, size_t dst_bytes)
+{
+    const size_t pixels = (size_t)frame.width * frame.height;
+    if (frame.bytes < pixels || dst_bytes < pixels * 3) return false;
+
+    BayerPattern pattern;
+    if (bayerPatternFromName(source_format.pixel_format, pattern)) {
+        demosaic(frame.data, frame.width, dst, (size_t)frame.width * 3, (int)frame.width, (int)frame.height,
+            pattern, DemosaicMethod::Bilinear);
+        return true;
+    }
+    // Mono8
+    for (size_t i = 0; i < pixels; ++i) {
+        dst[3 * i] = dst[3 * i + 1] = dst[3 * i + 2] = frame.data[i];
+    }
+    return true;
+}
+
+SyntheticFrameSource::Stats SyntheticFrameSource::stats() const
+{
+    Stats s;
+    s.generated = generated.load(std::memory_order_relaxed);
+    s.delivered = delivered.load(std::memory_order_relaxed);
+    s.dropped = dropped.load(std::memory_order_relaxed);
+    s.late = late.load(std::memory_order_relaxed);
+    s.max_late_ns = max_late_ns.load(std::memory_order_relaxed);
+    return s;
+}
@@ -0,0 +1,31 @@
+#include "ThreadAffinity.h"
+#include <thread>
+
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+bool pinCurrentThreadToCore(size_t core)
+{
+    if (core >= logicalCoreCount()) return false;
+#if defined(_WIN32)
+    if (core >= sizeof(DWORD_PTR) * 8) return false;
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) != 0;
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+size_t logicalCoreCount()
+{
+    unsigned int n = std::thread::hardware_concurrency();
+    return n == 0 ? 1 : n;
+}
@@ -0,0 +1,261 @@
+#include "TriggerIndex.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+    template <typename T>
+    void writeColumn(H5::Group& group, const char* name, const H5::PredType& type, const std::vector<T>& values)
+    {
+        const hsize_t size = values.size();
+        H5::DataSpace space(1, &size);
+        H5::DataSet dataset = group.createDataSet(name, type, space);
+        if (size > 0) dataset.write(values.data(), type);
+    }
+
+    void writeAttribute(H5::H5Object& object, const char* name, const H5::PredType& type, const void* value)
+    {
+        H5::DataSpace scalar_space(H5S_SCALAR);
+        H5::Attribute attribute = object.createAttribute(name, type, scalar_space);
+        attribute.write(type, value);
+    }
+}
+
+void TriggerIndex::reset()
+{
+    rows_.clear();
+    edges.clear();
+    edge_host_ns.clear();
+    pending.clear();
+    open_pulse = false;
+    history.assign(options.history_events, 0);
+    history_head = 0;
+    history_count = 0;
+    events_seen = 0;
+    last_t = INT64_MIN;
+    late = 0;
+    approximate = 0;
+
+    std::lock_guard<std::mutex> lock(rgb_mutex);
+    have_rgb = false;
+    first_frame_number = 0;
+    rgb_received.clear();
+    rgb_frames = 0;
+}
+
+void TriggerIndex::addEvents(const Metavision::EventCD* begin, const Metavision::EventCD* end)
+{
+    if (begin == end) return;
+    const size_t n = (size_t)(end - begin);
+    const Metavision::timestamp batch_last = (end - 1)->t;
+
+    // һı߽磺ڶ
+    while (!pending.empty() && pending.front().t <= batch_last) {
+        const Boundary boundary = pending.front();
+        pending.pop_front();
+        const Metavision::EventCD* it = std::lower_bound(begin, end, boundary.t,
+            [](const Metavision::EventCD& e, Metavision::timestamp t) { return e.t < t; });
+        resolve(boundary, events_seen + (uint64_t)(it - begin));
+    }
+
+    // ׷ӵʱʷֻ history.size() 
+    const size_t capacity = history.size();
+    if (capacity > 0) {
+        const size_t skip = n > capacity ? n - capacity : 0;
+        size_t pos = (history_head + history_count) % capacity;
+        for (size_t i = skip; i < n; ++i) {
+            history[pos] = begin[i].t;
+            if (++pos == capacity) pos = 0;
+        }
+        const size_t added = n - skip;
+        const size_t overflow = history_count + added > capacity ? history_count + added - capacity : 0;
+        history_head = (history_head + overflow) % capacity;
+        history_count = std::min(capacity, history_count + added);
+    }
+    events_seen += n;
+    last_t = batch_last;
+}
+
+void TriggerIndex::addTriggers(const Metavision::EventExtTrigger* begin, const Metavision::EventExtTrigger* end,
+    uint64_t host_timestamp_ns)
+{
+    for (const Metavision::EventExtTrigger* e = begin; e != end; ++e) {
+        if (options.channel >= 0 && e->id != options.channel) continue;
+        edges.push_back(*e);
+        edge_host_ns.push_back(host_timestamp_ns);
+        const bool starts = (e->p != 0) == options.rising_starts;
+        if (starts) {
+            if (open_pulse) {
+                // һأһ嵽ʼΪֹ
+                rows_.back().t_end = e->t;
+                addBoundary(e->t, rows_.size() - 1, true);
+            }
+            Row row;
+            row.pulse = rows_.size();
+            row.t_begin = e->t;
+            rows_.push_back(row);
+            addBoundary(e->t, rows_.size() - 1, false);
+            if (options.exposure_us > 0) {
+                rows_.back().t_end = e->t + options.exposure_us;
+                addBoundary(rows_.back().t_end, rows_.size() - 1, true);
+                open_pulse = false;
+            }
+            else {
+                open_pulse = true;
+            }
+        }
+        else if (open_pulse) {
+            // ɼʼǰĽء̶عģʽµĽضҪ
+            rows_.back().t_end = e->t;
+            addBoundary(e->t, rows_.size() - 1, true);
+            open_pulse = false;
+        }
+    }
+}
+
+void TriggerIndex::addBoundary(Metavision::timestamp t, size_t row, bool is_end)
+{
+    if (events_seen > 0 && t <= last_t) {
+        resolve(Boundary{ t, row, is_end }, positionInHistory(t));
+        return;
+    }
+    const Boundary boundary{ t, row, is_end };
+    auto it = std::upper_bound(pending.begin(), pending.end(), t,
+        [](Metavision::timestamp value, const Boundary& b) { return value < b.t; });
+    pending.insert(it, boundary);
+}
+
+// յ¼еһ t >= t 
+uint64_t TriggerIndex::positionInHistory(Metavision::timestamp t)
+{
+    late++;
+    const uint64_t oldest = events_seen - history_count;
+    const size_t capacity = history.size();
+    if (history_count == 0 || t <= history[history_head]) {
+        if (oldest > 0) approximate++;
+        return oldest;
+    }
+    // ߼Ļ϶
+    size_t lo = 0;
+    size_t hi = history_count;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (history[(history_head + mid) % capacity] < t) lo = mid + 1;
+        else hi = mid;
+    }
+    return oldest + lo;
+}
+
+void TriggerIndex::resolve(const Boundary& boundary, uint64_t position)
+{
+    Row& row = rows_[boundary.row];
+    if (boundary.is_end) row.event_end = position;
+    else row.event_begin = position;
+}
+
+void TriggerIndex::addRgbFrame(uint64_t frame_number)
+{
+    std::lock_guard<std::mutex> lock(rgb_mutex);
+    rgb_frames++;
+    if (!have_rgb) {
+        have_rgb = true;
+        first_frame_number = frame_number;
+    }
+    if (frame_number < first_frame_number) return;
+    const uint64_t k = frame_number - first_frame_number;
+    if (k >= ((uint64_t)1 << 28)) return;  // ֡䣬ͬһβɼ
+    if (k >= rgb_received.size()) rgb_received.resize((size_t)k + 1, 0);
+    rgb_received[(size_t)k] = 1;
+}
+
+void TriggerIndex::finish()
+{
+    if (open_pulse) {
+        const size_t last = rows_.size() - 1;
+        pending.erase(std::remove_if(pending.begin(), pending.end(),
+            [last](const Boundary& b) { return b.row == last; }), pending.end());
+        rows_.pop_back();
+        open_pulse = false;
+    }
+    for (const Boundary& boundary : pending) resolve(boundary, events_seen);
+    pending.clear();
+}
+
+bool TriggerIndex::write(H5::Group& parent, uint64_t dropped_events) const
+{
+    try {
+        H5::Group triggers = parent.createGroup("triggers");
+        std::vector<int64_t> t(edges.size());
+        std::vector<int16_t> p(edges.size());
+        std::vector<int16_t> id(edges.size());
+        for (size_t i = 0; i < edges.size(); ++i) {
+            t[i] = edges[i].t;
+            p[i] = edges[i].p;
+            id[i] = edges[i].id;
+        }
+        writeColumn(triggers, "t", H5::PredType::NATIVE_INT64, t);
+        writeColumn(triggers, "p", H5::PredType::NATIVE_INT16, p);
+        writeColumn(triggers, "id", H5::PredType::NATIVE_INT16, id);
+        writeColumn(triggers, "host_ns", H5::PredType::NATIVE_UINT64, edge_host_ns);
+
+        bool from_rgb;
+        uint64_t first;
+        std::vector<uint8_t> received(rows_.size(), 0);
+        {
+            std::lock_guard<std::mutex> lock(rgb_mutex);
+            from_rgb = have_rgb;
+            first = first_frame_number;
+            std::copy_n(rgb_received.begin(), std::min(rgb_received.size(), received.size()), received.begin());
+        }
+
+        H5::Group frames = parent.createGroup("frames");
+        const size_t n = rows_.size();
+        std::vector<uint64_t> frame_number(n), event_begin(n), event_end(n);
+        std::vector<int64_t> t_begin(n), t_end(n);
+        for (size_t i = 0; i < n; ++i) {
+            const Row& row = rows_[i];
+            frame_number[i] = (from_rgb ? first : 0) + row.pulse;
+            t_begin[i] = row.t_begin;
+            t_end[i] = row.t_end;
+            event_begin[i] = row.event_begin;
+            event_end[i] = row.event_end;
+        }
+        writeColumn(frames, "frame_number", H5::PredType::NATIVE_UINT64, frame_number);
+        writeColumn(frames, "t_begin", H5::PredType::NATIVE_INT64, t_begin);
+        writeColumn(frames, "t_end", H5::PredType::NATIVE_INT64, t_end);
+        writeColumn(frames, "event_begin", H5::PredType::NATIVE_UINT64, event_begin);
+        writeColumn(frames, "event_end", H5::PredType::NATIVE_UINT64, event_end);
+        writeColumn(frames, "rgb_received", H5::PredType::NATIVE_UINT8, received);
+
+        // frame_number  RGB ֡ ("rgb")ûյ RGB ֡ʱΪ ("pulse")
+        H5::StrType str_type(H5::PredType::C_S1, H5T_VARIABLE);
+        H5::DataSpace scalar_space(H5S_SCALAR);
+        H5::Attribute source_attr = frames.createAttribute("frame_number_source", str_type, scalar_space);
+        source_attr.write(str_type, std::string(from_rgb ? "rgb" : "pulse"));
+        const int64_t exposure_us = options.exposure_us;
+        writeAttribute(frames, "exposure_us", H5::PredType::NATIVE_INT64, &exposure_us);
+        writeAttribute(frames, "dropped_events", H5::PredType::NATIVE_UINT64, &dropped_events);
+        writeAttribute(frames, "approximate", H5::PredType::NATIVE_UINT64, &approximate);
+    }
+    catch (H5::Exception& e) {
+        printf("Failed to write trigger index: %s\n", e.getCDetailMsg());
+        return false;
+    }
+    if (dropped_events > 0) {
+        printf("Trigger index: %llu events were dropped, frames overlapping the drops have incomplete event ranges.\n",
+            (unsigned long long)dropped_events);
+    }
+    return true;
+}
+
+TriggerIndex::Stats TriggerIndex::stats() const
+{
+    Stats s;
+    s.edges = edges.size();
+    s.pulses = rows_.size();
+    s.late = late;
+    s.approximate = approximate;
+    s.events = events_seen;
+    std::lock_guard<std::mutex> lock(rgb_mutex);
+    s.rgb_frames = rgb_frames;
+    return s;
+}
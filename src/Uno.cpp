@@ -1,8 +1,128 @@
 #include "Uno.h"
+#include "SteadyClock.h"
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
 
-UNO::UNO() {
-    portName = "\\\\.\\COM3";
-    hSerial = CreateFile(portName,
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#if defined(__linux__)
+#include <linux/serial.h>
+#endif
+#endif
+
+namespace {
+#if !defined(_WIN32)
+    bool baudToSpeed(int baud, speed_t& speed)
+    {
+        switch (baud) {
+        case 9600: speed = B9600; return true;
+        case 19200: speed = B19200; return true;
+        case 38400: speed = B38400; return true;
+        case 57600: speed = B57600; return true;
+        case 115200: speed = B115200; return true;
+        case 230400: speed = B230400; return true;
+#if defined(B460800)
+        case 460800: speed = B460800; return true;
+#endif
+#if defined(B500000)
+        case 500000: speed = B500000; return true;
+#endif
+#if defined(B1000000)
+        case 1000000: speed = B1000000; return true;
+#endif
+#if defined(B2000000)
+        case 2000000: speed = B2000000; return true;
+#endif
+        default: return false;
+        }
+    }
+#endif
+}
+
+UNO::UNO() : UNO(Options()) {
+}
+
+UNO::UNO(const Options& options) {
+    open(options);
+}
+
+UNO::~UNO() {
+    close();
+}
+
+UNO::Stats UNO::stats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex);
+    return stats_;
+}
+
+void UNO::startAsync(Done done) {
+    submit(true, std::move(done));
+}
+
+void UNO::stopAsync(Done done) {
+    submit(false, std::move(done));
+}
+
+void UNO::submit(bool start_command, Done done) {
+    std::lock_guard<std::mutex> lock(command_mutex);
+    if (!command_thread.joinable()) {
+        command_exit = false;
+        command_thread = std::thread(&UNO::commandLoop, this);
+    }
+    commands.push_back(Command{ start_command, std::move(done) });
+    commands_pending++;
+    command_cv.notify_all();
+}
+
+void UNO::commandLoop() {
+    std::unique_lock<std::mutex> lock(command_mutex);
+    while (true) {
+        command_cv.wait(lock, [this]() { return !commands.empty() || command_exit; });
+        if (commands.empty()) break;  // ˳ǰִύ
+        Command command = std::move(commands.front());
+        commands.pop_front();
+        lock.unlock();
+        const bool ok = command.start ? start() : stop();
+        if (command.done) command.done(ok);
+        lock.lock();
+        commands_pending--;
+        command_cv.notify_all();
+    }
+}
+
+void UNO::waitIdle() {
+    std::unique_lock<std::mutex> lock(command_mutex);
+    command_cv.wait(lock, [this]() { return commands_pending == 0; });
+}
+
+void UNO::stopCommandThread() {
+    {
+        std::lock_guard<std::mutex> lock(command_mutex);
+        if (!command_thread.joinable()) return;
+        command_exit = true;
+    }
+    command_cv.notify_all();
+    command_thread.join();
+}
+
+#if defined(_WIN32)
+
+bool UNO::open(const Options& new_options) {
+    close();
+    options = new_options;
+    // COM10 ϱ \\.\ ǰ׺ COM1-9 ҲЧ
+    const std::string path = options.port.compare(0, 4, "\\\\.\\") == 0 ? options.port : "\\\\.\\" + options.port;
+    HANDLE hSerial = CreateFileA(path.c_str(),
         GENERIC_READ | GENERIC_WRITE,
         0,
         0,
@@ -11,72 +131,267 @@ UNO::UNO() {
         0);
 
     if (hSerial == INVALID_HANDLE_VALUE) {
-        printf("򿪴ʧ\n");
-        return;
+        printf("򿪴ʧ: %s\n", options.port.c_str());
+        return false;
     }
 
-    dcbSerialParams = { 0 };
+    DCB dcbSerialParams = { 0 };
     dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
 
     if (!GetCommState(hSerial, &dcbSerialParams)) {
         printf("ȡ״̬ʧ\n");
         CloseHandle(hSerial);
-        return;
+        return false;
     }
 
-    dcbSerialParams.BaudRate = CBR_9600;
+    dcbSerialParams.BaudRate = (DWORD)options.baud;
     dcbSerialParams.ByteSize = 8;
     dcbSerialParams.StopBits = ONESTOPBIT;
     dcbSerialParams.Parity = NOPARITY;
 
     if (!SetCommState(hSerial, &dcbSerialParams)) {
-        printf("ôڲʧ\n");
+        printf("ôڲʧ (%d baud)\n", options.baud);
         CloseHandle(hSerial);
-        return;
+        return false;
     }
 
-    // ôڳʱ
+    // أʱ readSome ÷ timeout ãд 50 ms
     COMMTIMEOUTS timeouts = { 0 };
-    timeouts.ReadIntervalTimeout = 50;
-    timeouts.ReadTotalTimeoutConstant = 50;
-    timeouts.ReadTotalTimeoutMultiplier = 10;
+    timeouts.ReadIntervalTimeout = MAXDWORD;
+    timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+    timeouts.ReadTotalTimeoutConstant = 10;
     timeouts.WriteTotalTimeoutConstant = 50;
     timeouts.WriteTotalTimeoutMultiplier = 10;
 
     if (!SetCommTimeouts(hSerial, &timeouts)) {
         printf("óʱʧ\n");
         CloseHandle(hSerial);
-        return;
+        return false;
     }
+    handle = (intptr_t)hSerial;
+    opened_ns = steadyNowNs();
+    rx.clear();
+    return true;
 }
 
-UNO::~UNO() {
-    if (hSerial != INVALID_HANDLE_VALUE) {
-        CloseHandle(hSerial);
+void UNO::close() {
+    stopCommandThread();
+    if (handle != -1) {
+        CloseHandle((HANDLE)handle);
+        handle = -1;
     }
 }
 
-void UNO::start() {
-    if (hSerial == INVALID_HANDLE_VALUE) {
+bool UNO::writeCommand(char command) {
+    DWORD bytesWritten = 0;
+    return WriteFile((HANDLE)handle, &command, 1, &bytesWritten, NULL) && bytesWritten == 1;
+}
+
+int UNO::readSome(char* buffer, int size, int timeout_ms) {
+    // ReadTotalTimeoutMultiplier = MAXDWORDأûݵ ReadTotalTimeoutConstant
+    COMMTIMEOUTS timeouts = { 0 };
+    GetCommTimeouts((HANDLE)handle, &timeouts);
+    timeouts.ReadTotalTimeoutConstant = (DWORD)(timeout_ms > 0 ? timeout_ms : 1);
+    SetCommTimeouts((HANDLE)handle, &timeouts);
+    DWORD bytesRead = 0;
+    if (!ReadFile((HANDLE)handle, buffer, (DWORD)size, &bytesRead, NULL)) return -1;
+    return (int)bytesRead;
+}
+
+void UNO::discardInput() {
+    PurgeComm((HANDLE)handle, PURGE_RXCLEAR);
+    rx.clear();
+}
+
+#else
+
+bool UNO::open(const Options& new_options) {
+    close();
+    options = new_options;
+    speed_t speed;
+    if (!baudToSpeed(options.baud, speed)) {
+        printf("ֵ֧Ĳ: %d\n", options.baud);
+        return false;
+    }
+    const int fd = ::open(options.port.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (fd < 0) {
+        printf("򿪴ʧ: %s (%s)\n", options.port.c_str(), strerror(errno));
+        return false;
+    }
+
+    // ԭʼģʽ 8N1л塢Ժأд poll Ƴʱ
+    termios tty;
+    if (tcgetattr(fd, &tty) != 0) {
+        printf("ȡ״̬ʧ: %s\n", strerror(errno));
+        ::close(fd);
+        return false;
+    }
+    cfmakeraw(&tty);
+    tty.c_cflag |= CLOCAL | CREAD;
+    tty.c_cflag &= ~(CSTOPB | PARENB);
+#if defined(CRTSCTS)
+    tty.c_cflag &= ~CRTSCTS;
+#endif
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
+    cfsetispeed(&tty, speed);
+    cfsetospeed(&tty, speed);
+    if (tcsetattr(fd, TCSANOW, &tty) != 0) {
+        printf("ôڲʧ (%d baud): %s\n", options.baud, strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+#if defined(__linux__) && defined(ASYNC_LOW_LATENCY)
+    // USB оƬ (FTDI ) Ĭ 16 ms ϱصCDC ACM αն˲֧֣ʧ
+    serial_struct serial;
+    if (ioctl(fd, TIOCGSERIAL, &serial) == 0) {
+        serial.flags |= ASYNC_LOW_LATENCY;
+        ioctl(fd, TIOCSSERIAL, &serial);
+    }
+#endif
+    handle = fd;
+    opened_ns = steadyNowNs();
+    rx.clear();
+    return true;
+}
+
+void UNO::close() {
+    stopCommandThread();
+    if (handle != -1) {
+        ::close((int)handle);
+        handle = -1;
+    }
+}
+
+bool UNO::writeCommand(char command) {
+    if (::write((int)handle, &command, 1) != 1) return false;
+    tcdrain((int)handle);  // ֽʱ̲׼ȷ
+    return true;
+}
+
+int UNO::readSome(char* buffer, int size, int timeout_ms) {
+    pollfd pfd = { (int)handle, POLLIN, 0 };
+    const int ready = poll(&pfd, 1, timeout_ms > 0 ? timeout_ms : 0);
+    if (ready <= 0) return ready;
+    const ssize_t n = ::read((int)handle, buffer, (size_t)size);
+    if (n < 0) return (errno == EAGAIN || errno == EINTR) ? 0 : -1;
+    return (int)n;
+}
+
+void UNO::discardInput() {
+    tcflush((int)handle, TCIFLUSH);
+    char buffer[256];
+    while (readSome(buffer, sizeof(buffer), 0) > 0) {
+    }
+    rx.clear();
+}
+
+#endif
+
+bool UNO::readLine(std::string& line, int timeout_ms) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (true) {
+        const size_t end = rx.find('\n');
+        if (end != std::string::npos) {
+            line.assign(rx, 0, end);
+            if (!line.empty() && line.back() == '\r') line.pop_back();
+            rx.erase(0, end + 1);
+            return true;
+        }
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (left <= 0) return false;
+        char buffer[64];
+        const int n = readSome(buffer, sizeof(buffer), (int)left);
+        if (n < 0) return false;
+        rx.append(buffer, (size_t)n);
+    }
+}
+
+bool UNO::start() {
+    if (handle == -1) {
         printf("δ\n");
-        return;
+        return false;
     }
+    // մ򿪴ʱ UNO  bootloader ᶪ
+    const uint64_t ready_ns = opened_ns + (uint64_t)options.boot_ms * 1000000;
+    const uint64_t now_ns = steadyNowNs();
+    if (now_ns < ready_ns) std::this_thread::sleep_for(std::chrono::nanoseconds(ready_ns - now_ns));
 
-    char command = 'a'; 
-    if (!WriteFile(hSerial, &command, 1, &bytesWritten, NULL)) {
+    discardInput();
+    Stats result;  // ֽһд stats_
+    result.command_host_ns = steadyNowNs();
+    if (!writeCommand('a')) {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        stats_ = result;
         printf("ʧ\n");
+        return false;
+    }
+
+    // Ӧ˳򵽴"A" ֮ "P" (̼ĵ) 
+    uint32_t ack_us = 0;
+    std::string line;
+    int timeout_ms = options.ack_timeout_ms;
+    while (readLine(line, timeout_ms)) {
+        if (line.size() > 2 && line[0] == 'A' && !result.acked) {
+            result.acked = true;
+            result.ack_rtt_us = (steadyNowNs() - result.command_host_ns) / 1e3;
+            ack_us = (uint32_t)strtoul(line.c_str() + 2, nullptr, 10);
+            const double byte_us = 10e6 / options.baud;
+            const double transfer_us = byte_us * (1 + line.size() + 1);
+            result.command_us = std::max(0.0, result.ack_rtt_us - transfer_us) / 2 + byte_us;
+            timeout_ms = options.pulse_timeout_ms;
+        }
+        else if (line.size() > 2 && line[0] == 'P' && result.acked) {
+            // micros() Լ 71 ӻƣ޷Ų
+            const uint32_t pulse_us = (uint32_t)strtoul(line.c_str() + 2, nullptr, 10);
+            result.pulse_seen = true;
+            result.device_delay_us = (double)(uint32_t)(pulse_us - ack_us);
+            result.latency_us = result.command_us + result.device_delay_us;
+            break;
+        }
     }
-    printf("ɹ\n");
+
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex);
+        stats_ = result;
+    }
+    if (!result.acked) {
+        printf("ɹ (Ӧ𣬾ɹ̼)\n");
+    }
+    else if (!result.pulse_seen) {
+        printf("ɹӦ %.2f ms%d ms ûյһ\n", result.ack_rtt_us / 1e3, options.pulse_timeout_ms);
+    }
+    else {
+        printf("ɹӦ %.2f msһԼ %.2f ms\n", result.ack_rtt_us / 1e3, result.latency_us / 1e3);
+    }
+    return true;
 }
 
-void UNO::stop() {
-    if (hSerial == INVALID_HANDLE_VALUE) {
+bool UNO::stop() {
+    if (handle == -1) {
         printf("δ\n");
-        return;
+        return false;
     }
-
-    char command = 'q'; 
-    if (!WriteFile(hSerial, &command, 1, &bytesWritten, NULL)) {
+    if (!writeCommand('q')) {
         printf("ʧ\n");
+        return false;
     }
-}
\ No newline at end of file
+    std::string line;
+    while (readLine(line, options.ack_timeout_ms)) {
+        if (line.size() > 2 && line[0] == 'Q') {
+            const char* p = line.c_str() + 2;
+            char* end = nullptr;
+            strtoul(p, &end, 10);
+            const uint32_t pulses = (uint32_t)strtoul(end, nullptr, 10);
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex);
+                stats_.stopped = true;
+                stats_.pulses = pulses;
+            }
+            printf("ֹͣ %u \n", pulses);
+            break;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,78 @@
+#include "BitPack.h"
+#include "BitPackKernels.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    inline uint32_t lowMask(int width)
+    {
+        return width >= 32 ? 0xFFFFFFFFu : ((1u << width) - 1);
+    }
+
+    // οʵּ֣ͨ BitPack.hout / in Ҫ룬ɾֲ忽
+    void packBits256Scalar(const uint32_t* in, int width, uint8_t* out)
+    {
+        const size_t words = (size_t)width * 8;
+        uint32_t dst[32 * 8] = {};
+        const uint32_t mask = lowMask(width);
+        for (int lane = 0; lane < 8; ++lane) {
+            for (int k = 0; k < 32; ++k) {
+                const uint32_t v = in[k * 8 + lane] & mask;
+                const int bit = k * width;
+                const int word = bit >> 5;
+                const int shift = bit & 31;
+                dst[word * 8 + lane] |= v << shift;
+                if (shift + width > 32) dst[(word + 1) * 8 + lane] |= v >> (32 - shift);
+            }
+        }
+        memcpy(out, dst, words * sizeof(uint32_t));
+    }
+
+    void unpackBits256Scalar(const uint8_t* in, int width, uint32_t* out)
+    {
+        uint32_t src[32 * 8];
+        memcpy(src, in, (size_t)width * 8 * sizeof(uint32_t));
+        const uint32_t mask = lowMask(width);
+        for (int lane = 0; lane < 8; ++lane) {
+            for (int k = 0; k < 32; ++k) {
+                const int bit = k * width;
+                const int word = bit >> 5;
+                const int shift = bit & 31;
+                uint32_t v = src[word * 8 + lane] >> shift;
+                if (shift + width > 32) v |= src[(word + 1) * 8 + lane] << (32 - shift);
+                out[k * 8 + lane] = v & mask;
+            }
+        }
+    }
+}
+
+void packBits256(const uint32_t* in, int width, uint8_t* out, SimdLevel level)
+{
+    if (width <= 0) return;
+    width = std::min(width, 32);
+#if defined(_M_X64) || defined(__x86_64__)
+    if (std::min(level, detectSimdLevel()) >= SimdLevel::AVX2) {
+        packBits256Avx2(in, width, out);
+        return;
+    }
+#endif
+    (void)level;
+    packBits256Scalar(in, width, out);
+}
+
+void unpackBits256(const uint8_t* in, int width, uint32_t* out, SimdLevel level)
+{
+    if (width <= 0) {
+        std::fill(out, out + kBitPackGroup, 0u);
+        return;
+    }
+    width = std::min(width, 32);
+#if defined(_M_X64) || defined(__x86_64__)
+    if (std::min(level, detectSimdLevel()) >= SimdLevel::AVX2) {
+        unpackBits256Avx2(in, width, out);
+        return;
+    }
+#endif
+    (void)level;
+    unpackBits256Scalar(in, width, out);
+}
@@ -0,0 +1,12 @@
+#ifndef BITPACKKERNELS_H
+#define BITPACKKERNELS_H
+
+#include <cstdint>
+
+// ָλʵ֣ BitPack.cpp  SimdLevel ѡ
+#if defined(_M_X64) || defined(__x86_64__)
+void packBits256Avx2(const uint32_t* in, int width, uint8_t* out);
+void unpackBits256Avx2(const uint8_t* in, int width, uint32_t* out);
+#endif
+
+#endif // BITPACKKERNELS_H
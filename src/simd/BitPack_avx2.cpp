@@ -0,0 +1,44 @@
+// AVX2 λÿָ 8 ͨ (ļ -mavx2 )
+#include "BitPackKernels.h"
+#include <immintrin.h>
+
+void packBits256Avx2(const uint32_t* in, int width, uint8_t* out)
+{
+    const __m256i mask = _mm256_set1_epi32(width >= 32 ? -1 : (int)((1u << width) - 1));
+    __m256i* dst = reinterpret_cast<__m256i*>(out);
+    __m256i acc = _mm256_setzero_si256();
+    int shift = 0;
+    for (int k = 0; k < 32; ++k) {
+        const __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(in + k * 8)), mask);
+        acc = _mm256_or_si256(acc, _mm256_sll_epi32(v, _mm_cvtsi32_si128(shift)));
+        shift += width;
+        if (shift >= 32) {
+            _mm256_storeu_si256(dst++, acc);
+            shift -= 32;
+            // ֵֵλֽһ (shift Ϊ 0 ʱ÷꣬srl 32  0)
+            acc = _mm256_srl_epi32(v, _mm_cvtsi32_si128(width - shift));
+        }
+    }
+    // 32 * width λ width ֣һ shift һص 0acc ûʣ
+}
+
+void unpackBits256Avx2(const uint8_t* in, int width, uint32_t* out)
+{
+    const __m256i mask = _mm256_set1_epi32(width >= 32 ? -1 : (int)((1u << width) - 1));
+    const __m256i* src = reinterpret_cast<const __m256i*>(in);
+    __m256i cur = _mm256_loadu_si256(src++);
+    int shift = 0;
+    for (int k = 0; k < 32; ++k) {
+        __m256i v = _mm256_srl_epi32(cur, _mm_cvtsi32_si128(shift));
+        shift += width;
+        if (shift >= 32) {
+            shift -= 32;
+            if (k < 31) {
+                cur = _mm256_loadu_si256(src++);
+                //  shift λһ
+                if (shift > 0) v = _mm256_or_si256(v, _mm256_sll_epi32(cur, _mm_cvtsi32_si128(width - shift)));
+            }
+        }
+        _mm256_storeu_si256((__m256i*)(out + k * 8), _mm256_and_si256(v, mask));
+    }
+}
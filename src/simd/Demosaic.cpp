@@ -0,0 +1,175 @@
+#include "Demosaic.h"
+#include "DemosaicRow.h"
+#include <algorithm>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__x86_64__)
+#include <cpuid.h>
+#endif
+
+namespace {
+#if defined(_M_X64) || defined(__x86_64__)
+    void cpuid(int leaf, int subleaf, unsigned int regs[4])
+    {
+#if defined(_MSC_VER)
+        int r[4];
+        __cpuidex(r, leaf, subleaf);
+        for (int i = 0; i < 4; ++i) regs[i] = (unsigned int)r[i];
+#else
+        __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    }
+
+    unsigned long long xgetbv0()
+    {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned int lo, hi;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return ((unsigned long long)hi << 32) | lo;
+#endif
+    }
+
+    SimdLevel probeSimdLevel()
+    {
+        unsigned int regs[4];
+        cpuid(0, 0, regs);
+        const unsigned int max_leaf = regs[0];
+        cpuid(1, 0, regs);
+        const bool sse41 = (regs[2] >> 19) & 1;
+        const bool ssse3 = (regs[2] >> 9) & 1;
+        const bool osxsave = (regs[2] >> 27) & 1;
+        const bool avx = (regs[2] >> 28) & 1;
+        if (!sse41 || !ssse3) return SimdLevel::Scalar;
+        if (!osxsave || !avx || max_leaf < 7) return SimdLevel::SSE4;
+
+        // ϵͳ뱣 YMM (Լ ZMM / opmask) ״̬
+        const unsigned long long xcr0 = xgetbv0();
+        if ((xcr0 & 0x6) != 0x6) return SimdLevel::SSE4;
+        cpuid(7, 0, regs);
+        const bool avx2 = (regs[1] >> 5) & 1;
+        const bool avx512f = (regs[1] >> 16) & 1;
+        const bool avx512bw = (regs[1] >> 30) & 1;
+        if (!avx2) return SimdLevel::SSE4;
+        if (avx512f && avx512bw && (xcr0 & 0xE6) == 0xE6) return SimdLevel::AVX512;
+        return SimdLevel::AVX2;
+    }
+#else
+    SimdLevel probeSimdLevel()
+    {
+        return SimdLevel::Scalar;
+    }
+#endif
+
+    inline uint8_t avg2(int a, int b) { return (uint8_t)((a + b + 1) >> 1); }
+    inline uint8_t avg4(int a, int b, int c, int d) { return (uint8_t)((a + b + c + d + 2) >> 2); }
+    inline int absDiff(int a, int b) { return a > b ? a - b : b - a; }
+
+    DemosaicRowSimdFn simdRowFunction(SimdLevel level)
+    {
+#if defined(_M_X64) || defined(__x86_64__)
+        switch (level) {
+        case SimdLevel::SSE4: return demosaicRowSse4;
+        case SimdLevel::AVX2: return demosaicRowAvx2;
+        case SimdLevel::AVX512: return demosaicRowAvx512;
+        default: return nullptr;
+        }
+#else
+        (void)level;
+        return nullptr;
+#endif
+    }
+}
+
+SimdLevel detectSimdLevel()
+{
+    static const SimdLevel level = probeSimdLevel();
+    return level;
+}
+
+const char* simdLevelName(SimdLevel level)
+{
+    switch (level) {
+    case SimdLevel::Scalar: return "scalar";
+    case SimdLevel::SSE4: return "sse4";
+    case SimdLevel::AVX2: return "avx2";
+    case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool bayerPatternFromName(const std::string& name, BayerPattern& pattern)
+{
+    if (name == "BayerGB8") pattern = BayerPattern::GB;
+    else if (name == "BayerRG8") pattern = BayerPattern::RG;
+    else if (name == "BayerGR8") pattern = BayerPattern::GR;
+    else if (name == "BayerBG8") pattern = BayerPattern::BG;
+    else return false;
+    return true;
+}
+
+// οʵ֣Ҳ߽к SIMD β
+void demosaicRowScalar(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, int width, BayerRow row, DemosaicMethod method, int x_begin, int x_end)
+{
+    for (int x = x_begin; x < x_end; ++x) {
+        const int xl = x > 0 ? x - 1 : 1;               // reflect-101
+        const int xr = x < width - 1 ? x + 1 : width - 2;
+        const int c = cur[x];
+        const int l = cur[xl], r = cur[xr], u = up[x], d = down[x];
+
+        uint8_t own, g, other;  // own: е R  Bother: һɫ
+        if (((x & 1) == 0) == row.g_even) {
+            own = avg2(l, r);
+            g = (uint8_t)c;
+            other = avg2(u, d);
+        }
+        else {
+            own = (uint8_t)c;
+            other = avg4(up[xl], up[xr], down[xl], down[xr]);
+            g = avg4(l, r, u, d);
+            if (method == DemosaicMethod::EdgeAware) {
+                const int dh = absDiff(l, r);
+                const int dv = absDiff(u, d);
+                if (dh < dv) g = avg2(l, r);
+                else if (dv < dh) g = avg2(u, d);
+            }
+        }
+
+        uint8_t* px = dst + 3 * x;
+        px[0] = row.red_row ? other : own;
+        px[1] = g;
+        px[2] = row.red_row ? own : other;
+    }
+}
+
+void demosaicRows(const uint8_t* src, size_t src_stride, uint8_t* dst, size_t dst_stride,
+    int width, int height, BayerPattern pattern, DemosaicMethod method,
+    int row_begin, int row_end, SimdLevel level)
+{
+    if (width < 2 || height < 2) return;
+    row_begin = std::max(row_begin, 0);
+    row_end = std::min(row_end, height);
+
+    level = std::min(level, detectSimdLevel());
+    DemosaicRowSimdFn simd_row = simdRowFunction(level);
+
+    for (int y = row_begin; y < row_end; ++y) {
+        const uint8_t* cur = src + (size_t)y * src_stride;
+        const uint8_t* up = src + (size_t)(y > 0 ? y - 1 : 1) * src_stride;
+        const uint8_t* down = src + (size_t)(y < height - 1 ? y + 1 : height - 2) * src_stride;
+        uint8_t* out = dst + (size_t)y * dst_stride;
+        const BayerRow row = bayerRow(pattern, y);
+
+        //  0 кһҪʼ߱ڲн SIMDʣµβɱ
+        demosaicRowScalar(up, cur, down, out, width, row, method, 0, 1);
+        int x = 1;
+        if (simd_row) {
+            x = simd_row(up, cur, down, out, row, method, 1, width - 1);
+        }
+        demosaicRowScalar(up, cur, down, out, width, row, method, x, width);
+    }
+}
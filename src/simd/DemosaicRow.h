@@ -0,0 +1,46 @@
+#ifndef DEMOSAICROW_H
+#define DEMOSAICROW_H
+
+// ȥ˸ʵֹмӿ (ڲʹãⲿ Demosaic.h)
+
+#include <cstdint>
+#include "Demosaic.h"
+
+// һеɫУred_row ʾк R ( B)g_even ʾżΪ G
+struct BayerRow {
+    bool red_row;
+    bool g_even;
+};
+
+inline BayerRow bayerRow(BayerPattern pattern, int y)
+{
+    const bool odd = (y & 1) != 0;
+    switch (pattern) {
+    case BayerPattern::GB: return odd ? BayerRow{ true, false } : BayerRow{ false, true };
+    case BayerPattern::RG: return odd ? BayerRow{ false, true } : BayerRow{ true, false };
+    case BayerPattern::GR: return odd ? BayerRow{ false, false } : BayerRow{ true, true };
+    case BayerPattern::BG: return odd ? BayerRow{ true, true } : BayerRow{ false, false };
+    }
+    return BayerRow{ true, false };
+}
+
+//  [x_begin, x_end) أup / cur / down ΪѰ߽ѡõС
+// x_begin >= 1  x_end <= width - 1 ڲز SIMD߽ɱ洦
+using DemosaicRowFn = void (*)(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, int width, BayerRow row, DemosaicMethod method, int x_begin, int x_end);
+
+// ʵʴ (ʣβɱ油)
+using DemosaicRowSimdFn = int (*)(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, BayerRow row, DemosaicMethod method, int x_begin, int x_end);
+
+void demosaicRowScalar(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, int width, BayerRow row, DemosaicMethod method, int x_begin, int x_end);
+
+int demosaicRowSse4(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, BayerRow row, DemosaicMethod method, int x_begin, int x_end);
+int demosaicRowAvx2(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, BayerRow row, DemosaicMethod method, int x_begin, int x_end);
+int demosaicRowAvx512(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, BayerRow row, DemosaicMethod method, int x_begin, int x_end);
+
+#endif // DEMOSAICROW_H
@@ -0,0 +1,70 @@
+// AVX2 ʵ֣ÿδ 32  (ļ -mavx2 )
+#include "DemosaicRow.h"
+#include "BgrInterleave.h"
+
+namespace {
+    // unpack / pack  128 λͨڽУʹʱ˳򲻱
+    inline __m256i avg4(__m256i a, __m256i b, __m256i c, __m256i d)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i two = _mm256_set1_epi16(2);
+        __m256i lo = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpacklo_epi8(a, zero), _mm256_unpacklo_epi8(b, zero)),
+            _mm256_add_epi16(_mm256_unpacklo_epi8(c, zero), _mm256_unpacklo_epi8(d, zero)));
+        __m256i hi = _mm256_add_epi16(_mm256_add_epi16(_mm256_unpackhi_epi8(a, zero), _mm256_unpackhi_epi8(b, zero)),
+            _mm256_add_epi16(_mm256_unpackhi_epi8(c, zero), _mm256_unpackhi_epi8(d, zero)));
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, two), 2);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, two), 2);
+        return _mm256_packus_epi16(lo, hi);
+    }
+
+    inline __m256i absDiff(__m256i a, __m256i b)
+    {
+        return _mm256_or_si256(_mm256_subs_epu8(a, b), _mm256_subs_epu8(b, a));
+    }
+
+    inline __m256i lessThan(__m256i a, __m256i b)
+    {
+        return _mm256_xor_si256(_mm256_cmpeq_epi8(_mm256_subs_epu8(b, a), _mm256_setzero_si256()), _mm256_set1_epi8(-1));
+    }
+
+    inline __m256i load(const uint8_t* p) { return _mm256_loadu_si256((const __m256i*)p); }
+}
+
+int demosaicRowAvx2(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, BayerRow row, DemosaicMethod method, int x_begin, int x_end)
+{
+    const bool g_at_lane0 = ((x_begin & 1) == 0) == row.g_even;
+    const __m256i g_mask = g_at_lane0 ? _mm256_set1_epi16(0x00FF) : _mm256_set1_epi16((short)0xFF00);
+    const bool edge_aware = method == DemosaicMethod::EdgeAware;
+
+    int x = x_begin;
+    for (; x + 32 <= x_end; x += 32) {
+        const __m256i c = load(cur + x);
+        const __m256i l = load(cur + x - 1);
+        const __m256i r = load(cur + x + 1);
+        const __m256i u = load(up + x);
+        const __m256i d = load(down + x);
+
+        const __m256i h2 = _mm256_avg_epu8(l, r);
+        const __m256i v2 = _mm256_avg_epu8(u, d);
+        const __m256i diag = avg4(load(up + x - 1), load(up + x + 1), load(down + x - 1), load(down + x + 1));
+        __m256i g_interp = avg4(l, r, u, d);
+        if (edge_aware) {
+            const __m256i dh = absDiff(l, r);
+            const __m256i dv = absDiff(u, d);
+            g_interp = _mm256_blendv_epi8(g_interp, v2, lessThan(dv, dh));
+            g_interp = _mm256_blendv_epi8(g_interp, h2, lessThan(dh, dv));
+        }
+
+        const __m256i own = _mm256_blendv_epi8(c, h2, g_mask);
+        const __m256i g = _mm256_blendv_epi8(g_interp, c, g_mask);
+        const __m256i other = _mm256_blendv_epi8(diag, v2, g_mask);
+        const __m256i b_out = row.red_row ? other : own;
+        const __m256i r_out = row.red_row ? own : other;
+
+        storeBgr16(dst + 3 * x, _mm256_castsi256_si128(b_out), _mm256_castsi256_si128(g), _mm256_castsi256_si128(r_out));
+        storeBgr16(dst + 3 * (x + 16), _mm256_extracti128_si256(b_out, 1), _mm256_extracti128_si256(g, 1),
+            _mm256_extracti128_si256(r_out, 1));
+    }
+    return x;
+}
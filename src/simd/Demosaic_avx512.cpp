@@ -0,0 +1,72 @@
+// AVX-512 (F + BW) ʵ֣ÿδ 64  (ļ -mavx512f -mavx512bw )
+#include "DemosaicRow.h"
+#include "BgrInterleave.h"
+
+namespace {
+    inline __m512i avg4(__m512i a, __m512i b, __m512i c, __m512i d)
+    {
+        const __m512i zero = _mm512_setzero_si512();
+        const __m512i two = _mm512_set1_epi16(2);
+        __m512i lo = _mm512_add_epi16(_mm512_add_epi16(_mm512_unpacklo_epi8(a, zero), _mm512_unpacklo_epi8(b, zero)),
+            _mm512_add_epi16(_mm512_unpacklo_epi8(c, zero), _mm512_unpacklo_epi8(d, zero)));
+        __m512i hi = _mm512_add_epi16(_mm512_add_epi16(_mm512_unpackhi_epi8(a, zero), _mm512_unpackhi_epi8(b, zero)),
+            _mm512_add_epi16(_mm512_unpackhi_epi8(c, zero), _mm512_unpackhi_epi8(d, zero)));
+        lo = _mm512_srli_epi16(_mm512_add_epi16(lo, two), 2);
+        hi = _mm512_srli_epi16(_mm512_add_epi16(hi, two), 2);
+        return _mm512_packus_epi16(lo, hi);
+    }
+
+    inline __m512i absDiff(__m512i a, __m512i b)
+    {
+        return _mm512_or_si512(_mm512_subs_epu8(a, b), _mm512_subs_epu8(b, a));
+    }
+
+    inline __m512i load(const uint8_t* p) { return _mm512_loadu_si512((const void*)p); }
+
+    //  k  128 λΡȫ 1  maskz ʽͨ extract ָͬ (k = 0 ʱֱõλĴ)
+    //  _mm*_undefined_* ΪֱֵͨGCC 12  -O2 -Wall »Ժ߱ -Wmaybe-uninitialized
+    template <int k>
+    inline __m128i lane(__m512i v) { return _mm512_maskz_extracti32x4_epi32(0xF, v, k); }
+}
+
+int demosaicRowAvx512(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, BayerRow row, DemosaicMethod method, int x_begin, int x_end)
+{
+    const bool g_at_lane0 = ((x_begin & 1) == 0) == row.g_even;
+    const __mmask64 g_mask = g_at_lane0 ? 0x5555555555555555ULL : 0xAAAAAAAAAAAAAAAAULL;
+    const bool edge_aware = method == DemosaicMethod::EdgeAware;
+
+    int x = x_begin;
+    for (; x + 64 <= x_end; x += 64) {
+        const __m512i c = load(cur + x);
+        const __m512i l = load(cur + x - 1);
+        const __m512i r = load(cur + x + 1);
+        const __m512i u = load(up + x);
+        const __m512i d = load(down + x);
+
+        const __m512i h2 = _mm512_avg_epu8(l, r);
+        const __m512i v2 = _mm512_avg_epu8(u, d);
+        const __m512i diag = avg4(load(up + x - 1), load(up + x + 1), load(down + x - 1), load(down + x + 1));
+        __m512i g_interp = avg4(l, r, u, d);
+        if (edge_aware) {
+            const __m512i dh = absDiff(l, r);
+            const __m512i dv = absDiff(u, d);
+            g_interp = _mm512_mask_blend_epi8(_mm512_cmplt_epu8_mask(dv, dh), g_interp, v2);
+            g_interp = _mm512_mask_blend_epi8(_mm512_cmplt_epu8_mask(dh, dv), g_interp, h2);
+        }
+
+        const __m512i own = _mm512_mask_blend_epi8(g_mask, c, h2);
+        const __m512i g = _mm512_mask_blend_epi8(g_mask, g_interp, c);
+        const __m512i other = _mm512_mask_blend_epi8(g_mask, diag, v2);
+        const __m512i b_out = row.red_row ? other : own;
+        const __m512i r_out = row.red_row ? own : other;
+
+        //  128 λ (16 ) ν֯д
+        uint8_t* out = dst + 3 * x;
+        storeBgr16(out, lane<0>(b_out), lane<0>(g), lane<0>(r_out));
+        storeBgr16(out + 48, lane<1>(b_out), lane<1>(g), lane<1>(r_out));
+        storeBgr16(out + 96, lane<2>(b_out), lane<2>(g), lane<2>(r_out));
+        storeBgr16(out + 144, lane<3>(b_out), lane<3>(g), lane<3>(r_out));
+    }
+    return x;
+}
@@ -0,0 +1,68 @@
+// SSE4.1 ʵ֣ÿδ 16  (ļ -msse4.1 )
+#include "DemosaicRow.h"
+#include "BgrInterleave.h"
+
+namespace {
+    // (a + b + c + d + 2) >> 2 16 λм󱥺ʹ
+    inline __m128i avg4(__m128i a, __m128i b, __m128i c, __m128i d)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i two = _mm_set1_epi16(2);
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero)),
+            _mm_add_epi16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero)));
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero)),
+            _mm_add_epi16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero)));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+        return _mm_packus_epi16(lo, hi);
+    }
+
+    inline __m128i absDiff(__m128i a, __m128i b)
+    {
+        return _mm_or_si128(_mm_subs_epu8(a, b), _mm_subs_epu8(b, a));
+    }
+
+    // ޷ a < b ֽ
+    inline __m128i lessThan(__m128i a, __m128i b)
+    {
+        return _mm_xor_si128(_mm_cmpeq_epi8(_mm_subs_epu8(b, a), _mm_setzero_si128()), _mm_set1_epi8(-1));
+    }
+
+    inline __m128i load(const uint8_t* p) { return _mm_loadu_si128((const __m128i*)p); }
+}
+
+int demosaicRowSse4(const uint8_t* up, const uint8_t* cur, const uint8_t* down,
+    uint8_t* dst, BayerRow row, DemosaicMethod method, int x_begin, int x_end)
+{
+    // Ϊżÿ G ڵͨλù̶
+    const bool g_at_lane0 = ((x_begin & 1) == 0) == row.g_even;
+    const __m128i g_mask = g_at_lane0 ? _mm_set1_epi16(0x00FF) : _mm_set1_epi16((short)0xFF00);
+    const bool edge_aware = method == DemosaicMethod::EdgeAware;
+
+    int x = x_begin;
+    for (; x + 16 <= x_end; x += 16) {
+        const __m128i c = load(cur + x);
+        const __m128i l = load(cur + x - 1);
+        const __m128i r = load(cur + x + 1);
+        const __m128i u = load(up + x);
+        const __m128i d = load(down + x);
+
+        const __m128i h2 = _mm_avg_epu8(l, r);
+        const __m128i v2 = _mm_avg_epu8(u, d);
+        const __m128i diag = avg4(load(up + x - 1), load(up + x + 1), load(down + x - 1), load(down + x + 1));
+        __m128i g_interp = avg4(l, r, u, d);
+        if (edge_aware) {
+            const __m128i dh = absDiff(l, r);
+            const __m128i dv = absDiff(u, d);
+            g_interp = _mm_blendv_epi8(g_interp, v2, lessThan(dv, dh));
+            g_interp = _mm_blendv_epi8(g_interp, h2, lessThan(dh, dv));
+        }
+
+        const __m128i own = _mm_blendv_epi8(c, h2, g_mask);
+        const __m128i g = _mm_blendv_epi8(g_interp, c, g_mask);
+        const __m128i other = _mm_blendv_epi8(diag, v2, g_mask);
+        if (row.red_row) storeBgr16(dst + 3 * x, other, g, own);
+        else storeBgr16(dst + 3 * x, own, g, other);
+    }
+    return x;
+}
@@ -0,0 +1,241 @@
+#include "Preview.h"
+#include <algorithm>
+#include <vector>
+
+// ȰһĿжӦԴۼӵ uint32 л (ڴϵԪؼӷԶ)
+// ٰ͡˵ȡƽдʱ˳ͨšԴͼÿֻֽһΡ
+namespace {
+    struct Spans {
+        std::vector<int> begin;
+        std::vector<int> end;
+    };
+
+    // Ŀ i -> Դ [i*src/dst, (i+1)*src/dst)Ŵʱ֤ 1 Դ
+    void makeSpans(int src_n, int dst_n, Spans& spans)
+    {
+        spans.begin.resize(dst_n);
+        spans.end.resize(dst_n);
+        for (int i = 0; i < dst_n; ++i) {
+            int b = (int)((int64_t)i * src_n / dst_n);
+            int e = (int)((int64_t)(i + 1) * src_n / dst_n);
+            b = std::min(b, src_n - 1);
+            spans.begin[i] = b;
+            spans.end[i] = std::max(e, b + 1);
+        }
+    }
+
+    // 㵹avg = (sum * recip + 2^23) >> 24sum <= 255 * n ʱһ
+    constexpr int kRecipShift = 24;
+
+    inline uint32_t reciprocal(uint32_t n)
+    {
+        return (uint32_t)(((1u << kRecipShift) + n / 2) / n);
+    }
+
+    inline uint8_t average(uint32_t sum, uint32_t recip)
+    {
+        uint32_t v = (uint32_t)(((uint64_t)sum * recip + (1u << (kRecipShift - 1))) >> kRecipShift);
+        return (uint8_t)std::min<uint32_t>(v, 255);
+    }
+
+    // ÿĿеĵֻ仯ʱ
+    void makeReciprocals(const Spans& xs, uint32_t rows, uint32_t weight, std::vector<uint32_t>& recip)
+    {
+        recip.resize(xs.begin.size());
+        for (size_t x = 0; x < xs.begin.size(); ++x) {
+            recip[x] = reciprocal((uint32_t)(xs.end[x] - xs.begin[x]) * rows * weight);
+        }
+    }
+
+    // Bayer Ԫ R / B /  G λ (, )
+    struct QuadLayout {
+        int r_row, r_col;
+        int b_row, b_col;
+        int g1_row, g1_col;
+        int g2_row, g2_col;
+    };
+
+    QuadLayout quadLayout(BayerPattern pattern)
+    {
+        switch (pattern) {
+        case BayerPattern::RG: return { 0, 0, 1, 1, 0, 1, 1, 0 };  // R G / G B
+        case BayerPattern::BG: return { 1, 1, 0, 0, 0, 1, 1, 0 };  // B G / G R
+        case BayerPattern::GR: return { 0, 1, 1, 0, 0, 0, 1, 1 };  // G R / B G
+        case BayerPattern::GB:
+        default:               return { 1, 0, 0, 1, 0, 0, 1, 1 };  // G B / R G
+        }
+    }
+}
+
+void previewFromBgr(const uint8_t* src, size_t src_stride, int src_w, int src_h,
+    uint8_t* dst, size_t dst_stride, int dst_w, int dst_h)
+{
+    if (!src || !dst || src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0) return;
+    Spans xs, ys;
+    makeSpans(src_w, dst_w, xs);
+    makeSpans(src_h, dst_h, ys);
+
+    const size_t row_elems = (size_t)src_w * 3;
+    thread_local std::vector<uint32_t> acc;
+    thread_local std::vector<uint32_t> recip;
+    acc.resize(row_elems);
+    uint32_t recip_rows = 0;
+
+    for (int y = 0; y < dst_h; ++y) {
+        std::fill(acc.begin(), acc.end(), 0u);
+        for (int sy = ys.begin[y]; sy < ys.end[y]; ++sy) {
+            const uint8_t* row = src + (size_t)sy * src_stride;
+            uint32_t* a = acc.data();
+            for (size_t i = 0; i < row_elems; ++i) a[i] += row[i];
+        }
+        const uint32_t rows = (uint32_t)(ys.end[y] - ys.begin[y]);
+        if (rows != recip_rows) {
+            makeReciprocals(xs, rows, 1, recip);
+            recip_rows = rows;
+        }
+
+        uint8_t* out = dst + (size_t)y * dst_stride;
+        if (src_w % dst_w == 0) {
+            // С ( 1280 -> 640)ÿĿеȿʡе
+            const int k = src_w / dst_w;
+            const uint32_t rc = recip[0];
+            const uint32_t* a = acc.data();
+            for (int x = 0; x < dst_w; ++x) {
+                uint32_t b = 0, g = 0, r = 0;
+                for (int i = 0; i < k; ++i, a += 3) {
+                    b += a[0];
+                    g += a[1];
+                    r += a[2];
+                }
+                out[x * 3 + 0] = average(r, rc);
+                out[x * 3 + 1] = average(g, rc);
+                out[x * 3 + 2] = average(b, rc);
+            }
+            continue;
+        }
+        for (int x = 0; x < dst_w; ++x) {
+            uint32_t b = 0, g = 0, r = 0;
+            const uint32_t* a = acc.data() + (size_t)xs.begin[x] * 3;
+            for (int sx = xs.begin[x]; sx < xs.end[x]; ++sx, a += 3) {
+                b += a[0];
+                g += a[1];
+                r += a[2];
+            }
+            out[x * 3 + 0] = average(r, recip[x]);
+            out[x * 3 + 1] = average(g, recip[x]);
+            out[x * 3 + 2] = average(b, recip[x]);
+        }
+    }
+}
+
+void previewFromBayer(const uint8_t* src, size_t src_stride, int src_w, int src_h, BayerPattern pattern,
+    uint8_t* dst, size_t dst_stride, int dst_w, int dst_h)
+{
+    const int qw = src_w / 2;
+    const int qh = src_h / 2;
+    if (!src || !dst || qw <= 0 || qh <= 0 || dst_w <= 0 || dst_h <= 0) return;
+    Spans xs, ys;
+    makeSpans(qw, dst_w, xs);
+    makeSpans(qh, dst_h, ys);
+    const QuadLayout q = quadLayout(pattern);
+
+    thread_local std::vector<uint32_t> acc_r, acc_g, acc_b;
+    thread_local std::vector<uint32_t> recip_rb, recip_g;
+    acc_r.resize(qw);
+    acc_g.resize(qw);
+    acc_b.resize(qw);
+    uint32_t recip_rows = 0;
+
+    for (int y = 0; y < dst_h; ++y) {
+        std::fill(acc_r.begin(), acc_r.end(), 0u);
+        std::fill(acc_g.begin(), acc_g.end(), 0u);
+        std::fill(acc_b.begin(), acc_b.end(), 0u);
+        for (int sy = ys.begin[y]; sy < ys.end[y]; ++sy) {
+            const uint8_t* quad = src + (size_t)sy * 2 * src_stride;
+            const uint8_t* pr = quad + q.r_row * src_stride + q.r_col;
+            const uint8_t* pb = quad + q.b_row * src_stride + q.b_col;
+            const uint8_t* pg1 = quad + q.g1_row * src_stride + q.g1_col;
+            const uint8_t* pg2 = quad + q.g2_row * src_stride + q.g2_col;
+            uint32_t* ar = acc_r.data();
+            uint32_t* ag = acc_g.data();
+            uint32_t* ab = acc_b.data();
+            for (int qx = 0; qx < qw; ++qx) {
+                ar[qx] += pr[2 * qx];
+                ab[qx] += pb[2 * qx];
+                ag[qx] += (uint32_t)pg1[2 * qx] + pg2[2 * qx];
+            }
+        }
+        const uint32_t rows = (uint32_t)(ys.end[y] - ys.begin[y]);
+        if (rows != recip_rows) {
+            makeReciprocals(xs, rows, 1, recip_rb);
+            makeReciprocals(xs, rows, 2, recip_g);
+            recip_rows = rows;
+        }
+
+        uint8_t* out = dst + (size_t)y * dst_stride;
+        if (qw % dst_w == 0) {
+            const int k = qw / dst_w;
+            for (int x = 0; x < dst_w; ++x) {
+                uint32_t r = 0, g = 0, b = 0;
+                for (int i = x * k; i < (x + 1) * k; ++i) {
+                    r += acc_r[i];
+                    g += acc_g[i];
+                    b += acc_b[i];
+                }
+                out[x * 3 + 0] = average(r, recip_rb[0]);
+                out[x * 3 + 1] = average(g, recip_g[0]);
+                out[x * 3 + 2] = average(b, recip_rb[0]);
+            }
+            continue;
+        }
+        for (int x = 0; x < dst_w; ++x) {
+            uint32_t r = 0, g = 0, b = 0;
+            for (int sx = xs.begin[x]; sx < xs.end[x]; ++sx) {
+                r += acc_r[sx];
+                g += acc_g[sx];
+                b += acc_b[sx];
+            }
+            out[x * 3 + 0] = average(r, recip_rb[x]);
+            out[x * 3 + 1] = average(g, recip_g[x]);
+            out[x * 3 + 2] = average(b, recip_rb[x]);
+        }
+    }
+}
+
+void previewFromMono(const uint8_t* src, size_t src_stride, int src_w, int src_h,
+    uint8_t* dst, size_t dst_stride, int dst_w, int dst_h)
+{
+    if (!src || !dst || src_w <= 0 || src_h <= 0 || dst_w <= 0 || dst_h <= 0) return;
+    Spans xs, ys;
+    makeSpans(src_w, dst_w, xs);
+    makeSpans(src_h, dst_h, ys);
+
+    thread_local std::vector<uint32_t> acc;
+    thread_local std::vector<uint32_t> recip;
+    acc.resize(src_w);
+    uint32_t recip_rows = 0;
+
+    for (int y = 0; y < dst_h; ++y) {
+        std::fill(acc.begin(), acc.end(), 0u);
+        for (int sy = ys.begin[y]; sy < ys.end[y]; ++sy) {
+            const uint8_t* row = src + (size_t)sy * src_stride;
+            uint32_t* a = acc.data();
+            for (int i = 0; i < src_w; ++i) a[i] += row[i];
+        }
+        const uint32_t rows = (uint32_t)(ys.end[y] - ys.begin[y]);
+        if (rows != recip_rows) {
+            makeReciprocals(xs, rows, 1, recip);
+            recip_rows = rows;
+        }
+
+        uint8_t* out = dst + (size_t)y * dst_stride;
+        for (int x = 0; x < dst_w; ++x) {
+            uint32_t sum = 0;
+            for (int sx = xs.begin[x]; sx < xs.end[x]; ++sx) sum += acc[sx];
+            const uint8_t v = average(sum, recip[x]);
+            out[x * 3 + 0] = v;
+            out[x * 3 + 1] = v;
+            out[x * 3 + 2] = v;
+        }
+    }
+}
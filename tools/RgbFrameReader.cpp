@@ -0,0 +1,160 @@
+#include "RgbFrameReader.h"
+#include "PixelFormat.h"
+#include "ChunkCodec.h"
+#include "SegmentManifest.h"
+#include <algorithm>
+#include <cstdio>
+
+RgbFrameReader::~RgbFrameReader()
+{
+    close();
+}
+
+bool RgbFrameReader::open(const std::string& path)
+{
+    close();
+    H5::Exception::dontPrint();
+    registerChunkFilters(); // ûаװ zstd / lz4 ʱҲܶѹļ
+
+    const bool is_manifest = path.size() > 5 && path.compare(path.size() - 5, 5, ".json") == 0;
+    if (!is_manifest) {
+        segments.push_back(Segment{ path, 0, 0 });
+    }
+    else {
+        SegmentManifest manifest;
+        if (!readSegmentManifest(path, manifest)) return false;
+        if (!manifest.complete) {
+            printf("Manifest %s is incomplete (recording interrupted), reading what is there.\n", path.c_str());
+        }
+        for (const SegmentInfo& info : manifest.segments) {
+            segments.push_back(Segment{ info.path, 0, 0 });
+        }
+    }
+    if (segments.empty()) {
+        printf("No segments in %s\n", path.c_str());
+        return false;
+    }
+
+    // δһΣļʵʵ֡Ϊ׼ (жϵһ嵥֡ܲ׼)
+    uint64_t total = 0;
+    int expected_rank = 0, expected_width = 0, expected_height = 0;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        if (!openSegment(i)) {
+            segments.clear();
+            return false;
+        }
+        if (i > 0 && (rank != expected_rank || frame_width != expected_width || frame_height != expected_height)) {
+            printf("Segment %s does not match the first segment's frame shape.\n", segments[i].path.c_str());
+            closeSegment();
+            segments.clear();
+            return false;
+        }
+        expected_rank = rank;
+        expected_width = frame_width;
+        expected_height = frame_height;
+        segments[i].first_frame = total;
+        total += segments[i].frames;
+    }
+    frame_count = total;
+    is_open = true;
+    return true;
+}
+
+bool RgbFrameReader::openSegment(size_t index)
+{
+    if (current == index) return true;
+    closeSegment();
+    const std::string& path = segments[index].path;
+    try {
+        file = H5::H5File(path, H5F_ACC_RDONLY);
+        dataset = file.openDataSet("/rgb/frames");
+
+        H5::DataSpace space = dataset.getSpace();
+        rank = space.getSimpleExtentNdims();
+        hsize_t dims[4] = { 0, 0, 0, 0 };
+        space.getSimpleExtentDims(dims);
+        if (rank == 4 && dims[3] != 3) {
+            printf("Unsupported channel count %llu in %s\n", (unsigned long long)dims[3], path.c_str());
+            return false;
+        }
+        if (rank != 3 && rank != 4) {
+            printf("Unsupported /rgb/frames rank %d in %s\n", rank, path.c_str());
+            return false;
+        }
+        segments[index].frames = dims[0];
+        frame_height = (int)dims[1];
+        frame_width = (int)dims[2];
+
+        // ļû pixel_format ԣֻ BGR
+        pixel_format = "BGR8";
+        if (dataset.attrExists("pixel_format")) {
+            H5::Attribute attr = dataset.openAttribute("pixel_format");
+            H5::StrType str_type = attr.getStrType();
+            attr.read(str_type, pixel_format);
+        }
+        if (rank == 3 && mosaicToBgrCode(pixel_format) < 0) {
+            printf("Unsupported raw pixel format %s in %s\n", pixel_format.c_str(), path.c_str());
+            return false;
+        }
+    }
+    catch (const H5::Exception& e) {
+        printf("Failed to open %s: %s\n", path.c_str(), e.getCDetailMsg());
+        return false;
+    }
+    current = index;
+    return true;
+}
+
+void RgbFrameReader::closeSegment()
+{
+    if (current == SIZE_MAX) return;
+    try {
+        dataset.close();
+        file.close();
+    }
+    catch (const H5::Exception& e) {
+        printf("HDF5 close error: %s\n", e.getCDetailMsg());
+    }
+    current = SIZE_MAX;
+}
+
+void RgbFrameReader::close()
+{
+    closeSegment();
+    segments.clear();
+    is_open = false;
+    frame_count = 0;
+}
+
+bool RgbFrameReader::readRaw(uint64_t index, cv::Mat& frame)
+{
+    if (!is_open || index >= frame_count) return false;
+    // ҵ index ڵķֶ
+    auto it = std::upper_bound(segments.begin(), segments.end(), index,
+        [](uint64_t i, const Segment& s) { return i < s.first_frame; });
+    const size_t segment = (size_t)(it - segments.begin()) - 1;
+    if (!openSegment(segment)) return false;
+    const hsize_t local = (hsize_t)(index - segments[segment].first_frame);
+    try {
+        frame.create(frame_height, frame_width, isRaw() ? CV_8UC1 : CV_8UC3);
+
+        H5::DataSpace file_space = dataset.getSpace();
+        hsize_t offset[4] = { local, 0, 0, 0 };
+        hsize_t slab_dims[4] = { 1, (hsize_t)frame_height, (hsize_t)frame_width, 3 };
+        file_space.selectHyperslab(H5S_SELECT_SET, slab_dims, offset);
+        H5::DataSpace mem_space(rank, slab_dims, NULL);
+        dataset.read(frame.data, H5::PredType::NATIVE_UINT8, mem_space, file_space);
+    }
+    catch (const H5::Exception& e) {
+        printf("Failed to read frame %llu: %s\n", (unsigned long long)index, e.getCDetailMsg());
+        return false;
+    }
+    return true;
+}
+
+bool RgbFrameReader::readBgr(uint64_t index, cv::Mat& bgr)
+{
+    if (!isRaw()) return readRaw(index, bgr);
+    if (!readRaw(index, scratch)) return false;
+    return demosaicToBgr(scratch, bgr, pixel_format);
+}
@@ -0,0 +1,62 @@
+#ifndef RGBFRAMEREADER_H
+#define RGBFRAMEREADER_H
+
+#include <H5Cpp.h>
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// rgb_data.h5 ߶ȡӿ
+// ͬʱּ֧¼ʽ
+//   - BGR:      /rgb/frames Ϊ N x H x W x 3pixel_format = "BGR8" (ļûиԣҲ BGR )
+//   - ԭʼ: /rgb/frames Ϊ N x H x Wpixel_format Ϊ BayerGB8 / BayerRG8 / ... ȡʱȥ
+// open ҲԴֶ¼Ƶ嵥 (rgb_manifest.json)ΰ嵥˳ƴ֡ţ
+// ͬһʱֻһļ
+class RgbFrameReader {
+public:
+    RgbFrameReader() = default;
+    ~RgbFrameReader();
+
+    RgbFrameReader(const RgbFrameReader&) = delete;
+    RgbFrameReader& operator=(const RgbFrameReader&) = delete;
+
+    bool open(const std::string& path);  // rgb_data.h5  rgb_manifest.json
+    void close();
+
+    bool isOpen() const { return is_open; }
+    uint64_t frameCount() const { return frame_count; }
+    int width() const { return frame_width; }
+    int height() const { return frame_height; }
+    bool isRaw() const { return rank == 3; }
+    const std::string& pixelFormat() const { return pixel_format; }
+
+    // ļеԭ index ֡ (ԭʼģʽΪ CV_8UC1 ˣBGR ģʽΪ CV_8UC3)
+    bool readRaw(uint64_t index, cv::Mat& frame);
+    //  index ֡תΪ BGR
+    bool readBgr(uint64_t index, cv::Mat& bgr);
+
+private:
+    struct Segment {
+        std::string path;
+        uint64_t first_frame = 0;
+        uint64_t frames = 0;
+    };
+
+    bool openSegment(size_t index);
+    void closeSegment();
+
+    std::vector<Segment> segments;
+    size_t current = SIZE_MAX;   // ǰ򿪵ķֶ
+    H5::H5File file;
+    H5::DataSet dataset;
+    bool is_open = false;
+    int rank = 0;
+    uint64_t frame_count = 0;
+    int frame_width = 0;
+    int frame_height = 0;
+    std::string pixel_format;
+    cv::Mat scratch;  // readBgr м˻壬֡
+};
+
+#endif // RGBFRAMEREADER_H
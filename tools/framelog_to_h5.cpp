@@ -0,0 +1,84 @@
+// ֡־ (rgb_frames.dcfl) תΪֱ¼ֵͬ rgb_data.h5
+// ÷: framelog_to_h5 <rgb_frames.dcfl> <rgb_data.h5> [none|deflate|zstd|lz4] [level]
+//   Ϊ /rgb/frames Ŀѹʽ ( HDF5 ڱѹ)Ĭϲѹ
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "FrameLog.h"
+#include "H5FrameSink.h"
+
+static bool parseCodec(const char* name, ChunkCodec& codec)
+{
+    const ChunkCodec codecs[] = { ChunkCodec::None, ChunkCodec::Deflate, ChunkCodec::Zstd, ChunkCodec::Lz4 };
+    for (ChunkCodec c : codecs) {
+        if (strcmp(name, chunkCodecName(c)) == 0) {
+            codec = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        printf("usage: %s <rgb_frames.dcfl> <rgb_data.h5> [none|deflate|zstd|lz4] [level]\n", argv[0]);
+        return 1;
+    }
+
+    H5FrameWriter::Options options;
+    options.batch_frames = 16;
+    if (argc > 3 && !parseCodec(argv[3], options.compression.codec)) {
+        printf("Unknown codec %s\n", argv[3]);
+        return 1;
+    }
+    if (argc > 4) options.compression.level = std::atoi(argv[4]);
+    if (!chunkCodecAvailable(options.compression.codec)) {
+        printf("Chunk codec %s is not available in this build.\n", chunkCodecName(options.compression.codec));
+        return 1;
+    }
+    registerChunkFilters();
+
+    FrameLogReader reader;
+    if (!reader.open(argv[1])) return 1;
+    const FrameFormat& format = reader.format();
+    printf("%llu frames, %ux%ux%u, %s\n", (unsigned long long)reader.frameCount(),
+        format.width, format.height, format.channels, format.pixel_format.c_str());
+
+    // record.chunk Ϊգѹ ()  HDF5 
+    H5FrameSink sink(options);
+    if (!sink.openFile(argv[2], format)) return 1;
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<uint8_t> pixels(reader.frameBytes());
+    framelog::RecordHeader header;
+    uint64_t converted = 0;
+    for (uint64_t i = 0; i < reader.frameCount(); ++i) {
+        if (!reader.read(i, header, pixels.data())) {
+            printf("Record %llu is damaged, stopping here.\n", (unsigned long long)i);
+            break;
+        }
+        FrameRecord record;
+        record.data = pixels.data();
+        record.data_bytes = pixels.size();
+        record.frame_number = header.frame_number;
+        record.host_timestamp_ns = header.host_timestamp_ns;
+        record.device_timestamp = header.device_timestamp;
+        record.event_timestamp_source = (uint8_t)(header.flags & 0xFF);
+        if (record.event_timestamp_source != 0) record.event_timestamp_us = header.event_timestamp_us;
+        if (!sink.write(record)) {
+            sink.close();
+            return 1;
+        }
+        converted++;
+    }
+    if (!sink.close()) return 1;
+
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    printf("Converted %llu frames to %s in %.2f s (%.0f MB/s)\n", (unsigned long long)converted, argv[2],
+        seconds, converted * (double)reader.frameBytes() / 1e6 / (seconds > 0 ? seconds : 1));
+    return 0;
+}
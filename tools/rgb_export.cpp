@@ -0,0 +1,39 @@
+//  rgb_data.h5 е֡Ϊ PNG (ԭʼļȥ)
+// ÷: rgb_export <rgb_data.h5 | rgb_manifest.json> <out_dir> [first] [count]
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <opencv2/imgcodecs.hpp>
+#include "RgbFrameReader.h"
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3) {
+        printf("usage: %s <rgb_data.h5 | rgb_manifest.json> <out_dir> [first] [count]\n", argv[0]);
+        return 1;
+    }
+    const std::string out_dir = argv[2];
+
+    RgbFrameReader reader;
+    if (!reader.open(argv[1])) return 1;
+    printf("%llu frames, %dx%d, %s\n", (unsigned long long)reader.frameCount(),
+        reader.width(), reader.height(), reader.pixelFormat().c_str());
+
+    const uint64_t first = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 0;
+    uint64_t count = argc > 4 ? std::strtoull(argv[4], nullptr, 10) : reader.frameCount();
+    if (first >= reader.frameCount()) return 0;
+    if (count > reader.frameCount() - first) count = reader.frameCount() - first;
+
+    cv::Mat bgr;
+    char name[64];
+    for (uint64_t i = first; i < first + count; ++i) {
+        if (!reader.readBgr(i, bgr)) return 1;
+        snprintf(name, sizeof(name), "/frame_%06llu.png", (unsigned long long)i);
+        if (!cv::imwrite(out_dir + name, bgr)) {
+            printf("Failed to write %s%s\n", out_dir.c_str(), name);
+            return 1;
+        }
+    }
+    printf("Exported %llu frames to %s\n", (unsigned long long)count, out_dir.c_str());
+    return 0;
+}